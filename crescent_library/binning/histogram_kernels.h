@@ -0,0 +1,285 @@
+#ifndef HISTOGRAM_KERNELS_H
+#define HISTOGRAM_KERNELS_H
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#if !defined(CRSC_DISABLE_SIMD)
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace crsc {
+    namespace hist {
+        /**
+         * \brief Detail namespace for the binning kernels used by the histograms. Nothing in this
+         *        namespace is part of the public API.
+         *
+         * SIMD code paths for the bin index computation of `float` and `double` data are selected at
+         * compile-time from the instruction set macros defined by the compiler (`__AVX512F__`, `__AVX2__`,
+         * `__ARM_NEON`); defining `CRSC_DISABLE_SIMD` before inclusion forces the portable scalar kernels.
+         */
+        namespace hist_impl {
+            /**
+             * \brief Type in which bin indices are computed from data of type `RTy`, `double` for integral data.
+             */
+            template<class RTy>
+            using scale_t = std::conditional_t<std::is_floating_point<RTy>::value, RTy, double>;
+            /**
+             * \brief Computes the index of the bin containing `value` for bins of reciprocal width `recip`
+             *        starting at `min`, clamping values below the first bin (and NaN) into the first bin and
+             *        values at or beyond the upper edge into the last bin.
+             */
+            template<class RTy>
+            std::size_t bin_index(RTy value, RTy min, scale_t<RTy> recip, std::size_t nbins) noexcept {
+                const scale_t<RTy> pos = static_cast<scale_t<RTy>>(value - min)*recip;
+                if (!(pos >= scale_t<RTy>())) return 0U;
+                if (pos >= static_cast<scale_t<RTy>>(nbins)) return nbins - 1U;
+                return static_cast<std::size_t>(pos);
+            }
+            /**
+             * \brief Number of values binned per block by `accumulate_counts`, such that a block of values
+             *        and their indices stay resident in L1.
+             */
+            constexpr std::size_t bin_block_size = 256U;
+            /**
+             * \brief Computes the bin indices `out[i]` of each of the `n` values `x[i]` with `bin_index`.
+             */
+            template<class RTy>
+            void scalar_bin_indices(const RTy* x, std::size_t n, RTy min, scale_t<RTy> recip, std::size_t nbins,
+                std::uint32_t* out) noexcept {
+                for (std::size_t i = 0U; i < n; ++i)
+                    out[i] = static_cast<std::uint32_t>(bin_index(x[i], min, recip, nbins));
+            }
+            /**
+             * \struct bin_index_kernel
+             *
+             * \brief Computes the bin indices `out[i]` of each of the `n` values `x[i]`, with the semantics of
+             *        `bin_index`, for histograms of fewer than `2^31` bins. This is the portable version used for
+             *        any arithmetic type without a vectorised specialisation.
+             */
+            template<class RTy, class = void>
+            struct bin_index_kernel {
+                static void run(const RTy* x, std::size_t n, RTy min, scale_t<RTy> recip, std::size_t nbins,
+                    std::uint32_t* out) noexcept {
+                    scalar_bin_indices(x, n, min, recip, nbins, out);
+                }
+            };
+#if !defined(CRSC_DISABLE_SIMD)
+#if defined(__AVX512F__)
+            template<>
+            struct bin_index_kernel<double> {
+                static void run(const double* x, std::size_t n, double min, double recip, std::size_t nbins,
+                    std::uint32_t* out) noexcept {
+                    const __m512d vmin = _mm512_set1_pd(min), vrecip = _mm512_set1_pd(recip);
+                    const __m512d vzero = _mm512_setzero_pd(), vlast = _mm512_set1_pd(static_cast<double>(nbins - 1U));
+                    std::size_t i = 0U;
+                    for (; i + 8U <= n; i += 8U) {
+                        // max(pos, 0) maps NaN to zero as the second operand is returned for unordered inputs
+                        __m512d pos = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), vmin), vrecip);
+                        pos = _mm512_min_pd(_mm512_max_pd(pos, vzero), vlast);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvttpd_epi32(pos));
+                    }
+                    scalar_bin_indices(x + i, n - i, min, recip, nbins, out + i);
+                }
+            };
+            template<>
+            struct bin_index_kernel<float> {
+                static void run(const float* x, std::size_t n, float min, float recip, std::size_t nbins,
+                    std::uint32_t* out) noexcept {
+                    const __m512 vmin = _mm512_set1_ps(min), vrecip = _mm512_set1_ps(recip);
+                    const __m512 vzero = _mm512_setzero_ps(), vlast = _mm512_set1_ps(static_cast<float>(nbins - 1U));
+                    std::size_t i = 0U;
+                    for (; i + 16U <= n; i += 16U) {
+                        __m512 pos = _mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(x + i), vmin), vrecip);
+                        pos = _mm512_min_ps(_mm512_max_ps(pos, vzero), vlast);
+                        _mm512_storeu_si512(reinterpret_cast<void*>(out + i), _mm512_cvttps_epi32(pos));
+                    }
+                    scalar_bin_indices(x + i, n - i, min, recip, nbins, out + i);
+                }
+            };
+#elif defined(__AVX2__)
+            template<>
+            struct bin_index_kernel<double> {
+                static void run(const double* x, std::size_t n, double min, double recip, std::size_t nbins,
+                    std::uint32_t* out) noexcept {
+                    const __m256d vmin = _mm256_set1_pd(min), vrecip = _mm256_set1_pd(recip);
+                    const __m256d vzero = _mm256_setzero_pd(), vlast = _mm256_set1_pd(static_cast<double>(nbins - 1U));
+                    std::size_t i = 0U;
+                    for (; i + 4U <= n; i += 4U) {
+                        // max(pos, 0) maps NaN to zero as the second operand is returned for unordered inputs
+                        __m256d pos = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i), vmin), vrecip);
+                        pos = _mm256_min_pd(_mm256_max_pd(pos, vzero), vlast);
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvttpd_epi32(pos));
+                    }
+                    scalar_bin_indices(x + i, n - i, min, recip, nbins, out + i);
+                }
+            };
+            template<>
+            struct bin_index_kernel<float> {
+                static void run(const float* x, std::size_t n, float min, float recip, std::size_t nbins,
+                    std::uint32_t* out) noexcept {
+                    const __m256 vmin = _mm256_set1_ps(min), vrecip = _mm256_set1_ps(recip);
+                    const __m256 vzero = _mm256_setzero_ps(), vlast = _mm256_set1_ps(static_cast<float>(nbins - 1U));
+                    std::size_t i = 0U;
+                    for (; i + 8U <= n; i += 8U) {
+                        __m256 pos = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), vmin), vrecip);
+                        pos = _mm256_min_ps(_mm256_max_ps(pos, vzero), vlast);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvttps_epi32(pos));
+                    }
+                    scalar_bin_indices(x + i, n - i, min, recip, nbins, out + i);
+                }
+            };
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            template<>
+            struct bin_index_kernel<float> {
+                static void run(const float* x, std::size_t n, float min, float recip, std::size_t nbins,
+                    std::uint32_t* out) noexcept {
+                    const float32x4_t vmin = vdupq_n_f32(min), vrecip = vdupq_n_f32(recip);
+                    const float32x4_t vlast = vdupq_n_f32(static_cast<float>(nbins - 1U));
+                    std::size_t i = 0U;
+                    for (; i + 4U <= n; i += 4U) {
+                        // unsigned conversion saturates negative values and NaN to zero
+                        float32x4_t pos = vmulq_f32(vsubq_f32(vld1q_f32(x + i), vmin), vrecip);
+                        vst1q_u32(out + i, vcvtq_u32_f32(vminq_f32(pos, vlast)));
+                    }
+                    scalar_bin_indices(x + i, n - i, min, recip, nbins, out + i);
+                }
+            };
+#if defined(__aarch64__)
+            template<>
+            struct bin_index_kernel<double> {
+                static void run(const double* x, std::size_t n, double min, double recip, std::size_t nbins,
+                    std::uint32_t* out) noexcept {
+                    const float64x2_t vmin = vdupq_n_f64(min), vrecip = vdupq_n_f64(recip);
+                    const float64x2_t vlast = vdupq_n_f64(static_cast<double>(nbins - 1U));
+                    std::size_t i = 0U;
+                    for (; i + 2U <= n; i += 2U) {
+                        float64x2_t pos = vmulq_f64(vsubq_f64(vld1q_f64(x + i), vmin), vrecip);
+                        vst1_u32(out + i, vmovn_u64(vcvtq_u64_f64(vminq_f64(pos, vlast))));
+                    }
+                    scalar_bin_indices(x + i, n - i, min, recip, nbins, out + i);
+                }
+            };
+#endif
+#endif
+#endif // !CRSC_DISABLE_SIMD
+            /**
+             * \brief Adds the values in the range `[first, last)` to the `nbins` frequencies `counts` of bins
+             *        of reciprocal width `recip` starting at `min`, with values clamped as by `bin_index`.
+             *
+             * Values are gathered in blocks of `bin_block_size` such that the bin indices of each block are
+             * computed by the (vectorised) `bin_index_kernel`, whatever the iterator type.
+             */
+            template<class RTy, class InputIt>
+            void accumulate_counts(InputIt first, InputIt last, RTy min, scale_t<RTy> recip, std::size_t nbins,
+                std::size_t* counts) {
+                if (nbins > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+                    for (; first != last; ++first) ++counts[bin_index(static_cast<RTy>(*first), min, recip, nbins)];
+                    return;
+                }
+                RTy values[bin_block_size];
+                std::uint32_t indices[bin_block_size];
+                while (first != last) {
+                    std::size_t n = 0U;
+                    for (; n < bin_block_size && first != last; ++n, ++first) values[n] = static_cast<RTy>(*first);
+                    bin_index_kernel<RTy>::run(values, n, min, recip, nbins, indices);
+                    for (std::size_t i = 0U; i < n; ++i) ++counts[indices[i]];
+                }
+            }
+            /**
+             * \brief Adds the value pairs of the ranges `[first_x, last_x)` and `[first_y, ...)` to the
+             *        row-major `xbins` x `ybins` frequencies `counts`, see `accumulate_counts`.
+             */
+            template<class RTy, class InputIt>
+            void accumulate_counts_2d(InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y,
+                RTy min_x, scale_t<RTy> recip_x, std::size_t xbins, RTy min_y, scale_t<RTy> recip_y, std::size_t ybins,
+                std::size_t* counts) {
+                const std::size_t max_bins = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+                if (xbins > max_bins || ybins > max_bins) {
+                    for (; first_x != last_x && first_y != last_y; ++first_x, ++first_y) {
+                        ++counts[bin_index(static_cast<RTy>(*first_x), min_x, recip_x, xbins)*ybins
+                            + bin_index(static_cast<RTy>(*first_y), min_y, recip_y, ybins)];
+                    }
+                    return;
+                }
+                RTy values_x[bin_block_size];
+                RTy values_y[bin_block_size];
+                std::uint32_t indices_x[bin_block_size];
+                std::uint32_t indices_y[bin_block_size];
+                while (first_x != last_x && first_y != last_y) {
+                    std::size_t n = 0U;
+                    for (; n < bin_block_size && first_x != last_x && first_y != last_y; ++n, ++first_x, ++first_y) {
+                        values_x[n] = static_cast<RTy>(*first_x);
+                        values_y[n] = static_cast<RTy>(*first_y);
+                    }
+                    bin_index_kernel<RTy>::run(values_x, n, min_x, recip_x, xbins, indices_x);
+                    bin_index_kernel<RTy>::run(values_y, n, min_y, recip_y, ybins, indices_y);
+                    for (std::size_t i = 0U; i < n; ++i)
+                        ++counts[static_cast<std::size_t>(indices_x[i])*ybins + indices_y[i]];
+                }
+            }
+            /**
+             * \brief Adds the values in the range `[first, last)` lying within `[min, max)` to the `nbins`
+             *        frequencies `counts`, see `accumulate_counts`, counting values below `min` (or NaN) in
+             *        `underflow` and values at or above `max` in `overflow`.
+             */
+            template<class RTy, class InputIt>
+            void accumulate_counts_in_range(InputIt first, InputIt last, RTy min, RTy max, scale_t<RTy> recip,
+                std::size_t nbins, std::size_t* counts, std::size_t& underflow, std::size_t& overflow) {
+                const bool vectorise = nbins <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+                RTy values[bin_block_size];
+                std::uint32_t indices[bin_block_size];
+                while (first != last) {
+                    // gather the values within range, the remainder only need counting
+                    std::size_t n = 0U;
+                    for (std::size_t taken = 0U; taken < bin_block_size && first != last; ++taken, ++first) {
+                        const RTy value = static_cast<RTy>(*first);
+                        if (!(value >= min)) ++underflow;
+                        else if (!(value < max)) ++overflow;
+                        else if (vectorise) values[n++] = value;
+                        else ++counts[bin_index(value, min, recip, nbins)];
+                    }
+                    bin_index_kernel<RTy>::run(values, n, min, recip, nbins, indices);
+                    for (std::size_t i = 0U; i < n; ++i) ++counts[indices[i]];
+                }
+            }
+            /**
+             * \brief Adds the value pairs of the ranges `[first_x, last_x)` and `[first_y, ...)` lying within
+             *        `[min_x, max_x)` x `[min_y, max_y)` to the row-major `xbins` x `ybins` frequencies `counts`,
+             *        see `accumulate_counts_2d`, counting the pairs lying outside (or with NaN) in `outside`.
+             */
+            template<class RTy, class InputIt>
+            void accumulate_counts_in_range_2d(InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y,
+                RTy min_x, RTy max_x, scale_t<RTy> recip_x, std::size_t xbins, RTy min_y, RTy max_y, scale_t<RTy> recip_y,
+                std::size_t ybins, std::size_t* counts, std::size_t& outside) {
+                const std::size_t max_bins = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+                const bool vectorise = xbins <= max_bins && ybins <= max_bins;
+                RTy values_x[bin_block_size];
+                RTy values_y[bin_block_size];
+                std::uint32_t indices_x[bin_block_size];
+                std::uint32_t indices_y[bin_block_size];
+                while (first_x != last_x && first_y != last_y) {
+                    std::size_t n = 0U;
+                    for (std::size_t taken = 0U; taken < bin_block_size && first_x != last_x && first_y != last_y;
+                        ++taken, ++first_x, ++first_y) {
+                        const RTy x = static_cast<RTy>(*first_x);
+                        const RTy y = static_cast<RTy>(*first_y);
+                        if (!(x >= min_x && x < max_x && y >= min_y && y < max_y)) ++outside;
+                        else if (vectorise) { values_x[n] = x; values_y[n++] = y; }
+                        else ++counts[bin_index(x, min_x, recip_x, xbins)*ybins + bin_index(y, min_y, recip_y, ybins)];
+                    }
+                    bin_index_kernel<RTy>::run(values_x, n, min_x, recip_x, xbins, indices_x);
+                    bin_index_kernel<RTy>::run(values_y, n, min_y, recip_y, ybins, indices_y);
+                    for (std::size_t i = 0U; i < n; ++i)
+                        ++counts[static_cast<std::size_t>(indices_x[i])*ybins + indices_y[i]];
+                }
+            }
+        }
+    }
+}
+
+#endif // !HISTOGRAM_KERNELS_H
@@ -1,73 +1,243 @@
 #ifndef RANGED_HISTOGRAM_H
 #define RANGED_HISTOGRAM_H
+#include "histogram_kernels.h"
+#include "threading_utilities.h"
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
 #include <map>
+#include <mutex>
 #include <numeric>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace crsc {
     namespace hist {
+        namespace hist_impl {
+            /**
+             * \class bin_iterator
+             *
+             * \brief Iterator over the bins of a histogram with flat storage, computing the edges of
+             *        each bin on dereference such that each element is a `(bin, frequency)` pair in
+             *        the same form as the entries of a `std::map` of bins to frequencies.
+             */
+            template<class Histogram>
+            class bin_iterator {
+            public:
+                typedef std::random_access_iterator_tag iterator_category;
+                typedef std::pair<typename Histogram::bin_type, typename Histogram::frequency_type> value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef value_type reference;
+                /**
+                 * \brief Proxy keeping the dereferenced pair alive for `operator->`.
+                 */
+                struct pointer {
+                    value_type entry;
+                    const value_type* operator->() const noexcept { return &entry; }
+                };
+                bin_iterator() noexcept : hst(nullptr), idx(0U) {}
+                bin_iterator(const Histogram* _hst, std::size_t _idx) noexcept : hst(_hst), idx(_idx) {}
+                reference operator*() const { return hst->entry(idx); }
+                pointer operator->() const { return pointer{ hst->entry(idx) }; }
+                reference operator[](difference_type n) const { return hst->entry(idx + n); }
+                bin_iterator& operator++() noexcept { ++idx; return *this; }
+                bin_iterator operator++(int) noexcept { bin_iterator tmp = *this; ++idx; return tmp; }
+                bin_iterator& operator--() noexcept { --idx; return *this; }
+                bin_iterator operator--(int) noexcept { bin_iterator tmp = *this; --idx; return tmp; }
+                bin_iterator& operator+=(difference_type n) noexcept { idx += n; return *this; }
+                bin_iterator& operator-=(difference_type n) noexcept { idx -= n; return *this; }
+                friend bin_iterator operator+(bin_iterator it, difference_type n) noexcept { return it += n; }
+                friend bin_iterator operator+(difference_type n, bin_iterator it) noexcept { return it += n; }
+                friend bin_iterator operator-(bin_iterator it, difference_type n) noexcept { return it -= n; }
+                friend difference_type operator-(const bin_iterator& lhs, const bin_iterator& rhs) noexcept {
+                    return static_cast<difference_type>(lhs.idx) - static_cast<difference_type>(rhs.idx);
+                }
+                friend bool operator==(const bin_iterator& lhs, const bin_iterator& rhs) noexcept { return lhs.idx == rhs.idx; }
+                friend bool operator!=(const bin_iterator& lhs, const bin_iterator& rhs) noexcept { return lhs.idx != rhs.idx; }
+                friend bool operator<(const bin_iterator& lhs, const bin_iterator& rhs) noexcept { return lhs.idx < rhs.idx; }
+                friend bool operator>(const bin_iterator& lhs, const bin_iterator& rhs) noexcept { return lhs.idx > rhs.idx; }
+                friend bool operator<=(const bin_iterator& lhs, const bin_iterator& rhs) noexcept { return lhs.idx <= rhs.idx; }
+                friend bool operator>=(const bin_iterator& lhs, const bin_iterator& rhs) noexcept { return lhs.idx >= rhs.idx; }
+            private:
+                const Histogram* hst;
+                std::size_t idx;
+            };
+            /**
+             * \brief Computes the edges `[min, max)` of the equal-width bins spanning the range of data in
+             *        `[first, last)`, widened to whole numbers as `[floor(min), ceil(max)]`.
+             */
+            template<class RTy, class InputIt>
+            std::pair<RTy, RTy> data_range(InputIt first, InputIt last) {
+                if (first == last) return std::make_pair(RTy(), static_cast<RTy>(1));
+                auto minmax = std::minmax_element(first, last);
+                RTy min = static_cast<RTy>(std::floor(*minmax.first));
+                RTy max = static_cast<RTy>(std::ceil(*minmax.second));
+                if (!(min < max)) max = min + static_cast<RTy>(1); // all data equal to the same whole number
+                return std::make_pair(min, max);
+            }
+            /**
+             * \brief Computes the edges of `data_range` for the random access range `[first, last)` with the
+             *        search for the extrema distributed over the threads of `policy`.
+             */
+            template<class RTy, class RandomIt>
+            std::pair<RTy, RTy> data_range(const execution::parallel_policy& policy, RandomIt first, RandomIt last) {
+                if (first == last) return std::make_pair(RTy(), static_cast<RTy>(1));
+                typedef std::pair<RandomIt, RandomIt> extrema_t;
+                const extrema_t extrema = parallel_reduce(policy, 0U, static_cast<std::size_t>(last - first), extrema_t(first, first),
+                    [first](std::size_t b, std::size_t e) { return std::minmax_element(first + b, first + e); },
+                    [](extrema_t lhs, extrema_t rhs) {
+                        if (*rhs.first < *lhs.first) lhs.first = rhs.first;
+                        if (*lhs.second < *rhs.second) lhs.second = rhs.second;
+                        return lhs;
+                    });
+                RTy min = static_cast<RTy>(std::floor(*extrema.first));
+                RTy max = static_cast<RTy>(std::ceil(*extrema.second));
+                if (!(min < max)) max = min + static_cast<RTy>(1);
+                return std::make_pair(min, max);
+            }
+            /**
+             * \brief Bins the random access range of `n` elements with a chunk per thread of `policy`, where
+             *        `accumulate(b, e, local, lower, upper)` adds elements `[b, e)` to the private frequencies
+             *        `local` and out of range counters `lower` and `upper` of its thread; the private arrays and
+             *        counters are summed into `counts`, `underflow` and `overflow` once each chunk is complete.
+             */
+            template<class Accumulate>
+            void parallel_accumulate(const execution::parallel_policy& policy, std::size_t n, std::vector<std::size_t>& counts,
+                std::size_t& underflow, std::size_t& overflow, Accumulate accumulate) {
+                std::mutex mtx;
+                parallel_for(policy, 0U, n, [&](std::size_t b, std::size_t e) {
+                    std::vector<std::size_t> local(counts.size(), 0U);
+                    std::size_t lower = 0U; std::size_t upper = 0U;
+                    accumulate(b, e, local.data(), lower, upper);
+                    std::lock_guard<std::mutex> lock(mtx);
+                    for (std::size_t i = 0U; i < local.size(); ++i) counts[i] += local[i];
+                    underflow += lower;
+                    overflow += upper;
+                });
+            }
+        }
+
+        /**
+         * \class ranged_histogram
+         *
+         * \brief A histogram of equal-width bins over a contiguous range, with bin frequencies
+         *        stored in a flat array indexed by bin number.
+         *
+         * Iteration yields `(bin, frequency)` pairs in order of increasing bin, where `bin` is the
+         * `[lower, upper)` pair of edges of the bin, computed on the fly from its index.
+         *
+         * \tparam RTy Arithmetic type of the binned data.
+         */
         template<class RTy,
             class = std::enable_if_t<std::is_arithmetic<RTy>::value>
         > class ranged_histogram {
-            // underlying container for ranged_histogram
-            typedef std::map<std::pair<RTy, RTy>, std::size_t> rhist_t;
         public:
             // PUBLIC TYPEDEFS
             typedef RTy range_type;
             typedef std::pair<RTy, RTy> bin_type;
             typedef std::size_t frequency_type;
-            typedef typename rhist_t::const_iterator const_iterator;
-            typedef typename rhist_t::const_reverse_iterator const_reverse_iterator;
+            typedef std::pair<bin_type, frequency_type> value_type;
+            typedef hist_impl::bin_iterator<ranged_histogram> const_iterator;
+            typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
             // CONSTRUCTION / DESTRUCTION
             /**
              * \brief Construct empty `ranged_histogram` with no bins.
              */
-            ranged_histogram() : rh(), nbins(0U), bin_size(range_type()) {}
+            ranged_histogram() : counts(), min_edge(range_type()), bin_size(range_type()), max_edge(range_type()), bin_recip() {}
             /**
-             * brief Construct `ranged_histogram` with `_nbins` bins of equal width
-             *       from a range of data `[first, last)`.
+             * \brief Construct `ranged_histogram` with `_nbins` bins of equal width
+             *        from a range of data `[first, last)`.
              * \param first Beginning of data range to bin.
              * \param last End of data range to bin.
              * \param _nbins Number of equal-width bins to construct in histogram.
              */
-            template<class InputIt>
-            ranged_histogram(InputIt first, InputIt last, std::size_t _nbins) 
-                : rh(), bin_size(range_type()) {
+            template<class InputIt,
+                class = std::enable_if_t<!std::is_arithmetic<InputIt>::value>
+            > ranged_histogram(InputIt first, InputIt last, std::size_t _nbins)
+                : counts(), min_edge(range_type()), bin_size(range_type()), max_edge(range_type()), bin_recip() {
                 bin_data_(first, last, _nbins);
             }
             /**
-             * \brief Construct `ranged_histogram` from a copy of a `std::map<std::pair<RTy, RTy>,
-             *        std::size_t` instance.
-             * \param range_map A `std::map` with key equal to `ranged_histogram::bin_type` and
-             *        mapped type equal to `std::size_t`.
+             * \brief Construct `ranged_histogram` with `_nbins` bins of equal width from a range of
+             *        data `[first, last)`, binned in parallel, see `bin_data(policy, first, last, _nbins)`.
+             */
+            template<class InputIt>
+            ranged_histogram(const execution::parallel_policy& policy, InputIt first, InputIt last, std::size_t _nbins)
+                : counts(), min_edge(range_type()), bin_size(range_type()), max_edge(range_type()), bin_recip() {
+                bin_data(policy, first, last, _nbins);
+            }
+            /**
+             * \brief Construct an empty fixed-range `ranged_histogram` with `_nbins` bins of equal width
+             *        spanning `[min, max)`, to which data is added incrementally via `add`.
+             * \param min Lower edge of the first bin.
+             * \param max Upper edge of the last bin.
+             * \param _nbins Number of equal-width bins.
+             * \throw Throws `std::invalid_argument` exception if `_nbins == 0` or `!(min < max)`.
              */
-            explicit ranged_histogram(const rhist_t& range_map) : rh(range_map),
-                nbins(rh.size()) {
-                bin_size = (*rh.begin()).second - (*rh.begin()).first;
+            ranged_histogram(range_type min, range_type max, std::size_t _nbins)
+                : counts(), min_edge(range_type()), bin_size(range_type()), max_edge(range_type()), bin_recip() {
+                if (!_nbins) throw std::invalid_argument("histogram must have at least one bin.");
+                if (!(min < max)) throw std::invalid_argument("histogram range must be non-empty.");
+                reset_bins_(std::make_pair(min, max), _nbins);
             }
             /**
-             * \brief Construct `ranged_histogram` from a `std::map<std::pair<RTy, RTy>,
-             *        std::size_t` instance via move-semantics.
+             * \brief Construct `ranged_histogram` with bins of equal width spanning `[min, max)` and
+             *        frequencies `frequencies`, one per bin.
+             * \param min Lower edge of the first bin.
+             * \param max Upper edge of the last bin.
+             * \param frequencies Frequency of each bin, in order of increasing bin.
+             */
+            ranged_histogram(range_type min, range_type max, std::vector<frequency_type> frequencies)
+                : counts(std::move(frequencies)), min_edge(min),
+                bin_size(counts.empty() ? range_type() : static_cast<range_type>((max - min)/counts.size())), max_edge(max),
+                bin_recip(counts.empty() ? hist_impl::scale_t<RTy>() : static_cast<hist_impl::scale_t<RTy>>(counts.size()/static_cast<double>(max - min))) {}
+            /**
+             * \brief Construct `ranged_histogram` from a `std::map<std::pair<RTy, RTy>, std::size_t>`
+             *        of contiguous equal-width bins.
              * \param range_map A `std::map` with key equal to `ranged_histogram::bin_type` and
              *        mapped type equal to `std::size_t`.
              */
-            explicit ranged_histogram(rhist_t&& range_map) : rh(std::move(range_map)),
-                nbins(rh.size()) {
-                bin_size = (*rh.begin()).second - (*rh.begin()).first;    
+            explicit ranged_histogram(const std::map<bin_type, frequency_type>& range_map)
+                : counts(), min_edge(range_type()), bin_size(range_type()), max_edge(range_type()), bin_recip() {
+                if (range_map.empty()) return;
+                min_edge = (*range_map.begin()).first.first;
+                bin_size = (*range_map.begin()).first.second - (*range_map.begin()).first.first;
+                bin_recip = static_cast<hist_impl::scale_t<RTy>>(1.0/bin_size);
+                max_edge = min_edge + range_map.size()*bin_size;
+                counts.reserve(range_map.size());
+                for (const auto& p : range_map) counts.push_back(p.second);
             }
-            ranged_histogram(const ranged_histogram& other) : rh(other.rh), 
-                nbins(other.nbins), bin_size(other.bin_size) {}
-            ranged_histogram(ranged_histogram&& other) : rh(std::move(other.rh)),
-                nbins(std::move(other.nbins)), bin_size(std::move(other.bin_size)) {}
             // BIN PROPERTIES
             /**
              * \brief Returns the number of bins in the histogram.
              * \return The number of bins.
              */
-            std::size_t bins() const noexcept { return nbins; }
+            std::size_t bins() const noexcept { return counts.size(); }
             range_type bin_width() const noexcept { return bin_size; }
+            /**
+             * \brief Returns the lower edge of the first bin.
+             */
+            range_type range_min() const noexcept { return min_edge; }
+            /**
+             * \brief Returns the upper edge of the last bin.
+             */
+            range_type range_max() const noexcept { return max_edge; }
+            /**
+             * \brief Returns the `[lower, upper)` edges of bin `i`.
+             */
+            bin_type bin(std::size_t i) const noexcept {
+                return std::make_pair(min_edge + i*bin_size, min_edge + (i + 1U)*bin_size);
+            }
+            /**
+             * \brief Returns the index of the bin containing `value`, which must lie within the range of
+             *        the histogram, with values on the upper edge belonging to the last bin.
+             */
+            std::size_t bin_index(range_type value) const noexcept {
+                return hist_impl::bin_index(value, min_edge, bin_recip, counts.size());
+            }
             // DATA BINNING
             /**
              * \brief Bins the data in the range `[first, last)` using equal-width bins.
@@ -79,139 +249,463 @@ namespace crsc {
             void bin_data(InputIt first, InputIt last, std::size_t _nbins) {
                 bin_data_(first, last, _nbins);
             }
+            /**
+             * \brief Bins the data in the range `[first, last)` using equal-width bins, with the data
+             *        split into a chunk per thread of `policy`. Each chunk is binned into a private array
+             *        of frequencies and the arrays summed on completion, such that the result is identical
+             *        to that of the sequential `bin_data`. Ranges without random access iterators are
+             *        binned sequentially.
+             * \param policy Execution policy determining the number of threads and minimum chunk size.
+             * \param first Beginning of data range to bin.
+             * \param last End of data range to bin.
+             * \param _nbins Number of equal-width bins to construct in histogram.
+             * \complexity Linear in `std::distance(first, last)` plus `_nbins` per thread.
+             */
+            template<class InputIt>
+            void bin_data(const execution::parallel_policy& policy, InputIt first, InputIt last, std::size_t _nbins) {
+                bin_data_(policy, first, last, _nbins, typename std::iterator_traits<InputIt>::iterator_category());
+            }
+            /**
+             * \brief Adds the value `value` to the histogram without altering its bins, counting it as
+             *        underflow if it lies below `range_min()` (or is NaN) and as overflow if it lies at or
+             *        above `range_max()`.
+             * \param value Value to add.
+             * \complexity Constant.
+             */
+            void add(range_type value) noexcept {
+                if (!(value >= min_edge)) ++n_underflow;
+                else if (!(value < range_max())) ++n_overflow;
+                else ++counts[hist_impl::bin_index(value, min_edge, bin_recip, counts.size())];
+            }
+            /**
+             * \brief Adds the data in the range `[first, last)` to the histogram without altering its bins,
+             *        see `add(value)`, such that data arriving in chunks can be binned as it arrives.
+             * \param first Beginning of data range to add.
+             * \param last End of data range to add.
+             * \complexity Linear in `std::distance(first, last)`.
+             */
+            template<class InputIt>
+            void add(InputIt first, InputIt last) {
+                hist_impl::accumulate_counts_in_range(first, last, min_edge, range_max(), bin_recip, counts.size(),
+                    counts.data(), n_underflow, n_overflow);
+            }
+            /**
+             * \brief Adds the data in the range `[first, last)` to the histogram, see `add(first, last)`, with
+             *        a chunk per thread of `policy` binned into a private array of frequencies. Ranges without
+             *        random access iterators are added sequentially.
+             * \param policy Execution policy determining the number of threads and minimum chunk size.
+             * \param first Beginning of data range to add.
+             * \param last End of data range to add.
+             */
+            template<class InputIt>
+            void add(const execution::parallel_policy& policy, InputIt first, InputIt last) {
+                add_(policy, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+            }
+            /**
+             * \brief Adds the frequencies and out of range counts of `other` to this histogram, e.g. to
+             *        combine histograms of data binned on different threads or nodes.
+             * \param other Histogram with bins identical to those of this histogram.
+             * \throw Throws `std::invalid_argument` exception if the bins of `other` differ.
+             * \complexity Linear in `bins()`.
+             */
+            void merge(const ranged_histogram& other) {
+                if (counts.size() != other.counts.size() || min_edge != other.min_edge || bin_size != other.bin_size)
+                    throw std::invalid_argument("histograms must have identical bins to merge.");
+                for (std::size_t i = 0U; i < counts.size(); ++i) counts[i] += other.counts[i];
+                n_underflow += other.n_underflow;
+                n_overflow += other.n_overflow;
+            }
+            /**
+             * \brief Returns the number of added values lying below the range of the histogram (or NaN).
+             */
+            std::size_t underflow() const noexcept { return n_underflow; }
+            /**
+             * \brief Returns the number of added values lying at or above the range of the histogram.
+             */
+            std::size_t overflow() const noexcept { return n_overflow; }
             // FREQUENCY ACCESS
             /**
-             * \brief Read-only access of freqeuncy for a given bin.
-             * \return The frequency of the given bin.
+             * \brief Read-only access of frequency for a given bin.
+             * \return The frequency of the given bin, or zero if it is not a bin of the histogram.
+             */
+            frequency_type operator[](const bin_type& bin) const noexcept {
+                if (counts.empty() || bin.first < min_edge) return 0U;
+                // round to nearest bin lower edge to be robust against accumulated edge rounding
+                const std::size_t i = static_cast<std::size_t>(std::floor((bin.first - min_edge)/bin_size + 0.5));
+                return (i < counts.size()) ? counts[i] : 0U;
+            }
+            /**
+             * \brief Read-only access of frequency of bin `i`.
+             */
+            frequency_type frequency(std::size_t i) const noexcept { return counts[i]; }
+            /**
+             * \brief Returns the frequencies of all bins, in order of increasing bin.
              */
-            frequency_type operator[](const bin_type& bin) const noexcept { return rh[bin]; }
+            const std::vector<frequency_type>& frequencies() const noexcept { return counts; }
             /**
-             * \brief Read-only access of freqeuncy for a given bin.
-             * \return The frequency of the given bin.
+             * \brief Returns the `(bin, frequency)` entry of bin `i`.
              */
-            frequency_type operator[](bin_type&& bin) const noexcept { return rh[std::move(bin)]; }
+            value_type entry(std::size_t i) const { return std::make_pair(bin(i), counts[i]); }
             // ITERATORS
-            const_iterator begin() const noexcept { return rh.begin(); }
-            const_iterator cbegin() const noexcept { return rh.cbegin(); }
-            const_iterator end() const noexcept { return rh.end(); }
-            const_iterator cend() const noexcept { return rh.cend(); }
-            const_reverse_iterator rbegin() const noexcept { return rh.rbegin(); }
-            const_reverse_iterator crbegin() const noexcept { return rh.crbegin(); }
-            const_reverse_iterator rend() const noexcept { return rh.rend(); }
-            const_reverse_iterator crend() const noexcept { return rh.crend(); }
+            const_iterator begin() const noexcept { return const_iterator(this, 0U); }
+            const_iterator cbegin() const noexcept { return begin(); }
+            const_iterator end() const noexcept { return const_iterator(this, counts.size()); }
+            const_iterator cend() const noexcept { return end(); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+            const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+            const_reverse_iterator crend() const noexcept { return rend(); }
         private:
             template<class InputIt>
             void bin_data_(InputIt first, InputIt last, std::size_t _nbins) {
-                nbins = _nbins;
-                auto minmax = *std::minmax_element(first, last);
+                if (!_nbins) throw std::invalid_argument("histogram must have at least one bin.");
                 // get min and max of data range
-                range_type min = std::floor(minmax.first);
-                range_type max = std::floor(minmax.second);
-                bin_size = (max - min) / nbins;
+                const auto bs_recip = reset_bins_(hist_impl::data_range<range_type>(first, last), _nbins);
+                hist_impl::accumulate_counts(first, last, min_edge, bs_recip, _nbins, counts.data());
+            }
+            template<class InputIt>
+            void bin_data_(const execution::parallel_policy&, InputIt first, InputIt last, std::size_t _nbins,
+                std::input_iterator_tag) {
+                bin_data_(first, last, _nbins);
+            }
+            template<class RandomIt>
+            void bin_data_(const execution::parallel_policy& policy, RandomIt first, RandomIt last, std::size_t _nbins,
+                std::random_access_iterator_tag) {
+                if (!_nbins) throw std::invalid_argument("histogram must have at least one bin.");
+                const auto bs_recip = reset_bins_(hist_impl::data_range<range_type>(policy, first, last), _nbins);
+                hist_impl::parallel_accumulate(policy, static_cast<std::size_t>(last - first), counts, n_underflow, n_overflow,
+                    [&](std::size_t b, std::size_t e, std::size_t* local, std::size_t&, std::size_t&) {
+                        hist_impl::accumulate_counts(first + b, first + e, min_edge, bs_recip, _nbins, local);
+                    });
+            }
+            template<class InputIt>
+            void add_(const execution::parallel_policy&, InputIt first, InputIt last, std::input_iterator_tag) {
+                add(first, last);
+            }
+            template<class RandomIt>
+            void add_(const execution::parallel_policy& policy, RandomIt first, RandomIt last, std::random_access_iterator_tag) {
+                hist_impl::parallel_accumulate(policy, static_cast<std::size_t>(last - first), counts, n_underflow, n_overflow,
+                    [&](std::size_t b, std::size_t e, std::size_t* local, std::size_t& lower, std::size_t& upper) {
+                        hist_impl::accumulate_counts_in_range(first + b, first + e, min_edge, max_edge, bin_recip, counts.size(),
+                            local, lower, upper);
+                    });
+            }
+            /**
+             * \brief Zero-initialises `_nbins` bins spanning `range` and the out of range counts, returning
+             *        the reciprocal bin width.
+             */
+            hist_impl::scale_t<RTy> reset_bins_(const std::pair<range_type, range_type>& range, std::size_t _nbins) {
+                min_edge = range.first;
+                max_edge = range.second;
+                bin_size = static_cast<range_type>((range.second - range.first)/_nbins);
+                counts.assign(_nbins, 0U);
+                n_underflow = 0U;
+                n_overflow = 0U;
                 // store reciprocal of bin size for computation speed
-                range_type bs_recip = static_cast<range_type>(1.0 / bin_size);
-                // zero-initialise frequencies of each bin
-                for (std::size_t i = 0U; i < nbins; ++i)
-                    rh[std::make_pair(min + i*bin_size, min + (i + 1)*bin_size)] = 0U;
-                for (; first < last; ++first) { // bin data 
-                    std::size_t bin = (*first - min)*bs_recip; // find correct bin
-                    rh[std::make_pair(min + bin*bin_size, min + (bin + 1)*bin_size)]++;
-                }
+                bin_recip = static_cast<hist_impl::scale_t<RTy>>(_nbins/static_cast<double>(range.second - range.first));
+                return bin_recip;
             }
-            rhist_t rh;
-            std::size_t nbins;
+            std::vector<frequency_type> counts;
+            range_type min_edge;
             range_type bin_size;
+            range_type max_edge;
+            hist_impl::scale_t<RTy> bin_recip;
+            std::size_t n_underflow = 0U;
+            std::size_t n_overflow = 0U;
         };
 
+        /**
+         * \class ranged_histogram_2d
+         *
+         * \brief A 2d histogram of equal-width bins over a rectangular range, with bin frequencies
+         *        stored in a dense row-major array indexed by `(x bin, y bin)`.
+         *
+         * Iteration yields `(bin, frequency)` pairs ordered by x bin then y bin, where `bin` is the pair
+         * of `[lower, upper)` x and y edges of the bin, computed on the fly from its indices.
+         *
+         * \tparam RTy Arithmetic type of the binned data.
+         */
         template<class RTy,
             class = std::enable_if_t<std::is_arithmetic<RTy>::value>
         > class ranged_histogram_2d {
-            typedef std::map<std::pair<
-                std::pair<RTy, RTy>,
-                std::pair<RTy, RTy>>, std::size_t> rhist_t;
         public:
             // PUBLIC TYPEDEFS
             typedef RTy range_type;
             typedef std::pair<std::pair<RTy, RTy>, std::pair<RTy, RTy>> bin_type;
             typedef std::size_t frequency_type;
-            typedef typename rhist_t::const_iterator const_iterator;
-            typedef typename rhist_t::const_reverse_iterator const_reverse_iterator;
+            typedef std::pair<bin_type, frequency_type> value_type;
+            typedef hist_impl::bin_iterator<ranged_histogram_2d> const_iterator;
+            typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
             // CONSTRUCTION / DESTRUCTION
-            ranged_histogram_2d() : rh(), nbinsx(0U), nbinsy(0U), 
-                xbin_size(range_type()), ybin_size(range_type()) {}
-            template<class InputIt>
-            ranged_histogram_2d(InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y,
-                std::size_t xbins, std::size_t ybins) : rh() {
+            ranged_histogram_2d() : counts(), nbinsx(0U), nbinsy(0U), min_x_edge(range_type()),
+                min_y_edge(range_type()), xbin_size(range_type()), ybin_size(range_type()) {}
+            template<class InputIt,
+                class = std::enable_if_t<!std::is_arithmetic<InputIt>::value>
+            > ranged_histogram_2d(InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y,
+                std::size_t xbins, std::size_t ybins) : ranged_histogram_2d() {
                 bin_data_(first_x, last_x, first_y, last_y, xbins, ybins);
             }
-            ranged_histogram_2d(const ranged_histogram_2d& other) : rh(other.rh), 
-                nbinsx(other.nbinsx), nbinsy(other.nbinsy), xbin_size(other.xbin_size),
-                ybin_size(other.ybin_size) {}
-            ranged_histogram_2d(ranged_histogram_2d&& other) : rh(std::move(other.rh)),
-                nbinsx(std::move(other.nbinsx)), nbinsy(std::move(other.nbinsy)),
-                xbin_size(std::move(other.xbin_size)), ybin_size(std::move(ybin_size)) {}
+            /**
+             * \brief Construct `ranged_histogram_2d` from the ranges of data `[first_x, last_x)` and
+             *        `[first_y, last_y)`, binned in parallel, see `bin_data(policy, ...)`.
+             */
+            template<class InputIt>
+            ranged_histogram_2d(const execution::parallel_policy& policy, InputIt first_x, InputIt last_x,
+                InputIt first_y, InputIt last_y, std::size_t xbins, std::size_t ybins) : ranged_histogram_2d() {
+                bin_data(policy, first_x, last_x, first_y, last_y, xbins, ybins);
+            }
+            /**
+             * \brief Construct an empty fixed-range `ranged_histogram_2d` with `xbins` x `ybins` bins of equal
+             *        width spanning `[min_x, max_x)` x `[min_y, max_y)`, to which data is added via `add`.
+             * \throw Throws `std::invalid_argument` exception if either bin count is zero or either range is empty.
+             */
+            ranged_histogram_2d(range_type min_x, range_type max_x, std::size_t xbins,
+                range_type min_y, range_type max_y, std::size_t ybins) : ranged_histogram_2d() {
+                if (!xbins || !ybins) throw std::invalid_argument("histogram must have at least one bin.");
+                if (!(min_x < max_x) || !(min_y < max_y)) throw std::invalid_argument("histogram range must be non-empty.");
+                reset_bins_(std::make_pair(min_x, max_x), std::make_pair(min_y, max_y), xbins, ybins);
+            }
+            /**
+             * \brief Construct `ranged_histogram_2d` with `xbins` x `ybins` bins of equal width spanning
+             *        `[min_x, max_x)` x `[min_y, max_y)` and row-major frequencies `frequencies`.
+             * \param frequencies Frequency of each bin, where bin `(i, j)` is at index `i*ybins + j`.
+             * \throw Throws `std::invalid_argument` exception if `frequencies.size() != xbins*ybins`.
+             */
+            ranged_histogram_2d(range_type min_x, range_type max_x, std::size_t xbins,
+                range_type min_y, range_type max_y, std::size_t ybins, std::vector<frequency_type> frequencies)
+                : ranged_histogram_2d() {
+                if (frequencies.size() != xbins*ybins)
+                    throw std::invalid_argument("number of frequencies must equal the number of bins.");
+                if (!frequencies.empty()) reset_bins_(std::make_pair(min_x, max_x), std::make_pair(min_y, max_y), xbins, ybins);
+                counts = std::move(frequencies);
+            }
+            /**
+             * \brief Construct `ranged_histogram_2d` from a `std::map` of bins to frequencies, where
+             *        the bins form a complete grid of contiguous equal-width bins.
+             * \param range_map A `std::map` with key equal to `ranged_histogram_2d::bin_type` and
+             *        mapped type equal to `std::size_t`.
+             */
+            explicit ranged_histogram_2d(const std::map<bin_type, frequency_type>& range_map)
+                : ranged_histogram_2d() {
+                if (range_map.empty()) return;
+                const auto& first_bin = (*range_map.begin()).first;
+                // bins are ordered by x range then y range, count the y bins sharing the first x range
+                for (const auto& p : range_map) {
+                    if (p.first.first != first_bin.first) break;
+                    ++nbinsy;
+                }
+                const std::size_t xbins = range_map.size()/nbinsy;
+                const range_type xwidth = first_bin.first.second - first_bin.first.first;
+                const range_type ywidth = first_bin.second.second - first_bin.second.first;
+                reset_bins_(std::make_pair(first_bin.first.first, static_cast<range_type>(first_bin.first.first + xbins*xwidth)),
+                    std::make_pair(first_bin.second.first, static_cast<range_type>(first_bin.second.first + nbinsy*ywidth)),
+                    xbins, nbinsy);
+                counts.clear();
+                for (const auto& p : range_map) counts.push_back(p.second);
+            }
             // BIN PROPERTIES
             std::size_t xbins() const noexcept { return nbinsx; }
             std::size_t ybins() const noexcept { return nbinsy; }
             range_type xbin_width() const noexcept { return xbin_size; }
             range_type ybin_width() const noexcept { return ybin_size; }
+            range_type x_range_min() const noexcept { return min_x_edge; }
+            range_type x_range_max() const noexcept { return max_x_edge; }
+            range_type y_range_min() const noexcept { return min_y_edge; }
+            range_type y_range_max() const noexcept { return max_y_edge; }
+            /**
+             * \brief Returns the `[lower, upper)` x edges of x bin `i`.
+             */
+            std::pair<RTy, RTy> xbin(std::size_t i) const noexcept {
+                return std::make_pair(min_x_edge + i*xbin_size, min_x_edge + (i + 1U)*xbin_size);
+            }
+            /**
+             * \brief Returns the `[lower, upper)` y edges of y bin `j`.
+             */
+            std::pair<RTy, RTy> ybin(std::size_t j) const noexcept {
+                return std::make_pair(min_y_edge + j*ybin_size, min_y_edge + (j + 1U)*ybin_size);
+            }
+            /**
+             * \brief Returns the edges of bin `(i, j)`.
+             */
+            bin_type bin(std::size_t i, std::size_t j) const noexcept { return std::make_pair(xbin(i), ybin(j)); }
             // DATA BINNING
             template<class InputIt>
-            void bin_data(InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y, 
+            void bin_data(InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y,
                 std::size_t xbins, std::size_t ybins) {
                 bin_data_(first_x, last_x, first_y, last_y, xbins, ybins);
             }
+            /**
+             * \brief Bins the data pairs of the ranges `[first_x, last_x)` and `[first_y, last_y)` with a
+             *        chunk per thread of `policy`, each binned into a private array of frequencies which are
+             *        summed on completion, such that the result is identical to that of the sequential
+             *        `bin_data`. Ranges without random access iterators are binned sequentially.
+             * \complexity Linear in the number of data pairs plus `xbins*ybins` per thread.
+             */
+            template<class InputIt>
+            void bin_data(const execution::parallel_policy& policy, InputIt first_x, InputIt last_x,
+                InputIt first_y, InputIt last_y, std::size_t xbins, std::size_t ybins) {
+                bin_data_(policy, first_x, last_x, first_y, last_y, xbins, ybins,
+                    typename std::iterator_traits<InputIt>::iterator_category());
+            }
+            /**
+             * \brief Adds the pair `(x, y)` to the histogram without altering its bins, counting it as
+             *        outside if either value lies beyond its range (or is NaN).
+             * \complexity Constant.
+             */
+            void add(range_type x, range_type y) noexcept {
+                if (!(x >= min_x_edge && x < max_x_edge && y >= min_y_edge && y < max_y_edge)) { ++n_outside; return; }
+                ++counts[hist_impl::bin_index(x, min_x_edge, x_recip, nbinsx)*nbinsy
+                    + hist_impl::bin_index(y, min_y_edge, y_recip, nbinsy)];
+            }
+            /**
+             * \brief Adds the data pairs of the ranges `[first_x, last_x)` and `[first_y, last_y)` to the
+             *        histogram without altering its bins, see `add(x, y)`.
+             * \complexity Linear in the number of data pairs.
+             */
+            template<class InputIt>
+            void add(InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y) {
+                hist_impl::accumulate_counts_in_range_2d(first_x, last_x, first_y, last_y, min_x_edge, max_x_edge, x_recip,
+                    nbinsx, min_y_edge, max_y_edge, y_recip, nbinsy, counts.data(), n_outside);
+            }
+            /**
+             * \brief Adds the data pairs of the ranges `[first_x, last_x)` and `[first_y, last_y)` to the
+             *        histogram, see `add(first_x, last_x, first_y, last_y)`, with a chunk per thread of `policy`
+             *        binned into a private array of frequencies. Ranges without random access iterators are
+             *        added sequentially.
+             */
+            template<class InputIt>
+            void add(const execution::parallel_policy& policy, InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y) {
+                add_(policy, first_x, last_x, first_y, last_y, typename std::iterator_traits<InputIt>::iterator_category());
+            }
+            /**
+             * \brief Adds the frequencies and outside count of `other` to this histogram, e.g. to combine
+             *        histograms of data binned on different threads or nodes.
+             * \param other Histogram with bins identical to those of this histogram.
+             * \throw Throws `std::invalid_argument` exception if the bins of `other` differ.
+             * \complexity Linear in `xbins()*ybins()`.
+             */
+            void merge(const ranged_histogram_2d& other) {
+                if (nbinsx != other.nbinsx || nbinsy != other.nbinsy || min_x_edge != other.min_x_edge
+                    || min_y_edge != other.min_y_edge || xbin_size != other.xbin_size || ybin_size != other.ybin_size)
+                    throw std::invalid_argument("histograms must have identical bins to merge.");
+                for (std::size_t i = 0U; i < counts.size(); ++i) counts[i] += other.counts[i];
+                n_outside += other.n_outside;
+            }
+            /**
+             * \brief Returns the number of added pairs with either value beyond its range (or NaN).
+             */
+            std::size_t outside() const noexcept { return n_outside; }
             // FREQUENCY ACCESS
-            frequency_type operator[](const bin_type& bin) { return rh[bin]; }
-            frequency_type operator[](bin_type&& bin) { return rh[std::move(bin)]; }
+            /**
+             * \brief Read-only access of frequency for a given bin.
+             * \return The frequency of the given bin, or zero if it is not a bin of the histogram.
+             */
+            frequency_type operator[](const bin_type& bin) const noexcept {
+                if (counts.empty() || bin.first.first < min_x_edge || bin.second.first < min_y_edge) return 0U;
+                const std::size_t i = static_cast<std::size_t>(std::floor((bin.first.first - min_x_edge)/xbin_size + 0.5));
+                const std::size_t j = static_cast<std::size_t>(std::floor((bin.second.first - min_y_edge)/ybin_size + 0.5));
+                return (i < nbinsx && j < nbinsy) ? counts[i*nbinsy + j] : 0U;
+            }
+            /**
+             * \brief Read-only access of frequency of bin `(i, j)`.
+             */
+            frequency_type frequency(std::size_t i, std::size_t j) const noexcept { return counts[i*nbinsy + j]; }
+            /**
+             * \brief Returns the row-major frequencies of all bins, where bin `(i, j)` is at `i*ybins() + j`.
+             */
+            const std::vector<frequency_type>& frequencies() const noexcept { return counts; }
+            /**
+             * \brief Returns the `(bin, frequency)` entry of the bin at row-major index `idx`.
+             */
+            value_type entry(std::size_t idx) const { return std::make_pair(bin(idx/nbinsy, idx%nbinsy), counts[idx]); }
             // ITERATORS
-            const_iterator begin() const noexcept { return rh.begin(); }
-            const_iterator cbegin() const noexcept { return rh.cbegin(); }
-            const_iterator end() const noexcept { return rh.end(); }
-            const_iterator cend() const noexcept { return rh.cend(); }
-            const_reverse_iterator rbegin() const noexcept { return rh.rbegin(); }
-            const_reverse_iterator crbegin() const noexcept { return rh.crbegin(); }
-            const_reverse_iterator rend() const noexcept { return rh.rend(); }
-            const_reverse_iterator crend() const noexcept { return rh.crend(); }
+            const_iterator begin() const noexcept { return const_iterator(this, 0U); }
+            const_iterator cbegin() const noexcept { return begin(); }
+            const_iterator end() const noexcept { return const_iterator(this, counts.size()); }
+            const_iterator cend() const noexcept { return end(); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+            const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+            const_reverse_iterator crend() const noexcept { return rend(); }
         private:
             template<class InputIt>
             void bin_data_(InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y,
                 std::size_t xbins, std::size_t ybins) {
+                if (!xbins || !ybins) throw std::invalid_argument("histogram must have at least one bin.");
+                const auto recips = reset_bins_(hist_impl::data_range<range_type>(first_x, last_x),
+                    hist_impl::data_range<range_type>(first_y, last_y), xbins, ybins);
+                hist_impl::accumulate_counts_2d(first_x, last_x, first_y, last_y, min_x_edge, recips.first, nbinsx,
+                    min_y_edge, recips.second, nbinsy, counts.data());
+            }
+            template<class InputIt>
+            void bin_data_(const execution::parallel_policy&, InputIt first_x, InputIt last_x, InputIt first_y,
+                InputIt last_y, std::size_t xbins, std::size_t ybins, std::input_iterator_tag) {
+                bin_data_(first_x, last_x, first_y, last_y, xbins, ybins);
+            }
+            template<class RandomIt>
+            void bin_data_(const execution::parallel_policy& policy, RandomIt first_x, RandomIt last_x, RandomIt first_y,
+                RandomIt last_y, std::size_t xbins, std::size_t ybins, std::random_access_iterator_tag) {
+                if (!xbins || !ybins) throw std::invalid_argument("histogram must have at least one bin.");
+                const auto recips = reset_bins_(hist_impl::data_range<range_type>(policy, first_x, last_x),
+                    hist_impl::data_range<range_type>(policy, first_y, last_y), xbins, ybins);
+                const std::size_t n = static_cast<std::size_t>(std::min(last_x - first_x, last_y - first_y));
+                std::size_t unused = 0U;
+                hist_impl::parallel_accumulate(policy, n, counts, n_outside, unused,
+                    [&](std::size_t b, std::size_t e, std::size_t* local, std::size_t&, std::size_t&) {
+                        hist_impl::accumulate_counts_2d(first_x + b, first_x + e, first_y + b, first_y + e,
+                            min_x_edge, recips.first, nbinsx, min_y_edge, recips.second, nbinsy, local);
+                    });
+            }
+            template<class InputIt>
+            void add_(const execution::parallel_policy&, InputIt first_x, InputIt last_x, InputIt first_y, InputIt last_y,
+                std::input_iterator_tag) {
+                add(first_x, last_x, first_y, last_y);
+            }
+            template<class RandomIt>
+            void add_(const execution::parallel_policy& policy, RandomIt first_x, RandomIt last_x, RandomIt first_y,
+                RandomIt last_y, std::random_access_iterator_tag) {
+                const std::size_t n = static_cast<std::size_t>(std::min(last_x - first_x, last_y - first_y));
+                std::size_t unused = 0U;
+                hist_impl::parallel_accumulate(policy, n, counts, n_outside, unused,
+                    [&](std::size_t b, std::size_t e, std::size_t* local, std::size_t& outside, std::size_t&) {
+                        hist_impl::accumulate_counts_in_range_2d(first_x + b, first_x + e, first_y + b, first_y + e,
+                            min_x_edge, max_x_edge, x_recip, nbinsx, min_y_edge, max_y_edge, y_recip, nbinsy, local, outside);
+                    });
+            }
+            /**
+             * \brief Zero-initialises `xbins` x `ybins` bins spanning `range_x` x `range_y` and the outside
+             *        count, returning the reciprocal x and y bin widths.
+             */
+            std::pair<hist_impl::scale_t<RTy>, hist_impl::scale_t<RTy>> reset_bins_(const std::pair<range_type, range_type>& range_x,
+                const std::pair<range_type, range_type>& range_y, std::size_t xbins, std::size_t ybins) {
                 nbinsx = xbins;
                 nbinsy = ybins;
-                auto minmax_x = *std::minmax_element(first_x, last_x);
-                auto minmax_y = *std::minmax_element(first_y, last_y);
-                range_type min_x = std::floor(*minmax_x.first);
-                range_type max_x = std::ceil(*minmax_x.second);
-                range_type min_y = std::floor(*minmax_y.first);
-                range_type max_y = std::ceil(*minmax_y.second);
-                xbin_size = (max_x - min_x)/nbinsx;
-                ybin_size = (max_y - min_y)/nbinsy;
-                range_type bs_x_recip = static_cast<range_type>(1.0 / xbin_size);
-                range_type bs_y_recip = static_cast<range_type>(1.0 / ybin_size);
-                for (std::size_t i = 0U; i < nbinsx; ++i) {
-                    for (std::size_t j = 0U; j < nbinsy; ++j) 
-                        rh[std::make_pair(
-                            std::make_pair(min_x + i*xbin_size, min_x + (i+1)*xbin_size),
-                            std::make_pair(min_y + j*ybin_size, min_y + (j+1)*ybin_size)
-                        )] = 0U;
-                }
-                for (; first_x < last_x || first_y < last_y; ++first_x; ++first_y) {
-                    std::size_t bin_x = (*first_x - min_x)*bs_x_recip;
-                    std::size_t bin_y = (*first_y - min_y)*bs_y_recip;
-                    rh[std::make_pair(
-                        std::make_pair(min_x + bin_x*xbin_size, min_x + (bin_x + 1)*xbin_size),
-                        std::make_pair(min_y + bin_y*ybin_size, min_y + (bin_y + 1)*ybin_size)
-                    )]++;
-                }
+                min_x_edge = range_x.first;
+                min_y_edge = range_y.first;
+                max_x_edge = range_x.second;
+                max_y_edge = range_y.second;
+                xbin_size = static_cast<range_type>((range_x.second - range_x.first)/nbinsx);
+                ybin_size = static_cast<range_type>((range_y.second - range_y.first)/nbinsy);
+                counts.assign(nbinsx*nbinsy, 0U);
+                n_outside = 0U;
+                x_recip = static_cast<hist_impl::scale_t<RTy>>(nbinsx/static_cast<double>(range_x.second - range_x.first));
+                y_recip = static_cast<hist_impl::scale_t<RTy>>(nbinsy/static_cast<double>(range_y.second - range_y.first));
+                return std::make_pair(x_recip, y_recip);
             }
-            rhist_t rh;
+            std::vector<frequency_type> counts;
             std::size_t nbinsx;
             std::size_t nbinsy;
+            range_type min_x_edge;
+            range_type min_y_edge;
             range_type xbin_size;
             range_type ybin_size;
+            range_type max_x_edge = range_type();
+            range_type max_y_edge = range_type();
+            hist_impl::scale_t<RTy> x_recip = hist_impl::scale_t<RTy>();
+            hist_impl::scale_t<RTy> y_recip = hist_impl::scale_t<RTy>();
+            std::size_t n_outside = 0U;
         };
-        
+
         template<class RTy, class InputIt>
         ranged_histogram<RTy> make_ranged_histogram(InputIt first, InputIt last, std::size_t bins) {
             return ranged_histogram<RTy>(first, last, bins);
@@ -221,7 +715,7 @@ namespace crsc {
             InputIt first_y, InputIt last_y, std::size_t xbins, std::size_t ybins) {
             return ranged_histogram_2d<RTy>(first_x, last_x, first_y, last_y, xbins, ybins);
         }
-        
+
         template<class RTy>
         std::map<RTy, std::size_t> range_midpoints(const ranged_histogram<RTy>& hst) {
             std::map<RTy, std::size_t> midpts;
@@ -239,22 +733,22 @@ namespace crsc {
                 )] = p.second;
             return midpts;
         }
-        
+
+        /**
+         * \brief Marginalises the y variable out of `hist_2d`, summing the frequencies of each x bin
+         *        over all y bins.
+         * \return Histogram of the x variable with the x bins of `hist_2d`.
+         */
         template<class RTy>
         ranged_histogram<RTy> marginalise_y(const ranged_histogram_2d<RTy>& hist_2d) {
-            std::map<std::pair<RTy, RTy>, std::size_t> marginalised;
-            std::size_t i = 0U; std::size_t acc = 0U;
-            for (const auto& p : hist_2d) {
-                acc += p.second;
-                if (!(i % hist_2d.xbins())) {
-                    marginalised[p.first.first] = 
-                        static_cast<std::size_t>(hist_2d.xbin_width()*acc);
-                    acc = 0U;
-                }
-                ++i;
+            std::vector<std::size_t> marginalised(hist_2d.xbins(), 0U);
+            const std::vector<std::size_t>& freq = hist_2d.frequencies();
+            for (std::size_t i = 0U; i < hist_2d.xbins(); ++i) {
+                marginalised[i] = std::accumulate(freq.begin() + i*hist_2d.ybins(),
+                    freq.begin() + (i + 1U)*hist_2d.ybins(), std::size_t(0U));
             }
-            return ranged_histogram<RTy>(std::move(marginalised));
+            return ranged_histogram<RTy>(hist_2d.x_range_min(), hist_2d.x_range_max(), std::move(marginalised));
         }
     }
 }
-#endif // !RANGED_HISTOGRAM_H
\ No newline at end of file
+#endif // !RANGED_HISTOGRAM_H
@@ -0,0 +1,359 @@
+#ifndef ADDRESSABLE_PRIORITY_QUEUE_H
+#define ADDRESSABLE_PRIORITY_QUEUE_H
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace crsc {
+	/**
+	 * \class addressable_priority_queue
+	 *
+	 * \brief A heap priority queue in which every enqueued element is identified by a stable handle,
+	 *        such that the priority of an element can be altered and the element erased in logarithmic time
+	 *        without searching the heap (e.g. decrease-key in Dijkstra-like algorithms and schedulers).
+	 *
+	 * The heap stores the elements contiguously alongside the handle of each, and an index map from handle
+	 * to heap position is updated on every move of an element during sifting. A handle is valid from the
+	 * `enqueue`/`emplace` which returned it until its element is dequeued or erased, after which the
+	 * handle may be reused by a subsequent `enqueue`/`emplace`; `contains` reports its validity.
+	 *
+	 * As in `crsc::priority_queue`, the element priorities are compared by default using `std::less<Ty>`
+	 * such that the largest element is always at the top of the heap.
+	 *
+	 * \tparam Ty The type of the elements.
+	 * \tparam Compare A `Compare` type providing a strict weak ordering, defaults to `std::less<Ty>`.
+	 * \tparam Arity Number of children of each heap node, defaults to 2, see `crsc::priority_queue`.
+	 * \invariant The heap shall never be invalidated between method calls and each valid handle shall
+	 *            always map to the heap position of its element.
+	 */
+	template<class Ty,
+		class Compare = std::less<Ty>,
+		std::size_t Arity = 2
+	> class addressable_priority_queue {
+		static_assert(Arity >= 2, "addressable_priority_queue heap arity must be at least 2.");
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef Ty value_type;
+		typedef Ty& reference;
+		typedef const Ty& const_reference;
+		typedef Ty* pointer;
+		typedef const Ty* const_pointer;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef std::size_t handle_type;
+		typedef typename std::vector<Ty>::const_iterator const_iterator;
+		typedef typename std::vector<Ty>::const_reverse_iterator const_reverse_iterator;
+		// CONSTRUCTION/ASSIGNMENT
+		/**
+		 * \brief Constructs an empty container with a copy of `compare` as the comparison functor. This is
+		 *        also the default constructor.
+		 */
+		explicit addressable_priority_queue(const Compare& compare = Compare()) : comp(compare) {}
+		/**
+		 * \brief Constructs the container with the contents of the range `[first, last)`, such that the
+		 *        element at position `i` of the range is given the handle `i`.
+		 *
+		 * \param first Beginning of range to copy elements from.
+		 * \param last End of range to copy elements from.
+		 * \param compare Comparator function object to initialise underlying comparison functor.
+		 * \complexity Linear in the distance between `first` and `last`.
+		 */
+		template<class InputIt>
+		addressable_priority_queue(InputIt first, InputIt last, const Compare& compare = Compare())
+			: heap_cntr(first, last), comp(compare) {
+			heap_handles.resize(heap_cntr.size());
+			positions.resize(heap_cntr.size());
+			for (size_type i = 0U; i < heap_cntr.size(); ++i) heap_handles[i] = positions[i] = i;
+			heapify();
+		}
+		// CAPACITY
+		/**
+		 * \brief Checks whether the container is empty.
+		 *
+		 * \return `true` if empty, `false` otherwise.
+		 * \complexity Constant.
+		 */
+		bool empty() const noexcept { return heap_cntr.empty(); }
+		/**
+		 * \brief Returns the number of elements in the container.
+		 *
+		 * \complexity Constant.
+		 */
+		size_type size() const noexcept { return heap_cntr.size(); }
+		/**
+		 * \brief Returns the maximum number of elements the container is able to hold due to system or
+		 *        library implementation limitations.
+		 */
+		size_type max_size() const noexcept { return heap_cntr.max_size(); }
+		/**
+		 * \brief Reserves storage for at least `n` elements and handles.
+		 *
+		 * \complexity At most linear in the size of the container.
+		 */
+		void reserve(size_type n) {
+			heap_cntr.reserve(n);
+			heap_handles.reserve(n);
+			positions.reserve(n);
+		}
+		// ELEMENT ACCESS
+		/**
+		 * \brief Accesses the top element of the container without popping it.
+		 *
+		 * \complexity Constant.
+		 * \exceptionsafety If `!empty()` then no-throw guarantee, otherwise undefined behaviour.
+		 */
+		const_reference top() const { return heap_cntr[0]; }
+		/**
+		 * \brief Returns the handle of the top element of the container.
+		 *
+		 * \complexity Constant.
+		 * \exceptionsafety If `!empty()` then no-throw guarantee, otherwise undefined behaviour.
+		 */
+		handle_type top_handle() const { return heap_handles[0]; }
+		/**
+		 * \brief Checks whether `h` is the handle of an element currently in the container.
+		 *
+		 * \complexity Constant.
+		 */
+		bool contains(handle_type h) const noexcept {
+			return h < positions.size() && positions[h] != npos;
+		}
+		/**
+		 * \brief Accesses the element with handle `h`.
+		 *
+		 * \complexity Constant.
+		 * \exceptionsafety If `contains(h)` then no-throw guarantee, otherwise undefined behaviour.
+		 */
+		const_reference operator[](handle_type h) const { return heap_cntr[positions[h]]; }
+		/**
+		 * \brief Accesses the element with handle `h`, with bounds checking.
+		 *
+		 * \throw Throws `std::out_of_range` exception if `!contains(h)`.
+		 * \complexity Constant.
+		 */
+		const_reference at(handle_type h) const {
+			if (!contains(h)) throw std::out_of_range("invalid priority queue handle.");
+			return heap_cntr[positions[h]];
+		}
+		/**
+		 * \brief Returns the handle of the element at the iterator position `pos`.
+		 *
+		 * \complexity Constant.
+		 */
+		handle_type handle(const_iterator pos) const {
+			return heap_handles[static_cast<size_type>(pos - heap_cntr.cbegin())];
+		}
+		// MODIFIERS
+		/**
+		 * \brief Pushes an item into the container and sorts it.
+		 *
+		 * \param _val Value to enqueue into the container.
+		 * \return Handle of the enqueued element.
+		 * \complexity Logarithmic in the size of the container plus amortized constant for
+		 *             `std::vector::push_back`.
+		 * \exceptionsafety Strong-guarantee, if an exception is thrown there are no changes
+		 *                  in the container.
+		 */
+		handle_type enqueue(const value_type& _val) { return emplace(_val); }
+		/**
+		 * \brief Pushes an item into the container via move-insertion and sorts it.
+		 *
+		 * \param _val rvalue reference to value to enqueue into the container.
+		 * \return Handle of the enqueued element.
+		 * \complexity Logarithmic in the size of the container plus amortized constant for
+		 *             `std::vector::push_back`.
+		 */
+		handle_type enqueue(value_type&& _val) { return emplace(std::move(_val)); }
+		/**
+		 * \brief Constructs element in-place and sorts the underlying container.
+		 *
+		 * \param args Arguments to forward to the constructor of the element.
+		 * \return Handle of the emplaced element.
+		 * \complexity Logarithmic in the size of the container plus complexity of single construction
+		 *             of `value_type`.
+		 * \exceptionsafety Strong-guarantee, if an exception is thrown there are no changes
+		 *                  in the container.
+		 */
+		template<class... Args>
+		handle_type emplace(Args&&... args) {
+			const bool fresh = free_handles.empty();
+			const handle_type h = fresh ? positions.size() : free_handles.back();
+			if (fresh) positions.push_back(npos);
+			heap_handles.push_back(h);
+			try {
+				heap_cntr.emplace_back(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				heap_handles.pop_back();
+				if (fresh) positions.pop_back();
+				throw;
+			}
+			if (!fresh) free_handles.pop_back();
+			positions[h] = heap_cntr.size() - 1U;
+			sift_up(heap_cntr.size() - 1U);
+			return h;
+		}
+		/**
+		 * \brief Pops the top item from the container, invalidating its handle. Does nothing if the
+		 *        container is empty.
+		 *
+		 * \complexity Logarithmic in the size of the container.
+		 */
+		void dequeue() {
+			if (!heap_cntr.empty()) erase_at(0U);
+		}
+		/**
+		 * \brief Alters the element with handle `h` to `_val` by copy-assignment.
+		 *
+		 * \param h Handle of the element to alter.
+		 * \param _val Value to assign to the element.
+		 * \complexity Logarithmic in the size of the container.
+		 * \exceptionsafety If `contains(h)` then strong-guarantee if the copy-assignment is, otherwise
+		 *                  undefined behaviour.
+		 */
+		void alter(handle_type h, const value_type& _val) {
+			const size_type pos = positions[h];
+			const bool b_up = comp(heap_cntr[pos], _val);
+			heap_cntr[pos] = _val;
+			b_up ? sift_up(pos) : sift_down(pos);
+		}
+		/**
+		 * \brief Alters the element with handle `h` to `_val` by move-assignment.
+		 *
+		 * \param h Handle of the element to alter.
+		 * \param _val rvalue reference to value to assign to the element.
+		 * \complexity Logarithmic in the size of the container.
+		 */
+		void alter(handle_type h, value_type&& _val) {
+			const size_type pos = positions[h];
+			const bool b_up = comp(heap_cntr[pos], _val);
+			heap_cntr[pos] = std::move(_val);
+			b_up ? sift_up(pos) : sift_down(pos);
+		}
+		/**
+		 * \brief Erases the element with handle `h` from the container, invalidating the handle.
+		 *
+		 * \param h Handle of the element to erase.
+		 * \complexity Logarithmic in the size of the container.
+		 * \exceptionsafety If `contains(h)` then basic guarantee, otherwise undefined behaviour.
+		 */
+		void erase(handle_type h) { erase_at(positions[h]); }
+		/**
+		 * \brief Clears all items from the container, invalidating all handles.
+		 *
+		 * \complexity Linear in the size of the container.
+		 */
+		void clear() noexcept {
+			heap_cntr.clear();
+			heap_handles.clear();
+			positions.clear();
+			free_handles.clear();
+		}
+		/**
+		 * \brief Exchanges the contents, including handles, of the container with those of `_other`.
+		 *
+		 * \complexity Constant.
+		 */
+		void swap(addressable_priority_queue& _other) {
+			heap_cntr.swap(_other.heap_cntr);
+			heap_handles.swap(_other.heap_handles);
+			positions.swap(_other.positions);
+			free_handles.swap(_other.free_handles);
+			std::swap(comp, _other.comp);
+		}
+		// ITERATORS
+		/**
+		 * \brief Returns a `const_iterator` to the first element of the heap storage, see `handle` for
+		 *        retrieving the handle of an iterated element.
+		 */
+		const_iterator cbegin() const noexcept { return heap_cntr.cbegin(); }
+		const_iterator cend() const noexcept { return heap_cntr.cend(); }
+		const_reverse_iterator crbegin() const noexcept { return heap_cntr.crbegin(); }
+		const_reverse_iterator crend() const noexcept { return heap_cntr.crend(); }
+	private:
+		static constexpr size_type npos = std::numeric_limits<size_type>::max();
+		std::vector<Ty> heap_cntr;	// heap ordered elements
+		std::vector<handle_type> heap_handles;	// handle of the element at each heap position
+		std::vector<size_type> positions;	// heap position of each handle, npos if free
+		std::vector<handle_type> free_handles;	// released handles available for reuse
+		Compare comp;	// comparator function-object, determines element priorities
+		/**
+		 * \brief Moves the hole at `pos` up the heap until `heap_cntr[pos]` is correctly placed, shifting
+		 *        each lower priority parent down by one level and recording the new positions.
+		 */
+		void sift_up(size_type pos) {
+			value_type val = std::move(heap_cntr[pos]);
+			const handle_type h = heap_handles[pos];
+			while (pos) {
+				const size_type parent = (pos - 1U)/Arity;
+				if (!comp(heap_cntr[parent], val)) break;
+				place(pos, std::move(heap_cntr[parent]), heap_handles[parent]);
+				pos = parent;
+			}
+			place(pos, std::move(val), h);
+		}
+		/**
+		 * \brief Moves the hole at `pos` down the heap until `heap_cntr[pos]` is correctly placed, shifting
+		 *        each higher priority child up by one level and recording the new positions.
+		 */
+		void sift_down(size_type pos) {
+			const size_type heap_size = heap_cntr.size();
+			value_type val = std::move(heap_cntr[pos]);
+			const handle_type h = heap_handles[pos];
+			for (size_type first_child = Arity*pos + 1U; first_child < heap_size; first_child = Arity*pos + 1U) {
+				const size_type last_child = std::min(first_child + Arity, heap_size);
+				size_type child = first_child;
+				for (size_type c = first_child + 1U; c < last_child; ++c) {
+					if (comp(heap_cntr[child], heap_cntr[c])) child = c;
+				}
+				if (!comp(val, heap_cntr[child])) break;
+				place(pos, std::move(heap_cntr[child]), heap_handles[child]);
+				pos = child;
+			}
+			place(pos, std::move(val), h);
+		}
+		void place(size_type pos, value_type&& val, handle_type h) {
+			heap_cntr[pos] = std::move(val);
+			heap_handles[pos] = h;
+			positions[h] = pos;
+		}
+		/**
+		 * \brief Removes the element at heap position `pos`, filling the position with the last element
+		 *        and restoring the heap from there.
+		 */
+		void erase_at(size_type pos) {
+			const handle_type h = heap_handles[pos];
+			free_handles.push_back(h);
+			positions[h] = npos;
+			const size_type last = heap_cntr.size() - 1U;
+			if (pos != last) {
+				const bool b_up = comp(heap_cntr[pos], heap_cntr[last]);
+				place(pos, std::move(heap_cntr[last]), heap_handles[last]);
+				heap_cntr.pop_back();
+				heap_handles.pop_back();
+				b_up ? sift_up(pos) : sift_down(pos);
+			}
+			else {
+				heap_cntr.pop_back();
+				heap_handles.pop_back();
+			}
+		}
+		/**
+		 * \brief Restores the heap property over the whole container by sifting down from each parent.
+		 *
+		 * \complexity Linear in the size of the container.
+		 */
+		void heapify() {
+			if (heap_cntr.size() < 2U) return;
+			for (size_type i = (heap_cntr.size() - 2U)/Arity + 1U; i-- > 0U;) sift_down(i);
+		}
+	};
+	template<class Ty, class Compare, std::size_t Arity>
+	constexpr typename addressable_priority_queue<Ty, Compare, Arity>::size_type
+		addressable_priority_queue<Ty, Compare, Arity>::npos;
+}
+
+#endif // !ADDRESSABLE_PRIORITY_QUEUE_H
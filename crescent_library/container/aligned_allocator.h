@@ -0,0 +1,75 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace crsc {
+	/**
+	 * \class aligned_allocator
+	 *
+	 * \brief An allocator satisfying the standard `Allocator` requirements which returns storage aligned to
+	 *        at least `Alignment` bytes, e.g. to cache-line (`64`) or AVX register (`32`) boundaries.
+	 *
+	 * Use as the allocator of a container to guarantee the alignment of its buffer, for example
+	 * `dynamic_matrix<double, aligned_allocator<double, 64>>` ensures `data()` is 64-byte aligned.
+	 *
+	 * \tparam Ty The type of the elements to allocate.
+	 * \tparam Alignment Alignment in bytes, must be a power of two.
+	 */
+	template<typename Ty,
+		std::size_t Alignment = 64U
+	> class aligned_allocator {
+		static_assert(Alignment && !(Alignment & (Alignment - 1U)), "aligned_allocator Alignment must be a power of two.");
+	public:
+		typedef Ty value_type;
+		typedef Ty* pointer;
+		typedef const Ty* const_pointer;
+		typedef Ty& reference;
+		typedef const Ty& const_reference;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		template<typename Uty>
+		struct rebind { typedef aligned_allocator<Uty, Alignment> other; };
+		/**
+		 * \brief Alignment, in bytes, of all storage returned by `allocate`.
+		 */
+		static constexpr std::size_t alignment = (Alignment < alignof(Ty)) ? ((alignof(Ty) < alignof(void*)) ? alignof(void*) : alignof(Ty))
+			: ((Alignment < alignof(void*)) ? alignof(void*) : Alignment);
+		aligned_allocator() noexcept = default;
+		template<typename Uty>
+		aligned_allocator(const aligned_allocator<Uty, Alignment>&) noexcept {}
+		/**
+		 * \brief Allocates uninitialised storage for `n` objects of type `Ty`, aligned to `alignment` bytes.
+		 *
+		 * \param n Number of objects to allocate storage for.
+		 * \return Pointer to the first byte of the allocated storage.
+		 * \throw Throws `std::bad_alloc` exception if the allocation fails or `n > max_size()`.
+		 */
+		pointer allocate(size_type n) {
+			if (n > max_size()) throw std::bad_alloc();
+			// over-allocate and store the original pointer immediately before the aligned block
+			const std::size_t extra = alignment + sizeof(void*);
+			void* raw = ::operator new(n*sizeof(Ty) + extra);
+			std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(raw) + extra) & ~static_cast<std::uintptr_t>(alignment - 1U);
+			reinterpret_cast<void**>(aligned)[-1] = raw;
+			return reinterpret_cast<pointer>(aligned);
+		}
+		/**
+		 * \brief Deallocates storage pointed to by `p`, which must have been obtained by `allocate`.
+		 */
+		void deallocate(pointer p, size_type) noexcept {
+			if (p) ::operator delete(reinterpret_cast<void**>(p)[-1]);
+		}
+		size_type max_size() const noexcept {
+			return (std::numeric_limits<size_type>::max() - alignment - sizeof(void*)) / sizeof(Ty);
+		}
+	};
+	template<typename Ty, typename Uty, std::size_t Alignment>
+	bool operator==(const aligned_allocator<Ty, Alignment>&, const aligned_allocator<Uty, Alignment>&) noexcept { return true; }
+	template<typename Ty, typename Uty, std::size_t Alignment>
+	bool operator!=(const aligned_allocator<Ty, Alignment>&, const aligned_allocator<Uty, Alignment>&) noexcept { return false; }
+}
+
+#endif // !ALIGNED_ALLOCATOR_H
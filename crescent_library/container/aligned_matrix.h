@@ -0,0 +1,304 @@
+#ifndef ALIGNED_MATRIX_H
+#define ALIGNED_MATRIX_H
+#include "aligned_allocator.h"
+#include "matrix_expression.h"
+#include "matrix_view.h"
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace crsc {
+	/**
+	 * \brief Layout tag selecting row-major storage, consecutive elements of a row are adjacent in memory.
+	 */
+	struct row_major {};
+	/**
+	 * \brief Layout tag selecting column-major storage, consecutive elements of a column are adjacent in memory.
+	 */
+	struct column_major {};
+	/**
+	 * \class aligned_matrix
+	 *
+	 * \brief A fixed-shape matrix container with a selectable storage layout whose rows (row-major) or
+	 *        columns (column-major) each begin on an `Alignment`-byte boundary.
+	 *
+	 * Elements are stored in an `aligned_allocator` backed buffer of `outer * leading_dimension()` elements,
+	 * where `outer` is the number of rows (row-major) or columns (column-major) and the leading dimension
+	 * is the inner extent rounded up to a whole number of `Alignment`-byte blocks. The padding elements are
+	 * value-initialised and never exposed through the element accessors, they exist so that every row or
+	 * column may be processed with aligned SIMD loads. The buffer matches the conventional BLAS/LAPACK
+	 * description `(data(), leading_dimension())` for the chosen layout, so it can be passed to such code
+	 * without a transposing copy.
+	 *
+	 * Whereas `dynamic_matrix` supports insertion and erasure of rows and columns on dense row-major storage,
+	 * `aligned_matrix` is intended for numerical kernels: it is a `matrix_expression`, so it may be used in and
+	 * assigned from the lazy element-wise operators, and its `view()`, `row(i)` and `column(j)` provide
+	 * `matrix_view` access. Iteration is in row-major order regardless of the storage layout.
+	 *
+	 * \tparam Ty The type of the elements.
+	 * \tparam Layout Storage layout, `row_major` or `column_major`.
+	 * \tparam Alignment Alignment in bytes of the buffer and of each row/column, must be a power of two.
+	 */
+	template<typename Ty,
+		class Layout = row_major,
+		std::size_t Alignment = 64U
+	> class aligned_matrix : public matrix_expression<aligned_matrix<Ty, Layout, Alignment>> {
+		static_assert(std::is_same<Layout, row_major>::value || std::is_same<Layout, column_major>::value,
+			"aligned_matrix Layout must be row_major or column_major.");
+		static constexpr bool is_row_major = std::is_same<Layout, row_major>::value;
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef Ty value_type;
+		typedef Ty& reference;
+		typedef const Ty& const_reference;
+		typedef Ty* pointer;
+		typedef const Ty* const_pointer;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef aligned_allocator<Ty, Alignment> allocator_type;
+		typedef Layout layout_type;
+		typedef typename matrix_view<Ty>::iterator iterator;
+		typedef typename matrix_view<const Ty>::iterator const_iterator;
+		// CONSTRUCTION/ASSIGNMENT
+		/**
+		 * \brief Default constructor, initialises an empty container.
+		 */
+		aligned_matrix() : buf(), nrows(0U), ncols(0U), ld(0U) {}
+		/**
+		 * \brief Initialises the container with `_rows` rows and `_cols` columns of value-initialised elements.
+		 *
+		 * \param _rows Number of rows.
+		 * \param _cols Number of columns.
+		 */
+		aligned_matrix(size_type _rows, size_type _cols)
+			: buf(), nrows(_rows), ncols(_cols), ld(padded_extent(is_row_major ? _cols : _rows)) {
+			buf.resize(ld*(is_row_major ? _rows : _cols));
+		}
+		/**
+		 * \brief Initialises the container with `_rows` rows and `_cols` columns with each element set to `_val`.
+		 *
+		 * \param _rows Number of rows.
+		 * \param _cols Number of columns.
+		 * \param _val Value to initialise elements with.
+		 */
+		aligned_matrix(size_type _rows, size_type _cols, const value_type& _val)
+			: aligned_matrix(_rows, _cols) {
+			fill(_val);
+		}
+		/**
+		 * \brief Constructs the container by evaluating the element-wise matrix expression `_expr`. Any
+		 *        matrix container, view or expression may be used as `_expr`, e.g. to change the layout of
+		 *        a `dynamic_matrix` via `aligned_matrix<Ty, column_major>(make_matrix_view(dm))`.
+		 *
+		 * \param _expr Expression to evaluate.
+		 * \complexity Linear in `rows()*columns()`.
+		 */
+		template<class Expr>
+		aligned_matrix(const matrix_expression<Expr>& _expr)
+			: aligned_matrix(_expr.self().rows(), _expr.self().columns()) {
+			evaluate_expression<matrix_expression_impl::assign>(_expr.self());
+		}
+		/**
+		 * \brief Replaces the contents of the container with the result of evaluating `_expr`.
+		 *
+		 * \remark `_expr` may refer to this container. It is evaluated in place only if its dimensions
+		 *         equal those of this container and it has no `matrix_view` operand (such as `view()`),
+		 *         otherwise into newly allocated storage, since a view may read elements of this container
+		 *         at other positions which have already been overwritten.
+		 */
+		template<class Expr>
+		aligned_matrix& operator=(const matrix_expression<Expr>& _expr) {
+			if (!matrix_expression_impl::has_view_operand<Expr>::value
+				&& nrows == _expr.self().rows() && ncols == _expr.self().columns())
+				evaluate_expression<matrix_expression_impl::assign>(_expr.self());
+			else aligned_matrix(_expr).swap(*this);
+			return *this;
+		}
+		allocator_type get_allocator() const { return buf.get_allocator(); }
+		// CAPACITY
+		bool empty() const noexcept { return !nrows || !ncols; }
+		size_type rows() const noexcept { return nrows; }
+		size_type columns() const noexcept { return ncols; }
+		size_type size() const noexcept { return nrows*ncols; }
+		/**
+		 * \brief Returns the distance, in elements, between the first elements of consecutive rows (row-major)
+		 *        or columns (column-major). This is never less than `columns()` (row-major) or `rows()`
+		 *        (column-major) respectively.
+		 */
+		size_type leading_dimension() const noexcept { return ld; }
+		/**
+		 * \brief Returns the alignment in bytes of `data()` and of the first element of each row (row-major)
+		 *        or column (column-major).
+		 */
+		static constexpr size_type alignment() noexcept { return allocator_type::alignment; }
+		// ELEMENT ACCESS
+		const_reference at(size_type i, size_type j) const {
+			if (i >= nrows || j >= ncols) throw std::out_of_range("aligned_matrix index out of bounds.");
+			return (*this)(i, j);
+		}
+		reference at(size_type i, size_type j) {
+			if (i >= nrows || j >= ncols) throw std::out_of_range("aligned_matrix index out of bounds.");
+			return (*this)(i, j);
+		}
+		const_reference operator()(size_type i, size_type j) const noexcept { return buf[offset(i, j)]; }
+		reference operator()(size_type i, size_type j) noexcept { return buf[offset(i, j)]; }
+		/**
+		 * \brief Returns a pointer to the underlying buffer, including padding, suitable for passing to
+		 *        routines taking a `(pointer, leading dimension)` pair.
+		 */
+		const_pointer data() const noexcept { return buf.data(); }
+		pointer data() noexcept { return buf.data(); }
+		// VIEWS
+		/**
+		 * \brief Returns a `matrix_view` of all elements of the container.
+		 */
+		matrix_view<const Ty> view() const noexcept {
+			return matrix_view<const Ty>(buf.data(), nrows, ncols, row_stride(), column_stride());
+		}
+		matrix_view<Ty> view() noexcept {
+			return matrix_view<Ty>(buf.data(), nrows, ncols, row_stride(), column_stride());
+		}
+		/**
+		 * \brief Returns a view of row `i`, contiguous and aligned if `Layout` is `row_major`.
+		 *
+		 * \throw Throws `std::out_of_range` exception if `i >= rows()`.
+		 */
+		matrix_view<const Ty> row(size_type i) const { return view().row(i); }
+		matrix_view<Ty> row(size_type i) { return view().row(i); }
+		/**
+		 * \brief Returns a view of column `j`, contiguous and aligned if `Layout` is `column_major`.
+		 *
+		 * \throw Throws `std::out_of_range` exception if `j >= columns()`.
+		 */
+		matrix_view<const Ty> column(size_type j) const { return view().column(j); }
+		matrix_view<Ty> column(size_type j) { return view().column(j); }
+		// OPERATIONS
+		/**
+		 * \brief Assigns the given value `_val` to all elements in the container.
+		 *
+		 * \complexity Linear in `rows()*columns()`.
+		 */
+		void fill(const value_type& _val) {
+			const size_type inner = is_row_major ? ncols : nrows;
+			for (size_type o = 0U; o < (is_row_major ? nrows : ncols); ++o)
+				std::fill(buf.begin() + o*ld, buf.begin() + o*ld + inner, _val);
+		}
+		/**
+		 * \brief Exchanges the contents of the container with those of `_other`.
+		 *
+		 * \complexity Constant.
+		 */
+		void swap(aligned_matrix& _other) noexcept {
+			buf.swap(_other.buf);
+			std::swap(nrows, _other.nrows);
+			std::swap(ncols, _other.ncols);
+			std::swap(ld, _other.ld);
+		}
+		// OPERATORS
+		bool operator==(const aligned_matrix& _other) const {
+			if (nrows != _other.nrows || ncols != _other.ncols) return false;
+			for (size_type i = 0U; i < nrows; ++i) {
+				for (size_type j = 0U; j < ncols; ++j)
+					if (!((*this)(i, j) == _other(i, j))) return false;
+			}
+			return true;
+		}
+		bool operator!=(const aligned_matrix& _other) const { return !(*this == _other); }
+		template<class Expr>
+		aligned_matrix& operator+=(const matrix_expression<Expr>& _expr) {
+			if (matrix_expression_impl::has_view_operand<Expr>::value) // a view may alias this matrix
+				evaluate_expression<matrix_expression_impl::plus_assign>(aligned_matrix(_expr));
+			else evaluate_expression<matrix_expression_impl::plus_assign>(_expr.self());
+			return *this;
+		}
+		template<class Expr>
+		aligned_matrix& operator-=(const matrix_expression<Expr>& _expr) {
+			if (matrix_expression_impl::has_view_operand<Expr>::value) // a view may alias this matrix
+				evaluate_expression<matrix_expression_impl::minus_assign>(aligned_matrix(_expr));
+			else evaluate_expression<matrix_expression_impl::minus_assign>(_expr.self());
+			return *this;
+		}
+		aligned_matrix& operator*=(const value_type& _scale) {
+			for (auto& el : buf) el *= _scale;
+			return *this;
+		}
+		// ITERATORS
+		const_iterator begin() const noexcept { return view().begin(); }
+		const_iterator end() const noexcept { return view().end(); }
+		iterator begin() noexcept { return view().begin(); }
+		iterator end() noexcept { return view().end(); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+	private:
+		std::vector<value_type, allocator_type> buf;
+		size_type nrows;
+		size_type ncols;
+		size_type ld;
+		size_type row_stride() const noexcept { return is_row_major ? ld : 1U; }
+		size_type column_stride() const noexcept { return is_row_major ? 1U : ld; }
+		size_type offset(size_type i, size_type j) const noexcept { return is_row_major ? i*ld + j : j*ld + i; }
+		/**
+		 * \brief Rounds `extent` up to a whole number of `alignment()`-byte blocks of elements.
+		 */
+		static size_type padded_extent(size_type extent) noexcept {
+			const size_type block = allocator_type::alignment / sizeof(Ty);
+			if (!block || allocator_type::alignment % sizeof(Ty)) return extent;
+			return (extent + block - 1U) / block * block;
+		}
+		template<class AssignOp, class Expr>
+		void evaluate_expression(const Expr& _expr) {
+			const matrix_expression_impl::operand_t<Expr> operand = matrix_expression_impl::make_operand(_expr);
+			if (operand.rows() != nrows || operand.columns() != ncols)
+				throw std::invalid_argument("matrix_expression dimensions must agree with aligned_matrix dimensions.");
+			// evaluate column-major destinations as the transposed problem so the inner loop is contiguous
+			if (is_row_major)
+				matrix_expression_impl::evaluate<AssignOp>(buf.data(), ld, 1U, operand, 0U, nrows);
+			else {
+				const matrix_expression_impl::transposed<matrix_expression_impl::operand_t<Expr>> transposed_operand(operand);
+				matrix_expression_impl::evaluate<AssignOp>(buf.data(), ld, 1U, transposed_operand, 0U, ncols);
+			}
+		}
+	};
+	/**
+	 * \brief Expression operand of an `aligned_matrix`, a strided view of its elements.
+	 */
+	namespace matrix_expression_impl {
+		template<typename Ty,
+			class Layout,
+			std::size_t Alignment
+		> struct operand_traits<aligned_matrix<Ty, Layout, Alignment>> {
+			typedef matrix_view<const Ty> type;
+			static type make(const aligned_matrix<Ty, Layout, Alignment>& m) noexcept { return m.view(); }
+		};
+	}
+	template<typename Ty,
+		class Layout,
+		std::size_t Alignment
+	> void swap(aligned_matrix<Ty, Layout, Alignment>& lhs, aligned_matrix<Ty, Layout, Alignment>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+	/**
+	 * \brief Returns an `aligned_matrix`, of the same layout as the operands, which gives the matrix product
+	 *        of `lhs` with `rhs`.
+	 *
+	 * \param lhs First instance of `aligned_matrix`.
+	 * \param rhs Second instance of `aligned_matrix`.
+	 * \return Container consisting of product of `lhs` and `rhs`.
+	 * \throw Throws `std::invalid_argument` exception if `lhs.columns() != rhs.rows()`.
+	 * \complexity Linear in `lhs.rows()*rhs.columns()*lhs.columns()`.
+	 */
+	template<typename Ty,
+		class Layout,
+		std::size_t Alignment
+	> aligned_matrix<Ty, Layout, Alignment> matrix_product(const aligned_matrix<Ty, Layout, Alignment>& lhs,
+		const aligned_matrix<Ty, Layout, Alignment>& rhs) {
+		if (lhs.columns() != rhs.rows())
+			throw std::invalid_argument("aligned_matrix dimensions must agree for matrix_product.");
+		aligned_matrix<Ty, Layout, Alignment> product(lhs.rows(), rhs.columns());
+		matrix_product(lhs.view(), rhs.view(), product.view());
+		return product;
+	}
+}
+
+#endif // !ALIGNED_MATRIX_H
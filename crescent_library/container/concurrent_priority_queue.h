@@ -0,0 +1,252 @@
+#ifndef CONCURRENT_PRIORITY_QUEUE_H
+#define CONCURRENT_PRIORITY_QUEUE_H
+#include "priority_queue.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace crsc {
+	/**
+	 * \class concurrent_priority_queue
+	 *
+	 * \brief A relaxed priority queue for concurrent use by multiple producer and consumer threads, built as
+	 *        a "multiqueue" of independently locked `crsc::priority_queue` heaps.
+	 *
+	 * Each `enqueue` inserts into one randomly chosen sub-queue, and each `dequeue` pops the higher priority
+	 * of the tops of two randomly chosen sub-queues, such that threads rarely contend for the same lock and
+	 * no operation serialises on a global lock. In exchange the queue is relaxed: a dequeued element is one of
+	 * the highest priority elements with high probability, rather than always the highest, and concurrent
+	 * calls are not linearisable. The expected rank error grows with the number of sub-queues, which defaults
+	 * to twice the number of hardware threads. A queue of a single sub-queue is an exact priority queue behind
+	 * one mutex.
+	 *
+	 * \tparam Ty The type of the elements, must be move-constructible.
+	 * \tparam Compare A `Compare` type providing a strict weak ordering, defaults to `std::less<Ty>`.
+	 * \tparam Arity Number of children of each node of the sub-queue heaps, see `crsc::priority_queue`.
+	 */
+	template<class Ty,
+		class Compare = std::less<Ty>,
+		std::size_t Arity = 2
+	> class concurrent_priority_queue {
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef Ty value_type;
+		typedef Ty& reference;
+		typedef const Ty& const_reference;
+		typedef std::size_t size_type;
+		// CONSTRUCTION
+		/**
+		 * \brief Constructs an empty queue of `queues` sub-queues, each with a copy of `compare` as its
+		 *        comparison functor. This is also the default constructor.
+		 *
+		 * \param queues Number of sub-queues, `0` selects twice `std::thread::hardware_concurrency()`.
+		 * \param compare Comparator function object to initialise the comparison functors.
+		 */
+		explicit concurrent_priority_queue(size_type queues = 0U, const Compare& compare = Compare())
+			: nqueues(queues ? queues : 2U*std::max(1U, std::thread::hardware_concurrency())),
+			subqueues(new sub_queue[nqueues]), comp(compare) {
+			for (size_type i = 0U; i < nqueues; ++i) subqueues[i].heap = heap_type(compare);
+		}
+		concurrent_priority_queue(const concurrent_priority_queue&) = delete;
+		concurrent_priority_queue& operator=(const concurrent_priority_queue&) = delete;
+		// CAPACITY
+		/**
+		 * \brief Returns the number of elements in the queue, exact only if no other thread is modifying it.
+		 *
+		 * \complexity Linear in the number of sub-queues.
+		 */
+		size_type size() const {
+			size_type n = 0U;
+			for (size_type i = 0U; i < nqueues; ++i) {
+				std::lock_guard<std::mutex> lock(subqueues[i].mut);
+				n += subqueues[i].heap.size();
+			}
+			return n;
+		}
+		/**
+		 * \brief Checks whether the queue is empty, exact only if no other thread is modifying it.
+		 *
+		 * \complexity Linear in the number of sub-queues.
+		 */
+		bool empty() const {
+			for (size_type i = 0U; i < nqueues; ++i) {
+				std::lock_guard<std::mutex> lock(subqueues[i].mut);
+				if (!subqueues[i].heap.empty()) return false;
+			}
+			return true;
+		}
+		/**
+		 * \brief Returns the number of sub-queues.
+		 */
+		size_type queues() const noexcept { return nqueues; }
+		// ELEMENT ACCESS
+		/**
+		 * \brief Copies the higher priority of the tops of two randomly chosen sub-queues into `out`
+		 *        without popping it, i.e. the element the next `dequeue` on this thread would likely return.
+		 *
+		 * \param out Destination of the copied element.
+		 * \return `true` if an element was copied, `false` if the queue was observed to be empty.
+		 * \complexity Constant, or linear in the number of sub-queues if both chosen sub-queues are empty.
+		 */
+		bool top(value_type& out) const {
+			return select([&out](sub_queue& q) { out = q.heap.top(); });
+		}
+		// MODIFIERS
+		/**
+		 * \brief Pushes an item into a randomly chosen sub-queue.
+		 *
+		 * \param _val Value to enqueue.
+		 * \complexity Logarithmic in the size of the sub-queue, plus the time to acquire its lock.
+		 */
+		void enqueue(const value_type& _val) {
+			sub_queue& q = acquire();
+			std::lock_guard<std::mutex> lock(q.mut, std::adopt_lock);
+			q.heap.enqueue(_val);
+		}
+		/**
+		 * \brief Pushes an item into a randomly chosen sub-queue via move-insertion.
+		 *
+		 * \param _val rvalue reference to value to enqueue.
+		 * \complexity Logarithmic in the size of the sub-queue, plus the time to acquire its lock.
+		 */
+		void enqueue(value_type&& _val) {
+			sub_queue& q = acquire();
+			std::lock_guard<std::mutex> lock(q.mut, std::adopt_lock);
+			q.heap.enqueue(std::move(_val));
+		}
+		/**
+		 * \brief Pushes the items of the range `[first, last)` into one randomly chosen sub-queue under a
+		 *        single lock acquisition.
+		 *
+		 * \param first Beginning of range of values to enqueue.
+		 * \param last End of range of values to enqueue.
+		 */
+		template<class InputIt>
+		void enqueue(InputIt first, InputIt last) {
+			sub_queue& q = acquire();
+			std::lock_guard<std::mutex> lock(q.mut, std::adopt_lock);
+			q.heap.enqueue(first, last);
+		}
+		/**
+		 * \brief Constructs element in-place in a randomly chosen sub-queue.
+		 *
+		 * \param args Arguments to forward to the constructor of the element.
+		 * \complexity Logarithmic in the size of the sub-queue, plus the time to acquire its lock.
+		 */
+		template<class... Args>
+		void emplace(Args&&... args) {
+			sub_queue& q = acquire();
+			std::lock_guard<std::mutex> lock(q.mut, std::adopt_lock);
+			q.heap.emplace(std::forward<Args>(args)...);
+		}
+		/**
+		 * \brief Pops the higher priority of the tops of two randomly chosen sub-queues, moving it into `out`.
+		 *        If both are empty every sub-queue is tried in turn.
+		 *
+		 * \param out Destination of the popped element.
+		 * \return `true` if an element was popped, `false` if the queue was observed to be empty.
+		 * \complexity Logarithmic in the size of the sub-queue, or linear in the number of sub-queues if both
+		 *             chosen sub-queues are empty.
+		 */
+		bool dequeue(value_type& out) {
+			return select([&out](sub_queue& q) {
+				out = std::move(const_cast<value_type&>(q.heap.top()));
+				q.heap.dequeue();
+			});
+		}
+		/**
+		 * \brief Pops and discards the element that `dequeue(value_type&)` would return.
+		 *
+		 * \return `true` if an element was popped, `false` if the queue was observed to be empty.
+		 */
+		bool dequeue() {
+			return select([](sub_queue& q) { q.heap.dequeue(); });
+		}
+		/**
+		 * \brief Clears all items from the queue.
+		 *
+		 * \complexity Linear in the size of the queue.
+		 */
+		void clear() {
+			for (size_type i = 0U; i < nqueues; ++i) {
+				std::lock_guard<std::mutex> lock(subqueues[i].mut);
+				subqueues[i].heap.clear();
+			}
+		}
+	private:
+		typedef priority_queue<Ty, std::vector<Ty>, Compare, Arity> heap_type;
+		static constexpr size_type cache_line = 64U;
+		struct sub_queue {
+			mutable std::mutex mut;
+			heap_type heap;
+			char pad[cache_line];	// keeps neighbouring locks and heaps off each other's cache lines
+		};
+		size_type nqueues;
+		std::unique_ptr<sub_queue[]> subqueues;
+		Compare comp;
+		/**
+		 * \brief Returns a random sub-queue index from a per-thread xorshift generator.
+		 */
+		size_type random_queue() const noexcept {
+			thread_local std::uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id())
+				| static_cast<std::uint64_t>(1U);
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return static_cast<size_type>(state % nqueues);
+		}
+		/**
+		 * \brief Locks and returns a random sub-queue, preferring any sub-queue whose lock is free.
+		 */
+		sub_queue& acquire() const {
+			for (size_type attempt = 0U; attempt < nqueues; ++attempt) {
+				sub_queue& q = subqueues[random_queue()];
+				if (q.mut.try_lock()) return q;
+			}
+			sub_queue& q = subqueues[random_queue()];
+			q.mut.lock();
+			return q;
+		}
+		/**
+		 * \brief Applies `f` to the sub-queue with the higher priority top of two randomly chosen non-empty
+		 *        sub-queues (or the only non-empty one) whilst holding its lock, falling back to a sweep of all
+		 *        sub-queues if both are empty.
+		 *
+		 * \return `true` if `f` was applied, `false` if every sub-queue was observed to be empty.
+		 */
+		template<class Function>
+		bool select(Function f) const {
+			sub_queue& a = acquire();
+			std::unique_lock<std::mutex> lock_a(a.mut, std::adopt_lock);
+			if (nqueues > 1U) {
+				sub_queue& b = subqueues[random_queue()];
+				if (&b != &a) {
+					std::unique_lock<std::mutex> lock_b(b.mut, std::try_to_lock);
+					if (lock_b.owns_lock() && !b.heap.empty()
+						&& (a.heap.empty() || comp(a.heap.top(), b.heap.top()))) {
+						lock_a.unlock();
+						f(b);
+						return true;
+					}
+				}
+			}
+			if (!a.heap.empty()) { f(a); return true; }
+			lock_a.unlock();
+			for (size_type i = 0U; i < nqueues; ++i) {
+				std::lock_guard<std::mutex> lock(subqueues[i].mut);
+				if (!subqueues[i].heap.empty()) { f(subqueues[i]); return true; }
+			}
+			return false;
+		}
+	};
+	template<class Ty, class Compare, std::size_t Arity>
+	constexpr typename concurrent_priority_queue<Ty, Compare, Arity>::size_type
+		concurrent_priority_queue<Ty, Compare, Arity>::cache_line;
+}
+
+#endif // !CONCURRENT_PRIORITY_QUEUE_H
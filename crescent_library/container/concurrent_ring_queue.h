@@ -0,0 +1,284 @@
+#ifndef CONCURRENT_RING_QUEUE_H
+#define CONCURRENT_RING_QUEUE_H
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace crsc {
+	namespace ring_queue_impl {
+		constexpr std::size_t cache_line = 64U;
+		/**
+		 * \brief Returns the smallest power of two of at least `n` (and at least `2`).
+		 */
+		inline std::size_t ring_capacity(std::size_t n) noexcept {
+			std::size_t c = 2U;
+			while (c < n) c <<= 1;
+			return c;
+		}
+		/**
+		 * \brief An atomic index padded to the size of a cache line, such that the indices of the producer and
+		 *        consumer sides of a queue do not share a cache line.
+		 */
+		struct padded_index {
+			std::atomic<std::size_t> value;
+			char pad[cache_line - sizeof(std::atomic<std::size_t>)];
+			padded_index() noexcept : value(0U) {}
+		};
+		template<class Ty>
+		using storage_t = typename std::aligned_storage<sizeof(Ty), alignof(Ty)>::type;
+	}
+	/**
+	 * \class spsc_ring_queue
+	 *
+	 * \brief A bounded lock-free queue for one producer thread and one consumer thread, built as a ring buffer.
+	 *
+	 * `try_enqueue` and `try_dequeue` never block and never allocate: each is a handful of loads and a single
+	 * release store of the index owned by the calling side, with the index of the other side cached so that it
+	 * is re-read only when the ring appears full (or empty). Blocking hand-off between pipeline stages is
+	 * obtained by pairing the queue with `crsc::semaphore`s counting the filled and free slots.
+	 *
+	 * \tparam Ty The type of the elements, must be nothrow move-constructible.
+	 */
+	template<class Ty>
+	class spsc_ring_queue {
+		static_assert(std::is_nothrow_move_constructible<Ty>::value && std::is_nothrow_destructible<Ty>::value,
+			"spsc_ring_queue elements must be nothrow move-constructible and destructible.");
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef Ty value_type;
+		typedef std::size_t size_type;
+		// CONSTRUCTION
+		/**
+		 * \brief Constructs an empty queue of at least `_capacity` slots, rounded up to a power of two.
+		 *
+		 * \throw Throws `std::bad_alloc` if the ring cannot be allocated.
+		 */
+		explicit spsc_ring_queue(size_type _capacity)
+			: mask(ring_queue_impl::ring_capacity(_capacity) - 1U), slots(new ring_queue_impl::storage_t<Ty>[mask + 1U]) {}
+		spsc_ring_queue(const spsc_ring_queue&) = delete;
+		spsc_ring_queue& operator=(const spsc_ring_queue&) = delete;
+		~spsc_ring_queue() {
+			const size_type t = tail.value.load(std::memory_order_acquire);
+			for (size_type h = head.value.load(std::memory_order_acquire); h != t; ++h)
+				reinterpret_cast<value_type*>(&slots[h & mask])->~value_type();
+		}
+		// CAPACITY
+		/**
+		 * \brief Returns the number of slots of the ring.
+		 */
+		size_type capacity() const noexcept { return mask + 1U; }
+		/**
+		 * \brief Returns the number of elements in the queue, exact only if no other thread is modifying it.
+		 */
+		size_type size() const noexcept {
+			return tail.value.load(std::memory_order_acquire) - head.value.load(std::memory_order_acquire);
+		}
+		/**
+		 * \brief Checks whether the queue is empty, exact only if no other thread is modifying it.
+		 */
+		bool empty() const noexcept { return !size(); }
+		// MODIFIERS
+		/**
+		 * \brief Appends a copy of `_val` unless the queue is full. Producer thread only.
+		 *
+		 * \return `true` if the element was enqueued, `false` if the queue was full.
+		 */
+		bool try_enqueue(const value_type& _val) { return try_emplace(_val); }
+		/**
+		 * \brief Appends `_val`, moved from only if enqueued, unless the queue is full. Producer thread only.
+		 */
+		bool try_enqueue(value_type&& _val) noexcept { return try_emplace(std::move(_val)); }
+		/**
+		 * \brief Appends an element constructed in place from `args` unless the queue is full. Producer
+		 *        thread only.
+		 *
+		 * \throw Propagates any exception thrown by the construction, leaving the queue unchanged.
+		 */
+		template<class... Args>
+		bool try_emplace(Args&&... args) {
+			const size_type t = tail.value.load(std::memory_order_relaxed);
+			if (t - cached_head == capacity()) {
+				cached_head = head.value.load(std::memory_order_acquire);
+				if (t - cached_head == capacity()) return false;
+			}
+			::new (static_cast<void*>(&slots[t & mask])) value_type(std::forward<Args>(args)...);
+			tail.value.store(t + 1U, std::memory_order_release);
+			return true;
+		}
+		/**
+		 * \brief Moves the front element into `out` and removes it, unless the queue is empty. Consumer
+		 *        thread only.
+		 *
+		 * \return `true` if an element was dequeued, `false` if the queue was empty.
+		 */
+		bool try_dequeue(value_type& out) noexcept(std::is_nothrow_move_assignable<Ty>::value) {
+			const size_type h = head.value.load(std::memory_order_relaxed);
+			if (h == cached_tail) {
+				cached_tail = tail.value.load(std::memory_order_acquire);
+				if (h == cached_tail) return false;
+			}
+			value_type* p = reinterpret_cast<value_type*>(&slots[h & mask]);
+			out = std::move(*p);
+			p->~value_type();
+			head.value.store(h + 1U, std::memory_order_release);
+			return true;
+		}
+	private:
+		size_type mask;
+		std::unique_ptr<ring_queue_impl::storage_t<Ty>[]> slots;
+		ring_queue_impl::padded_index head;	// next slot to dequeue, written by the consumer
+		size_type cached_tail = 0U;	// consumer's copy of tail
+		char pad[ring_queue_impl::cache_line - sizeof(size_type)];
+		ring_queue_impl::padded_index tail;	// next slot to enqueue, written by the producer
+		size_type cached_head = 0U;	// producer's copy of head
+	};
+	/**
+	 * \class mpmc_ring_queue
+	 *
+	 * \brief A bounded lock-free queue for any number of producer and consumer threads, built as a ring buffer
+	 *        of sequenced slots (D. Vyukov's bounded MPMC queue).
+	 *
+	 * Each slot carries a sequence number stating whether it is free or filled for the current lap of the
+	 * ring, so a producer (consumer) claims a slot with a single compare-and-swap of the tail (head) index and
+	 * publishes it with a release store of the sequence number; threads only contend on the index of their
+	 * own side and never block. Elements are dequeued in the order their slots were claimed.
+	 *
+	 * A slot is claimed in order, so `try_enqueue` (`try_dequeue`) also fails while the next slot is still
+	 * being emptied (filled) by a slower thread of the other side, even if other slots are free (filled). When
+	 * pairing the queue with `crsc::semaphore`s counting the filled and free slots for blocking hand-off, a call
+	 * made after acquiring a permit can therefore fail transiently and should be retried, e.g. after
+	 * `std::this_thread::yield()`; it succeeds as soon as the thread holding the slot completes its operation.
+	 *
+	 * \tparam Ty The type of the elements, must be nothrow move-constructible.
+	 */
+	template<class Ty>
+	class mpmc_ring_queue {
+		static_assert(std::is_nothrow_move_constructible<Ty>::value && std::is_nothrow_destructible<Ty>::value,
+			"mpmc_ring_queue elements must be nothrow move-constructible and destructible.");
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef Ty value_type;
+		typedef std::size_t size_type;
+		// CONSTRUCTION
+		/**
+		 * \brief Constructs an empty queue of at least `_capacity` slots, rounded up to a power of two.
+		 *
+		 * \throw Throws `std::bad_alloc` if the ring cannot be allocated.
+		 */
+		explicit mpmc_ring_queue(size_type _capacity)
+			: mask(ring_queue_impl::ring_capacity(_capacity) - 1U), cells(new cell[mask + 1U]) {
+			for (size_type i = 0U; i <= mask; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		mpmc_ring_queue(const mpmc_ring_queue&) = delete;
+		mpmc_ring_queue& operator=(const mpmc_ring_queue&) = delete;
+		~mpmc_ring_queue() {
+			for (size_type h = head.value.load(std::memory_order_acquire);
+				cells[h & mask].sequence.load(std::memory_order_acquire) == h + 1U; ++h)
+				reinterpret_cast<value_type*>(&cells[h & mask].storage)->~value_type();
+		}
+		// CAPACITY
+		/**
+		 * \brief Returns the number of slots of the ring.
+		 */
+		size_type capacity() const noexcept { return mask + 1U; }
+		/**
+		 * \brief Returns the number of claimed slots, exact only if no other thread is modifying the queue.
+		 */
+		size_type size() const noexcept {
+			const size_type h = head.value.load(std::memory_order_acquire);
+			const size_type t = tail.value.load(std::memory_order_acquire);
+			return (t > h) ? t - h : 0U;
+		}
+		/**
+		 * \brief Checks whether the queue is empty, exact only if no other thread is modifying it.
+		 */
+		bool empty() const noexcept { return !size(); }
+		// MODIFIERS
+		/**
+		 * \brief Appends a copy of `_val` unless the queue is full.
+		 *
+		 * \return `true` if the element was enqueued, `false` if the queue was full.
+		 * \throw Propagates any exception thrown by the copy, leaving the queue unchanged.
+		 */
+		bool try_enqueue(const value_type& _val) {
+			value_type tmp(_val);
+			return try_enqueue(std::move(tmp));
+		}
+		/**
+		 * \brief Appends `_val`, moved from only if enqueued, unless the queue is full.
+		 */
+		bool try_enqueue(value_type&& _val) noexcept {
+			size_type pos = tail.value.load(std::memory_order_relaxed);
+			cell* c;
+			for (;;) {
+				c = &cells[pos & mask];
+				const size_type seq = c->sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - pos);
+				if (diff == 0) {
+					if (tail.value.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)) break;
+				}
+				else if (diff < 0) return false;	// slot not yet freed from the previous lap: full
+				else pos = tail.value.load(std::memory_order_relaxed);
+			}
+			::new (static_cast<void*>(&c->storage)) value_type(std::move(_val));
+			c->sequence.store(pos + 1U, std::memory_order_release);
+			return true;
+		}
+		/**
+		 * \brief Appends an element constructed from `args` unless the queue is full.
+		 *
+		 * \throw Propagates any exception thrown by the construction, leaving the queue unchanged.
+		 */
+		template<class... Args>
+		bool try_emplace(Args&&... args) {
+			value_type tmp(std::forward<Args>(args)...);
+			return try_enqueue(std::move(tmp));
+		}
+		/**
+		 * \brief Moves the oldest claimed element into `out` and removes it, unless the queue is empty.
+		 *
+		 * \return `true` if an element was dequeued, `false` if the queue was empty.
+		 */
+		bool try_dequeue(value_type& out) noexcept(std::is_nothrow_move_assignable<Ty>::value) {
+			size_type pos = head.value.load(std::memory_order_relaxed);
+			cell* c;
+			for (;;) {
+				c = &cells[pos & mask];
+				const size_type seq = c->sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + 1U));
+				if (diff == 0) {
+					if (head.value.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)) break;
+				}
+				else if (diff < 0) return false;	// slot not yet filled for this lap: empty
+				else pos = head.value.load(std::memory_order_relaxed);
+			}
+			value_type* p = reinterpret_cast<value_type*>(&c->storage);
+			// a throwing move assignment leaves the element in place but the slot released, so it is still destroyed
+			struct release {
+				cell* c;
+				value_type* p;
+				size_type next;
+				~release() {
+					p->~value_type();
+					c->sequence.store(next, std::memory_order_release);
+				}
+			} guard{ c, p, pos + mask + 1U };
+			out = std::move(*p);
+			return true;
+		}
+	private:
+		struct cell {
+			std::atomic<size_type> sequence;
+			ring_queue_impl::storage_t<Ty> storage;
+		};
+		size_type mask;
+		std::unique_ptr<cell[]> cells;
+		ring_queue_impl::padded_index head;	// next slot to dequeue
+		ring_queue_impl::padded_index tail;	// next slot to enqueue
+	};
+}
+
+#endif // !CONCURRENT_RING_QUEUE_H
@@ -4,8 +4,11 @@
 #include <iostream>
 #include <initializer_list>
 #include <iterator>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 template<typename T> class dynamic_array_const_iterator;
 
@@ -47,7 +50,7 @@ public:
 		ptr = tmp_ptr; // reset ptr of this to initial value
 		return tmp;
 	}
-	std::ptrdiff_t operator-(const dynamic_array_iterator& _other) { return _other.ptr - ptr; }
+	std::ptrdiff_t operator-(const dynamic_array_iterator& _other) const { return ptr - _other.ptr; }
 	dynamic_array_iterator& operator++() { ptr++; return *this; }
 	dynamic_array_iterator operator++(int) {
 		dynamic_array_iterator<Ty> tmp(*this);
@@ -114,7 +117,7 @@ public:
 		ptr = tmp_ptr;
 		return tmp;
 	}
-	std::ptrdiff_t operator-(const dynamic_array_const_iterator& _other) { return _other.ptr - ptr; }
+	std::ptrdiff_t operator-(const dynamic_array_const_iterator& _other) const { return ptr - _other.ptr; }
 	dynamic_array_const_iterator& operator++() { ptr++; return *this; }
 	dynamic_array_const_iterator operator++(int) { dynamic_array_const_iterator<Ty> tmp(*this); operator++(); return tmp; }
 	dynamic_array_const_iterator& operator--() { ptr--; return *this; }
@@ -160,19 +163,58 @@ bool operator>=(const dynamic_array_iterator<Ty>& iter, const dynamic_array_cons
 	return iter.get_ptr() >= citer.get_ptr();
 }
 
+/**
+* \brief Trait marking types whose objects may be relocated (moved to new storage and the source
+*        discarded without destruction) by a bytewise copy, such that `dynamic_array` grows by
+*        `std::memcpy`. True for trivially copyable types, specialise as `std::true_type` for other
+*        types which hold no pointers into themselves (e.g. `std::unique_ptr`).
+*/
+template<typename Ty>
+struct is_trivially_relocatable : std::is_trivially_copyable<Ty> {};
+template<typename Ty, class Deleter>
+struct is_trivially_relocatable<std::unique_ptr<Ty, Deleter>> : std::is_trivially_copyable<Deleter> {};
+
+namespace dynamic_array_impl {
+	// uninitialised storage for N elements of Ty held inside the container object
+	template<typename Ty, std::size_t N>
+	struct inline_storage {
+		Ty* data() noexcept { return reinterpret_cast<Ty*>(&buf); }
+		typename std::aligned_storage<sizeof(Ty)*N, alignof(Ty)>::type buf;
+	};
+	template<typename Ty>
+	struct inline_storage<Ty, 0U> {
+		Ty* data() noexcept { return nullptr; }
+	};
+}
+
 /**
 * \class dynamic_array
 *
 * \brief A container storing an array in contiguous storage with methods to expand and contract
 *        the storage as necessary.
 *
-* \tparam The type of the stored elements.
+* Storage is obtained through `Allocator`, except for arrays of at most `InlineCapacity` elements
+* which are held in a buffer inside the container object itself, such that small arrays require
+* no allocation at all. Capacity grows by a factor of 1.5 and, for types satisfying
+* `is_trivially_relocatable`, elements are relocated to new storage by `std::memcpy`. Other elements are
+* moved if their move constructor is `noexcept` and copied otherwise, such that `emplace_back`, `emplace`,
+* `insert` and `reserve` leave the container unchanged if they throw.
+*
+* \tparam Ty The type of the stored elements.
+* \tparam Allocator An allocator that is used to acquire memory to store the elements. The type must meet the
+*                   requirements of `Allocator` (see C++ Standard). Behaviour is undefined if
+*                   `Allocator::value_type != Ty`.
+* \tparam InlineCapacity Number of elements which can be stored without allocation, defaults to `0`.
 */
-template<typename Ty>
-class dynamic_array {
+template<typename Ty,
+	class Allocator = std::allocator<Ty>,
+	std::size_t InlineCapacity = 0U
+> class dynamic_array {
+	typedef std::allocator_traits<Allocator> alloc_traits;
 public:
 	// PUBLIC API TYPE DEFINITIONS
 	typedef Ty value_type;
+	typedef Allocator allocator_type;
 	typedef Ty& reference;
 	typedef const Ty& const_reference;
 	typedef Ty* pointer;
@@ -183,46 +225,70 @@ public:
 	typedef dynamic_array_const_iterator<Ty> const_iterator;
 	typedef std::reverse_iterator<iterator> reverse_iterator;
 	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+	static constexpr size_type inline_capacity = InlineCapacity;
 	// CONSTRUCTION/ASSIGNMENT
-	dynamic_array()
-		: arr_capacity(0), arr_size(0) { allocate(0); }
-	dynamic_array(size_type count)
-		: arr_capacity(count), arr_size(count) { allocate(count); }
-	dynamic_array(size_type count, const value_type& _val)
-		: arr_capacity(count), arr_size(count) { allocate(count); fill(_val); }
+	dynamic_array() : dynamic_array(Allocator()) {}
+	explicit dynamic_array(const Allocator& _alloc)
+		: alloc(_alloc), arr(inline_data()), arr_capacity(InlineCapacity), arr_size(0) {}
+	explicit dynamic_array(size_type count, const Allocator& _alloc = Allocator())
+		: dynamic_array(_alloc) { resize(count); }
+	dynamic_array(size_type count, const value_type& _val, const Allocator& _alloc = Allocator())
+		: dynamic_array(_alloc) { resize(count, _val); }
 	dynamic_array(const dynamic_array& _other)
-		: arr_capacity(_other.arr_capacity), arr_size(_other.arr_size) { 
-		allocate(arr_capacity);
-		std::copy(_other.arr, _other.arr + _other.arr_size, arr);
-	}
-	dynamic_array(dynamic_array&& _other)
-		: arr_capacity(std::move(_other.arr_capacity)), arr_size(std::move(_other.arr_size)) {
-		allocate(arr_capacity);
-		std::move(_other.arr, _other.arr + arr_size, arr);
-	}
-	dynamic_array(std::initializer_list<value_type> ilist)
-		: arr_capacity(ilist.size()), arr_size(ilist.size()) {
-		allocate(arr_capacity);
-		std::move(ilist.begin(), ilist.end(), arr);
+		: dynamic_array(_other, alloc_traits::select_on_container_copy_construction(_other.alloc)) {}
+	dynamic_array(const dynamic_array& _other, const Allocator& _alloc)
+		: dynamic_array(_alloc) {
+		reserve(_other.arr_size);
+		std::uninitialized_copy(_other.arr, _other.arr + _other.arr_size, arr);
+		arr_size = _other.arr_size;
+	}
+	dynamic_array(dynamic_array&& _other) noexcept(!InlineCapacity || std::is_nothrow_move_constructible<Ty>::value)
+		: alloc(std::move(_other.alloc)), arr(inline_data()), arr_capacity(InlineCapacity), arr_size(0) {
+		steal(_other);
+	}
+	dynamic_array(std::initializer_list<value_type> ilist, const Allocator& _alloc = Allocator())
+		: dynamic_array(_alloc) {
+		reserve(ilist.size());
+		std::uninitialized_copy(ilist.begin(), ilist.end(), arr);
+		arr_size = ilist.size();
 	}
 	~dynamic_array() { destroy(); }
 	dynamic_array& operator=(const dynamic_array& _other) { // copy-assign
-		if (this != &_other)
-			dynamic_array<value_type>(_other).swap(*this);
+		if (this != &_other) {
+			if (alloc_traits::propagate_on_container_copy_assignment::value && !(alloc == _other.alloc)) {
+				destroy();
+				arr = inline_data(); arr_capacity = InlineCapacity;
+				alloc = _other.alloc;
+			}
+			assign(_other.arr, _other.arr + _other.arr_size);
+		}
 		return *this;
 	}
 	dynamic_array& operator=(dynamic_array&& _other) { // move-assign
-		destroy();
-		arr = _other.arr;
-		_other.arr = nullptr;
+		if (this == &_other) return *this;
+		if (alloc_traits::propagate_on_container_move_assignment::value || alloc == _other.alloc) {
+			destroy();
+			arr = inline_data(); arr_capacity = InlineCapacity; arr_size = 0;
+			if (alloc_traits::propagate_on_container_move_assignment::value) alloc = std::move(_other.alloc);
+			steal(_other);
+		}
+		else { // unequal non-propagating allocators, move element-wise
+			clear();
+			reserve(_other.arr_size);
+			std::uninitialized_copy(std::make_move_iterator(_other.arr), std::make_move_iterator(_other.arr + _other.arr_size), arr);
+			arr_size = _other.arr_size;
+			_other.clear();
+		}
 		return *this;
 	}
+	allocator_type get_allocator() const { return alloc; }
 	// CAPACITY
-	bool empty() const noexcept { return arr_size; }
+	bool empty() const noexcept { return !arr_size; }
 	size_type size() const noexcept { return arr_size; }
+	size_type max_size() const noexcept { return alloc_traits::max_size(alloc); }
 	size_type capacity() const noexcept { return arr_capacity; }
 	void reserve(size_type new_cap) { if (new_cap > arr_capacity) reallocate(new_cap); }
-	void shrink_to_fit() { if (arr_size < arr_capacity) reallocate(arr_size); }
+	void shrink_to_fit() { if (arr_size < arr_capacity && !is_inline()) reallocate(arr_size); }
 	// ELEMENT ACCESS
 	reference operator[](size_type n) { return arr[n]; }
 	const_reference operator[](size_type n) const { return arr[n]; }
@@ -234,151 +300,301 @@ public:
 		if (!(n < arr_size)) throw std::out_of_range("dynamic_array index out of bounds.");
 		return arr[n];
 	}
-	pointer data() { return &arr[0]; }
-	const_pointer data() const { return &arr[0]; }
+	pointer data() noexcept { return arr; }
+	const_pointer data() const noexcept { return arr; }
 	// MODIFIERS
-	void clear() {
-		for (size_type i = 0; i < arr_size; ++i) { // destruct each element
-			(&arr[i])->~value_type();
-		}
+	void clear() noexcept {
+		destroy_elements(arr, arr + arr_size);
 		arr_size = 0;
 	}
-	iterator erase(const_iterator pos) {	// erase element at position pos
-		size_type pos_index = std::distance(cbegin(), pos);
-		while (pos_index < arr_size - 1) {
-			std::swap(arr[pos_index], arr[pos_index + 1]);
-			++pos_index;
+	void assign(size_type count, const value_type& _val) {	// replace contents with count copies of _val
+		if (count > arr_capacity) {
+			const value_type tmp(_val);	// _val may be an element of this container
+			clear();
+			reserve(count);
+			std::uninitialized_fill_n(arr, count, tmp);
+			arr_size = count;
+			return;
 		}
-		pop_back();
-		return iterator(&arr[std::distance(cbegin(), pos)]);
-	}
-	iterator erase(const_iterator first, const_iterator last) {	// erase elements in range [first, last)
-		while (first != last) {
-			last = erase(--last);
-		}
-		return iterator(&arr[std::distance(cbegin(), first)]);
-	}
-	iterator insert(const_iterator pos, const value_type& _val) {	// insert _val at position pos
-		size_type pos_index = std::distance(cbegin(), pos);
-		size_type iter_index = arr_size;
-		push_back(_val);
-		while (iter_index > pos_index) {
-			std::swap(arr[iter_index], arr[iter_index - 1]);
-			--iter_index;
+		std::fill_n(arr, std::min(count, arr_size), _val);
+		if (count > arr_size) std::uninitialized_fill_n(arr + arr_size, count - arr_size, _val);
+		else destroy_elements(arr + count, arr + arr_size);
+		arr_size = count;
+	}
+	template<class InputIt,
+		class = std::enable_if_t<!std::is_integral<InputIt>::value>
+	> void assign(InputIt first, InputIt last) {	// replace contents with the range [first, last)
+		assign_(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+	}
+	void assign(std::initializer_list<value_type> ilist) { assign(ilist.begin(), ilist.end()); }
+	iterator erase(const_iterator pos) { return erase(pos, pos + 1); }	// erase element at position pos
+	iterator erase(const_iterator first, const_iterator last) {	// erase elements in range [first, last), shifting the tail once
+		const pointer p = arr + (first - cbegin());
+		const size_type n = static_cast<size_type>(last - first);
+		if (!n) return iterator(p);
+		const pointer old_end = arr + arr_size;
+		if (is_trivially_relocatable<Ty>::value) {
+			destroy_elements(p, p + n);
+			std::memmove(static_cast<void*>(p), static_cast<const void*>(p + n), (old_end - p - n) * sizeof(Ty));
 		}
-		return iterator(&arr[pos_index]);
-	}
-	iterator insert(const_iterator pos, value_type&& _val) {	// move-insert _val at position pos
-		size_type pos_index = std::distance(cbegin(), pos);
-		size_type iter_index = arr_size;
-		push_back(std::move(_val));
-		while (iter_index > pos_index) {
-			std::swap(arr[iter_index], arr[iter_index - 1]);
-			--iter_index;
+		else {
+			std::move(p + n, old_end, p);
+			destroy_elements(old_end - n, old_end);
 		}
-		return iterator(&arr[pos_index]);
+		arr_size -= n;
+		return iterator(p);
 	}
+	iterator insert(const_iterator pos, const value_type& _val) { return emplace(pos, _val); }	// insert _val at position pos
+	iterator insert(const_iterator pos, value_type&& _val) { return emplace(pos, std::move(_val)); }	// move-insert _val at position pos
 	iterator insert(const_iterator pos, size_type count, const value_type& _val) {	// insert count copies of _val at position pos
-		while (count) {
-			pos = insert(pos, _val);
-			--count;
+		const size_type index = static_cast<size_type>(pos - cbegin());
+		if (!count) return iterator(arr + index);
+		const value_type tmp(_val);	// _val may be an element of this container
+		return iterator(insert_gap(index, count, [count, &tmp](pointer gap) { std::uninitialized_fill_n(gap, count, tmp); }));
+	}
+	template<class InputIt,
+		class = std::enable_if_t<!std::is_integral<InputIt>::value>
+	> iterator insert(const_iterator pos, InputIt first, InputIt last) {	// insert range of elements in [first, last) at position pos
+		return insert_(static_cast<size_type>(pos - cbegin()), first, last, typename std::iterator_traits<InputIt>::iterator_category());
+	}
+	iterator insert(const_iterator pos, std::initializer_list<value_type> ilist) { return insert(pos, ilist.begin(), ilist.end()); }
+	template<class... Args>
+	iterator emplace(const_iterator pos, Args&&... args) {	// construct element in-place at position pos
+		const size_type index = static_cast<size_type>(pos - cbegin());
+		if (index == arr_size) { emplace_back(std::forward<Args>(args)...); return iterator(arr + index); }
+		value_type tmp(std::forward<Args>(args)...);	// args may refer to elements of this container
+		return iterator(insert_gap(index, 1, [this, &tmp](pointer gap) { alloc_traits::construct(alloc, gap, std::move(tmp)); }));
+	}
+	void push_back(const value_type& _val) { emplace_back(_val); }	// push _val to back of container
+	void push_back(value_type&& _val) { emplace_back(std::move(_val)); }	// push _val to back of container via move-semantics
+	template<class... Args>
+	reference emplace_back(Args&&... args) {	// construct element in-place at back of container
+		if (arr_size == arr_capacity) {
+			// construct the new element in the new storage before relocating, such that
+			// args may refer to elements of this container
+			const size_type new_cap = grown_capacity(arr_size + 1);
+			pointer tmp = alloc_traits::allocate(alloc, new_cap);
+			try { alloc_traits::construct(alloc, tmp + arr_size, std::forward<Args>(args)...); }
+			catch (...) { alloc_traits::deallocate(alloc, tmp, new_cap); throw; }
+			try { relocate(arr, arr_size, tmp); }
+			catch (...) {
+				alloc_traits::destroy(alloc, tmp + arr_size);
+				alloc_traits::deallocate(alloc, tmp, new_cap);
+				throw;
+			}
+			release();
+			arr = tmp;
+			arr_capacity = new_cap;
 		}
-		return iterator(&arr[std::distance(cbegin(), pos)]);
-	}
-	template<class InputIt>
-	iterator insert(const_iterator pos, InputIt first, InputIt last) {	// insert range of elements in [first, last) at position pos
-		while (last != first) pos = insert(pos, *(--last));
-		return iterator(&arr[std::distance(cbegin(), pos)]);
-	}
-	void push_back(const value_type& _val) {	// push _val to back of container
-		// if size of container has reached capacity perform
-		// reallocation to larger storage 
-		if (arr_size == arr_capacity) reallocate((arr_capacity != 0) ? arr_capacity * 2 : 8);
-		// use placement-new to push back _val
-		pointer val = new (arr + arr_size) value_type(_val);
-		++arr_size;
-	}
-	void push_back(value_type&& _val) {		// push _val to back of container via move-semantics
-		// if size of container has reached capacity perform
-		// reallocation to larger storage 
-		if (arr_size == arr_capacity) reallocate((arr_capacity != 0) ? arr_capacity * 2 : 8);
-		// use placement-new to push back _val
-		pointer val = new (arr + arr_size) value_type(std::move(_val));
-		++arr_size;
+		else alloc_traits::construct(alloc, arr + arr_size, std::forward<Args>(args)...);
+		return arr[arr_size++];
 	}
 	void pop_back() {	// remove last element of container
-		(&arr[arr_size - 1])->~value_type();	// destruct last element
+		alloc_traits::destroy(alloc, arr + arr_size - 1);	// destruct last element
 		--arr_size;
 	}
 	void resize(size_type count) {	// resize container to contain count elements
-		if (count == arr_size) return;
-		size_type tmp_size_cpy = arr_size;
-		if (count > arr_size) { // expand container
-			reallocate(count); // reallocate storage to count elements
-							   // push back count - arr_size default-constructed values
-			for (size_type i = 0; i < count - tmp_size_cpy; ++i)
-				push_back(std::move(value_type()));
+		if (count > arr_size) { // expand container with value-initialised elements
+			reserve(count);
+			for (; arr_size < count; ++arr_size) alloc_traits::construct(alloc, arr + arr_size);
 		}
-		else if (count < arr_size) { // contract container
-									 // pop back size() - count elements
-			for (size_type i = 0; i < tmp_size_cpy - count; ++i)
-				pop_back();
+		else { // contract container
+			destroy_elements(arr + count, arr + arr_size);
+			arr_size = count;
 		}
 	}
 	void resize(size_type count, const value_type& _val) {	// resize container where extra values take value _val
-		if (count == arr_size) return;
-		size_type tmp_size_cpy = arr_size;
-		if (count > arr_size) { // expand container
-			reallocate(count); // realloc storage to count elements
-							   // push back count - arr_size copies of _val
-			for (size_type i = 0; i < count - tmp_size_cpy; ++i)
-				push_back(_val);
+		if (count > arr_size) { // expand container with copies of _val
+			if (count > arr_capacity) {
+				const value_type tmp(_val);	// _val may be an element of this container
+				reserve(count);
+				for (; arr_size < count; ++arr_size) alloc_traits::construct(alloc, arr + arr_size, tmp);
+			}
+			else for (; arr_size < count; ++arr_size) alloc_traits::construct(alloc, arr + arr_size, _val);
 		}
-		else if (count < arr_size) { // contract container
-									 // pop back size() - count elements
-			for (size_type i = 0; i < tmp_size_cpy - count; ++i)
-				pop_back();
+		else { // contract container
+			destroy_elements(arr + count, arr + arr_size);
+			arr_size = count;
 		}
 	}
 	void swap(dynamic_array& _other) {	// exchange contents of container with those of _other
-		std::swap(arr, _other.arr);
-		std::swap(arr_capacity, _other.arr_capacity);
-		std::swap(arr_size, _other.arr_size);
+		if (!is_inline() && !_other.is_inline()) {
+			using std::swap;
+			if (alloc_traits::propagate_on_container_swap::value) swap(alloc, _other.alloc);
+			std::swap(arr, _other.arr);
+			std::swap(arr_capacity, _other.arr_capacity);
+			std::swap(arr_size, _other.arr_size);
+		}
+		else {	// inline elements live inside the objects and must be moved
+			dynamic_array tmp(std::move(_other));
+			_other = std::move(*this);
+			*this = std::move(tmp);
+		}
 	}
 	static void swap(dynamic_array& lhs, dynamic_array& rhs) { lhs.swap(rhs); }
 	// ITERATORS
-	iterator begin() const noexcept { return iterator(&arr[0]); }
-	iterator end() const noexcept { return iterator(&arr[arr_size]); }
-	const_iterator cbegin() const noexcept { return const_iterator(&arr[0]); }
-	const_iterator cend() const noexcept { return const_iterator(&arr[arr_size]); }
-	reverse_iterator rbegin() const noexcept { return reverse_iterator(&arr[0]); }
-	reverse_iterator rend() const noexcept { return reverse_iterator(&arr[arr_size]); }
-	const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(&arr[0]); }
-	const_reverse_iterator crend() const noexcept { return const_reverse_iterator(&arr[arr_size]); }
+	iterator begin() const noexcept { return iterator(arr); }
+	iterator end() const noexcept { return iterator(arr + arr_size); }
+	const_iterator cbegin() const noexcept { return const_iterator(arr); }
+	const_iterator cend() const noexcept { return const_iterator(arr + arr_size); }
+	reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+	reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+	const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+	const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
 private:
+	allocator_type alloc;
+	dynamic_array_impl::inline_storage<Ty, InlineCapacity> inline_buf;
 	value_type* arr;
 	size_type arr_capacity;
 	size_type arr_size;
-	void allocate(size_type n) {	// dynamically allocate memory to array
-		arr = new value_type[n];
-	}
-	void reallocate(size_type new_cap) {	// rellocate array memory to new_cap block
-		value_type* tmp = new value_type[new_cap];	// allocate temp array
-		size_type tmp_rows = (new_cap > arr_capacity) ? arr_capacity : new_cap;
-		// move all elements from arr to temp array
-		for (size_type i = 0; i < tmp_rows; ++i)
-			tmp[i] = std::move(arr[i]);
-		delete[] arr; // deallocate arr
-		arr = tmp; // reassign arr to tmp
-		arr_capacity = new_cap;
-	}
-	void destroy() {	// deallocate array memory
-		delete[] arr;
-	}
-	void fill(const value_type& _val) {	// fill array with _val
-		for (size_type i = 0; i < arr_size; ++i)
-			arr[i] = _val;
+	pointer inline_data() noexcept { return inline_buf.data(); }
+	bool is_inline() const noexcept { return InlineCapacity && arr == const_cast<dynamic_array*>(this)->inline_data(); }
+	size_type grown_capacity(size_type min_cap) const noexcept {	// geometric growth by 1.5, at least 8
+		const size_type grown = arr_capacity + arr_capacity / 2;
+		return std::max(std::max(grown, min_cap), static_cast<size_type>(8));
+	}
+	// construct n elements at uninitialised dst from those at src, by memcpy if Ty is trivially relocatable (the
+	// originals then must not be destroyed) and by move_if_noexcept otherwise; constructs none if this throws
+	void transfer(pointer src, size_type n, pointer dst) {
+		if (is_trivially_relocatable<Ty>::value) {
+			if (n) std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(Ty));
+			return;
+		}
+		size_type i = 0;
+		try { for (; i < n; ++i) alloc_traits::construct(alloc, dst + i, std::move_if_noexcept(src[i])); }
+		catch (...) { destroy_elements(dst, dst + i); throw; }
+	}
+	void relocate(pointer src, size_type n, pointer dst) {	// move n elements from src to uninitialised dst, ending src lifetimes; src is unchanged if this throws
+		transfer(src, n, dst);
+		if (!is_trivially_relocatable<Ty>::value) destroy_elements(src, src + n);
+	}
+	void reallocate(size_type new_cap) {	// relocate elements to storage of new_cap elements, new_cap >= size()
+		pointer tmp = (new_cap <= InlineCapacity) ? inline_data() : alloc_traits::allocate(alloc, new_cap);
+		if (tmp == arr) return;	// already inline
+		try { relocate(arr, arr_size, tmp); }
+		catch (...) { if (tmp != inline_data()) alloc_traits::deallocate(alloc, tmp, new_cap); throw; }
+		release();
+		arr = tmp;
+		arr_capacity = (tmp == inline_data()) ? InlineCapacity : new_cap;
+	}
+	// insert n elements at index, constructed by construct(p) at uninitialised p (constructing none if it throws),
+	// reallocating at most once; the container is unchanged if this throws
+	template<class Construct>
+	pointer insert_gap(size_type index, size_type n, Construct construct) {
+		// the tail is shifted in place only if that cannot throw, else the elements are copied to new storage
+		if (arr_size + n > arr_capacity || !(is_trivially_relocatable<Ty>::value || std::is_nothrow_move_constructible<Ty>::value)) {
+			const size_type new_cap = (arr_size + n > arr_capacity) ? grown_capacity(arr_size + n) : arr_capacity;
+			pointer tmp = alloc_traits::allocate(alloc, new_cap);
+			try { construct(tmp + index); }
+			catch (...) { alloc_traits::deallocate(alloc, tmp, new_cap); throw; }
+			try {
+				transfer(arr, index, tmp);
+				try { transfer(arr + index, arr_size - index, tmp + index + n); }
+				catch (...) { destroy_elements(tmp, tmp + index); throw; }
+			}
+			catch (...) {
+				destroy_elements(tmp + index, tmp + index + n);
+				alloc_traits::deallocate(alloc, tmp, new_cap);
+				throw;
+			}
+			if (!is_trivially_relocatable<Ty>::value) destroy_elements(arr, arr + arr_size);
+			release();
+			arr = tmp;
+			arr_capacity = new_cap;
+		}
+		else {
+			open_gap(index, n);
+			try { construct(arr + index); }
+			catch (...) { close_gap(index, n); throw; }
+		}
+		arr_size += n;
+		return arr + index;
+	}
+	void open_gap(size_type index, size_type n) noexcept {	// shift the tail up by n in place, Ty is trivially relocatable or nothrow movable
+		if (is_trivially_relocatable<Ty>::value) {
+			std::memmove(static_cast<void*>(arr + index + n), static_cast<const void*>(arr + index), (arr_size - index) * sizeof(Ty));
+		}
+		else {	// relocate the tail up, backwards, such that each destination is uninitialised or already vacated
+			for (size_type i = arr_size; i-- > index;) {
+				alloc_traits::construct(alloc, arr + i + n, std::move(arr[i]));
+				alloc_traits::destroy(alloc, arr + i);
+			}
+		}
+	}
+	void close_gap(size_type index, size_type n) noexcept {	// undo open_gap(index, n) after a failed construction
+		if (is_trivially_relocatable<Ty>::value) {
+			std::memmove(static_cast<void*>(arr + index), static_cast<const void*>(arr + index + n), (arr_size - index) * sizeof(Ty));
+		}
+		else {
+			for (size_type i = index; i < arr_size; ++i) {
+				alloc_traits::construct(alloc, arr + i, std::move(arr[i + n]));
+				alloc_traits::destroy(alloc, arr + i + n);
+			}
+		}
+	}
+	template<class InputIt>
+	void assign_(InputIt first, InputIt last, std::input_iterator_tag) {
+		clear();
+		for (; first != last; ++first) emplace_back(*first);
+	}
+	template<class ForwardIt>
+	void assign_(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+		const size_type count = static_cast<size_type>(std::distance(first, last));
+		if (count > arr_capacity) {
+			clear();
+			reserve(count);
+			std::uninitialized_copy(first, last, arr);
+			arr_size = count;
+			return;
+		}
+		ForwardIt mid = first;
+		std::advance(mid, std::min(count, arr_size));
+		std::copy(first, mid, arr);
+		if (count > arr_size) std::uninitialized_copy(mid, last, arr + arr_size);
+		else destroy_elements(arr + count, arr + arr_size);
+		arr_size = count;
+	}
+	template<class InputIt>
+	iterator insert_(size_type index, InputIt first, InputIt last, std::input_iterator_tag) {
+		// single pass range, append then rotate into position
+		const size_type old_size = arr_size;
+		for (; first != last; ++first) emplace_back(*first);
+		std::rotate(arr + index, arr + old_size, arr + arr_size);
+		return iterator(arr + index);
+	}
+	template<class ForwardIt>
+	iterator insert_(size_type index, ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+		const size_type count = static_cast<size_type>(std::distance(first, last));
+		if (!count) return iterator(arr + index);
+		return iterator(insert_gap(index, count, [first, last](pointer gap) { std::uninitialized_copy(first, last, gap); }));
+	}
+	void steal(dynamic_array& _other) {	// take contents of _other into this empty, inline array
+		if (_other.is_inline()) {
+			relocate(_other.arr, _other.arr_size, arr);
+			arr_size = _other.arr_size;
+		}
+		else {
+			arr = _other.arr;
+			arr_capacity = _other.arr_capacity;
+			arr_size = _other.arr_size;
+			_other.arr = _other.inline_data();
+			_other.arr_capacity = InlineCapacity;
+		}
+		_other.arr_size = 0;
+	}
+	void destroy_elements(pointer first, pointer last) noexcept {
+		if (!std::is_trivially_destructible<Ty>::value)
+			for (; first != last; ++first) alloc_traits::destroy(alloc, first);
+	}
+	void release() noexcept {	// deallocate heap storage without destroying elements
+		if (arr && !is_inline()) alloc_traits::deallocate(alloc, arr, arr_capacity);
+	}
+	void destroy() noexcept {	// destroy elements and deallocate array memory
+		clear();
+		release();
 	}
 };
+template<typename Ty, class Allocator, std::size_t InlineCapacity>
+constexpr typename dynamic_array<Ty, Allocator, InlineCapacity>::size_type dynamic_array<Ty, Allocator, InlineCapacity>::inline_capacity;
 
-#endif // !DYNAMIC_ARRAY_H
\ No newline at end of file
+#endif // !DYNAMIC_ARRAY_H
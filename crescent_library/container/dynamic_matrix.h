@@ -1,6 +1,8 @@
 #ifndef DYNAMIC_MATRIX_H
 #define DYNAMIC_MATRIX_H
+#include "matrix_kernels.h"
 #include "sfinae_operators.h"
+#include "threading_utilities.h"
 #include <algorithm>
 #include <iterator>
 #include <ostream>
@@ -688,8 +690,7 @@ namespace crsc {
 		 * \param _val Value to initialise all elements of the newly inserted column with.
 		 * \return Iterator pointing to the first element inserted.
 		 * \throw Throws `std::invalid_argument` exception if `_col_pos > columns()`.
-		 * \complexity Linear in `rows()` multiplied by linear in distance between `_col_pos` and 
-		 *             `end` of the container.
+		 * \complexity Linear in `rows()*columns()`.
 		 * \exceptionsafety Strong guarantee - if an exception is thrown there are no changes
 		 *                  in the container.
 		 */
@@ -715,8 +716,7 @@ namespace crsc {
 		 * \return Iterator pointing to the first element inserted.
 		 * \throw Throws `std::out_of_range` exception, `std::invalid_argument` exception 
 		 *        if `_col_pos > columns() || _col_vec.size() != rows()`, respectively.
-		 * \complexity Linear in `rows()` multiplied by linear in distance
-		 *             between `_cols_pos` and `end` of the container.
+		 * \complexity Linear in `rows()*columns()`.
 		 * \exceptionsafety Strong guarantee - if an exception is thrown there are no changes
 		 *                  in the container.
 		 */
@@ -727,18 +727,8 @@ namespace crsc {
 				throw std::out_of_range("_col_pos must be <= current value of columns().");
 			if (_col_vec.size() != rows_)
 				throw std::invalid_argument("_col_vec.size() must = current value of rows().");
-			iterator rtn; // val to return
-			// no. of elements in _col_vec matches row size, insert each value of
-			// _col_vec sequentially into new column of matrix
-			for (size_type i = 0; i < _col_vec.size(); ++i) {
-				// insert i'th el. of _col_vec at position offset from
-				// beginning by row, col position plus loop index to take
-				// account for extra values inserted on previous iteration
-				if (!i) rtn = mtx.insert(mtx.cbegin() + i*(cols_ + 1) + _col_pos, _col_vec[i]);
-				else mtx.insert(mtx.cbegin() + i*(cols_ + 1) + _col_pos, _col_vec[i]);
-			}
-			++cols_;
-			return rtn;
+			std::vector<value_type> fresh(_col_vec);
+			return rebuild_with_columns(_col_pos, 1U, fresh, rows_);
 		}
 		/**
 		 * \brief Inserts a column vector to the position one slot before `_col_pos` using move-semantics.
@@ -756,10 +746,7 @@ namespace crsc {
 		 * \return Iterator pointing the the first element inserted.
 		 * \throw Throws `std::out_of_range` exception, `std::invalid_argument` exception
 		 *        if `_col_pos > columns() || _col_vec.size() > rows()`, respectively.
-		 * \complexity If `_col_vec.size() == rows()` then linear in `rows()` multiplied by linear in distance
-		 *             between `_cols_pos` and `end` of the container, else if `_col_vec.size() < rows()` then
-		 *             linear in `rows()` multiplied by linear in distance between `_col_pos` and `end` of the 
-		 *             container plus linear in `rows() - _col_vec.size()`.
+		 * \complexity Linear in `rows()*columns()` plus linear in `rows() - _col_vec.size()`.
 		 * \exceptionsafety Strong guarantee - if an exception is thrown there are no changes
 		 *                  in the container.
 		 */
@@ -770,16 +757,64 @@ namespace crsc {
 				throw std::out_of_range("_col_pos must be <= current value of columns().");
 			if (_col_vec.size() > rows_)
 				throw std::invalid_argument("_col_vec.size() must be <= current value of rows().");
-			iterator rtn; // val to return
 			if (_col_vec.size() < rows_)
 				_col_vec.resize(rows_);
-			// move-insert _col_vec contents to specified column position
-			for (size_type i = 0; i < _col_vec.size(); ++i) {
-				if (!i) rtn = mtx.insert(mtx.cbegin() + i*(cols_ + 1) + _col_pos, std::move(_col_vec[i]));
-				else mtx.insert(mtx.cbegin() + i*(cols_ + 1) + _col_pos, std::move(_col_vec[i]));
+			return rebuild_with_columns(_col_pos, 1U, _col_vec, rows_);
+		}
+		/**
+		 * \brief Inserts `_count` columns, each element of which is initialised with `_val`, to the
+		 *        position one slot before `_col_pos`.
+		 *
+		 * All columns are inserted in a single pass over the container, inserting `n` columns this way
+		 * is therefore `n` times cheaper than `n` calls to `insert_column`.
+		 *
+		 * \param _col_pos Position one slot after insertion point.
+		 * \param _count Number of columns to insert.
+		 * \param _val Value to initialise all elements of the newly inserted columns with.
+		 * \return Iterator pointing to the first element inserted, or `end()` if `rows() == 0`.
+		 * \throw Throws `std::out_of_range` exception if `_col_pos > columns()`.
+		 * \complexity Linear in `rows()*(columns() + _count)`.
+		 * \exceptionsafety Strong guarantee - if an exception is thrown there are no changes
+		 *                  in the container.
+		 */
+		template<class Uty = Ty,
+			class = std::enable_if_t<std::is_copy_assignable<Uty>::value>
+		> iterator insert_columns(size_type _col_pos, size_type _count, const value_type& _val) {
+			if (_col_pos > cols_)
+				throw std::out_of_range("_col_pos must be <= current value of columns().");
+			std::vector<value_type> fresh(rows_*_count, _val);
+			return rebuild_with_columns(_col_pos, _count, fresh, rows_);
+		}
+		/**
+		 * \brief Inserts all columns of `_cols_mtx` to the position one slot before `_col_pos`.
+		 *
+		 * All columns are inserted in a single pass over the container. This is the preferred way of
+		 * building a matrix column-by-column: gather a batch of columns into `_cols_mtx` and append
+		 * them via `push_columns`, rather than calling `push_column` once per column.
+		 *
+		 * \param _col_pos Position one slot after insertion point.
+		 * \param _cols_mtx Container of columns to insert, if this container has no rows and no columns
+		 *        then it takes the number of rows of `_cols_mtx`.
+		 * \return Iterator pointing to the first element inserted, or `end()` if `rows() == 0`.
+		 * \throw Throws `std::out_of_range` exception, `std::invalid_argument` exception if
+		 *        `_col_pos > columns() || _cols_mtx.rows() != rows()`, respectively.
+		 * \complexity Linear in `rows()*(columns() + _cols_mtx.columns())`.
+		 * \exceptionsafety Strong guarantee - if an exception is thrown there are no changes
+		 *                  in the container.
+		 */
+		template<class Uty = Ty,
+			class = std::enable_if_t<std::is_copy_assignable<Uty>::value>
+		> iterator insert_columns(size_type _col_pos, const dynamic_matrix& _cols_mtx) {
+			if (_col_pos > cols_)
+				throw std::out_of_range("_col_pos must be <= current value of columns().");
+			if (!rows_ && !cols_) {
+				std::vector<value_type> fresh(_cols_mtx.mtx.begin(), _cols_mtx.mtx.end());
+				return rebuild_with_columns(0U, _cols_mtx.cols_, fresh, _cols_mtx.rows_);
 			}
-			++cols_;
-			return rtn;
+			if (_cols_mtx.rows_ != rows_)
+				throw std::invalid_argument("_cols_mtx.rows() must = current value of rows().");
+			std::vector<value_type> fresh(_cols_mtx.mtx.begin(), _cols_mtx.mtx.end());
+			return rebuild_with_columns(_col_pos, _cols_mtx.cols_, fresh, rows_);
 		}
 		/**
 		 * \brief Erases a row vector at `_row_pos`.
@@ -808,24 +843,46 @@ namespace crsc {
 		 * \return Iterator following the last removed element, i.e. the iterator pointing
 		 *         to the next element along from the last row of the erased column.
 		 * \throw Throws `std::out_of_range` exception if `!(_col_pos < columns())`.
-		 * \complexity Linear in `rows()` multiplied by linearly decreasing factor given
-		 *             by distance between each element in column and `end` of container.
-		 * \exceptionsafety Strong guarantee - if an exception is thrown there are no changes
-		 *                  in the container.
+		 * \complexity Linear in `rows()*columns()`.
+		 * \exceptionsafety See `erase_columns`.
 		 */
 		template<class Uty = Ty,
 			class = std::enable_if_t<std::is_move_assignable<Uty>::value>
 		> iterator erase_column(size_type _col_pos) {
 			if (!(_col_pos < cols_))
 				throw std::out_of_range("_col_pos must be < current value of columns().");
-			iterator rtn;
-			// erase el. of mtx at position offset from beginning by
-			// row, col position minus loop index to take account for
-			// values erased on previous iteration
-			for (size_type i = 0; i < rows_; ++i)
-				rtn = mtx.erase(mtx.cbegin() + i*(cols_ - 1) + _col_pos);
-			--cols_;
-			return rtn;
+			return erase_columns(_col_pos, 1U);
+		}
+		/**
+		 * \brief Erases the `_count` column vectors starting at `_col_pos` in a single pass over the container.
+		 *
+		 * \param _col_pos Position of first column to remove.
+		 * \param _count Number of columns to remove.
+		 * \return Iterator following the last removed element, i.e. the iterator pointing
+		 *         to the next element along from the last row of the erased columns.
+		 * \throw Throws `std::out_of_range` exception if `_col_pos + _count > columns()`.
+		 * \complexity Linear in `rows()*columns()`.
+		 * \exceptionsafety Basic guarantee if the move-assignment of `Ty` may throw, otherwise no-throw
+		 *                  guarantee once the range has been checked.
+		 */
+		template<class Uty = Ty,
+			class = std::enable_if_t<std::is_move_assignable<Uty>::value>
+		> iterator erase_columns(size_type _col_pos, size_type _count) {
+			if (_col_pos > cols_ || _count > cols_ - _col_pos)
+				throw std::out_of_range("_col_pos + _count must be <= current value of columns().");
+			const size_type new_cols = cols_ - _count;
+			if (_count && rows_) {
+				// compact each row towards the front, the head of the first row is already in place
+				auto out = mtx.begin() + _col_pos;
+				for (size_type i = 0; i < rows_; ++i) {
+					auto row = mtx.begin() + i*cols_;
+					if (i) out = std::move(row, row + _col_pos, out);
+					out = std::move(row + _col_pos + _count, row + cols_, out);
+				}
+				mtx.erase(out, mtx.end());
+			}
+			cols_ = new_cols;
+			return rows_ ? mtx.begin() + (rows_ - 1)*new_cols + _col_pos : mtx.end();
 		}
 		/**
 		 * \brief Assigns the given value `_val` to all elements in the container.
@@ -839,6 +896,22 @@ namespace crsc {
 		> void fill(const value_type& _val) noexcept {
 			std::fill(mtx.begin(), mtx.end(), _val);
 		}
+		/**
+		 * \brief Assigns the given value `_val` to all elements in the container, splitting the
+		 *        assignments across threads according to `policy`.
+		 *
+		 * \param policy Execution policy to use.
+		 * \param _val Value to assign to all elements.
+		 * \complexity Exactly `rows()*columns()` assignments.
+		 * \exceptionsafety Basic-guarantee, may throw `std::system_error` if a thread cannot be started.
+		 */
+		template<class Uty = Ty,
+			class = std::enable_if_t<std::is_copy_assignable<Uty>::value>
+		> void fill(const execution::parallel_policy& policy, const value_type& _val) {
+			parallel_for(policy, 0U, mtx.size(), [this, &_val](size_type first, size_type last) {
+				std::fill(mtx.begin() + first, mtx.begin() + last, _val);
+			});
+		}
 		/**
 		 * \brief Pushes an extra row-vector to the back of the container where each element
 		 *        in the inserted row will have the specified value `_val`.
@@ -919,6 +992,35 @@ namespace crsc {
 				mtx.push_back(std::move(el));
 			++rows_;
 		}
+		/**
+		 * \brief Pushes the rows of the row-major block of values `[first, last)` to the back of the
+		 *        container, i.e. `std::distance(first, last)/columns()` rows in a single insertion.
+		 *
+		 * Prefer this to repeated `push_row` calls when appending many rows, such as from a parser, as no
+		 * intermediate row-vectors are constructed. Combined with `reserve` no reallocation occurs.
+		 *
+		 * \param first Iterator to the first value of the block.
+		 * \param last Iterator past the last value of the block.
+		 * \throw Throws `std::invalid_argument` exception if `std::distance(first, last)` is not a multiple of
+		 *        `columns()`, or is non-zero while `columns() == 0`.
+		 * \complexity Amortized linear in `std::distance(first, last)`.
+		 * \exceptionsafety If an exception is thrown there are no changes in the container, unless `Ty`'s
+		 *                  move constructor throws, see `push_row`.
+		 */
+		template<class InputIt,
+			class Uty = Ty,
+			class = std::enable_if_t<std::is_copy_assignable<Uty>::value>
+		> void push_rows(InputIt first, InputIt last) {
+			const size_type old_size = mtx.size();
+			mtx.insert(mtx.end(), first, last);
+			const size_type added = mtx.size() - old_size;
+			if (!added) return;
+			if (!cols_ || added % cols_) {
+				mtx.erase(mtx.begin() + old_size, mtx.end());
+				throw std::invalid_argument("number of values pushed must be a multiple of the current value of columns().");
+			}
+			rows_ += added/cols_;
+		}
 		/**
 		 * \brief Pushes an extra column-vector to the back of the container where each element
 		 *        in the inserted column will have the specified value `_val`.
@@ -976,6 +1078,20 @@ namespace crsc {
 		> void push_column(std::vector<value_type>&& _col_vec = std::vector<value_type>()) { 
 			insert_column(cols_, std::move(_col_vec)); 
 		}
+		/**
+		 * \brief Pushes all columns of `_cols_mtx` to the back of the container in a single pass.
+		 *
+		 * \remark Equivalent to `insert_columns(columns(), _cols_mtx)`.
+		 * \param _cols_mtx Container of columns to append.
+		 * \throw Throws `std::invalid_argument` exception if `_cols_mtx.rows() != rows()` and this
+		 *        container is not `empty()`.
+		 * \complexity Linear in `rows()*(columns() + _cols_mtx.columns())`.
+		 * \exceptionsafety Strong guarantee - if an exception is thrown there are no changes
+		 *                  in the container.
+		 */
+		template<class Uty = Ty,
+			class = std::enable_if_t<std::is_copy_assignable<Uty>::value>
+		> void push_columns(const dynamic_matrix& _cols_mtx) { insert_columns(cols_, _cols_mtx); }
 		/**
 		 * \brief Pops the last row from the back of the container.
 		 *
@@ -993,8 +1109,7 @@ namespace crsc {
 		 * \brief Pops the last column from the back of the container.
 		 *
 		 * \remark Equivalent to `erase_columns(columns() - 1)`.
-		 * \complexity Linear in `rows()` multiplied by linearly decreasing factor given
-		 *             by distance between each element in column and `end` of container.
+		 * \complexity Linear in `rows()*columns()`.
 		 * \exceptionsafety No-throw guarantee unless an exception is thrown by the copy constructor, 
 		 *                  move constructor, copy-assignment operator or move-assignment operator of
 		 *                  `Ty`.
@@ -1071,27 +1186,19 @@ namespace crsc {
 		 * does nothing.
 		 *
 		 * \param _cols New number of columns in the container.
-		 * \complexity If `_cols > columns()` then linear in `|_cols - columns()|` multiplied by amortized
-		 *             linear in `rows()`, else if `_cols < columns()` then linear in `|columns() - _cols|`
-		 *             multiplied by complexity of `pop_column()`.
-		 * \exceptionsafety If `_cols > columns()` then no-throw guarantee, else if `_cols < columns()`
-		 *                  and the container is `empty()` then undefined behaviour otherwise no-throw
-		 *                  guarantee.
+		 * \complexity Linear in `rows()*max(columns(), _cols)`, the container is rebuilt in a single pass.
+		 * \exceptionsafety If `_cols > columns()` then strong guarantee, else see `erase_columns`.
 		 */
 		template<class Uty = Ty,
 			class = std::enable_if_t<std::is_move_assignable<Uty>::value
 				&& std::is_default_constructible<Uty>::value>
 		> void columns_resize(size_type _cols) {
-			size_type tmp_cols = cols_;
 			if (_cols == cols_) return;
 			if (_cols > cols_) {	// expand number of columns in matrix
-				for (size_type i = 0; i < (_cols - tmp_cols); ++i)
-					insert_column(cols_, std::move(std::vector<value_type>(rows_)));
-			}
-			else {	// contract number of columns in matrix
-				for (size_type i = 0; i < (tmp_cols - _cols); ++i)
-					pop_column();
+				std::vector<value_type> fresh(rows_*(_cols - cols_));
+				rebuild_with_columns(cols_, _cols - cols_, fresh, rows_);
 			}
+			else erase_columns(_cols, cols_ - _cols);	// contract number of columns in matrix
 		}
 		/**
 		 * \brief Resizes the container to contain `_cols` column vectors, with any extra values
@@ -1104,26 +1211,15 @@ namespace crsc {
 		 *
 		 * \param _cols New number of columns in the container.
 		 * \param _val Value to initialise all elements of new column vectors with (if any).
-		 * \complexity If `_cols > columns()` then linear in `|_cols - columns()|` multiplied by amortized
-		 *             linear in `rows()`, else if `_cols < columns()` then linear in `|columns() - _cols|` 
-		 *             multiplied by complexity of `pop_column()`.
-		 * \exceptionsafety If `_cols > columns()` then no-throw guarantee, else if `_cols < columns()`
-		 *                  and the container is `empty()` then undefined behaviour otherwise no-throw
-		 *                  guarantee.
+		 * \complexity Linear in `rows()*max(columns(), _cols)`, the container is rebuilt in a single pass.
+		 * \exceptionsafety If `_cols > columns()` then strong guarantee, else see `erase_columns`.
 		 */
 		template<class Uty = Ty,
 			class = std::enable_if_t<std::is_copy_assignable<Uty>::value>
 		> void columns_resize(size_type _cols, const value_type& _val) {
-			size_type tmp_cols = cols_;
 			if (_cols == cols_) return;
-			if (_cols > cols_) {	// expand number of columns in matrix
-				for (size_type i = 0; i < (_cols - tmp_cols); ++i)
-					insert_column(cols_, _val);
-			}
-			else {	// contract number of columns in matrix
-				for (size_type i = 0; i < (tmp_cols - _cols); ++i)
-					pop_column();
-			}
+			if (_cols > cols_) insert_columns(cols_, _cols - cols_, _val);	// expand number of columns in matrix
+			else erase_columns(_cols, cols_ - _cols);	// contract number of columns in matrix
 		}
 		/**
 		 * \brief Resizes the container to contain `_rows` row vectors and `_cols` column vectors where
@@ -1177,6 +1273,8 @@ namespace crsc {
 		/**
 		 * \brief Erases the specified row and column from the container, yielding the submatrix.
 		 *
+		 * \remark For read or write access to a block of the container without erasing or copying
+		 *         elements use `make_matrix_view(*this).block(...)` from `matrix_view.h`.
 		 * \param _row_index Index of row to remove.
 		 * \param _col_index Index of column to remove.
 		 * \return `*this`.
@@ -1223,6 +1321,33 @@ namespace crsc {
 		size_type rows_;
 		size_type cols_;
 		void swap(dynamic_matrix& lhs, dynamic_matrix& rhs) { lhs.swap(rhs); }
+		/**
+		 * \brief Rebuilds the storage in a single pass with the `_rows x _count` row-major block `_fresh`
+		 *        inserted as new columns before `_col_pos`.
+		 *
+		 * `_rows` is `rows()` unless the container is empty, in which case it sets the number of rows. The new
+		 * buffer is filled by moving elements if `Ty`'s move constructor is `noexcept` and by copying otherwise;
+		 * as `_fresh` is fully constructed beforehand, the container is unchanged if this throws.
+		 */
+		iterator rebuild_with_columns(size_type _col_pos, size_type _count, std::vector<value_type>& _fresh, size_type _rows) {
+			const size_type new_cols = cols_ + _count;
+			if (!_rows) {
+				cols_ = new_cols;
+				return mtx.end();
+			}
+			std::vector<value_type, allocator_type> tmp(mtx.get_allocator());
+			tmp.reserve(_rows*new_cols);
+			for (size_type i = 0; i < _rows; ++i) {
+				const size_type row = i*cols_;
+				for (size_type j = 0; j < _col_pos; ++j) tmp.push_back(std::move_if_noexcept(mtx[row + j]));
+				for (size_type k = 0; k < _count; ++k) tmp.push_back(std::move_if_noexcept(_fresh[i*_count + k]));
+				for (size_type j = _col_pos; j < cols_; ++j) tmp.push_back(std::move_if_noexcept(mtx[row + j]));
+			}
+			mtx.swap(tmp);
+			rows_ = _rows;
+			cols_ = new_cols;
+			return mtx.begin() + _col_pos;
+		}
 	};
 	/**
 	 * \brief Exchanges the contents of two `dynamic_matrix` containers, `lhs` and `rhs`.
@@ -1356,6 +1481,35 @@ namespace crsc {
 			*itsum = *itlhs + *itrhs;
 		return sum;
 	}
+	/**
+	 * \brief Returns a `dynamic_matrix` whose elements equal the component-wise addition of `lhs` and `rhs`,
+	 *        with the additions split across threads according to `policy`.
+	 *
+	 * \param policy Execution policy to use.
+	 * \param lhs First instance of `dynamic_matrix`.
+	 * \param rhs Second instance of `dynamic_matrix`.
+	 * \return Container consisting of sum of `lhs` and `rhs`.
+	 * \throw Throws `std::invalid_argument` exception if `lhs.rows() != rhs.rows() ||
+	 *        lhs.columns() != rhs.columns()`.
+	 * \complexity Linear in `rows()*columns()` (assignments) plus linear in
+	 *             `rows()*columns()` (additions).
+	 */
+	template<typename Ty,
+		class Allocator = std::allocator<Ty>
+	> dynamic_matrix<Ty, Allocator> matrix_sum(const execution::parallel_policy& policy, const dynamic_matrix<Ty, Allocator>& lhs, 
+		const dynamic_matrix<Ty, Allocator>& rhs) {
+		if (lhs.rows() != rhs.rows() || lhs.columns() != rhs.columns())
+			throw std::invalid_argument("dynamic_matrix dimensions must agree for component-wise addition.");
+		dynamic_matrix<Ty, Allocator> sum(lhs.rows(), lhs.columns());
+		const Ty* plhs = lhs.data();
+		const Ty* prhs = rhs.data();
+		Ty* psum = sum.data();
+		parallel_for(policy, 0U, sum.size(), [plhs, prhs, psum](std::size_t first, std::size_t last) {
+			for (std::size_t i = first; i < last; ++i)
+				psum[i] = plhs[i] + prhs[i];
+		});
+		return sum;
+	}
 	/**
 	 * \brief Returns a `dynamic_matrix` whose elements equal the component-wise subtraction of `rhs` from `lhs`.
 	 *
@@ -1377,9 +1531,43 @@ namespace crsc {
 			*itdiff = *itlhs - *itrhs;
 		return difference;
 	}
+	/**
+	 * \brief Returns a `dynamic_matrix` whose elements equal the component-wise subtraction of `rhs` from `lhs`,
+	 *        with the subtractions split across threads according to `policy`.
+	 *
+	 * \param policy Execution policy to use.
+	 * \param lhs First instance of `dynamic_matrix`.
+	 * \param rhs Second instance of `dynamic_matrix`.
+	 * \return Container consisting of difference of `lhs` and `rhs`.
+	 * \throw Throws `std::invalid_argument` exception if `lhs.rows() != rhs.rows() ||
+	 *        lhs.columns() != rhs.columns()`.
+	 * \complexity Linear in `rows()*columns()` (assignments) plus linear in
+	 *             `rows()*columns()` (subtractions).
+	 */
+	template<typename Ty,
+		class Allocator = std::allocator<Ty>
+	> dynamic_matrix<Ty, Allocator> matrix_difference(const execution::parallel_policy& policy, const dynamic_matrix<Ty, Allocator>& lhs, 
+		const dynamic_matrix<Ty, Allocator>& rhs) {
+		if (lhs.rows() != rhs.rows() || lhs.columns() != rhs.columns())
+			throw std::invalid_argument("dynamic_matrix dimensions must agree for component-wise subtraction.");
+		dynamic_matrix<Ty, Allocator> difference(lhs.rows(), lhs.columns());
+		const Ty* plhs = lhs.data();
+		const Ty* prhs = rhs.data();
+		Ty* pdiff = difference.data();
+		parallel_for(policy, 0U, difference.size(), [plhs, prhs, pdiff](std::size_t first, std::size_t last) {
+			for (std::size_t i = first; i < last; ++i)
+				pdiff[i] = plhs[i] - prhs[i];
+		});
+		return difference;
+	}
 	/**
 	 * \brief Returns a `dynamic_matrix` which gives the matrix product of `lhs` with `rhs`.
 	 *
+	 * For arithmetic `Ty` the product is computed by a cache-blocked kernel operating on packed copies of
+	 * `lhs` and `rhs`, with register-blocked SIMD micro-kernels for `float` and `double` where the target
+	 * supports AVX2/FMA, AVX-512 or NEON. Other types use a row-wise loop ordering which walks `rhs` and the
+	 * product along contiguous rows.
+	 *
 	 * \param lhs First instance of `dynamic_matrix`.
 	 * \param rhs Second instance of `dynamic_matrix`.
 	 * \return Container consisting of product of `lhs` and `rhs`.
@@ -1392,13 +1580,42 @@ namespace crsc {
 		if (lhs.columns() != rhs.rows())
 			throw std::invalid_argument("dynamic_matrix dimensions must agree for matrix_product.");
 		dynamic_matrix<Ty, Allocator> product(lhs.rows(), rhs.columns());
-		typedef typename dynamic_matrix<Ty, Allocator>::size_type size_type;
-		for (size_type i = 0; i < product.rows(); ++i) {
-			for (size_type j = 0; j < product.columns(); ++j) {
-				for (size_type k = 0; k < lhs.columns(); ++k)
-					product(i,j) += lhs(i,k) * rhs(k,j);
-			}
-		}
+		matrix_kernels_impl::gemm(lhs.rows(), rhs.columns(), lhs.columns(), lhs.data(), lhs.columns(),
+			rhs.data(), rhs.columns(), product.data(), product.columns());
+		return product;
+	}
+	/**
+	 * \brief Returns a `dynamic_matrix` which gives the matrix product of `lhs` with `rhs`, with blocks of
+	 *        rows of the product computed concurrently according to `policy`.
+	 *
+	 * Each thread receives a contiguous band of rows of `lhs` and the product, and runs the same kernel as
+	 * the serial `matrix_product` on its band. Bands are sized to contain at least
+	 * `matrix_kernels_impl::gemm_parallel_min_work` multiply-adds, so small products run serially.
+	 *
+	 * \param policy Execution policy to use.
+	 * \param lhs First instance of `dynamic_matrix`.
+	 * \param rhs Second instance of `dynamic_matrix`.
+	 * \return Container consisting of product of `lhs` and `rhs`.
+	 * \throw Throws `std::invalid_argument` exception if `lhs.columns() != rhs.rows()`.
+	 * \complexity Linear in `lhs.rows()*rhs.columns()*lhs.columns()`.
+	 */
+	template<typename Ty,
+		class Allocator = std::allocator<Ty>
+	> dynamic_matrix<Ty, Allocator> matrix_product(const execution::parallel_policy& policy, const dynamic_matrix<Ty, Allocator>& lhs, 
+		const dynamic_matrix<Ty, Allocator>& rhs) {
+		if (lhs.columns() != rhs.rows())
+			throw std::invalid_argument("dynamic_matrix dimensions must agree for matrix_product.");
+		dynamic_matrix<Ty, Allocator> product(lhs.rows(), rhs.columns());
+		const std::size_t n = rhs.columns();
+		const std::size_t k = lhs.columns();
+		if (!n || !k) return product;
+		const std::size_t row_grain = std::max<std::size_t>(matrix_kernels_impl::gemm_parallel_min_work / (n*k), 1U);
+		const Ty* plhs = lhs.data();
+		const Ty* prhs = rhs.data();
+		Ty* pprod = product.data();
+		parallel_for(policy, 0U, lhs.rows(), row_grain, [plhs, prhs, pprod, n, k](std::size_t first, std::size_t last) {
+			matrix_kernels_impl::gemm(last - first, n, k, plhs + first*k, k, prhs, n, pprod + first*n, n);
+		});
 		return product;
 	}
 	/**
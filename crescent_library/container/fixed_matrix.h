@@ -1,5 +1,6 @@
 #ifndef FIXED_MATRIX_H
 #define FIXED_MATRIX_H
+#include "matrix_expression.h"
 #include "sfinae_operators.h"
 #include <algorithm>
 #include <array>
@@ -37,6 +38,11 @@ namespace crsc {
 	 * \tparam Ty The type of the elements.
 	 * \tparam _Rows Number of matrix rows.
 	 * \tparam _Cols Number of matrix columns.
+	 * Element-wise arithmetic (`+`, `-`, unary `-`, scaling by a scalar) is provided through the lazily
+	 * evaluated `crsc::matrix_expression` operators. As every extent is known at compile-time, dimension
+	 * mismatches between `fixed_matrix` operands are compilation errors and the fused evaluation loop has
+	 * a constant trip count of `_Rows*_Cols`.
+	 *
 	 * \remark The dimensions of the matrix must be known at compile-time and cannot be altered at any time
 	 *         during execution. If you require a matrix-object with run-time dimension manipulation then
 	 *         use crsc::dynamic_matrix instead.
@@ -48,7 +54,7 @@ namespace crsc {
 	template<typename Ty,
 		std::size_t _Rows,
 		std::size_t _Cols
-	> class fixed_matrix {
+	> class fixed_matrix : public matrix_expression<fixed_matrix<Ty, _Rows, _Cols>> {
 	public:
 		// PUBLIC API TYPE DEFINITIONS
 		typedef Ty value_type;
@@ -142,6 +148,18 @@ namespace crsc {
 				std::advance(it, _Cols);
 			}
 		}
+		/**
+		 * \brief Constructs the container by evaluating the element-wise matrix expression `_expr`.
+		 *
+		 * \param _expr Expression to evaluate, its compile-time dimensions must agree with `_Rows, _Cols`.
+		 * \throw Throws `std::invalid_argument` exception if `_expr` involves run-time sized operands and
+		 *        its dimensions are not `_Rows, _Cols`.
+		 * \complexity Linear in `_Rows*_Cols`, each operand element is read exactly once.
+		 */
+		template<class Expr>
+		fixed_matrix(const matrix_expression<Expr>& _expr) : mtx() {
+			evaluate_expression<matrix_expression_impl::assign>(_expr.self());
+		}
 		/**
 		 * \brief Destructs the container. The destructors of the elements are called and used
 		 *        storage is deallocated.
@@ -171,6 +189,25 @@ namespace crsc {
 				swap(*this, _other);
 			return *this;
 		}
+		/**
+		 * \brief Expression-assignment operator. Replaces the contents of the container with the result
+		 *        of evaluating the element-wise matrix expression `_expr` in a single pass.
+		 *
+		 * \remark `_expr` may refer to this container. The result is evaluated in place unless `_expr`
+		 *         has a `matrix_view` operand, as each element then depends only on the elements at the
+		 *         same position in the operands. Otherwise it is evaluated into a temporary, since a view
+		 *         (e.g. a transpose) may read elements of this container which have already been overwritten.
+		 * \param _expr Expression to evaluate.
+		 * \return `*this`.
+		 * \throw Throws `std::invalid_argument` exception if `_expr` involves run-time sized operands and
+		 *        its dimensions are not `_Rows, _Cols`.
+		 */
+		template<class Expr>
+		fixed_matrix& operator=(const matrix_expression<Expr>& _expr) {
+			if (matrix_expression_impl::has_view_operand<Expr>::value) mtx = fixed_matrix(_expr).mtx;
+			else evaluate_expression<matrix_expression_impl::assign>(_expr.self());
+			return *this;
+		}
 		// CAPACITY
 		/**
 		 * \brief Checks if the container has no elements.
@@ -492,6 +529,8 @@ namespace crsc {
 		 * \brief Gets the submatrix of the container obtained by removing the specified row and column
 		 *        and returning the resulting matrix.
 		 *
+		 * \remark For access to a block of the container without copying use
+		 *         `make_matrix_view(*this).block(...)` from `matrix_view.h`.
 		 * \param _row_index Index of row to remove.
 		 * \param _col_index Index of column to remove.
 		 * \return Submatrix of the container with specified row, column removed.
@@ -542,8 +581,72 @@ namespace crsc {
 		bool operator!=(const fixed_matrix& _other) const noexcept {
 			return !(*this == _other);
 		}
+		/**
+		 * \brief Adds the result of the element-wise matrix expression `_expr` to this container.
+		 *
+		 * \param _expr Expression to evaluate.
+		 * \return `*this`.
+		 * \throw Throws `std::invalid_argument` exception if `_expr` involves run-time sized operands and
+		 *        its dimensions are not `_Rows, _Cols`.
+		 * \complexity Linear in `rows()*columns()`.
+		 */
+		template<class Expr>
+		fixed_matrix& operator+=(const matrix_expression<Expr>& _expr) {
+			if (matrix_expression_impl::has_view_operand<Expr>::value) // a view may alias this matrix
+				evaluate_expression<matrix_expression_impl::plus_assign>(fixed_matrix(_expr));
+			else evaluate_expression<matrix_expression_impl::plus_assign>(_expr.self());
+			return *this;
+		}
+		/**
+		 * \brief Subtracts the result of the element-wise matrix expression `_expr` from this container.
+		 *
+		 * \param _expr Expression to evaluate.
+		 * \return `*this`.
+		 * \throw Throws `std::invalid_argument` exception if `_expr` involves run-time sized operands and
+		 *        its dimensions are not `_Rows, _Cols`.
+		 * \complexity Linear in `rows()*columns()`.
+		 */
+		template<class Expr>
+		fixed_matrix& operator-=(const matrix_expression<Expr>& _expr) {
+			if (matrix_expression_impl::has_view_operand<Expr>::value) // a view may alias this matrix
+				evaluate_expression<matrix_expression_impl::minus_assign>(fixed_matrix(_expr));
+			else evaluate_expression<matrix_expression_impl::minus_assign>(_expr.self());
+			return *this;
+		}
+		/**
+		 * \brief Multiplies each element of the container by `_scale`.
+		 *
+		 * \param _scale Value to multiply by.
+		 * \return `*this`.
+		 * \complexity Linear in `rows()*columns()`.
+		 */
+		fixed_matrix& operator*=(const value_type& _scale) {
+			for (auto& el : mtx) el *= _scale;
+			return *this;
+		}
 	private:
 		std::array<value_type, _Rows*_Cols> mtx;
+		template<class AssignOp, class Expr>
+		void evaluate_expression(const Expr& _expr) {
+			typedef matrix_expression_impl::operand_t<Expr> operand_type;
+			static_assert(matrix_expression_impl::static_extents_agree(operand_type::static_rows, _Rows)
+				&& matrix_expression_impl::static_extents_agree(operand_type::static_columns, _Cols),
+				"matrix_expression dimensions must agree with fixed_matrix dimensions.");
+			const operand_type operand = matrix_expression_impl::make_operand(_expr);
+			if (operand.rows() != _Rows || operand.columns() != _Cols)
+				throw std::invalid_argument("matrix_expression dimensions must agree with fixed_matrix dimensions.");
+			matrix_expression_impl::evaluate<AssignOp>(mtx.data(), _Cols, 1U, operand, 0U, _Rows);
+		}
+	};
+	/**
+	 * \brief Compile-time dimensions of `fixed_matrix` used in matrix expressions.
+	 */
+	template<typename Ty,
+		std::size_t _Rows,
+		std::size_t _Cols
+	> struct matrix_static_extents<fixed_matrix<Ty, _Rows, _Cols>> {
+		static constexpr std::size_t rows = _Rows;
+		static constexpr std::size_t columns = _Cols;
 	};
 	template<typename Ty,
 		std::size_t _Rows,
@@ -576,7 +679,7 @@ namespace crsc {
 		class = std::enable_if_t<_rows == _cols
 			&& std::is_arithmetic<Ty>::value>
 	> fixed_matrix<Ty, _rows, _cols> make_identity_matrix() {
-		fixed_matrix<Ty, _rows, _cols> identity_matrix();
+		fixed_matrix<Ty, _rows, _cols> identity_matrix;
 		for (std::size_t i = 0; i < _rows; ++i) {
 			for (std::size_t j = 0; j < _cols; ++j)
 				if (i == j) identity_matrix[i][j] = static_cast<Ty>(1);
@@ -626,7 +729,7 @@ namespace crsc {
 	> fixed_matrix<Ty, Rows, Cols> matrix_difference(const fixed_matrix<Ty, Rows, Cols>& lhs, const fixed_matrix<Ty, Rows, Cols>& rhs) {
 		fixed_matrix<Ty, Rows, Cols> difference;
 		for (auto itdiff = difference.begin(), itlhs = lhs.begin(), itrhs = rhs.begin(); itdiff < difference.end(); ++itdiff, ++itlhs, ++itrhs)
-			*itdiff = *itlhs + *itrhs;
+			*itdiff = *itlhs - *itrhs;
 		return difference;
 	}
 	template<typename Ty,
@@ -637,7 +740,7 @@ namespace crsc {
 		for (std::size_t i = 0; i < LHSRows; ++i) {
 			for (std::size_t j = 0; j < RHSCols; ++j) {
 				for (std::size_t k = 0; k < LHSCols; ++k)
-					product(i, j) += lhs(i, j) * rhs(k, j);
+					product(i, j) += lhs(i, k) * rhs(k, j);
 			}
 		}
 		return product;
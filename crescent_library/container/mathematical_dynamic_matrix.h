@@ -1,11 +1,12 @@
 #ifndef MATHEMATICAL_DYNAMIC_MATRIX_H
 #define MATHEMATICAL_DYNAMIC_MATRIX_H
 #include "dynamic_matrix.h"
+#include "matrix_expression.h"
 
 namespace crsc {
 	template<typename Ty,
 		class Allocator = std::allocator<Ty>
-	> class mathematical_dynamic_matrix {
+	> class mathematical_dynamic_matrix : public matrix_expression<mathematical_dynamic_matrix<Ty, Allocator>> {
 		typedef typename crsc::dynamic_matrix<Ty, Allocator> matrix_type;
 	public:
 		// PUBLIC API TYPE DEFINITIONS
@@ -32,29 +33,79 @@ namespace crsc {
 		explicit mathematical_dynamic_matrix(value_type** arr_2d, size_type rows, size_type cols, const Allocator& alloc = Allocator())
 			: mtx(arr_2d, rows, cols, alloc) {}
 		mathematical_dynamic_matrix(const mathematical_dynamic_matrix& other)
-			: mtx(other.mtx) {}
+			: mtx(other.mtx), policy(other.policy) {}
 		mathematical_dynamic_matrix(const mathematical_dynamic_matrix& other, const Allocator& alloc)
-			: mtx(other.mtx, alloc) {}
+			: mtx(other.mtx, alloc), policy(other.policy) {}
 		mathematical_dynamic_matrix(mathematical_dynamic_matrix&& other) 
-			: mtx(std::move(other.mtx)) {}
+			: mtx(std::move(other.mtx)), policy(other.policy) {}
 		mathematical_dynamic_matrix(mathematical_dynamic_matrix&& other, const Allocator& alloc) 
-			: mtx(std::move(other.mtx), alloc) {}
+			: mtx(std::move(other.mtx), alloc), policy(other.policy) {}
 		mathematical_dynamic_matrix(std::initializer_list<std::initializer_list<value_type>> mat_init_list, const Allocator& alloc = Allocator())
 			: mtx(mat_init_list, alloc) {}
+		/**
+		 * \brief Constructs the container by evaluating the element-wise matrix expression `expr` in a
+		 *        single pass, without materialising any of its sub-expressions.
+		 *
+		 * \remark The constructed matrix uses the default execution policy `execution::seq`.
+		 */
+		template<class Expr>
+		mathematical_dynamic_matrix(const matrix_expression<Expr>& expr, const Allocator& alloc = Allocator())
+			: mtx(expr.self().rows(), expr.self().columns(), alloc) {
+			evaluate_expression<matrix_expression_impl::assign>(expr.self());
+		}
 		~mathematical_dynamic_matrix() {}
 		mathematical_dynamic_matrix& operator=(const mathematical_dynamic_matrix& other) {
 			if (this != &other) mathematical_dynamic_matrix(other).swap(*this); // copy-swap
 			return *this;
 		}
 		mathematical_dynamic_matrix& operator=(mathematical_dynamic_matrix&& other) {
-			if (this != &other) mtx = std::move(other.mtx);
+			if (this != &other) {
+				mtx = std::move(other.mtx);
+				policy = other.policy;
+			}
 			return *this;
 		}
 		mathematical_dynamic_matrix& operator=(std::initializer_list<std::initializer_list<value_type>> ilist) {
 			mtx = ilist;
 			return *this;
 		}
+		/**
+		 * \brief Replaces the contents of the container with the result of evaluating the element-wise
+		 *        matrix expression `expr`, using the execution policy of this matrix.
+		 *
+		 * \remark `expr` may refer to this container. The result is evaluated in place if the dimensions
+		 *         of this container equal those of `expr` and `expr` has no `matrix_view` operand, as each
+		 *         element then depends only on the elements at the same position in the operands. Otherwise
+		 *         it is evaluated into newly allocated storage, since a view (e.g. a transpose) may read
+		 *         elements of this container which have already been overwritten.
+		 */
+		template<class Expr>
+		mathematical_dynamic_matrix& operator=(const matrix_expression<Expr>& expr) {
+			if (!matrix_expression_impl::has_view_operand<Expr>::value
+				&& rows() == expr.self().rows() && columns() == expr.self().columns())
+				evaluate_expression<matrix_expression_impl::assign>(expr.self());
+			else {
+				mathematical_dynamic_matrix tmp(expr.self().rows(), expr.self().columns(), get_allocator());
+				tmp.policy = policy;
+				tmp.evaluate_expression<matrix_expression_impl::assign>(expr.self());
+				mtx.swap(tmp.mtx);
+			}
+			return *this;
+		}
 		allocator_type get_allocator() const { return mtx.get_allocator(); }
+		// EXECUTION
+		/**
+		 * \brief Returns the execution policy used by the arithmetic operations and `fill` of this matrix.
+		 */
+		const execution::parallel_policy& execution_policy() const noexcept { return policy; }
+		/**
+		 * \brief Sets the execution policy used by the arithmetic operations and `fill` of this matrix. By
+		 *        default a matrix uses `execution::seq`, pass e.g. `execution::par` to enable multithreading.
+		 *
+		 * \remark The policy is propagated to copies of this matrix and to the results of `operator*`. It is
+		 *         also used when a matrix expression is assigned to this matrix.
+		 */
+		void set_execution_policy(const execution::parallel_policy& _policy) noexcept { policy = _policy; }
 		// CAPACITY
 		bool empty() const noexcept { return mtx.empty(); }
 		size_type rows() const noexcept { return mtx.rows(); }
@@ -98,7 +149,8 @@ namespace crsc {
 		}
 		iterator erase_row(size_type row_pos) { return mtx.erase_row(row_pos); }
 		iterator erase_column(size_type col_pos) { return mtx.erase_column(col_pos); }
-		void fill(const value_type& val) noexcept { mtx.fill(val); }
+		void fill(const value_type& val) { mtx.fill(policy, val); }
+		void fill(const execution::parallel_policy& _policy, const value_type& val) { mtx.fill(_policy, val); }
 		void push_row(const value_type& val) { mtx.push_row(val); }
 		void push_row(const std::vector<value_type>& row_vec) { mtx.push_row(row_vec); }
 		void push_row(std::vector<value_type>&& row_vec = std::vector<value_type>()) { mtx.push_row(std::move(row_vec)); }
@@ -113,7 +165,10 @@ namespace crsc {
 		void columns_resize(size_type columns, const value_type& val) { mtx.columns_resize(columns, val); }
 		void resize(size_type rows, size_type columns) { mtx.resize(rows, columns); }
 		void resize(size_type rows, size_type columns, const value_type& val) { mtx.resize(rows, columns, val); }
-		void swap(mathematical_dynamic_matrix& other) { mtx.swap(other.mtx); }
+		void swap(mathematical_dynamic_matrix& other) {
+			mtx.swap(other.mtx);
+			std::swap(policy, other.policy);
+		}
 		mathematical_dynamic_matrix& submatrix(size_type i, size_type j) {
 			mtx.submatrix(i, j);
 			return *this;
@@ -122,37 +177,44 @@ namespace crsc {
 		// OPERATORS
 		bool operator==(const mathematical_dynamic_matrix& other) const noexcept { return mtx == other.mtx; }
 		bool operator!=(const mathematical_dynamic_matrix& other) const noexcept { return !(*this == other); }
-		mathematical_dynamic_matrix& operator+=(const mathematical_dynamic_matrix& other) {
-			for (size_type i = 0; i < rows(); ++i) {
-				for (size_type j = 0; j < columns(); ++j)
-					mtx(i, j) += other.mtx(i, j);
+		template<class Expr>
+		mathematical_dynamic_matrix& operator+=(const matrix_expression<Expr>& expr) {
+			if (rows() != expr.self().rows() || columns() != expr.self().columns())
+				throw std::invalid_argument("mathematical_dynamic_matrix dimensions must agree for component-wise addition.");
+			if (matrix_expression_impl::has_view_operand<Expr>::value) {
+				// a view may alias this matrix, so evaluate it into new storage first
+				mathematical_dynamic_matrix tmp(rows(), columns(), get_allocator());
+				tmp.policy = policy;
+				tmp.evaluate_expression<matrix_expression_impl::assign>(expr.self());
+				evaluate_expression<matrix_expression_impl::plus_assign>(tmp);
 			}
+			else evaluate_expression<matrix_expression_impl::plus_assign>(expr.self());
 			return *this;
 		}
-		mathematical_dynamic_matrix& operator-=(const mathematical_dynamic_matrix& other) {
-			for (size_type i = 0; i < rows(); ++i) {
-				for (size_type j = 0; j < columns(); ++j)
-					mtx(i, j) -= other.mtx(i, j);
+		template<class Expr>
+		mathematical_dynamic_matrix& operator-=(const matrix_expression<Expr>& expr) {
+			if (rows() != expr.self().rows() || columns() != expr.self().columns())
+				throw std::invalid_argument("mathematical_dynamic_matrix dimensions must agree for component-wise subtraction.");
+			if (matrix_expression_impl::has_view_operand<Expr>::value) {
+				// a view may alias this matrix, so evaluate it into new storage first
+				mathematical_dynamic_matrix tmp(rows(), columns(), get_allocator());
+				tmp.policy = policy;
+				tmp.evaluate_expression<matrix_expression_impl::assign>(expr.self());
+				evaluate_expression<matrix_expression_impl::minus_assign>(tmp);
 			}
+			else evaluate_expression<matrix_expression_impl::minus_assign>(expr.self());
 			return *this;
 		}
-		mathematical_dynamic_matrix operator+(const mathematical_dynamic_matrix& other) {
-			return matrix_sum(mtx, other.mtx);
-		}
-		mathematical_dynamic_matrix operator-(const mathematical_dynamic_matrix& other) {
-			return matrix_difference(mtx, other.mtx);
-		}
-		mathematical_dynamic_matrix operator*(const mathematical_dynamic_matrix& other) {
-			return matrix_product(mtx, other.mtx);
+		mathematical_dynamic_matrix operator*(const mathematical_dynamic_matrix& other) const {
+			return mathematical_dynamic_matrix(matrix_product(policy, mtx, other.mtx), policy);
 		}
 		mathematical_dynamic_matrix& operator*=(const value_type& scale) {
-			std::for_each(begin(), end(), [scale](auto& el) { el *= scale; });
+			pointer pthis = data();
+			parallel_for(policy, 0U, size(), [pthis, &scale](size_type first, size_type last) {
+				for (size_type i = first; i < last; ++i) pthis[i] *= scale;
+			});
 			return *this;
 		}
-		mathematical_dynamic_matrix operator*(const value_type& scale) {
-			mathematical_dynamic_matrix scaled_matrix(*this);
-			return scaled_matrix *= scale;
-		}
 		// ITERATORS
 		/**
 		 * \brief Returns a const_iterator the first element of the container.
@@ -261,6 +323,19 @@ namespace crsc {
 		reverse_iterator rend() noexcept { return mtx.rend(); }
 	private:
 		matrix_type mtx;
+		execution::parallel_policy policy = execution::seq;
+		explicit mathematical_dynamic_matrix(matrix_type&& other, const execution::parallel_policy& _policy)
+			: mtx(std::move(other)), policy(_policy) {}
+		template<class AssignOp, class Expr>
+		void evaluate_expression(const Expr& expr) {
+			const matrix_expression_impl::operand_t<Expr> operand = matrix_expression_impl::make_operand(expr);
+			pointer out = data();
+			const size_type cols = columns();
+			const size_type row_grain = std::max<size_type>(policy.grain_size() / std::max<size_type>(cols, 1U), 1U);
+			parallel_for(policy, 0U, rows(), row_grain, [out, cols, &operand](size_type first, size_type last) {
+				matrix_expression_impl::evaluate<AssignOp>(out, cols, 1U, operand, first, last);
+			});
+		}
 	};
 	template<typename Ty,
 		class Alloc = std::allocator<Ty>
@@ -287,7 +362,7 @@ namespace crsc {
 		mathematical_dynamic_matrix<Ty, Alloc> identity_matrix(rows, columns, alloc);
 		for (typename mathematical_dynamic_matrix<Ty, Alloc>::size_type i = 0U; i < rows; ++i) {
 			for (typename mathematical_dynamic_matrix<Ty, Alloc>::size_type j = 0U; j < columns; ++j)
-				if (i == j) identity_matrix[i][j] = static_cast<Ty>(1);
+				if (i == j) identity_matrix(i, j) = static_cast<Ty>(1);
 		}
 		return identity_matrix;
 	}
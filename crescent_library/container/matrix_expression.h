@@ -0,0 +1,366 @@
+#ifndef MATRIX_EXPRESSION_H
+#define MATRIX_EXPRESSION_H
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace crsc {
+	/**
+	 * \class matrix_expression
+	 *
+	 * \brief CRTP base of all lazily evaluated element-wise matrix expressions and of the matrix containers
+	 *        which may appear as operands in such expressions.
+	 *
+	 * Element-wise operators (`+`, `-`, unary `-`, multiplication and division by a scalar) applied to
+	 * `matrix_expression` operands do not compute a result, instead they return a lightweight expression
+	 * object recording the operation. The expression is evaluated in a single pass over the destination
+	 * buffer when it is assigned to (or used to construct) a matrix container, such that a chain like
+	 * `A + B - C*2.0` performs no intermediate allocations and traverses each operand exactly once.
+	 *
+	 * \warning Expressions hold references to the storage of their matrix operands, an expression must
+	 *          therefore be evaluated before any of its operands is destroyed or resized. Storing an
+	 *          expression in an `auto` variable is only safe whilst all operands remain alive and unaltered.
+	 * \tparam Expr The derived expression or container type.
+	 */
+	template<class Expr>
+	class matrix_expression {
+	public:
+		/**
+		 * \brief Returns a reference to this as the derived type `Expr`.
+		 */
+		const Expr& self() const noexcept { return static_cast<const Expr&>(*this); }
+	protected:
+		matrix_expression() = default;
+		matrix_expression(const matrix_expression&) = default;
+		matrix_expression& operator=(const matrix_expression&) = default;
+		~matrix_expression() = default;
+	};
+	/**
+	 * \brief Compile-time dimensions of a matrix container used in a `matrix_expression`, a value of `0`
+	 *        denotes a dimension only known at run-time. Specialised by `fixed_matrix`.
+	 */
+	template<class Matrix>
+	struct matrix_static_extents {
+		static constexpr std::size_t rows = 0U;
+		static constexpr std::size_t columns = 0U;
+	};
+	namespace matrix_expression_impl {
+		/**
+		 * \brief Tag base identifying types which are stored by value within expression nodes (expression
+		 *        nodes and views), as opposed to matrix containers.
+		 */
+		struct node_tag {};
+		/**
+		 * \class leaf
+		 *
+		 * \brief Expression operand wrapping the contiguous storage of a matrix container.
+		 */
+		template<class Matrix>
+		class leaf {
+		public:
+			typedef typename Matrix::value_type value_type;
+			typedef std::size_t size_type;
+			static constexpr size_type static_rows = matrix_static_extents<Matrix>::rows;
+			static constexpr size_type static_columns = matrix_static_extents<Matrix>::columns;
+			explicit leaf(const Matrix& m) noexcept
+				: ptr(m.data()), nrows(m.rows()), ncols(m.columns()) {}
+			size_type rows() const noexcept { return nrows; }
+			size_type columns() const noexcept { return ncols; }
+			const value_type& eval(size_type i, size_type j) const noexcept { return ptr[i*ncols + j]; }
+		private:
+			const value_type* ptr;
+			size_type nrows;
+			size_type ncols;
+		};
+		/**
+		 * \brief Describes how an operand of type `Ty` is stored within an expression node; nodes are stored
+		 *        by value whilst containers are stored as a `leaf` view of their elements. Containers whose
+		 *        storage is not dense row-major specialise this to provide a suitable operand type.
+		 */
+		template<class Ty,
+			class = void
+		> struct operand_traits {
+			typedef leaf<Ty> type;
+			static type make(const Ty& m) noexcept { return type(m); }
+		};
+		template<class Ty>
+		struct operand_traits<Ty, std::enable_if_t<std::is_base_of<node_tag, Ty>::value>> {
+			typedef Ty type;
+			static const Ty& make(const Ty& node) noexcept { return node; }
+		};
+		template<class Ty>
+		using operand_t = typename operand_traits<Ty>::type;
+		/**
+		 * \brief Returns the operand used to store `expr` within an expression node.
+		 */
+		template<class Ty>
+		operand_t<Ty> make_operand(const Ty& expr) { return operand_traits<Ty>::make(expr); }
+		/**
+		 * \class transposed
+		 *
+		 * \brief Operand adaptor presenting the transpose of another operand, used to evaluate expressions
+		 *        into column-major destinations with a contiguous inner loop.
+		 */
+		template<class Operand>
+		class transposed {
+		public:
+			typedef typename Operand::value_type value_type;
+			typedef std::size_t size_type;
+			explicit transposed(const Operand& _op) : op(_op) {}
+			size_type rows() const noexcept { return op.columns(); }
+			size_type columns() const noexcept { return op.rows(); }
+			value_type eval(size_type i, size_type j) const { return op.eval(j, i); }
+		private:
+			const Operand& op;
+		};
+		/**
+		 * \brief Returns `true` if the `static_rows`/`static_columns` of two operands can describe the same shape.
+		 */
+		constexpr bool static_extents_agree(std::size_t lhs, std::size_t rhs) noexcept {
+			return !lhs || !rhs || lhs == rhs;
+		}
+		// ELEMENT-WISE OPERATIONS
+		struct plus {
+			template<typename Ty>
+			static Ty apply(const Ty& lhs, const Ty& rhs) { return lhs + rhs; }
+		};
+		struct minus {
+			template<typename Ty>
+			static Ty apply(const Ty& lhs, const Ty& rhs) { return lhs - rhs; }
+		};
+		struct multiplies_right {
+			template<typename Ty>
+			static Ty apply(const Ty& el, const Ty& scalar) { return el * scalar; }
+		};
+		struct multiplies_left {
+			template<typename Ty>
+			static Ty apply(const Ty& el, const Ty& scalar) { return scalar * el; }
+		};
+		struct divides {
+			template<typename Ty>
+			static Ty apply(const Ty& el, const Ty& scalar) { return el / scalar; }
+		};
+		struct negate {
+			template<typename Ty>
+			static Ty apply(const Ty& el) { return -el; }
+		};
+		// ASSIGNMENT OPERATIONS
+		struct assign {
+			template<typename Ty, typename Uty>
+			static void apply(Ty& dst, const Uty& src) { dst = src; }
+		};
+		struct plus_assign {
+			template<typename Ty, typename Uty>
+			static void apply(Ty& dst, const Uty& src) { dst += src; }
+		};
+		struct minus_assign {
+			template<typename Ty, typename Uty>
+			static void apply(Ty& dst, const Uty& src) { dst -= src; }
+		};
+		/**
+		 * \brief Evaluates the rows `[first_row, last_row)` of `expr` into the strided destination `out`
+		 *        using the assignment operation `AssignOp`. This is the single loop of an expression evaluation.
+		 */
+		template<class AssignOp, typename Ty, class Operand>
+		void evaluate(Ty* out, std::size_t row_stride, std::size_t col_stride, const Operand& expr,
+			std::size_t first_row, std::size_t last_row) {
+			const std::size_t cols = expr.columns();
+			for (std::size_t i = first_row; i < last_row; ++i) {
+				Ty* row = out + i*row_stride;
+				if (col_stride == 1U) {
+					for (std::size_t j = 0U; j < cols; ++j)
+						AssignOp::apply(row[j], expr.eval(i, j));
+				}
+				else {
+					for (std::size_t j = 0U; j < cols; ++j)
+						AssignOp::apply(row[j*col_stride], expr.eval(i, j));
+				}
+			}
+		}
+	}
+	/**
+	 * \class matrix_binary_expression
+	 *
+	 * \brief Lazy element-wise combination `Op(lhs, rhs)` of two matrix expressions of equal shape.
+	 *
+	 * \tparam Lhs Type of first operand.
+	 * \tparam Rhs Type of second operand.
+	 * \tparam Op Element-wise operation.
+	 */
+	template<class Lhs,
+		class Rhs,
+		class Op
+	> class matrix_binary_expression : public matrix_expression<matrix_binary_expression<Lhs, Rhs, Op>>,
+		public matrix_expression_impl::node_tag {
+		typedef matrix_expression_impl::operand_t<Lhs> lhs_type;
+		typedef matrix_expression_impl::operand_t<Rhs> rhs_type;
+	public:
+		typedef typename lhs_type::value_type value_type;
+		typedef std::size_t size_type;
+		static constexpr size_type static_rows = lhs_type::static_rows ? lhs_type::static_rows : rhs_type::static_rows;
+		static constexpr size_type static_columns = lhs_type::static_columns ? lhs_type::static_columns : rhs_type::static_columns;
+		static_assert(std::is_same<value_type, typename rhs_type::value_type>::value,
+			"matrix_expression operands must have the same value_type.");
+		static_assert(matrix_expression_impl::static_extents_agree(lhs_type::static_rows, rhs_type::static_rows)
+			&& matrix_expression_impl::static_extents_agree(lhs_type::static_columns, rhs_type::static_columns),
+			"matrix dimensions must agree for component-wise operation.");
+		/**
+		 * \brief Constructs the expression from its two operands.
+		 *
+		 * \throw Throws `std::invalid_argument` exception if `lhs` and `rhs` do not have equal dimensions.
+		 */
+		matrix_binary_expression(const Lhs& _lhs, const Rhs& _rhs)
+			: lhs(matrix_expression_impl::make_operand(_lhs)), rhs(matrix_expression_impl::make_operand(_rhs)) {
+			if (lhs.rows() != rhs.rows() || lhs.columns() != rhs.columns())
+				throw std::invalid_argument("matrix dimensions must agree for component-wise operation.");
+		}
+		size_type rows() const noexcept { return lhs.rows(); }
+		size_type columns() const noexcept { return lhs.columns(); }
+		size_type size() const noexcept { return rows()*columns(); }
+		value_type eval(size_type i, size_type j) const { return Op::apply(lhs.eval(i, j), rhs.eval(i, j)); }
+	private:
+		lhs_type lhs;
+		rhs_type rhs;
+	};
+	/**
+	 * \class matrix_scalar_expression
+	 *
+	 * \brief Lazy element-wise combination `Op(el, scalar)` of a matrix expression with a scalar value.
+	 *
+	 * \tparam Expr Type of matrix operand.
+	 * \tparam Op Element-wise operation.
+	 */
+	template<class Expr,
+		class Op
+	> class matrix_scalar_expression : public matrix_expression<matrix_scalar_expression<Expr, Op>>,
+		public matrix_expression_impl::node_tag {
+		typedef matrix_expression_impl::operand_t<Expr> expr_type;
+	public:
+		typedef typename expr_type::value_type value_type;
+		typedef std::size_t size_type;
+		static constexpr size_type static_rows = expr_type::static_rows;
+		static constexpr size_type static_columns = expr_type::static_columns;
+		matrix_scalar_expression(const Expr& _expr, const value_type& _scalar)
+			: expr(matrix_expression_impl::make_operand(_expr)), scalar(_scalar) {}
+		size_type rows() const noexcept { return expr.rows(); }
+		size_type columns() const noexcept { return expr.columns(); }
+		size_type size() const noexcept { return rows()*columns(); }
+		value_type eval(size_type i, size_type j) const { return Op::apply(expr.eval(i, j), scalar); }
+	private:
+		expr_type expr;
+		value_type scalar;
+	};
+	/**
+	 * \class matrix_unary_expression
+	 *
+	 * \brief Lazy element-wise application `Op(el)` to a matrix expression.
+	 *
+	 * \tparam Expr Type of matrix operand.
+	 * \tparam Op Element-wise operation.
+	 */
+	template<class Expr,
+		class Op
+	> class matrix_unary_expression : public matrix_expression<matrix_unary_expression<Expr, Op>>,
+		public matrix_expression_impl::node_tag {
+		typedef matrix_expression_impl::operand_t<Expr> expr_type;
+	public:
+		typedef typename expr_type::value_type value_type;
+		typedef std::size_t size_type;
+		static constexpr size_type static_rows = expr_type::static_rows;
+		static constexpr size_type static_columns = expr_type::static_columns;
+		explicit matrix_unary_expression(const Expr& _expr)
+			: expr(matrix_expression_impl::make_operand(_expr)) {}
+		size_type rows() const noexcept { return expr.rows(); }
+		size_type columns() const noexcept { return expr.columns(); }
+		size_type size() const noexcept { return rows()*columns(); }
+		value_type eval(size_type i, size_type j) const { return Op::apply(expr.eval(i, j)); }
+	private:
+		expr_type expr;
+	};
+	namespace matrix_expression_impl {
+		/**
+		 * \brief `value` is `true` if the expression `Expr` has a `matrix_view` operand. A view may refer to
+		 *        the storage of the container an expression is assigned to with a different layout (e.g. a
+		 *        transpose), so containers evaluate such expressions into new storage. Specialised by
+		 *        `matrix_view`.
+		 */
+		template<class Expr>
+		struct has_view_operand : std::false_type {};
+		template<class Lhs,
+			class Rhs,
+			class Op
+		> struct has_view_operand<matrix_binary_expression<Lhs, Rhs, Op>>
+			: std::integral_constant<bool, has_view_operand<Lhs>::value || has_view_operand<Rhs>::value> {};
+		template<class Expr,
+			class Op
+		> struct has_view_operand<matrix_scalar_expression<Expr, Op>> : has_view_operand<Expr> {};
+		template<class Expr,
+			class Op
+		> struct has_view_operand<matrix_unary_expression<Expr, Op>> : has_view_operand<Expr> {};
+	}
+	/**
+	 * \brief Lazy component-wise addition of `lhs` and `rhs`.
+	 *
+	 * \throw Throws `std::invalid_argument` exception if `lhs` and `rhs` do not have equal dimensions, for
+	 *        operands of compile-time dimensions a mismatch is instead a compilation error.
+	 * \complexity Constant, the additions are performed when the expression is evaluated.
+	 */
+	template<class Lhs,
+		class Rhs
+	> matrix_binary_expression<Lhs, Rhs, matrix_expression_impl::plus> operator+(const matrix_expression<Lhs>& lhs, const matrix_expression<Rhs>& rhs) {
+		return matrix_binary_expression<Lhs, Rhs, matrix_expression_impl::plus>(lhs.self(), rhs.self());
+	}
+	/**
+	 * \brief Lazy component-wise subtraction of `rhs` from `lhs`.
+	 *
+	 * \throw Throws `std::invalid_argument` exception if `lhs` and `rhs` do not have equal dimensions, for
+	 *        operands of compile-time dimensions a mismatch is instead a compilation error.
+	 * \complexity Constant, the subtractions are performed when the expression is evaluated.
+	 */
+	template<class Lhs,
+		class Rhs
+	> matrix_binary_expression<Lhs, Rhs, matrix_expression_impl::minus> operator-(const matrix_expression<Lhs>& lhs, const matrix_expression<Rhs>& rhs) {
+		return matrix_binary_expression<Lhs, Rhs, matrix_expression_impl::minus>(lhs.self(), rhs.self());
+	}
+	/**
+	 * \brief Lazy component-wise negation of `expr`.
+	 *
+	 * \complexity Constant, the negations are performed when the expression is evaluated.
+	 */
+	template<class Expr>
+	matrix_unary_expression<Expr, matrix_expression_impl::negate> operator-(const matrix_expression<Expr>& expr) {
+		return matrix_unary_expression<Expr, matrix_expression_impl::negate>(expr.self());
+	}
+	/**
+	 * \brief Lazy multiplication of each element of `expr` by `scalar`.
+	 *
+	 * \complexity Constant, the multiplications are performed when the expression is evaluated.
+	 */
+	template<class Expr>
+	matrix_scalar_expression<Expr, matrix_expression_impl::multiplies_right> operator*(const matrix_expression<Expr>& expr,
+		const typename Expr::value_type& scalar) {
+		return matrix_scalar_expression<Expr, matrix_expression_impl::multiplies_right>(expr.self(), scalar);
+	}
+	/**
+	 * \brief Lazy multiplication of `scalar` by each element of `expr`.
+	 *
+	 * \complexity Constant, the multiplications are performed when the expression is evaluated.
+	 */
+	template<class Expr>
+	matrix_scalar_expression<Expr, matrix_expression_impl::multiplies_left> operator*(const typename Expr::value_type& scalar,
+		const matrix_expression<Expr>& expr) {
+		return matrix_scalar_expression<Expr, matrix_expression_impl::multiplies_left>(expr.self(), scalar);
+	}
+	/**
+	 * \brief Lazy division of each element of `expr` by `scalar`.
+	 *
+	 * \complexity Constant, the divisions are performed when the expression is evaluated.
+	 */
+	template<class Expr>
+	matrix_scalar_expression<Expr, matrix_expression_impl::divides> operator/(const matrix_expression<Expr>& expr,
+		const typename Expr::value_type& scalar) {
+		return matrix_scalar_expression<Expr, matrix_expression_impl::divides>(expr.self(), scalar);
+	}
+}
+
+#endif // !MATRIX_EXPRESSION_H
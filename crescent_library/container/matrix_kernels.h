@@ -0,0 +1,388 @@
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#if !defined(CRSC_DISABLE_SIMD)
+#if defined(__AVX512F__) || (defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER)))
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace crsc {
+	/**
+	 * \brief Detail namespace for the computational kernels used by the matrix containers. Nothing
+	 *        in this namespace is part of the public API.
+	 *
+	 * All kernels operate on raw row-major buffers described by a pointer and a leading dimension
+	 * (the distance, in elements, between the starts of two consecutive rows) such that they can be
+	 * shared by every matrix type regardless of how it owns its storage.
+	 *
+	 * SIMD code paths are selected at compile-time from the instruction set macros defined by the
+	 * compiler (`__AVX512F__`, `__AVX2__` with FMA, `__ARM_NEON`); defining `CRSC_DISABLE_SIMD` before
+	 * inclusion forces the portable scalar kernels.
+	 */
+	namespace matrix_kernels_impl {
+		/**
+		 * \struct gemm_micro_kernel
+		 *
+		 * \brief Register-blocked micro-kernel computing `C[mr x nr] += A_panel * B_panel` where both panels
+		 *        have been packed by `pack_a_panel` and `pack_b_panel` respectively. This is the portable
+		 *        version used for any arithmetic type without a vectorised specialisation.
+		 */
+		template<typename Ty, class = void>
+		struct gemm_micro_kernel {
+			static constexpr std::size_t mr = 4U;
+			static constexpr std::size_t nr = 4U;
+			static void run(std::size_t kc, const Ty* a, const Ty* b, Ty* c, std::size_t ldc) {
+				Ty acc[mr][nr] = {};
+				for (std::size_t k = 0U; k < kc; ++k, a += mr, b += nr) {
+					for (std::size_t i = 0U; i < mr; ++i) {
+						for (std::size_t j = 0U; j < nr; ++j)
+							acc[i][j] += a[i] * b[j];
+					}
+				}
+				for (std::size_t i = 0U; i < mr; ++i) {
+					for (std::size_t j = 0U; j < nr; ++j)
+						c[i*ldc + j] += acc[i][j];
+				}
+			}
+		};
+#if !defined(CRSC_DISABLE_SIMD)
+#if defined(__AVX512F__)
+		template<>
+		struct gemm_micro_kernel<double> {
+			static constexpr std::size_t mr = 4U;
+			static constexpr std::size_t nr = 16U;
+			static void run(std::size_t kc, const double* a, const double* b, double* c, std::size_t ldc) {
+				__m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+				__m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+				__m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+				__m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+				for (std::size_t k = 0U; k < kc; ++k, a += mr, b += nr) {
+					__m512d b0 = _mm512_loadu_pd(b);
+					__m512d b1 = _mm512_loadu_pd(b + 8);
+					__m512d ai = _mm512_set1_pd(a[0]);
+					c00 = _mm512_fmadd_pd(ai, b0, c00); c01 = _mm512_fmadd_pd(ai, b1, c01);
+					ai = _mm512_set1_pd(a[1]);
+					c10 = _mm512_fmadd_pd(ai, b0, c10); c11 = _mm512_fmadd_pd(ai, b1, c11);
+					ai = _mm512_set1_pd(a[2]);
+					c20 = _mm512_fmadd_pd(ai, b0, c20); c21 = _mm512_fmadd_pd(ai, b1, c21);
+					ai = _mm512_set1_pd(a[3]);
+					c30 = _mm512_fmadd_pd(ai, b0, c30); c31 = _mm512_fmadd_pd(ai, b1, c31);
+				}
+				store_row(c, c00, c01); store_row(c + ldc, c10, c11);
+				store_row(c + 2*ldc, c20, c21); store_row(c + 3*ldc, c30, c31);
+			}
+		private:
+			static void store_row(double* c, __m512d lo, __m512d hi) {
+				_mm512_storeu_pd(c, _mm512_add_pd(_mm512_loadu_pd(c), lo));
+				_mm512_storeu_pd(c + 8, _mm512_add_pd(_mm512_loadu_pd(c + 8), hi));
+			}
+		};
+		template<>
+		struct gemm_micro_kernel<float> {
+			static constexpr std::size_t mr = 4U;
+			static constexpr std::size_t nr = 32U;
+			static void run(std::size_t kc, const float* a, const float* b, float* c, std::size_t ldc) {
+				__m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+				__m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+				__m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+				__m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+				for (std::size_t k = 0U; k < kc; ++k, a += mr, b += nr) {
+					__m512 b0 = _mm512_loadu_ps(b);
+					__m512 b1 = _mm512_loadu_ps(b + 16);
+					__m512 ai = _mm512_set1_ps(a[0]);
+					c00 = _mm512_fmadd_ps(ai, b0, c00); c01 = _mm512_fmadd_ps(ai, b1, c01);
+					ai = _mm512_set1_ps(a[1]);
+					c10 = _mm512_fmadd_ps(ai, b0, c10); c11 = _mm512_fmadd_ps(ai, b1, c11);
+					ai = _mm512_set1_ps(a[2]);
+					c20 = _mm512_fmadd_ps(ai, b0, c20); c21 = _mm512_fmadd_ps(ai, b1, c21);
+					ai = _mm512_set1_ps(a[3]);
+					c30 = _mm512_fmadd_ps(ai, b0, c30); c31 = _mm512_fmadd_ps(ai, b1, c31);
+				}
+				store_row(c, c00, c01); store_row(c + ldc, c10, c11);
+				store_row(c + 2*ldc, c20, c21); store_row(c + 3*ldc, c30, c31);
+			}
+		private:
+			static void store_row(float* c, __m512 lo, __m512 hi) {
+				_mm512_storeu_ps(c, _mm512_add_ps(_mm512_loadu_ps(c), lo));
+				_mm512_storeu_ps(c + 16, _mm512_add_ps(_mm512_loadu_ps(c + 16), hi));
+			}
+		};
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+		template<>
+		struct gemm_micro_kernel<double> {
+			static constexpr std::size_t mr = 4U;
+			static constexpr std::size_t nr = 8U;
+			static void run(std::size_t kc, const double* a, const double* b, double* c, std::size_t ldc) {
+				__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+				__m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+				__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+				__m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+				for (std::size_t k = 0U; k < kc; ++k, a += mr, b += nr) {
+					__m256d b0 = _mm256_loadu_pd(b);
+					__m256d b1 = _mm256_loadu_pd(b + 4);
+					__m256d ai = _mm256_broadcast_sd(a);
+					c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+					ai = _mm256_broadcast_sd(a + 1);
+					c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+					ai = _mm256_broadcast_sd(a + 2);
+					c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+					ai = _mm256_broadcast_sd(a + 3);
+					c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+				}
+				store_row(c, c00, c01); store_row(c + ldc, c10, c11);
+				store_row(c + 2*ldc, c20, c21); store_row(c + 3*ldc, c30, c31);
+			}
+		private:
+			static void store_row(double* c, __m256d lo, __m256d hi) {
+				_mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), lo));
+				_mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), hi));
+			}
+		};
+		template<>
+		struct gemm_micro_kernel<float> {
+			static constexpr std::size_t mr = 4U;
+			static constexpr std::size_t nr = 16U;
+			static void run(std::size_t kc, const float* a, const float* b, float* c, std::size_t ldc) {
+				__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+				__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+				__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+				__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+				for (std::size_t k = 0U; k < kc; ++k, a += mr, b += nr) {
+					__m256 b0 = _mm256_loadu_ps(b);
+					__m256 b1 = _mm256_loadu_ps(b + 8);
+					__m256 ai = _mm256_broadcast_ss(a);
+					c00 = _mm256_fmadd_ps(ai, b0, c00); c01 = _mm256_fmadd_ps(ai, b1, c01);
+					ai = _mm256_broadcast_ss(a + 1);
+					c10 = _mm256_fmadd_ps(ai, b0, c10); c11 = _mm256_fmadd_ps(ai, b1, c11);
+					ai = _mm256_broadcast_ss(a + 2);
+					c20 = _mm256_fmadd_ps(ai, b0, c20); c21 = _mm256_fmadd_ps(ai, b1, c21);
+					ai = _mm256_broadcast_ss(a + 3);
+					c30 = _mm256_fmadd_ps(ai, b0, c30); c31 = _mm256_fmadd_ps(ai, b1, c31);
+				}
+				store_row(c, c00, c01); store_row(c + ldc, c10, c11);
+				store_row(c + 2*ldc, c20, c21); store_row(c + 3*ldc, c30, c31);
+			}
+		private:
+			static void store_row(float* c, __m256 lo, __m256 hi) {
+				_mm256_storeu_ps(c, _mm256_add_ps(_mm256_loadu_ps(c), lo));
+				_mm256_storeu_ps(c + 8, _mm256_add_ps(_mm256_loadu_ps(c + 8), hi));
+			}
+		};
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+		template<>
+		struct gemm_micro_kernel<float> {
+			static constexpr std::size_t mr = 4U;
+			static constexpr std::size_t nr = 8U;
+			static void run(std::size_t kc, const float* a, const float* b, float* c, std::size_t ldc) {
+				float32x4_t c00 = vdupq_n_f32(0.0f), c01 = vdupq_n_f32(0.0f);
+				float32x4_t c10 = vdupq_n_f32(0.0f), c11 = vdupq_n_f32(0.0f);
+				float32x4_t c20 = vdupq_n_f32(0.0f), c21 = vdupq_n_f32(0.0f);
+				float32x4_t c30 = vdupq_n_f32(0.0f), c31 = vdupq_n_f32(0.0f);
+				for (std::size_t k = 0U; k < kc; ++k, a += mr, b += nr) {
+					float32x4_t b0 = vld1q_f32(b);
+					float32x4_t b1 = vld1q_f32(b + 4);
+					c00 = vmlaq_n_f32(c00, b0, a[0]); c01 = vmlaq_n_f32(c01, b1, a[0]);
+					c10 = vmlaq_n_f32(c10, b0, a[1]); c11 = vmlaq_n_f32(c11, b1, a[1]);
+					c20 = vmlaq_n_f32(c20, b0, a[2]); c21 = vmlaq_n_f32(c21, b1, a[2]);
+					c30 = vmlaq_n_f32(c30, b0, a[3]); c31 = vmlaq_n_f32(c31, b1, a[3]);
+				}
+				store_row(c, c00, c01); store_row(c + ldc, c10, c11);
+				store_row(c + 2*ldc, c20, c21); store_row(c + 3*ldc, c30, c31);
+			}
+		private:
+			static void store_row(float* c, float32x4_t lo, float32x4_t hi) {
+				vst1q_f32(c, vaddq_f32(vld1q_f32(c), lo));
+				vst1q_f32(c + 4, vaddq_f32(vld1q_f32(c + 4), hi));
+			}
+		};
+#if defined(__aarch64__)
+		template<>
+		struct gemm_micro_kernel<double> {
+			static constexpr std::size_t mr = 4U;
+			static constexpr std::size_t nr = 4U;
+			static void run(std::size_t kc, const double* a, const double* b, double* c, std::size_t ldc) {
+				float64x2_t c00 = vdupq_n_f64(0.0), c01 = vdupq_n_f64(0.0);
+				float64x2_t c10 = vdupq_n_f64(0.0), c11 = vdupq_n_f64(0.0);
+				float64x2_t c20 = vdupq_n_f64(0.0), c21 = vdupq_n_f64(0.0);
+				float64x2_t c30 = vdupq_n_f64(0.0), c31 = vdupq_n_f64(0.0);
+				for (std::size_t k = 0U; k < kc; ++k, a += mr, b += nr) {
+					float64x2_t b0 = vld1q_f64(b);
+					float64x2_t b1 = vld1q_f64(b + 2);
+					c00 = vfmaq_n_f64(c00, b0, a[0]); c01 = vfmaq_n_f64(c01, b1, a[0]);
+					c10 = vfmaq_n_f64(c10, b0, a[1]); c11 = vfmaq_n_f64(c11, b1, a[1]);
+					c20 = vfmaq_n_f64(c20, b0, a[2]); c21 = vfmaq_n_f64(c21, b1, a[2]);
+					c30 = vfmaq_n_f64(c30, b0, a[3]); c31 = vfmaq_n_f64(c31, b1, a[3]);
+				}
+				store_row(c, c00, c01); store_row(c + ldc, c10, c11);
+				store_row(c + 2*ldc, c20, c21); store_row(c + 3*ldc, c30, c31);
+			}
+		private:
+			static void store_row(double* c, float64x2_t lo, float64x2_t hi) {
+				vst1q_f64(c, vaddq_f64(vld1q_f64(c), lo));
+				vst1q_f64(c + 2, vaddq_f64(vld1q_f64(c + 2), hi));
+			}
+		};
+#endif
+#endif
+#endif // !CRSC_DISABLE_SIMD
+		/**
+		 * \brief Cache blocking sizes used by `gemm_packed`, chosen such that a packed `kc x nr` panel of the
+		 *        right-hand operand stays resident in L1, a packed `mc x kc` block of the left-hand operand in L2
+		 *        and a packed `kc x nc` block of the right-hand operand in L3.
+		 */
+		template<typename Ty>
+		struct gemm_blocking {
+			typedef gemm_micro_kernel<Ty> kernel;
+			static constexpr std::size_t kc = 256U;
+			static constexpr std::size_t mc = 32U * kernel::mr;
+			static constexpr std::size_t nc = (4096U / sizeof(Ty) / kernel::nr) * kernel::nr * 4U;
+		};
+		/**
+		 * \brief Packs the `mc x kc` block of `a` (leading dimension `lda`) into contiguous micro-panels of
+		 *        `mr` rows stored column by column, zero-padding any partial panel at the bottom edge.
+		 */
+		template<std::size_t MR, typename Ty>
+		void pack_a_panel(std::size_t mc, std::size_t kc, const Ty* a, std::size_t lda, Ty* packed) {
+			for (std::size_t i = 0U; i < mc; i += MR) {
+				const std::size_t rows = std::min(MR, mc - i);
+				for (std::size_t k = 0U; k < kc; ++k) {
+					for (std::size_t r = 0U; r < rows; ++r)
+						*packed++ = a[(i + r)*lda + k];
+					for (std::size_t r = rows; r < MR; ++r)
+						*packed++ = Ty();
+				}
+			}
+		}
+		/**
+		 * \brief Packs the `kc x nc` block of `b` (leading dimension `ldb`) into contiguous micro-panels of
+		 *        `nr` columns stored row by row, zero-padding any partial panel at the right edge.
+		 */
+		template<std::size_t NR, typename Ty>
+		void pack_b_panel(std::size_t kc, std::size_t nc, const Ty* b, std::size_t ldb, Ty* packed) {
+			for (std::size_t j = 0U; j < nc; j += NR) {
+				const std::size_t cols = std::min(NR, nc - j);
+				for (std::size_t k = 0U; k < kc; ++k) {
+					const Ty* b_row = b + k*ldb + j;
+					for (std::size_t c = 0U; c < cols; ++c)
+						*packed++ = b_row[c];
+					for (std::size_t c = cols; c < NR; ++c)
+						*packed++ = Ty();
+				}
+			}
+		}
+		/**
+		 * \brief Computes `C += A*B` for row-major `A (m x k)`, `B (k x n)` and `C (m x n)` using a three-level
+		 *        cache-blocked algorithm on packed copies of the operands, dispatching each `mr x nr` tile of `C`
+		 *        to `gemm_micro_kernel<Ty>`.
+		 *
+		 * \complexity Linear in `m*n*k` multiply-adds plus linear in `m*k + k*n*(m/mc)` packing copies.
+		 */
+		template<typename Ty>
+		void gemm_packed(std::size_t m, std::size_t n, std::size_t k, const Ty* a, std::size_t lda,
+			const Ty* b, std::size_t ldb, Ty* c, std::size_t ldc) {
+			typedef gemm_micro_kernel<Ty> kernel;
+			typedef gemm_blocking<Ty> blocking;
+			const std::size_t MR = kernel::mr;
+			const std::size_t NR = kernel::nr;
+			const std::size_t KC = blocking::kc;
+			const std::size_t MC = blocking::mc;
+			const std::size_t NC = blocking::nc;
+			const std::size_t kc_max = std::min(k, KC);
+			const std::size_t mc_max = std::min(m, MC);
+			const std::size_t nc_max = std::min(n, NC);
+			std::vector<Ty> a_packed(((mc_max + MR - 1) / MR)*MR*kc_max);
+			std::vector<Ty> b_packed(((nc_max + NR - 1) / NR)*NR*kc_max);
+			Ty edge[kernel::mr*kernel::nr];
+			for (std::size_t jc = 0U; jc < n; jc += NC) {
+				const std::size_t nc = std::min(NC, n - jc);
+				for (std::size_t pc = 0U; pc < k; pc += KC) {
+					const std::size_t kc = std::min(KC, k - pc);
+					pack_b_panel<kernel::nr>(kc, nc, b + pc*ldb + jc, ldb, b_packed.data());
+					for (std::size_t ic = 0U; ic < m; ic += MC) {
+						const std::size_t mc = std::min(MC, m - ic);
+						pack_a_panel<kernel::mr>(mc, kc, a + ic*lda + pc, lda, a_packed.data());
+						for (std::size_t jr = 0U; jr < nc; jr += NR) {
+							const std::size_t nr = std::min(NR, nc - jr);
+							const Ty* b_panel = b_packed.data() + jr*kc;
+							for (std::size_t ir = 0U; ir < mc; ir += MR) {
+								const std::size_t mr = std::min(MR, mc - ir);
+								const Ty* a_panel = a_packed.data() + ir*kc;
+								Ty* c_tile = c + (ic + ir)*ldc + jc + jr;
+								if (mr == MR && nr == NR) {
+									kernel::run(kc, a_panel, b_panel, c_tile, ldc);
+									continue;
+								}
+								// partial tile at bottom/right edge, compute into scratch and add valid part
+								std::fill(edge, edge + MR*NR, Ty());
+								kernel::run(kc, a_panel, b_panel, edge, NR);
+								for (std::size_t i = 0U; i < mr; ++i) {
+									for (std::size_t j = 0U; j < nr; ++j)
+										c_tile[i*ldc + j] += edge[i*NR + j];
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+		/**
+		 * \brief Computes `C += A*B` for row-major operands using an i-k-j loop ordering such that the innermost
+		 *        loop walks contiguous rows of `B` and `C`. Used for non-arithmetic element types (for which
+		 *        zero-padding with `Ty()` cannot be assumed neutral) and for products too small to amortise packing.
+		 *
+		 * \complexity Linear in `m*n*k` multiply-adds.
+		 */
+		template<typename Ty>
+		void gemm_rowwise(std::size_t m, std::size_t n, std::size_t k, const Ty* a, std::size_t lda,
+			const Ty* b, std::size_t ldb, Ty* c, std::size_t ldc) {
+			for (std::size_t i = 0U; i < m; ++i) {
+				Ty* c_row = c + i*ldc;
+				for (std::size_t p = 0U; p < k; ++p) {
+					const Ty& a_ip = a[i*lda + p];
+					const Ty* b_row = b + p*ldb;
+					for (std::size_t j = 0U; j < n; ++j)
+						c_row[j] += a_ip * b_row[j];
+				}
+			}
+		}
+		template<typename Ty>
+		void gemm_dispatch(std::size_t m, std::size_t n, std::size_t k, const Ty* a, std::size_t lda,
+			const Ty* b, std::size_t ldb, Ty* c, std::size_t ldc, std::true_type) {
+			gemm_packed(m, n, k, a, lda, b, ldb, c, ldc);
+		}
+		template<typename Ty>
+		void gemm_dispatch(std::size_t m, std::size_t n, std::size_t k, const Ty* a, std::size_t lda,
+			const Ty* b, std::size_t ldb, Ty* c, std::size_t ldc, std::false_type) {
+			gemm_rowwise(m, n, k, a, lda, b, ldb, c, ldc);
+		}
+		/**
+		 * \brief Product size (in multiply-adds) below which `gemm` skips packing, the copies would cost
+		 *        more than the cache misses they avoid.
+		 */
+		constexpr std::size_t gemm_packing_threshold = 32U * 32U * 32U;
+		/**
+		 * \brief Minimum number of multiply-adds given to each thread by multithreaded matrix products.
+		 */
+		constexpr std::size_t gemm_parallel_min_work = 1U << 20;
+		/**
+		 * \brief Computes `C += A*B` for row-major `A (m x k)`, `B (k x n)` and `C (m x n)`, selecting the
+		 *        packed, register-blocked path for arithmetic types and the row-wise path otherwise.
+		 */
+		template<typename Ty>
+		void gemm(std::size_t m, std::size_t n, std::size_t k, const Ty* a, std::size_t lda,
+			const Ty* b, std::size_t ldb, Ty* c, std::size_t ldc) {
+			if (!m || !n || !k) return;
+			if (m*n*k >= gemm_packing_threshold)
+				gemm_dispatch(m, n, k, a, lda, b, ldb, c, ldc, std::is_arithmetic<Ty>());
+			else gemm_rowwise(m, n, k, a, lda, b, ldb, c, ldc);
+		}
+	}
+}
+
+#endif // !MATRIX_KERNELS_H
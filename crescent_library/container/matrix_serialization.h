@@ -0,0 +1,353 @@
+#ifndef MATRIX_SERIALIZATION_H
+#define MATRIX_SERIALIZATION_H
+#include "aligned_matrix.h"
+#include "atomic_file_writer.h"
+#include "dynamic_matrix.h"
+#include "fixed_matrix.h"
+#include "mapped_file.h"
+#include "mathematical_dynamic_matrix.h"
+#include "matrix_view.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace crsc {
+	/**
+	 * \brief Element type codes of the binary matrix format.
+	 */
+	enum class matrix_dtype : std::uint8_t {
+		int8 = 1, uint8, int16, uint16, int32, uint32, int64, uint64, float32, float64
+	};
+	/**
+	 * \brief Storage order of the elements in a binary matrix file.
+	 */
+	enum class matrix_layout : std::uint8_t {
+		row_major = 0,
+		column_major = 1
+	};
+	/**
+	 * \brief Returns the `matrix_dtype` of the arithmetic type `Ty`.
+	 */
+	template<typename Ty>
+	constexpr matrix_dtype matrix_dtype_of() noexcept {
+		static_assert(std::is_arithmetic<Ty>::value && !std::is_same<Ty, bool>::value && sizeof(Ty) <= 8U
+			&& (!std::is_floating_point<Ty>::value || sizeof(Ty) == 4U || sizeof(Ty) == 8U),
+			"binary matrix elements must be integers or IEEE single/double precision floating point types.");
+		return std::is_floating_point<Ty>::value ? (sizeof(Ty) == 4U ? matrix_dtype::float32 : matrix_dtype::float64)
+			: static_cast<matrix_dtype>((sizeof(Ty) == 1U ? 1 : sizeof(Ty) == 2U ? 3 : sizeof(Ty) == 4U ? 5 : 7)
+				+ (std::is_signed<Ty>::value ? 0 : 1));
+	}
+	/**
+	 * \brief Detail namespace for the binary matrix format. Nothing in this namespace is part of the public API.
+	 *
+	 * A file consists of a 64-byte header followed, from `data_offset`, by the `rows*columns` elements in
+	 * native byte order and the stated layout. All header fields are stored in native byte order, identified
+	 * by the byte order mark:
+	 *
+	 * | Offset | Size | Field                                              |
+	 * |--------|------|----------------------------------------------------|
+	 * | 0      | 8    | magic `"CRSCMAT1"`                                 |
+	 * | 8      | 4    | byte order mark `0x01020304`                       |
+	 * | 12     | 2    | format version, `1`                                |
+	 * | 14     | 1    | `matrix_dtype`                                     |
+	 * | 15     | 1    | `matrix_layout`                                    |
+	 * | 16     | 8    | rows                                               |
+	 * | 24     | 8    | columns                                            |
+	 * | 32     | 8    | data_offset, a multiple of alignment               |
+	 * | 40     | 8    | alignment of the data in bytes                     |
+	 * | 48     | 8    | element size in bytes                              |
+	 * | 56     | 8    | reserved, `0`                                      |
+	 */
+	namespace matrix_io_impl {
+		constexpr std::size_t header_size = 64U;
+		constexpr std::uint32_t byte_order_mark = 0x01020304U;
+		constexpr std::uint16_t version = 1U;
+		inline const char* magic() noexcept { return "CRSCMAT1"; }
+		struct header {
+			matrix_dtype dtype;
+			matrix_layout layout;
+			std::uint64_t rows;
+			std::uint64_t cols;
+			std::uint64_t data_offset;
+			std::uint64_t alignment;
+			std::uint64_t element_size;
+		};
+		template<class T>
+		void put(char* buf, std::size_t offset, T value) noexcept { std::memcpy(buf + offset, &value, sizeof(T)); }
+		template<class T>
+		T get(const char* buf, std::size_t offset) noexcept {
+			T value;
+			std::memcpy(&value, buf + offset, sizeof(T));
+			return value;
+		}
+		inline void encode(const header& h, char* buf) noexcept {
+			std::memset(buf, 0, header_size);
+			std::memcpy(buf, magic(), 8U);
+			put(buf, 8U, byte_order_mark);
+			put(buf, 12U, version);
+			put(buf, 14U, static_cast<std::uint8_t>(h.dtype));
+			put(buf, 15U, static_cast<std::uint8_t>(h.layout));
+			put(buf, 16U, h.rows);
+			put(buf, 24U, h.cols);
+			put(buf, 32U, h.data_offset);
+			put(buf, 40U, h.alignment);
+			put(buf, 48U, h.element_size);
+		}
+		/**
+		 * \brief Decodes and validates the header of the binary matrix file `file` named `filename`.
+		 *
+		 * \throw Throws `std::runtime_error` if the file is not a valid binary matrix file.
+		 */
+		inline header decode(const mapped_file& file, const std::string& filename) {
+			const char* buf = file.data();
+			if (file.size() < header_size || std::memcmp(buf, magic(), 8U))
+				throw std::runtime_error("File: " + filename + " is not a binary matrix file.");
+			if (get<std::uint32_t>(buf, 8U) != byte_order_mark)
+				throw std::runtime_error("File: " + filename + " was written with a different byte order.");
+			if (get<std::uint16_t>(buf, 12U) != version)
+				throw std::runtime_error("File: " + filename + " has an unsupported binary matrix format version.");
+			header h;
+			h.dtype = static_cast<matrix_dtype>(get<std::uint8_t>(buf, 14U));
+			h.layout = static_cast<matrix_layout>(get<std::uint8_t>(buf, 15U));
+			h.rows = get<std::uint64_t>(buf, 16U);
+			h.cols = get<std::uint64_t>(buf, 24U);
+			h.data_offset = get<std::uint64_t>(buf, 32U);
+			h.alignment = get<std::uint64_t>(buf, 40U);
+			h.element_size = get<std::uint64_t>(buf, 48U);
+			const std::uint64_t max_elements = h.element_size ? (std::uint64_t(-1) - h.data_offset)/h.element_size : 0U;
+			if ((h.layout != matrix_layout::row_major && h.layout != matrix_layout::column_major) || !h.element_size
+				|| !h.alignment || (h.alignment & (h.alignment - 1U)) || h.data_offset % h.alignment
+				|| h.data_offset < header_size || (h.cols && h.rows > max_elements/h.cols)
+				|| h.data_offset + h.rows*h.cols*h.element_size > file.size())
+				throw std::runtime_error("File: " + filename + " has a corrupt binary matrix header.");
+			return h;
+		}
+		/**
+		 * \brief Returns the smallest multiple of the power of two `alignment` of at least `n`.
+		 */
+		inline std::uint64_t align_up(std::uint64_t n, std::uint64_t alignment) noexcept {
+			return (n + alignment - 1U) & ~(alignment - 1U);
+		}
+	}
+	/**
+	 * \brief Writes the elements viewed by `mv` to the file `filename` in the binary matrix format, replacing
+	 *        the file atomically and durably (see `crsc::atomic_file_writer`).
+	 *
+	 * Contiguous row-major or column-major views are written in their own layout with a single bulk write of
+	 * the element storage, any other view is written row by row in row-major layout.
+	 *
+	 * \param filename Name/directory of the file.
+	 * \param mv View of the elements to save.
+	 * \param alignment Alignment, in bytes, of the element data within the file (and hence of the data of a
+	 *        `mapped_matrix` of the file); a power of two of at most the page size, `4096`.
+	 * \throw Throws `std::invalid_argument` if `alignment` is invalid, or `std::system_error` if the file
+	 *        cannot be written, in which case any existing file is left unchanged.
+	 * \complexity Linear in `mv.size()`.
+	 */
+	template<typename Ty>
+	void save_matrix(const std::string& filename, const matrix_view<Ty>& mv, std::size_t alignment = 64U) {
+		typedef std::remove_cv_t<Ty> value_type;
+		if (!alignment || (alignment & (alignment - 1U)) || alignment > 4096U || alignment < alignof(value_type))
+			throw std::invalid_argument("binary matrix alignment must be a power of two in [alignof(Ty), 4096].");
+		const std::size_t rows = mv.rows(), cols = mv.columns();
+		const bool row_contiguous = mv.column_stride() == 1U && (mv.row_stride() == cols || rows <= 1U);
+		const bool column_contiguous = !row_contiguous && mv.row_stride() == 1U && (mv.column_stride() == rows || cols <= 1U);
+		matrix_io_impl::header h;
+		h.dtype = matrix_dtype_of<value_type>();
+		h.layout = column_contiguous ? matrix_layout::column_major : matrix_layout::row_major;
+		h.rows = rows;
+		h.cols = cols;
+		h.alignment = alignment;
+		h.data_offset = matrix_io_impl::align_up(matrix_io_impl::header_size, alignment);
+		h.element_size = sizeof(value_type);
+		std::vector<char> head(static_cast<std::size_t>(h.data_offset), '\0');
+		matrix_io_impl::encode(h, head.data());
+		atomic_file_writer writer(filename);
+		writer.write(head.data(), head.size());
+		if (rows && cols) {
+			if (row_contiguous || column_contiguous)
+				writer.write(reinterpret_cast<const char*>(mv.data()), rows*cols*sizeof(value_type));
+			else if (mv.column_stride() == 1U) {
+				for (std::size_t i = 0U; i < rows; ++i)
+					writer.write(reinterpret_cast<const char*>(mv.data() + i*mv.row_stride()), cols*sizeof(value_type));
+			}
+			else {
+				std::vector<value_type> row(cols);
+				for (std::size_t i = 0U; i < rows; ++i) {
+					for (std::size_t j = 0U; j < cols; ++j) row[j] = mv(i, j);
+					writer.write(reinterpret_cast<const char*>(row.data()), cols*sizeof(value_type));
+				}
+			}
+		}
+		writer.commit();
+	}
+	/**
+	 * \brief Writes the matrix container `m`, with contiguous row-major storage provided through `data()`,
+	 *        `rows()` and `columns()` (`dynamic_matrix`, `mathematical_dynamic_matrix`, `fixed_matrix`), to
+	 *        the file `filename` in the binary matrix format.
+	 *
+	 * \see save_matrix(const std::string&, const matrix_view<Ty>&, std::size_t)
+	 */
+	template<class Matrix>
+	void save_matrix(const std::string& filename, const Matrix& m, std::size_t alignment = 64U) {
+		save_matrix(filename, make_matrix_view(m), alignment);
+	}
+	/**
+	 * \brief Writes the `aligned_matrix` `m`, without its padding, to the file `filename` in the binary
+	 *        matrix format.
+	 *
+	 * \see save_matrix(const std::string&, const matrix_view<Ty>&, std::size_t)
+	 */
+	template<typename Ty,
+		class Layout,
+		std::size_t Alignment
+	> void save_matrix(const std::string& filename, const aligned_matrix<Ty, Layout, Alignment>& m, std::size_t alignment = 64U) {
+		save_matrix(filename, m.view(), alignment);
+	}
+	/**
+	 * \class mapped_matrix
+	 *
+	 * \brief A read-only matrix backed by a memory mapping of a binary matrix file (see `save_matrix`), such
+	 *        that opening it neither reads nor copies the elements - they are paged in on first access.
+	 *
+	 * The elements are accessed through `view()`, a `matrix_view<const Ty>` which may be used with every
+	 * operation on views, e.g. as an operand of the lazy element-wise operators or `matrix_product`, or to
+	 * construct a container such as `aligned_matrix<Ty>(mm.view())`. Views (and pointers into the data) are
+	 * valid until the `mapped_matrix` is destroyed; moving it transfers the mapping without invalidating them.
+	 *
+	 * \tparam Ty The type of the elements, which must match the element type of the file.
+	 */
+	template<typename Ty>
+	class mapped_matrix {
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef Ty value_type;
+		typedef const Ty& const_reference;
+		typedef const Ty* const_pointer;
+		typedef std::size_t size_type;
+		// CONSTRUCTION
+		/**
+		 * \brief Maps the binary matrix file `filename`.
+		 *
+		 * \param filename Name/directory of the file.
+		 * \throw Throws `std::system_error` if the file cannot be mapped, or `std::runtime_error` if it is not
+		 *        a valid binary matrix file of elements of type `Ty` in native byte order.
+		 * \complexity Constant.
+		 */
+		explicit mapped_matrix(const std::string& filename)
+			: file(filename) {
+			const matrix_io_impl::header h = matrix_io_impl::decode(file, filename);
+			if (h.dtype != matrix_dtype_of<Ty>() || h.element_size != sizeof(Ty))
+				throw std::runtime_error("File: " + filename + " does not hold elements of the requested type.");
+			if (h.data_offset % alignof(Ty))
+				throw std::runtime_error("File: " + filename + " has misaligned element data.");
+			nrows = static_cast<size_type>(h.rows);
+			ncols = static_cast<size_type>(h.cols);
+			lay = h.layout;
+			ptr = reinterpret_cast<const Ty*>(file.data() + h.data_offset);
+		}
+		mapped_matrix(const mapped_matrix&) = delete;
+		mapped_matrix& operator=(const mapped_matrix&) = delete;
+		mapped_matrix(mapped_matrix&&) = default;
+		mapped_matrix& operator=(mapped_matrix&&) = default;
+		// CAPACITY
+		size_type rows() const noexcept { return nrows; }
+		size_type columns() const noexcept { return ncols; }
+		size_type size() const noexcept { return nrows*ncols; }
+		bool empty() const noexcept { return !size(); }
+		matrix_layout layout() const noexcept { return lay; }
+		// ELEMENT ACCESS
+		/**
+		 * \brief Returns the element at position `(i, j)`, without bounds-checking.
+		 */
+		const_reference operator()(size_type i, size_type j) const noexcept {
+			return (lay == matrix_layout::row_major) ? ptr[i*ncols + j] : ptr[j*nrows + i];
+		}
+		/**
+		 * \brief Returns a pointer to the element storage, in the order given by `layout()`.
+		 */
+		const_pointer data() const noexcept { return ptr; }
+		/**
+		 * \brief Returns a `rows() x columns()` view of the elements.
+		 */
+		matrix_view<const Ty> view() const noexcept {
+			return (lay == matrix_layout::row_major) ? matrix_view<const Ty>(ptr, nrows, ncols)
+				: matrix_view<const Ty>(ptr, nrows, ncols, 1U, nrows);
+		}
+		/**
+		 * \brief Advises the operating system of the expected access pattern of the elements.
+		 */
+		void advise(mapped_file::access_hint hint) const noexcept { file.advise(hint); }
+	private:
+		mapped_file file;
+		const Ty* ptr = nullptr;
+		size_type nrows = 0U;
+		size_type ncols = 0U;
+		matrix_layout lay = matrix_layout::row_major;
+	};
+	namespace matrix_io_impl {
+		/**
+		 * \brief Copies the elements of `src` into the contiguous row-major storage `out`.
+		 */
+		template<typename Ty>
+		void copy_row_major(const mapped_matrix<Ty>& src, Ty* out) {
+			if (src.empty()) return;
+			if (src.layout() == matrix_layout::row_major) {
+				src.advise(mapped_file::access_hint::sequential);
+				std::memcpy(out, src.data(), src.size()*sizeof(Ty));
+				return;
+			}
+			matrix_view<Ty>(out, src.rows(), src.columns()).assign(src.view());
+		}
+	}
+	/**
+	 * \brief Loads the binary matrix file `filename` into `m`, replacing its contents and dimensions.
+	 *
+	 * \throw Throws as `mapped_matrix<Ty>(filename)`.
+	 * \complexity Linear in the number of elements of the file, copied in bulk from a mapping of the file.
+	 */
+	template<typename Ty,
+		class Allocator
+	> void load_matrix(const std::string& filename, dynamic_matrix<Ty, Allocator>& m) {
+		const mapped_matrix<Ty> src(filename);
+		dynamic_matrix<Ty, Allocator> tmp(src.rows(), src.columns(), m.get_allocator());
+		matrix_io_impl::copy_row_major(src, tmp.data());
+		m.swap(tmp);
+	}
+	/**
+	 * \brief Loads the binary matrix file `filename` into `m`, replacing its contents and dimensions but
+	 *        keeping its execution policy.
+	 *
+	 * \see load_matrix(const std::string&, dynamic_matrix<Ty, Allocator>&)
+	 */
+	template<typename Ty,
+		class Allocator
+	> void load_matrix(const std::string& filename, mathematical_dynamic_matrix<Ty, Allocator>& m) {
+		const mapped_matrix<Ty> src(filename);
+		mathematical_dynamic_matrix<Ty, Allocator> tmp(src.rows(), src.columns(), m.get_allocator());
+		matrix_io_impl::copy_row_major(src, tmp.data());
+		tmp.set_execution_policy(m.execution_policy());
+		m.swap(tmp);
+	}
+	/**
+	 * \brief Loads the binary matrix file `filename` into `m`.
+	 *
+	 * \throw Throws `std::invalid_argument` if the dimensions of the file are not `Rows x Cols`, otherwise
+	 *        throws as `mapped_matrix<Ty>(filename)`.
+	 */
+	template<typename Ty,
+		std::size_t Rows,
+		std::size_t Cols
+	> void load_matrix(const std::string& filename, fixed_matrix<Ty, Rows, Cols>& m) {
+		const mapped_matrix<Ty> src(filename);
+		if (src.rows() != Rows || src.columns() != Cols)
+			throw std::invalid_argument("File: " + filename + " does not hold a matrix of the dimensions of the fixed_matrix.");
+		matrix_io_impl::copy_row_major(src, m.data());
+	}
+}
+
+#endif // !MATRIX_SERIALIZATION_H
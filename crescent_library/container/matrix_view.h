@@ -0,0 +1,365 @@
+#ifndef MATRIX_VIEW_H
+#define MATRIX_VIEW_H
+#include "matrix_expression.h"
+#include "matrix_kernels.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace crsc {
+	/**
+	 * \class matrix_view_iterator
+	 *
+	 * \brief Random access iterator over the elements of a `matrix_view`, traversing the viewed elements by
+	 *        rows from left to right, top to bottom.
+	 *
+	 * \tparam Ty The type of the elements, `const`-qualified for a constant iterator.
+	 */
+	template<typename Ty>
+	class matrix_view_iterator {
+		template<typename> friend class matrix_view_iterator;
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef std::remove_cv_t<Ty> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef Ty* pointer;
+		typedef Ty& reference;
+		matrix_view_iterator() noexcept
+			: base(nullptr), idx(0U), cols(1U), rstride(0U), cstride(0U) {}
+		matrix_view_iterator(Ty* _base, std::size_t _idx, std::size_t _cols, std::size_t _rstride, std::size_t _cstride) noexcept
+			: base(_base), idx(_idx), cols(std::max<std::size_t>(_cols, 1U)), rstride(_rstride), cstride(_cstride) {}
+		template<typename Uty,
+			class = std::enable_if_t<std::is_convertible<Uty*, Ty*>::value>
+		> matrix_view_iterator(const matrix_view_iterator<Uty>& other) noexcept
+			: base(other.base), idx(other.idx), cols(other.cols), rstride(other.rstride), cstride(other.cstride) {}
+		reference operator*() const noexcept { return base[(idx / cols)*rstride + (idx % cols)*cstride]; }
+		pointer operator->() const noexcept { return &**this; }
+		reference operator[](difference_type n) const noexcept { return *(*this + n); }
+		matrix_view_iterator& operator++() noexcept { ++idx; return *this; }
+		matrix_view_iterator operator++(int) noexcept { matrix_view_iterator tmp(*this); ++idx; return tmp; }
+		matrix_view_iterator& operator--() noexcept { --idx; return *this; }
+		matrix_view_iterator operator--(int) noexcept { matrix_view_iterator tmp(*this); --idx; return tmp; }
+		matrix_view_iterator& operator+=(difference_type n) noexcept { idx += n; return *this; }
+		matrix_view_iterator& operator-=(difference_type n) noexcept { idx -= n; return *this; }
+		friend matrix_view_iterator operator+(matrix_view_iterator it, difference_type n) noexcept { return it += n; }
+		friend matrix_view_iterator operator+(difference_type n, matrix_view_iterator it) noexcept { return it += n; }
+		friend matrix_view_iterator operator-(matrix_view_iterator it, difference_type n) noexcept { return it -= n; }
+		friend difference_type operator-(const matrix_view_iterator& lhs, const matrix_view_iterator& rhs) noexcept {
+			return static_cast<difference_type>(lhs.idx) - static_cast<difference_type>(rhs.idx);
+		}
+		friend bool operator==(const matrix_view_iterator& lhs, const matrix_view_iterator& rhs) noexcept { return lhs.idx == rhs.idx; }
+		friend bool operator!=(const matrix_view_iterator& lhs, const matrix_view_iterator& rhs) noexcept { return lhs.idx != rhs.idx; }
+		friend bool operator<(const matrix_view_iterator& lhs, const matrix_view_iterator& rhs) noexcept { return lhs.idx < rhs.idx; }
+		friend bool operator>(const matrix_view_iterator& lhs, const matrix_view_iterator& rhs) noexcept { return lhs.idx > rhs.idx; }
+		friend bool operator<=(const matrix_view_iterator& lhs, const matrix_view_iterator& rhs) noexcept { return lhs.idx <= rhs.idx; }
+		friend bool operator>=(const matrix_view_iterator& lhs, const matrix_view_iterator& rhs) noexcept { return lhs.idx >= rhs.idx; }
+	private:
+		Ty* base;
+		std::size_t idx;
+		std::size_t cols;
+		std::size_t rstride;
+		std::size_t cstride;
+	};
+	/**
+	 * \class matrix_view
+	 *
+	 * \brief A non-owning view of a two-dimensional block of elements described by a base pointer, a shape
+	 *        and a stride (in elements) between consecutive rows and between consecutive columns.
+	 *
+	 * The element at position `(i, j)` of the view refers to `data()[i*row_stride() + j*column_stride()]`,
+	 * such that views of whole matrices, blocks, single rows, single columns and transposes of any of these
+	 * can all be formed in constant time without copying. Views may be created over the storage of
+	 * `dynamic_matrix`, `mathematical_dynamic_matrix` and `fixed_matrix` via `make_matrix_view`, or over
+	 * any externally owned buffer via the pointer constructors.
+	 *
+	 * A `matrix_view` is a `matrix_expression`, so it may be used as an operand of the lazily evaluated
+	 * element-wise operators, and a view of non-const elements may be the destination of such an expression
+	 * through `assign`, `+=` and `-=`.
+	 *
+	 * Copying a `matrix_view` copies the view itself, not the elements - use `assign` to copy elements.
+	 *
+	 * \tparam Ty The type of the elements, a view of `const Ty` provides read-only access.
+	 * \warning A view does not own the elements it refers to, it is invalidated by any operation which
+	 *          reallocates or destroys the underlying storage (e.g. resizing the viewed `dynamic_matrix`).
+	 */
+	template<typename Ty>
+	class matrix_view : public matrix_expression<matrix_view<Ty>>,
+		public matrix_expression_impl::node_tag {
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef std::remove_cv_t<Ty> value_type;
+		typedef Ty& reference;
+		typedef const Ty& const_reference;
+		typedef Ty* pointer;
+		typedef const Ty* const_pointer;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef matrix_view_iterator<Ty> iterator;
+		typedef matrix_view_iterator<const Ty> const_iterator;
+		typedef std::reverse_iterator<iterator> reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+		static constexpr size_type static_rows = 0U;
+		static constexpr size_type static_columns = 0U;
+		// CONSTRUCTION
+		/**
+		 * \brief Default constructor, constructs an empty view.
+		 */
+		matrix_view() noexcept
+			: ptr(nullptr), nrows(0U), ncols(0U), rstride(0U), cstride(1U) {}
+		/**
+		 * \brief Constructs a view of the contiguous row-major buffer `_data` of dimensions `_rows x _cols`.
+		 *
+		 * \param _data Pointer to the first element.
+		 * \param _rows Number of rows.
+		 * \param _cols Number of columns.
+		 */
+		matrix_view(pointer _data, size_type _rows, size_type _cols) noexcept
+			: ptr(_data), nrows(_rows), ncols(_cols), rstride(_cols), cstride(1U) {}
+		/**
+		 * \brief Constructs a view of dimensions `_rows x _cols` with the specified strides between
+		 *        rows and columns, e.g. a column-major buffer is viewed with `_row_stride = 1` and
+		 *        `_col_stride = _rows`.
+		 *
+		 * \param _data Pointer to the element at position `(0, 0)`.
+		 * \param _rows Number of rows.
+		 * \param _cols Number of columns.
+		 * \param _row_stride Distance, in elements, between consecutive rows.
+		 * \param _col_stride Distance, in elements, between consecutive columns.
+		 */
+		matrix_view(pointer _data, size_type _rows, size_type _cols, size_type _row_stride, size_type _col_stride = 1U) noexcept
+			: ptr(_data), nrows(_rows), ncols(_cols), rstride(_row_stride), cstride(_col_stride) {}
+		/**
+		 * \brief Converting constructor, a view of `Uty` converts to a view of `const Uty`.
+		 */
+		template<typename Uty,
+			class = std::enable_if_t<std::is_convertible<Uty*, Ty*>::value>
+		> matrix_view(const matrix_view<Uty>& other) noexcept
+			: ptr(other.data()), nrows(other.rows()), ncols(other.columns()),
+			rstride(other.row_stride()), cstride(other.column_stride()) {}
+		// CAPACITY
+		bool empty() const noexcept { return !nrows || !ncols; }
+		size_type rows() const noexcept { return nrows; }
+		size_type columns() const noexcept { return ncols; }
+		size_type size() const noexcept { return nrows*ncols; }
+		size_type row_stride() const noexcept { return rstride; }
+		size_type column_stride() const noexcept { return cstride; }
+		/**
+		 * \brief Returns `true` if the viewed elements occupy the contiguous range `[data(), data() + size())`
+		 *        in row-major order.
+		 */
+		bool is_contiguous() const noexcept { return (cstride == 1U || ncols <= 1U) && (rstride == ncols || nrows <= 1U); }
+		// ELEMENT ACCESS
+		/**
+		 * \brief Returns a reference to the element at position `(i, j)`, with bounds checking.
+		 *
+		 * \throw Throws `std::out_of_range` exception if `i >= rows() || j >= columns()`.
+		 */
+		reference at(size_type i, size_type j) const {
+			if (i >= nrows || j >= ncols) throw std::out_of_range("matrix_view index out of bounds.");
+			return (*this)(i, j);
+		}
+		/**
+		 * \brief Returns a reference to the element at position `(i, j)`, without bounds checking.
+		 */
+		reference operator()(size_type i, size_type j) const noexcept { return ptr[i*rstride + j*cstride]; }
+		/**
+		 * \brief Returns a pointer to the element at position `(0, 0)`.
+		 */
+		pointer data() const noexcept { return ptr; }
+		/**
+		 * \brief Returns the element at position `(i, j)` for the evaluation of matrix expressions.
+		 */
+		const_reference eval(size_type i, size_type j) const noexcept { return ptr[i*rstride + j*cstride]; }
+		// VIEWS
+		/**
+		 * \brief Returns a view of the `_rows x _cols` block of this view whose top-left element is at
+		 *        position `(i, j)`.
+		 *
+		 * \throw Throws `std::out_of_range` exception if the block does not lie within this view.
+		 * \complexity Constant.
+		 */
+		matrix_view block(size_type i, size_type j, size_type _rows, size_type _cols) const {
+			if (i > nrows || j > ncols || _rows > nrows - i || _cols > ncols - j)
+				throw std::out_of_range("matrix_view block out of bounds.");
+			return matrix_view(ptr + i*rstride + j*cstride, _rows, _cols, rstride, cstride);
+		}
+		/**
+		 * \brief Returns a `1 x columns()` view of row `i`.
+		 *
+		 * \throw Throws `std::out_of_range` exception if `i >= rows()`.
+		 */
+		matrix_view row(size_type i) const {
+			if (i >= nrows) throw std::out_of_range("matrix_view row index out of bounds.");
+			return matrix_view(ptr + i*rstride, 1U, ncols, rstride, cstride);
+		}
+		/**
+		 * \brief Returns a `rows() x 1` view of column `j`.
+		 *
+		 * \throw Throws `std::out_of_range` exception if `j >= columns()`.
+		 */
+		matrix_view column(size_type j) const {
+			if (j >= ncols) throw std::out_of_range("matrix_view column index out of bounds.");
+			return matrix_view(ptr + j*cstride, nrows, 1U, rstride, cstride);
+		}
+		/**
+		 * \brief Returns a `columns() x rows()` view of the transpose of this view.
+		 */
+		matrix_view transpose() const noexcept { return matrix_view(ptr, ncols, nrows, cstride, rstride); }
+		// OPERATIONS
+		/**
+		 * \brief Assigns the given value `val` to all viewed elements.
+		 *
+		 * \complexity Exactly `size()` assignments.
+		 */
+		void fill(const value_type& val) const {
+			static_assert(!std::is_const<Ty>::value, "cannot modify the elements of a matrix_view of const elements.");
+			for (size_type i = 0U; i < nrows; ++i) {
+				for (size_type j = 0U; j < ncols; ++j) (*this)(i, j) = val;
+			}
+		}
+		/**
+		 * \brief Replaces the viewed elements with the result of evaluating the element-wise matrix
+		 *        expression `expr` in a single pass.
+		 *
+		 * \warning `expr` must not refer to elements which overlap with, but are not identically laid out
+		 *          as, the elements of this view (e.g. `v.assign(v.transpose())`).
+		 * \throw Throws `std::invalid_argument` exception if the dimensions of `expr` differ from this view.
+		 * \complexity Linear in `size()`.
+		 */
+		template<class Expr>
+		const matrix_view& assign(const matrix_expression<Expr>& expr) const {
+			evaluate_expression<matrix_expression_impl::assign>(expr.self());
+			return *this;
+		}
+		/**
+		 * \brief Adds the result of evaluating the element-wise matrix expression `expr` to the viewed elements.
+		 *
+		 * \throw Throws `std::invalid_argument` exception if the dimensions of `expr` differ from this view.
+		 */
+		template<class Expr>
+		const matrix_view& operator+=(const matrix_expression<Expr>& expr) const {
+			evaluate_expression<matrix_expression_impl::plus_assign>(expr.self());
+			return *this;
+		}
+		/**
+		 * \brief Subtracts the result of evaluating the element-wise matrix expression `expr` from the viewed elements.
+		 *
+		 * \throw Throws `std::invalid_argument` exception if the dimensions of `expr` differ from this view.
+		 */
+		template<class Expr>
+		const matrix_view& operator-=(const matrix_expression<Expr>& expr) const {
+			evaluate_expression<matrix_expression_impl::minus_assign>(expr.self());
+			return *this;
+		}
+		/**
+		 * \brief Multiplies each viewed element by `scale`.
+		 */
+		const matrix_view& operator*=(const value_type& scale) const {
+			static_assert(!std::is_const<Ty>::value, "cannot modify the elements of a matrix_view of const elements.");
+			for (size_type i = 0U; i < nrows; ++i) {
+				for (size_type j = 0U; j < ncols; ++j) (*this)(i, j) *= scale;
+			}
+			return *this;
+		}
+		// ITERATORS
+		iterator begin() const noexcept { return iterator(ptr, 0U, ncols, rstride, cstride); }
+		iterator end() const noexcept { return iterator(ptr, size(), ncols, rstride, cstride); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+		reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+		reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+	private:
+		pointer ptr;
+		size_type nrows;
+		size_type ncols;
+		size_type rstride;
+		size_type cstride;
+		template<class AssignOp, class Expr>
+		void evaluate_expression(const Expr& expr) const {
+			static_assert(!std::is_const<Ty>::value, "cannot modify the elements of a matrix_view of const elements.");
+			const matrix_expression_impl::operand_t<Expr> operand = matrix_expression_impl::make_operand(expr);
+			if (operand.rows() != nrows || operand.columns() != ncols)
+				throw std::invalid_argument("matrix_expression dimensions must agree with matrix_view dimensions.");
+			matrix_expression_impl::evaluate<AssignOp>(ptr, rstride, cstride, operand, 0U, nrows);
+		}
+	};
+	namespace matrix_expression_impl {
+		template<typename Ty>
+		struct has_view_operand<matrix_view<Ty>> : std::true_type {};
+	}
+	/**
+	 * \brief Makes a `matrix_view` of all elements of the matrix container `m`, which must provide contiguous
+	 *        row-major storage through `data()`, `rows()` and `columns()`.
+	 *
+	 * \param m Container to view, a view of const elements is returned if `m` is const.
+	 * \return `rows() x columns()` view of `m`.
+	 * \complexity Constant.
+	 */
+	template<class Matrix>
+	auto make_matrix_view(Matrix& m) noexcept -> matrix_view<std::remove_pointer_t<decltype(m.data())>> {
+		return matrix_view<std::remove_pointer_t<decltype(m.data())>>(m.data(), m.rows(), m.columns());
+	}
+	/**
+	 * \brief Computes the matrix product of `lhs` with `rhs`, writing the result into the elements viewed by `out`.
+	 *
+	 * When every view has a column stride of `1` (row-major), or every view has a row stride of `1`
+	 * (column-major), the product uses the same cache-blocked kernels as `matrix_product` for
+	 * `dynamic_matrix`, operating directly on the viewed storage.
+	 *
+	 * \warning `out` must not overlap with `lhs` or `rhs`.
+	 * \param lhs First view.
+	 * \param rhs Second view.
+	 * \param out Destination view of dimensions `lhs.rows() x rhs.columns()`.
+	 * \throw Throws `std::invalid_argument` exception if `lhs.columns() != rhs.rows()` or if the
+	 *        dimensions of `out` are not `lhs.rows() x rhs.columns()`.
+	 * \complexity Linear in `lhs.rows()*rhs.columns()*lhs.columns()`.
+	 */
+	template<typename Ty,
+		typename Lty,
+		typename Rty
+	> void matrix_product(const matrix_view<Lty>& lhs, const matrix_view<Rty>& rhs, const matrix_view<Ty>& out) {
+		static_assert(!std::is_const<Ty>::value, "matrix_product destination must be a matrix_view of non-const elements.");
+		static_assert(std::is_same<Ty, std::remove_cv_t<Lty>>::value && std::is_same<Ty, std::remove_cv_t<Rty>>::value,
+			"matrix_product operands must have the same value_type.");
+		if (lhs.columns() != rhs.rows() || out.rows() != lhs.rows() || out.columns() != rhs.columns())
+			throw std::invalid_argument("matrix_view dimensions must agree for matrix_product.");
+		out.fill(Ty());
+		if (lhs.column_stride() == 1U && rhs.column_stride() == 1U && out.column_stride() == 1U) {
+			matrix_kernels_impl::gemm(lhs.rows(), rhs.columns(), lhs.columns(), lhs.data(), lhs.row_stride(),
+				rhs.data(), rhs.row_stride(), out.data(), out.row_stride());
+			return;
+		}
+		if (lhs.row_stride() == 1U && rhs.row_stride() == 1U && out.row_stride() == 1U) {	// column-major, out^T = rhs^T * lhs^T
+			matrix_kernels_impl::gemm(rhs.columns(), lhs.rows(), lhs.columns(), rhs.data(), rhs.column_stride(),
+				lhs.data(), lhs.column_stride(), out.data(), out.column_stride());
+			return;
+		}
+		for (std::size_t i = 0U; i < lhs.rows(); ++i) {
+			for (std::size_t k = 0U; k < lhs.columns(); ++k) {
+				const Ty a = lhs(i, k);
+				for (std::size_t j = 0U; j < rhs.columns(); ++j)
+					out(i, j) += a * rhs(k, j);
+			}
+		}
+	}
+	/**
+	 * \brief Computes the trace of a square `matrix_view`.
+	 *
+	 * \throw Throws `std::invalid_argument` exception if `mv.rows() != mv.columns()`.
+	 * \complexity Linear in `mv.rows()`.
+	 */
+	template<typename Ty>
+	std::remove_cv_t<Ty> matrix_trace(const matrix_view<Ty>& mv) {
+		if (mv.rows() != mv.columns()) throw std::invalid_argument("cannot compute trace of non-square matrix_view.");
+		std::remove_cv_t<Ty> trace = std::remove_cv_t<Ty>();
+		for (std::size_t i = 0U; i < mv.rows(); ++i)
+			trace += mv(i, i);
+		return trace;
+	}
+}
+
+#endif // !MATRIX_VIEW_H
@@ -23,6 +23,8 @@ namespace crsc {
 	 * alter item values, clear the container and iterate over the container with `const_iterator`s which the 
 	 * STL priority queue does not provide. In addition, similarly to `std::priority_queue`, every method is guaranteed
 	 * to preserve the class invariant such that the heap is not invalidated at any point between method calls.
+	 * Altering or erasing an element by value or predicate requires a linear search, see
+	 * `crsc::addressable_priority_queue` for logarithmic alteration and erasure via handles.
 	 *
 	 * \tparam Ty The type of the elements.
 	 * \tparam _Cntr The type of the underlying container to use to store the elements. The container must satisfy the
@@ -32,6 +34,10 @@ namespace crsc {
 	 *         - `pop_back()`
 	 *         - `emplace_back()`
 	 * \tparam _Pr A `Compare` type providing a strict weak ordering, defaults to `std::less<Ty>`.
+	 * \tparam Arity Number of children of each heap node, defaults to 2 (binary heap). Wider heaps (typically
+	 *         4 or 8) are shallower, such that `dequeue` touches fewer levels, each of whose children are
+	 *         adjacent in memory, at the expense of more comparisons per level; favour them for pop-heavy use
+	 *         of large queues.
 	 * \invariant The heap (whose ordering/behaviour is defined by the comparator `_Pr`) shall never be invalidated
 	 *            between method calls, and if any exceptions are thrown by a method the heap shall never be left in
 	 *            a state which would invalidate the heap.
@@ -40,8 +46,10 @@ namespace crsc {
 	 */
 	template<typename Ty,
 		class _Cntr = std::vector<Ty>,
-		class _Pr = std::less<Ty>
+		class _Pr = std::less<Ty>,
+		std::size_t Arity = 2
 	> class priority_queue {
+		static_assert(Arity >= 2, "priority_queue heap arity must be at least 2.");
 	public:
 		// PUBLIC API TYPE DEFINITIONS
 		typedef Ty value_type;
@@ -311,6 +319,34 @@ namespace crsc {
 			heap_cntr.emplace_back(std::forward<Args>(_args)...);
 			bubble_up(heap_cntr.size() - 1);
 		}
+		/**
+		 * \brief Pushes the items of the range `[first, last)` into the container. When the range is large
+		 *        relative to the container the heap is rebuilt in one pass rather than sorting each item.
+		 *
+		 * \param first Beginning of range of values to enqueue.
+		 * \param last End of range of values to enqueue.
+		 * \complexity Linear in the size of the container plus the size of the range if the range is at
+		 *             least as large as the container, otherwise the size of the range multiplied by
+		 *             logarithmic in the size of the container.
+		 * \exceptionsafety Strong-guarantee for the insertion of the range, if an exception is thrown
+		 *                  whilst inserting the items (e.g. by the iterator or a copy) the items inserted
+		 *                  thus far are removed and the container is unchanged. Basic-guarantee if an
+		 *                  exception is thrown whilst ordering the inserted items.
+		 */
+		template<class InputIt>
+		void enqueue(InputIt first, InputIt last) {
+			const size_type old_size = heap_cntr.size();
+			try {
+				heap_cntr.insert(heap_cntr.end(), first, last);
+			}
+			catch (...) {
+				heap_cntr.erase(heap_cntr.begin() + old_size, heap_cntr.end());
+				throw;
+			}
+			const size_type count = heap_cntr.size() - old_size;
+			if (count >= old_size) heapify();
+			else for (size_type i = old_size; i < heap_cntr.size(); ++i) bubble_up(i);
+		}
 		/**
 		 * \brief Pops the top item from the container.
 		 * 
@@ -580,8 +616,9 @@ namespace crsc {
 		_Cntr heap_cntr;	// underlying heap container
 		_Pr comp;	// comparator function-object, determines element priorities
 		/**
-		 * \brief Bubbles down the heap from a given vector index, performing
-		 *        swaps based on comparator conditions.
+		 * \brief Bubbles down the heap from a given vector index, moving the element at `_pos` past each
+		 *        of its higher priority children (the highest of the `Arity` children of each node) until
+		 *        it is correctly placed.
 		 *
 		 * \param _pos Index to perform bubbling down from.
 		 * \complexity Logarithmic in the size of the container.
@@ -589,30 +626,25 @@ namespace crsc {
 		 *                  undefined behaviour.
 		 */
 		void bubble_down(size_type _pos) {
-			size_type heap_size = heap_cntr.size();
-			// positions of left, right nodes relative to parent in heap_cntr
-			size_type left_child = 2 * _pos + 1;
-			size_type right_child = 2 * _pos + 2;
-			// reached end of heap, exit
-			if (left_child >= heap_size) return;
-			size_type min_pos = _pos;
-			// perform comparison between values of heap at _pos and left node pos
-			// and set min_pos to position of left node if comparison yields true
-			if (comp(heap_cntr[_pos], heap_cntr[left_child]))
-				min_pos = left_child;
-			// perform comparison between values of heap at min_pos and right node pos
-			// and set min_pos to position of right node if comparision yields true
-			if (right_child < heap_size && comp(heap_cntr[min_pos], heap_cntr[right_child]))
-				min_pos = right_child;
-			// if required, perform swap and bubble down from swapped min_pos
-			if (min_pos != _pos) {
-				std::swap(heap_cntr[_pos], heap_cntr[min_pos]);
-				bubble_down(min_pos);
+			const size_type heap_size = heap_cntr.size();
+			if (Arity*_pos + 1 >= heap_size) return;
+			value_type val = std::move(heap_cntr[_pos]);
+			for (size_type first_child = Arity*_pos + 1; first_child < heap_size; first_child = Arity*_pos + 1) {
+				// select the highest priority child of the (adjacent) children of _pos
+				const size_type last_child = std::min(first_child + Arity, heap_size);
+				size_type max_child = first_child;
+				for (size_type c = first_child + 1; c < last_child; ++c) {
+					if (comp(heap_cntr[max_child], heap_cntr[c])) max_child = c;
+				}
+				if (!comp(val, heap_cntr[max_child])) break;
+				heap_cntr[_pos] = std::move(heap_cntr[max_child]);
+				_pos = max_child;
 			}
+			heap_cntr[_pos] = std::move(val);
 		}
 		/**
-		 * \brief Bubbles up the heap from a given vector index, performing
-		 *        swaps based on comparator conditions.
+		 * \brief Bubbles up the heap from a given vector index, moving the element at `_pos` past each
+		 *        lower priority parent until it is correctly placed.
 		 *
 		 * \param _pos Index to perform bubbling up from.
 		 * \complexity Logarithmic in the size of the container.
@@ -620,16 +652,15 @@ namespace crsc {
 		 *                  undefined behaviour.
 		 */
 		void bubble_up(size_type _pos) {
-			// at top of heap, exit
 			if (!_pos) return;
-			// positon of parent node relative to a child node in heap_cntr
-			size_type parent = (_pos - 1) / 2;
-			// perform comparison between heap values at parent and _pos
-			// and do swap and bubble up from parent if comparison is true
-			if (comp(heap_cntr[parent], heap_cntr[_pos])) {
-				std::swap(heap_cntr[_pos], heap_cntr[parent]);
-				bubble_up(parent);
+			value_type val = std::move(heap_cntr[_pos]);
+			while (_pos) {
+				const size_type parent = (_pos - 1) / Arity;
+				if (!comp(heap_cntr[parent], val)) break;
+				heap_cntr[_pos] = std::move(heap_cntr[parent]);
+				_pos = parent;
 			}
+			heap_cntr[_pos] = std::move(val);
 		}
 		/**
 		 * \brief Removes the top item from the heap and bubbles down from new top.
@@ -640,22 +671,23 @@ namespace crsc {
 		void pop_top() noexcept {
 			size_type heap_size = heap_cntr.size();
 			if (!heap_size) return;
-			// set top of heap to last heap element then remove last heap element
-			std::swap(heap_cntr[0], heap_cntr[--heap_size]);
+			// move last heap element to the top then remove the last heap element
+			if (heap_size > 1) heap_cntr[0] = std::move(heap_cntr[heap_size - 1]);
 			heap_cntr.pop_back();
 			// bubble down from top to get previously last heap element to correct position
 			bubble_down(0);
 		}
 		/**
-		 * \brief Performs heapification of entire binary heap, bubbling down from
-		 *        each index such that the binary heap invariant is guaranteed.
+		 * \brief Performs heapification of entire heap, bubbling down from each parent
+		 *        node in reverse order such that the heap invariant is guaranteed.
 		 *
-		 * \complexity Linear in the size of the container multiplied by
-		 *             logarithmic in the size of the container.
+		 * \complexity Linear in the size of the container.
 		 * \exceptionsafety No-throw guarantee, `noexcept` specification.
 		 */
 		void heapify() noexcept {
-			for (int i = heap_cntr.size() - 1; i > -1; --i)
+			const size_type heap_size = heap_cntr.size();
+			if (heap_size < 2) return;
+			for (size_type i = (heap_size - 2) / Arity + 1; i-- > 0;)
 				bubble_down(i);
 		}
 	};
@@ -14,6 +14,7 @@ namespace crsc {
 	 *        of logarithmic insertion and extraction. Unlike `crsc::priority_queue`, this container has no invariant
 	 *        such that the heap ordering can be broken by the user; therefore `bubble_up`, `bubble_down` and `heapify`
 	 *        methods are provided as part of the containers' public API to allow correct heap re-ordering to be called.
+	 *        See `crsc::addressable_priority_queue` for logarithmic alteration and erasure of elements via handles.
 	 *
 	 * The element priorities are compared by default using `std::less<Ty>` such that the largest element is always at
 	 * the top of the heap, this comparator can be altered as a template argument to any other `Compare` type such as 
@@ -242,7 +243,7 @@ namespace crsc {
 		/**
 		 * \brief Constructs element in-place and sorts the underlying container.
 		 *
-		 * \param _args Arguments to forward to the constructor of the element.
+		 * \param args Arguments to forward to the constructor of the element.
 		 * \complexity Logarithmic in the size of the container plus complexity
 		 *             of single construction of argument of `value_type`.
 		 * \exceptionsafety Strong-guarantee, if an exception is thrown there are no changes
@@ -250,7 +251,7 @@ namespace crsc {
 		 */
 		template<class... Args>
 		void emplace(Args&&... args) {
-			heap_cntr.emplace_back(std::forward<Args>(_args)...);
+			heap_cntr.emplace_back(std::forward<Args>(args)...);
 			bubble_up(heap_cntr.size() - 1);
 		}
 		/**
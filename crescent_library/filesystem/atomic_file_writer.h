@@ -0,0 +1,301 @@
+#ifndef ATOMIC_FILE_WRITER_H
+#define ATOMIC_FILE_WRITER_H
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <system_error>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace crsc {
+	/**
+	 * \class atomic_file_writer
+	 *
+	 * \brief Writes a file durably by replacement: the contents are written to a temporary file
+	 *        `path + ".tmp." + suffix` which, on `commit`, is flushed to the storage device and atomically
+	 *        renamed over `path`. Readers of `path` therefore see either the old or the new contents in full,
+	 *        even if the process or the machine fails part way through.
+	 *
+	 * The suffix is made of the process id and a per-process counter, and the temporary file is created
+	 * exclusively (retrying with the next suffix if it exists), so concurrent writers of the same `path` never
+	 * share a temporary file; the last one to commit wins. The replacement keeps the permissions of the file
+	 * it replaces, or, if there is none, is created with `0666` less the umask.
+	 *
+	 * Output is collected in a buffer aligned to `block_alignment` and written to the operating system in
+	 * whole buffers, i.e. in large aligned blocks, except for the final partial one; single writes of at least
+	 * a whole buffer are passed to the operating system directly. A writer destroyed without
+	 * a successful `commit` removes the temporary file and leaves `path` untouched. Output can be written
+	 * with `write` or through `stream()`.
+	 */
+	class atomic_file_writer {
+	public:
+		static constexpr std::size_t block_alignment = 4096U;
+		static constexpr std::size_t default_buffer_size = static_cast<std::size_t>(1U) << 20;
+		// CONSTRUCTION/ASSIGNMENT
+		/**
+		 * \brief Creates a new temporary file for replacing `_path`.
+		 *
+		 * \param _path Name/directory of the file to replace.
+		 * \param buffer_size Size of the write buffer, rounded up to a multiple of `block_alignment`.
+		 * \throw Throws `std::system_error` if the temporary file cannot be created.
+		 */
+		explicit atomic_file_writer(const std::string& _path, std::size_t buffer_size = default_buffer_size)
+			: path(_path), buf(buffer_size), os(&buf) {
+			open_tmp();
+		}
+		atomic_file_writer(const atomic_file_writer&) = delete;
+		atomic_file_writer& operator=(const atomic_file_writer&) = delete;
+		~atomic_file_writer() { discard(); }
+		// OUTPUT
+		/**
+		 * \brief Returns an output stream writing to the temporary file. The stream has `badbit` set if a write
+		 *        fails, in which case `commit` throws.
+		 */
+		std::ostream& stream() noexcept { return os; }
+		/**
+		 * \brief Writes `count` characters starting at `s`.
+		 *
+		 * \throw Throws `std::system_error` if the write fails.
+		 */
+		void write(const char* s, std::size_t count) {
+			if (!os.write(s, static_cast<std::streamsize>(count))) throw_error(buf.error, "Unable to write file: " + tmp_path);
+		}
+		/**
+		 * \brief Flushes the output to the storage device and atomically replaces `path` with it.
+		 *
+		 * \throw Throws `std::system_error` if any write, the flush or the rename fails, in which case the
+		 *        temporary file is removed and `path` is left untouched.
+		 */
+		void commit() {
+			if (!is_open()) throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor), "Writer of " + path + " is not open");
+			if (!os.flush() || buf.error) {
+				const int err = buf.error;
+				discard();
+				throw_error(err, "Unable to write file: " + tmp_path);
+			}
+#if defined(_WIN32)
+			if (!::FlushFileBuffers(buf.handle)) {
+				const int err = static_cast<int>(::GetLastError());
+				discard();
+				throw_error(err, "Unable to flush file: " + tmp_path);
+			}
+			::CloseHandle(buf.handle);
+			buf.handle = INVALID_HANDLE_VALUE;
+			if (!::MoveFileExA(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+				const int err = static_cast<int>(::GetLastError());
+				std::remove(tmp_path.c_str());
+				throw_error(err, "Unable to replace file: " + path);
+			}
+#else
+			if (::fsync(buf.fd) != 0) {
+				const int err = errno;
+				discard();
+				throw_error(err, "Unable to flush file: " + tmp_path);
+			}
+			::close(buf.fd);
+			buf.fd = -1;
+			if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+				const int err = errno;
+				std::remove(tmp_path.c_str());
+				throw_error(err, "Unable to replace file: " + path);
+			}
+			sync_directory();
+#endif
+		}
+		/**
+		 * \brief Abandons the output, removing the temporary file. No-op if already committed or discarded.
+		 */
+		void discard() noexcept {
+			if (!is_open()) return;
+#if defined(_WIN32)
+			::CloseHandle(buf.handle);
+			buf.handle = INVALID_HANDLE_VALUE;
+#else
+			::close(buf.fd);
+			buf.fd = -1;
+#endif
+			std::remove(tmp_path.c_str());
+		}
+		/**
+		 * \brief Checks whether the temporary file is open, i.e. neither committed nor discarded.
+		 */
+		bool is_open() const noexcept {
+#if defined(_WIN32)
+			return buf.handle != INVALID_HANDLE_VALUE;
+#else
+			return buf.fd >= 0;
+#endif
+		}
+	private:
+		/**
+		 * \brief Stream buffer over an aligned block, passing whole blocks to the operating system.
+		 */
+		class block_buf : public std::streambuf {
+		public:
+			explicit block_buf(std::size_t size)
+				: capacity(((size ? size : static_cast<std::size_t>(block_alignment)) + block_alignment - 1U) / block_alignment * block_alignment),
+				storage(new char[capacity + block_alignment]) {
+				void* p = storage.get();
+				std::size_t space = capacity + block_alignment;
+				char* first = static_cast<char*>(std::align(block_alignment, capacity, p, space));
+				setp(first, first + capacity);
+			}
+#if defined(_WIN32)
+			HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+			int fd = -1;
+#endif
+			int error = 0;	// error code of the first failed write, if any
+		protected:
+			int_type overflow(int_type ch) override {
+				if (!drain()) return traits_type::eof();
+				if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+					*pptr() = traits_type::to_char_type(ch);
+					pbump(1);
+				}
+				return traits_type::not_eof(ch);
+			}
+			std::streamsize xsputn(const char* s, std::streamsize count) override {
+				std::streamsize written = 0;
+				// writes of at least a whole buffer bypass it, saving a copy of bulk data
+				if (count >= static_cast<std::streamsize>(capacity)) {
+					if (!drain() || !write_all(s, static_cast<std::size_t>(count))) return 0;
+					return count;
+				}
+				while (written < count) {
+					if (pptr() == epptr() && !drain()) break;
+					const std::streamsize n = std::min<std::streamsize>(count - written, epptr() - pptr());
+					std::memcpy(pptr(), s + written, static_cast<std::size_t>(n));
+					pbump(static_cast<int>(n));
+					written += n;
+				}
+				return written;
+			}
+			int sync() override { return drain() ? 0 : -1; }
+		private:
+			std::size_t capacity;
+			std::unique_ptr<char[]> storage;
+			/**
+			 * \brief Writes out the buffered characters, returning `false` on failure.
+			 */
+			bool drain() noexcept {
+				if (!write_all(pbase(), static_cast<std::size_t>(pptr() - pbase()))) return false;
+				setp(pbase(), epptr());
+				return true;
+			}
+			/**
+			 * \brief Writes `n` characters starting at `p` to the file, returning `false` on failure.
+			 */
+			bool write_all(const char* p, std::size_t n) noexcept {
+				if (error) return false;
+				while (n) {
+#if defined(_WIN32)
+					DWORD w = 0;
+					const DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(n, static_cast<std::size_t>(1U) << 30));
+					if (!::WriteFile(handle, p, chunk, &w, nullptr)) {
+						error = static_cast<int>(::GetLastError());
+						return false;
+					}
+#else
+					const ::ssize_t w = ::write(fd, p, n);
+					if (w < 0) {
+						if (errno == EINTR) continue;
+						error = errno;
+						return false;
+					}
+#endif
+					p += w;
+					n -= static_cast<std::size_t>(w);
+				}
+				return true;
+			}
+		};
+		std::string path;
+		std::string tmp_path;
+		block_buf buf;
+		std::ostream os;
+		/**
+		 * \brief Creates the temporary file under the first free name `path + ".tmp." + suffix` and opens it.
+		 */
+		void open_tmp() {
+			static constexpr unsigned max_attempts = 64U;
+#if defined(_WIN32)
+			const unsigned long pid = static_cast<unsigned long>(::GetCurrentProcessId());
+#else
+			const unsigned long pid = static_cast<unsigned long>(::getpid());
+			// the replacement keeps the permissions of the file it replaces, else the umask applies
+			struct stat st;
+			const bool replaces = (::stat(path.c_str(), &st) == 0);
+			const ::mode_t mode = replaces ? (st.st_mode & 07777) : 0666;
+#endif
+			for (unsigned attempt = 1U;; ++attempt) {
+				tmp_path = path + ".tmp." + std::to_string(pid) + '.' + std::to_string(next_tmp_id());
+#if defined(_WIN32)
+				buf.handle = ::CreateFileA(tmp_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW,
+					FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				if (buf.handle != INVALID_HANDLE_VALUE) return;
+				const DWORD err = ::GetLastError();
+				if ((err != ERROR_FILE_EXISTS && err != ERROR_ALREADY_EXISTS) || attempt == max_attempts)
+					throw_error(static_cast<int>(err), "Unable to create file: " + tmp_path);
+#else
+				buf.fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, mode);
+				if (buf.fd >= 0) {
+					if (replaces) ::fchmod(buf.fd, mode);
+					return;
+				}
+				const int err = errno;
+				if (err != EEXIST || attempt == max_attempts) throw_error(err, "Unable to create file: " + tmp_path);
+#endif
+			}
+		}
+		/**
+		 * \brief Returns the next value of the counter distinguishing the temporary files of this process.
+		 */
+		static unsigned long long next_tmp_id() noexcept {
+			static std::atomic<unsigned long long> counter(0U);
+			return counter.fetch_add(1U, std::memory_order_relaxed);
+		}
+#if !defined(_WIN32)
+		/**
+		 * \brief Flushes the directory entry of the rename, without which the replacement itself may be
+		 *        lost on power failure. Failure is ignored as not all file systems support it.
+		 */
+		void sync_directory() const noexcept {
+			const std::string::size_type sep = path.find_last_of('/');
+			const std::string dir = (sep == std::string::npos) ? std::string(".") : (sep ? path.substr(0U, sep) : std::string("/"));
+			const int dfd = ::open(dir.c_str(), O_RDONLY);
+			if (dfd < 0) return;
+			::fsync(dfd);
+			::close(dfd);
+		}
+#endif
+		static void throw_error(int err, const std::string& what) {
+			if (!err) throw std::system_error(std::make_error_code(std::errc::io_error), what);
+#if defined(_WIN32)
+			throw std::system_error(err, std::system_category(), what);
+#else
+			throw std::system_error(err, std::generic_category(), what);
+#endif
+		}
+	};
+}
+
+#endif // !ATOMIC_FILE_WRITER_H
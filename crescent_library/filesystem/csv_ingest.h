@@ -0,0 +1,294 @@
+#ifndef CSV_INGEST_H
+#define CSV_INGEST_H
+#include "dynamic_matrix.h"
+#include "string_utilities.h"
+#include "string_view.h"
+#include "threading_utilities.h"
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <future>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace crsc {
+	/**
+	 * \class csv_parse_error
+	 *
+	 * \brief Exception thrown by the CSV ingest functions for a field which cannot be parsed or a row with the
+	 *        wrong number of fields.
+	 */
+	class csv_parse_error : public std::runtime_error {
+	public:
+		/**
+		 * \param _line Line number (from 1) of the row in the input.
+		 * \param _field Field number (from 1) within the row.
+		 * \param _ec Error of the field, see `crsc::split_parse`.
+		 */
+		csv_parse_error(std::size_t _line, std::size_t _field, std::errc _ec)
+			: std::runtime_error("CSV parse error at line " + std::to_string(_line) + ", field " + std::to_string(_field)
+				+ ": " + std::make_error_code(_ec).message()), ln(_line), fld(_field), ec(_ec) {}
+		std::size_t line() const noexcept { return ln; }
+		std::size_t field() const noexcept { return fld; }
+		std::errc code() const noexcept { return ec; }
+	private:
+		std::size_t ln;
+		std::size_t fld;
+		std::errc ec;
+	};
+	/**
+	 * \brief Options of the CSV ingest functions.
+	 */
+	struct csv_ingest_options {
+		char delimiter = ',';
+		std::size_t header_rows = 0U;	// number of leading lines to skip
+		std::size_t columns = 0U;	// number of fields per row, `0` to infer from the first non-blank row
+		std::size_t chunk_size = static_cast<std::size_t>(1U) << 22;	// bytes of input read per chunk
+		std::size_t max_chunks_in_flight = 0U;	// chunks read but not yet consumed, `0` for twice the threads
+	};
+	/**
+	 * \brief Detail namespace for the CSV ingest pipeline. Nothing in this namespace is part of the public API.
+	 */
+	namespace csv_impl {
+		/**
+		 * \brief A chunk of whole lines of input and the values parsed from it.
+		 */
+		template<class Ty>
+		struct chunk {
+			std::string text;
+			std::vector<Ty> values;	// row-major, `rows*columns` values
+			std::size_t columns = 0U;
+			std::size_t rows = 0U;
+			std::size_t lines = 0U;
+			std::size_t error_line = 0U;	// line of the error within the chunk, from 0
+			std::size_t error_field = 0U;	// field of the error within the line, from 0
+			std::errc ec = std::errc();
+		};
+		/**
+		 * \brief Reads the next chunk of at least `chunk_size` bytes (or the rest of `is`) ending at a line
+		 *        boundary into `text`, keeping the start of any partial line read beyond it in `carry`.
+		 *
+		 * \return `false` if `is` is exhausted.
+		 */
+		inline bool read_chunk(std::istream& is, std::string& carry, std::string& text, std::size_t chunk_size) {
+			text.assign(carry);
+			carry.clear();
+			for (;;) {
+				const std::size_t old = text.size();
+				text.resize(old + chunk_size);
+				is.read(&text[old], static_cast<std::streamsize>(chunk_size));
+				const std::size_t got = static_cast<std::size_t>(is.gcount());
+				text.resize(old + got);
+				if (got < chunk_size) return !text.empty();
+				const std::string::size_type nl = text.rfind('\n');
+				if (nl != std::string::npos && nl >= old) {
+					carry.assign(text, nl + 1U, std::string::npos);
+					text.resize(nl + 1U);
+					return true;
+				}
+				// a line longer than the chunk so far, keep reading
+			}
+		}
+		/**
+		 * \brief Returns the number of fields of the first non-blank line of `text`, or `0` if all are blank.
+		 */
+		inline std::size_t infer_columns(const std::string& text, char delim) {
+			std::size_t cols = 0U;
+			string_impl::for_each_token(text.data(), text.data() + text.size(), '\n', [&cols, delim](const char* first, const char* last) {
+				while (first != last && string_impl::is_blank(*first)) ++first;
+				if (first == last) return true;
+				cols = 1U + static_cast<std::size_t>(std::count(first, last, delim));
+				return false;
+			});
+			return cols;
+		}
+		/**
+		 * \brief Parses every non-blank line of `c.text` as a row of `c.columns` fields into `c.values`,
+		 *        stopping at the first error.
+		 */
+		template<class Ty>
+		void parse_chunk(chunk<Ty>& c, char delim) {
+			c.values.clear();
+			c.rows = 0U;
+			c.lines = 0U;
+			c.ec = std::errc();
+			const std::size_t cols = c.columns;
+			string_impl::for_each_token(c.text.data(), c.text.data() + c.text.size(), '\n', [&c, cols, delim](const char* first, const char* last) {
+				const std::size_t line = c.lines++;
+				const char* p = first;
+				while (p != last && string_impl::is_blank(*p)) ++p;
+				if (p == last) return true;	// blank lines are skipped
+				const std::size_t offset = c.values.size();
+				c.values.resize(offset + cols);
+				split_parse_result<Ty*> res = split_parse(string_view(first, static_cast<std::size_t>(last - first)), delim,
+					c.values.data() + offset, c.values.data() + offset + cols);
+				if (res.ec == std::errc() && res.count != cols) res.ec = std::errc::invalid_argument;	// too few fields
+				if (res.ec != std::errc()) {
+					c.values.resize(offset);
+					c.ec = res.ec;
+					c.error_line = line;
+					c.error_field = res.count;
+					return false;
+				}
+				++c.rows;
+				return true;
+			});
+		}
+	}
+	/**
+	 * \brief Streams the numeric CSV data of `is` to `sink` as blocks of rows, parsing chunks of the input
+	 *        concurrently as tasks of `policy.executor()`.
+	 *
+	 * The calling thread reads chunks of `options.chunk_size` bytes cut at line boundaries, which the tasks
+	 * parse with `crsc::split_parse` into per-chunk buffers without per-row allocation. The blocks are passed to
+	 * `sink` on the calling thread in input order. At most `options.max_chunks_in_flight` chunks are read ahead
+	 * of the one being consumed, such that reading stalls while `sink` or the parsing falls behind and the memory
+	 * used is bounded by roughly `max_chunks_in_flight*chunk_size` bytes of text plus the values parsed from
+	 * them; the buffers are reused between chunks.
+	 *
+	 * Fields are delimited by `options.delimiter`, with spaces, tabs and carriage returns around them ignored,
+	 * and blank lines are skipped. Quoted fields are not supported.
+	 *
+	 * \tparam Ty Arithmetic type of the values.
+	 * \param is Input stream, preferably opened in binary mode.
+	 * \param sink Callable invoked as `sink(const Ty* values, std::size_t rows, std::size_t columns)` with each
+	 *        non-empty row-major block.
+	 * \param options Ingest options.
+	 * \param policy Execution policy, chunks are parsed on the pool of `policy` unless `policy.concurrency()`
+	 *        is `1`, in which case everything runs on the calling thread.
+	 * \return Number of rows passed to `sink`.
+	 * \throw Throws `crsc::csv_parse_error` for the first field which cannot be parsed or row with a number of
+	 *        fields other than `options.columns` (or that of the first row), after all preceding rows were
+	 *        passed to `sink`. Exceptions thrown by `sink` are propagated once the outstanding chunks are parsed.
+	 */
+	template<class Ty,
+		class Sink
+	> std::size_t ingest_csv(std::istream& is, Sink sink, const csv_ingest_options& options = csv_ingest_options(),
+		const execution::parallel_policy& policy = execution::par) {
+		const std::size_t chunk_size = std::max<std::size_t>(options.chunk_size, 1U);
+		for (std::size_t i = 0U; i < options.header_rows && is; ++i)
+			is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		std::size_t columns = options.columns;
+		std::size_t lines_before = options.header_rows;
+		std::size_t rows = 0U;
+		std::string carry;
+		auto consume = [&](csv_impl::chunk<Ty>& c) {
+			// the rows of the chunk preceding an error are passed on before it is thrown
+			if (c.rows) sink(static_cast<const Ty*>(c.values.data()), c.rows, c.columns);
+			rows += c.rows;
+			if (c.ec != std::errc()) throw csv_parse_error(lines_before + c.error_line + 1U, c.error_field + 1U, c.ec);
+			lines_before += c.lines;
+		};
+		auto fill = [&](csv_impl::chunk<Ty>& c) {
+			if (!csv_impl::read_chunk(is, carry, c.text, chunk_size)) return false;
+			if (!columns) columns = csv_impl::infer_columns(c.text, options.delimiter);
+			c.columns = columns;
+			return true;
+		};
+		if (policy.concurrency() <= 1U) {
+			csv_impl::chunk<Ty> c;
+			while (fill(c)) {
+				csv_impl::parse_chunk(c, options.delimiter);
+				consume(c);
+			}
+			return rows;
+		}
+		const std::size_t in_flight = options.max_chunks_in_flight ? options.max_chunks_in_flight : 2U*policy.concurrency();
+		std::vector<csv_impl::chunk<Ty>> slots(in_flight);
+		std::vector<std::future<void>> parsed(in_flight);
+		thread_pool& pool = policy.executor();
+		// the tasks refer to the slots, so every exit path waits for those outstanding
+		struct drainer {
+			thread_pool& pool;
+			std::vector<std::future<void>>& parsed;
+			~drainer() {
+				for (auto& f : parsed) {
+					if (f.valid()) pool.wait(f);
+				}
+			}
+		} drain_guard{ pool, parsed };
+		const char delim = options.delimiter;
+		std::size_t issued = 0U, consumed = 0U;
+		bool eof = false;
+		for (;;) {
+			while (!eof && issued - consumed < in_flight) {
+				const std::size_t idx = issued % in_flight;
+				csv_impl::chunk<Ty>& c = slots[idx];
+				if (!fill(c)) {
+					eof = true;
+					break;
+				}
+				parsed[idx] = pool.submit([&c, delim]() { csv_impl::parse_chunk(c, delim); });
+				++issued;
+			}
+			if (consumed == issued) break;
+			const std::size_t idx = consumed % in_flight;
+			pool.wait(parsed[idx]);
+			parsed[idx].get();
+			consume(slots[idx]);
+			++consumed;
+		}
+		return rows;
+	}
+	/**
+	 * \brief Appends the rows of the numeric CSV data of `is` to `mtx`, see `crsc::ingest_csv`.
+	 *
+	 * Each parsed block is appended with a single `push_rows`, so no reallocation occurs if `mtx` was
+	 * `reserve`d for the rows beforehand. If `mtx` is not empty the rows must have `mtx.columns()` fields.
+	 *
+	 * \return Number of rows appended.
+	 * \throw Throws `crsc::csv_parse_error` as `crsc::ingest_csv`; the rows preceding the error are appended.
+	 */
+	template<class Ty,
+		class Allocator
+	> std::size_t load_csv(std::istream& is, dynamic_matrix<Ty, Allocator>& mtx, csv_ingest_options options = csv_ingest_options(),
+		const execution::parallel_policy& policy = execution::par) {
+		if (!mtx.empty()) options.columns = mtx.columns();
+		return ingest_csv<Ty>(is, [&mtx](const Ty* values, std::size_t rows, std::size_t columns) {
+			if (mtx.empty() && mtx.columns() != columns) mtx.resize(0U, columns);
+			mtx.push_rows(values, values + rows*columns);
+		}, options, policy);
+	}
+	/**
+	 * \brief Appends the rows of the numeric CSV file `filename` to `mtx`, see `crsc::load_csv`.
+	 *
+	 * \throw Throws `std::runtime_error` if the file cannot be opened.
+	 */
+	template<class Ty,
+		class Allocator
+	> std::size_t load_csv(const std::string& filename, dynamic_matrix<Ty, Allocator>& mtx,
+		const csv_ingest_options& options = csv_ingest_options(), const execution::parallel_policy& policy = execution::par) {
+		std::ifstream is(filename, std::ios::binary);
+		if (!is) throw std::runtime_error("Unable to open file: " + filename);
+		return load_csv(is, mtx, options, policy);
+	}
+	/**
+	 * \brief Appends each field of the numeric CSV data of `is` to the buffer of its column in `columns`,
+	 *        see `crsc::ingest_csv`. `columns` is resized to the number of fields per row if it is empty,
+	 *        otherwise the rows must have `columns.size()` fields.
+	 *
+	 * \return Number of rows appended.
+	 * \throw Throws `crsc::csv_parse_error` as `crsc::ingest_csv`; the rows preceding the error are appended.
+	 */
+	template<class Ty,
+		class Allocator
+	> std::size_t load_csv_columns(std::istream& is, std::vector<std::vector<Ty, Allocator>>& columns,
+		csv_ingest_options options = csv_ingest_options(), const execution::parallel_policy& policy = execution::par) {
+		if (!columns.empty()) options.columns = columns.size();
+		return ingest_csv<Ty>(is, [&columns](const Ty* values, std::size_t rows, std::size_t ncols) {
+			if (columns.empty()) columns.resize(ncols);
+			for (std::size_t j = 0U; j < ncols; ++j) {
+				std::vector<Ty, Allocator>& col = columns[j];
+				const std::size_t offset = col.size();
+				col.resize(offset + rows);
+				for (std::size_t i = 0U; i < rows; ++i) col[offset + i] = values[i*ncols + j];
+			}
+		}, options, policy);
+	}
+}
+
+#endif // !CSV_INGEST_H
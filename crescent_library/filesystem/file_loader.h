@@ -1,9 +1,21 @@
 #ifndef FILE_LOADER_H
 #define FILE_LOADER_H
+#include "atomic_file_writer.h"
+#include "line_piece_table.h"
+#include "threading_utilities.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace crsc {
@@ -19,31 +31,45 @@ namespace crsc {
 	 *         satisfy the requirements of `RandomAccessIterator` (see C++ Concepts). Additionally the
 	 *         `Container::value_type` must be `std::string`. If these condtions are not satisfied then
 	 *         undefined behaviour is invoked for all methods and operations involving `file_loader`.
+	 *         Line access returns `Container::reference` and `Container::const_reference`. For large files use
+	 *         `crsc::line_piece_table`, which keeps the file in one buffer plus an overlay of edited lines and
+	 *         returns `crsc::string_view`s from const access, instead of the default `std::vector<std::string>`
+	 *         with its allocation per line.
 	 * \remark In the documentation of this class, the term "internal cached storage" is used to
 	 *         denote the encapsulated data structure which stores the contents of the file in
 	 *         memory. This structure is used for reading and manipulating the contents data
 	 *         internally - any changes made to this structure are not automatically applied to
 	 *         the filestream (i.e. the file itself), these updates can be pushed by invoking
 	 *		   file_loader::write_changes() on an instance of a file_loader.
+	 * \remark Saves replace the file atomically, see `crsc::atomic_file_writer`, and are skipped if no
+	 *         modifier or mutable accessor has been used since the last save. With `crsc::line_piece_table`
+	 *         mutable accessors yield references which copy a line only when it is written, and only written
+	 *         lines count as changed. Destroying a `file_loader` waits for any save started with
+	 *         `write_changes_async` to complete.
 	 * \author Samuel Rowlinson
 	 * \date June, 2016
 	 */
 	template<
 		class Container = std::vector<std::string>
 	> class file_loader {
-		typedef Container::const_iterator const_iterator;
-		typedef Container::iterator iterator;
-		typedef Container::const_reverse_iterator const_reverse_iterator;
-		typedef Container::reverse_iterator reverse_iterator;
 	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef typename Container::const_iterator const_iterator;
+		typedef typename Container::iterator iterator;
+		typedef typename Container::const_reverse_iterator const_reverse_iterator;
+		typedef typename Container::reverse_iterator reverse_iterator;
+		typedef typename Container::reference reference;
+		typedef typename Container::const_reference const_reference;
 		// CONSTRUCTION/ASSIGNMENT
 		/**
 		 * \brief Constructs a file_loader instance using a given filename, loads the file
 		 *        with name `_filename` and caches its contents into the internal cached
 		 *        storage.
 		 *
+		 * The file is read with a single unformatted read and then split into lines.
+		 *
 		 * \param _filename Name/directory of file to load.
-		 * \param _max_line_length Optional, approximate maximum length of file lines.
+		 * \param _max_line_length Unused, retained for compatibility.
 		 */
 		explicit file_loader(const std::string& _filename, std::size_t _max_line_length = 256U) 
 			: fs(_filename), filename(_filename) { cache_contents(_max_line_length); }
@@ -60,25 +86,41 @@ namespace crsc {
 		 */
 		file_loader(file_loader&& _other) 
 			: fs(std::move(_other.fs)), filename(std::move(_other.filename)), 
-				cached_contents_cntr(std::move(_other.cached_contents_cntr)) {}
+				cached_contents_cntr(std::move(_other.cached_contents_cntr)), saves(std::move(_other.saves)),
+				pending_save(std::move(_other.pending_save)), last_save_failed(std::move(_other.last_save_failed)),
+				dirty(_other.dirty), dirty_first(_other.dirty_first), dirty_last(_other.dirty_last) {}
 		/**
 		 * \brief Deleted copy assignment operator, copy assignment is forbidden. No two `file_loader`
 		 *        instances may manage the same loaded file stream resource.
 		 */
 		file_loader& operator=(const file_loader&) = delete;
+		/**
+		 * \brief Waits for any save started with `write_changes_async` to complete.
+		 */
+		~file_loader() {
+			try { wait_pending_save(); }
+			catch (...) {}
+		}
 		/**
 		 * \brief Move assignment operator, uses move-semantics to move the parameterised
-		 *		  file_loader instance to this. Instance being moved is left in a
-		 *        valid but unspecified state.
+		 *		  file_loader instance to this, after any save started with `write_changes_async` on this
+		 *        instance completes. Instance being moved is left in a valid but unspecified state.
 		 *
 		 * \param _other rvalue reference to file_loader instance.
 		 */
 		file_loader& operator=(file_loader&& _other) {
 			// check for self-assignment
 			if (this != &_other) {
+				wait_pending_save();
 				fs = std::move(_other.fs);
 				filename = std::move(_other.filename);
 				cached_contents_cntr = std::move(_other.cached_contents_cntr);
+				saves = std::move(_other.saves);
+				pending_save = std::move(_other.pending_save);
+				last_save_failed = std::move(_other.last_save_failed);
+				dirty = _other.dirty;
+				dirty_first = _other.dirty_first;
+				dirty_last = _other.dirty_last;
 			}
 			return *this;
 		}
@@ -109,7 +151,7 @@ namespace crsc {
 		 * \return const reference to `std::string` instance given by `n`'th line.
 		 * \throw Throws `std::out_of_range` exception if `!(n < lines())`.
 		 */
-		const std::string& line_at(std::size_t n) const {
+		const_reference line_at(std::size_t n) const {
 			if (!(n < cached_contents_cntr.size()))
 				throw std::out_of_range("File: " + filename + " does not have " + std::to_string(n) + " lines.");
 			return cached_contents_cntr[n];
@@ -125,9 +167,10 @@ namespace crsc {
 		 * \return reference to `std::string` instance given by `n`'th line.
 		 * \throw Throws `std::out_of_range` exception if `!(n < lines())`.
 		 */
-		std::string& line_at(std::size_t n) {
+		reference line_at(std::size_t n) {
 			if (!(n < cached_contents_cntr.size()))
 				throw std::out_of_range("File: " + filename + " does not have " + std::to_string(n) + " lines.");
+			mark_accessed(n, n + 1U);
 			return cached_contents_cntr[n];
 		}
 		/**
@@ -141,7 +184,7 @@ namespace crsc {
 		 * \param n Line number to read.
 		 * \return const reference to `std::string` instance given by `n`'th line.
 		 */
-		const std::string& operator[](std::size_t n) const {
+		const_reference operator[](std::size_t n) const {
 			return cached_contents_cntr[n];
 		}
 		/**
@@ -157,7 +200,8 @@ namespace crsc {
 		 * \param n Line number to read.
 		 * \return reference to `std::string` instance given by `n`'th line.
 		 */
-		std::string& operator[](std::size_t n) {
+		reference operator[](std::size_t n) {
+			mark_accessed(n, n + 1U);
 			return cached_contents_cntr[n];
 		}
 		/**
@@ -165,7 +209,7 @@ namespace crsc {
 		 *
 		 * \return First line of the internal container.
 		 */
-		const std::string& front() const noexcept {
+		const_reference front() const noexcept {
 			return cached_contents_cntr.front();
 		}
 		/**
@@ -173,7 +217,8 @@ namespace crsc {
 		 *
 		 * \return First line of the internal container.
 		 */
-		std::string& front() noexcept {
+		reference front() {
+			mark_accessed(0U, 1U);
 			return cached_contents_cntr.front();
 		}
 		/**
@@ -181,7 +226,7 @@ namespace crsc {
 		 *
 		 * \return Last line of the internal container.
 		 */
-		const std::string& back() const noexcept {
+		const_reference back() const noexcept {
 			return cached_contents_cntr.back();
 		}
 		/**
@@ -189,7 +234,8 @@ namespace crsc {
 		 *
 		 * \return Last line of the internal container.
 		 */
-		std::string& back() noexcept {
+		reference back() {
+			mark_accessed(cached_contents_cntr.size() - 1U, cached_contents_cntr.size());
 			return cached_contents_cntr.back();
 		}
 		// INTERNAL CACHE MODIFIERS
@@ -198,6 +244,7 @@ namespace crsc {
 		 *        next call to `write_changes` wipes the file completely.
 		 */
 		void clear_contents() noexcept {
+			mark_dirty(0U, to_end);
 			cached_contents_cntr.clear();
 		}
 		/**
@@ -209,6 +256,7 @@ namespace crsc {
 		 * \return Iterator to next valid position in internal cached storage container.
 		 */
 		iterator erase_line(const_iterator pos) {
+			mark_dirty(index_of(pos), to_end);
 			return cached_contents_cntr.erase(pos);
 		}
 		/**
@@ -221,6 +269,7 @@ namespace crsc {
 		 * \return Iterator to next valid position in internal cached storage container.
 		 */
 		iterator erase_block(const_iterator first, const_iterator last) {
+			mark_dirty(index_of(first), to_end);
 			return cached_contents_cntr.erase(first, last);
 		}
 		/**
@@ -232,6 +281,7 @@ namespace crsc {
 		 * \param str Contents of added line.
 		 */
 		iterator insert_line(const_iterator pos, const std::string& str) {
+			mark_dirty(index_of(pos), to_end);
 			return cached_contents_cntr.insert(pos, str);
 		}
 		/**
@@ -243,6 +293,7 @@ namespace crsc {
 		 * \param str Contents of added line.
 		 */
 		iterator insert_line(const_iterator pos, std::string&& str = "") {
+			mark_dirty(index_of(pos), to_end);
 			return cached_contents_cntr.insert(pos, std::move(str));
 		}
 		/**
@@ -255,6 +306,7 @@ namespace crsc {
 		 */
 		template<class InputIt>
 		iterator insert_block(const_iterator pos, InputIt first, InputIt last) {
+			mark_dirty(index_of(pos), to_end);
 			return cached_contents_cntr.insert(pos, first, last);
 		}
 		/**
@@ -265,6 +317,7 @@ namespace crsc {
 		 * \param str Contents of added line.
 		 */
 		void push_line_back(const std::string& str) {
+			mark_dirty(cached_contents_cntr.size(), to_end);
 			cached_contents_cntr.push_back(str);
 		}
 		/**
@@ -275,6 +328,7 @@ namespace crsc {
 		 * \param str Contents of added line.
 		 */
 		void push_line_back(std::string&& str = "") {
+			mark_dirty(cached_contents_cntr.size(), to_end);
 			cached_contents_cntr.push_back(std::move(str));
 		}
 		/**
@@ -282,6 +336,7 @@ namespace crsc {
 		 *        to `write_changes` removes the last line from the file contents.
 		 */
 		void pop_line_back() {
+			mark_dirty(cached_contents_cntr.size() - 1U, to_end);
 			cached_contents_cntr.pop_back();
 		}
 		// ITERATORS
@@ -289,36 +344,136 @@ namespace crsc {
 			return cached_contents_cntr.cbegin();
 		}
 		iterator begin() noexcept {
+			mark_accessed(0U, to_end);
 			return cached_contents_cntr.begin();
 		}
 		const_iterator cend() const noexcept {
 			return cached_contents_cntr.cend();
 		}
 		iterator end() noexcept {
+			mark_accessed(0U, to_end);
 			return cached_contents_cntr.end();
 		}
 		const_reverse_iterator crbegin() const noexcept {
 			return cached_contents_cntr.crbegin();
 		}
 		reverse_iterator rbegin() noexcept {
+			mark_accessed(0U, to_end);
 			return cached_contents_cntr.rbegin();
 		}
 		const_reverse_iterator crend() const noexcept {
 			return cached_contents_cntr.crend();
 		}
 		reverse_iterator rend() noexcept {
+			mark_accessed(0U, to_end);
 			return cached_contents_cntr.rend();
 		}
 		// FILE OPERATIONS/MODIFIERS
 		/**
 		 * \brief Writes all changes made to the internal cached storage to the
 		 *		  filestream, overwriting the current contents of the file.
+		 *
+		 * The file is replaced atomically and durably via `crsc::atomic_file_writer`, after any save started
+		 * by `write_changes_async` completes. Nothing is written if there are no unsaved changes.
+		 *
+		 * \throw Throws `std::system_error` if the file cannot be written, in which case the file is left
+		 *        unchanged and the changes remain unsaved.
 		 */
 		void write_changes() {
-			fs.clear();
-			for (const auto& el : cached_contents_cntr) {
-				fs << el << '\n';
+			wait_pending_save();
+			refresh_dirty_state();
+			if (!dirty) return;
+			fs.close();
+			save(cached_contents_cntr, filename);
+			dirty = false;
+		}
+		/**
+		 * \brief Writes all changes made to the internal cached storage to the file as a task of
+		 *        `thread_pool::default_pool()`, see `write_changes`.
+		 *
+		 * A snapshot of the internal cached storage is taken before returning such that the contents may be
+		 * modified immediately. The saves of a `file_loader` are queued and written one after another by a
+		 * single pool task, so they complete in the order in which they are started without any task waiting
+		 * for another.
+		 *
+		 * \return `std::shared_future` which becomes ready when the save completes, storing any
+		 *         `std::system_error` with which it failed. If there are no unsaved changes this is the future
+		 *         of the previous save, or a ready future if there is none.
+		 * \complexity Linear in the size of the contents, on the calling thread, for the snapshot.
+		 */
+		std::shared_future<void> write_changes_async() {
+			return write_changes_async([](std::exception_ptr) {});
+		}
+		/**
+		 * \brief Writes all changes made to the internal cached storage to the file as a task of
+		 *        `thread_pool::default_pool()`, invoking `on_complete` when done, see `write_changes_async()`.
+		 *
+		 * \param on_complete CopyConstructible callable invoked as `on_complete(std::exception_ptr)` on the
+		 *        thread running the save with a null pointer on success, or the exception with which the save
+		 *        failed. If there are no unsaved changes it is invoked with a null pointer before returning.
+		 */
+		template<class Callback>
+		std::shared_future<void> write_changes_async(Callback on_complete) {
+			refresh_dirty_state();
+			if (!dirty) {
+				on_complete(std::exception_ptr());
+				if (pending_save.valid()) return pending_save;
+				std::promise<void> done;
+				done.set_value();
+				return done.get_future().share();
+			}
+			fs.close();
+			std::shared_ptr<const Container> snapshot = std::make_shared<const Container>(cached_contents_cntr);
+			std::shared_ptr<std::atomic<bool>> failed = std::make_shared<std::atomic<bool>>(false);
+			if (!saves) saves = std::make_shared<save_queue>();
+			save_job job{ std::move(snapshot), filename, std::function<void(std::exception_ptr)>(std::move(on_complete)), failed, std::promise<void>() };
+			std::shared_future<void> done = job.done.get_future().share();
+			bool start_drain;
+			{
+				std::lock_guard<std::mutex> lock(saves->mut);
+				saves->jobs.push_back(std::move(job));
+				start_drain = !saves->draining;
+				saves->draining = true;
 			}
+			if (start_drain) {
+				std::shared_ptr<save_queue> queue = saves;
+				try { thread_pool::default_pool().submit([queue]() { drain_saves(*queue); }); }
+				catch (...) {
+					std::lock_guard<std::mutex> lock(saves->mut);
+					saves->jobs.pop_back();
+					saves->draining = false;
+					throw;
+				}
+			}
+			pending_save = std::move(done);
+			last_save_failed = std::move(failed);
+			dirty = false;
+			return pending_save;
+		}
+		/**
+		 * \brief Checks whether the internal cached storage may differ from the file as last saved, i.e. whether
+		 *        a modifier or mutable accessor has been used since or the last save failed.
+		 */
+		bool has_unsaved_changes() const noexcept {
+			const std::pair<std::size_t, std::size_t> edits = container_edits(cached_contents_cntr, 0);
+			return dirty || edits.first != edits.second || (last_save_failed && last_save_failed->load());
+		}
+		/**
+		 * \brief Returns the range `[first, last)` of lines which may differ from the file as last saved. Lines
+		 *        following an inserted or erased line count as changed since their positions have shifted.
+		 *
+		 * \return Range of changed lines, empty if there are no unsaved changes or only trailing lines were
+		 *         removed, see `has_unsaved_changes`.
+		 */
+		std::pair<std::size_t, std::size_t> dirty_lines() const noexcept {
+			const std::size_t n = cached_contents_cntr.size();
+			if (last_save_failed && last_save_failed->load()) return std::make_pair(static_cast<std::size_t>(0U), n);
+			std::pair<std::size_t, std::size_t> edits = container_edits(cached_contents_cntr, 0);
+			if (dirty && edits.first != edits.second)
+				edits = std::make_pair(std::min(dirty_first, edits.first), std::max(dirty_last, edits.second));
+			else if (dirty) edits = std::make_pair(dirty_first, dirty_last);
+			else if (edits.first == edits.second) return std::make_pair(n, n);
+			return std::make_pair(std::min(edits.first, n), std::min(edits.second, n));
 		}
 		/**
 		 * \brief Gets a const reference to the internal cached storage container
@@ -331,23 +486,167 @@ namespace crsc {
 			return cached_contents_cntr;
 		}
 	private:
+		static constexpr std::size_t to_end = static_cast<std::size_t>(-1);
 		std::fstream fs;
 		std::string filename;
 		Container cached_contents_cntr;	// internal cached storage container
+		/**
+		 * \brief An asynchronous save waiting to be written.
+		 */
+		struct save_job {
+			std::shared_ptr<const Container> snapshot;
+			std::string path;
+			std::function<void(std::exception_ptr)> on_complete;
+			std::shared_ptr<std::atomic<bool>> failed;
+			std::promise<void> done;
+		};
+		/**
+		 * \brief The asynchronous saves of a loader not yet written, and whether a pool task is writing them.
+		 */
+		struct save_queue {
+			std::mutex mut;
+			std::deque<save_job> jobs;
+			bool draining = false;
+		};
+		std::shared_ptr<save_queue> saves;	// shared with the task writing the saves
+		std::shared_future<void> pending_save;	// most recently started asynchronous save
+		std::shared_ptr<std::atomic<bool>> last_save_failed;	// set by that save if it fails
+		bool dirty = false;	// whether lines [dirty_first, dirty_last) may differ from the file
+		std::size_t dirty_first = 0U;
+		std::size_t dirty_last = 0U;
+		/**
+		 * \brief Writes the saves of `queue` in order until it is empty.
+		 */
+		static void drain_saves(save_queue& queue) noexcept {
+			for (;;) {
+				save_job job;
+				{
+					std::lock_guard<std::mutex> lock(queue.mut);
+					if (queue.jobs.empty()) {
+						queue.draining = false;
+						return;
+					}
+					job = std::move(queue.jobs.front());
+					queue.jobs.pop_front();
+				}
+				std::exception_ptr error;
+				try { save(*job.snapshot, job.path); }
+				catch (...) {
+					job.failed->store(true);
+					error = std::current_exception();
+				}
+				try { job.on_complete(error); }
+				catch (...) { if (!error) error = std::current_exception(); }
+				if (error) job.done.set_exception(error);
+				else job.done.set_value();
+			}
+		}
+		/**
+		 * \brief Waits for the most recently started asynchronous save, and hence all earlier ones.
+		 */
+		void wait_pending_save() {
+			if (pending_save.valid()) thread_pool::default_pool().wait(pending_save);
+		}
+		void mark_dirty(std::size_t first, std::size_t last) noexcept {
+			dirty_first = dirty ? std::min(dirty_first, first) : first;
+			dirty_last = dirty ? std::max(dirty_last, last) : last;
+			dirty = true;
+		}
+		/**
+		 * \brief Marks lines `[first, last)` as changed upon mutable access to them, unless the container
+		 *        records the lines written through its references itself (see `line_piece_table::edited_lines`),
+		 *        in which case only those written count.
+		 */
+		void mark_accessed(std::size_t first, std::size_t last) noexcept { mark_accessed(cached_contents_cntr, first, last, 0); }
+		template<class Cntr>
+		auto mark_accessed(const Cntr& cntr, std::size_t, std::size_t, int) noexcept -> decltype(cntr.edited_lines(), void()) {}
+		template<class Cntr>
+		void mark_accessed(const Cntr&, std::size_t first, std::size_t last, long) noexcept { mark_dirty(first, last); }
+		template<class Cntr>
+		static auto container_edits(const Cntr& cntr, int) noexcept -> decltype(cntr.edited_lines()) { return cntr.edited_lines(); }
+		template<class Cntr>
+		static std::pair<std::size_t, std::size_t> container_edits(const Cntr&, long) noexcept {
+			return std::make_pair(static_cast<std::size_t>(0U), static_cast<std::size_t>(0U));
+		}
+		template<class Cntr>
+		static auto clear_container_edits(Cntr& cntr, int) noexcept -> decltype(cntr.clear_edits(), void()) { cntr.clear_edits(); }
+		template<class Cntr>
+		static void clear_container_edits(Cntr&, long) noexcept {}
+		/**
+		 * \brief Marks the lines written through references of the container as changed, and all lines if
+		 *        the last asynchronous save failed.
+		 */
+		void refresh_dirty_state() noexcept {
+			const std::pair<std::size_t, std::size_t> edits = container_edits(cached_contents_cntr, 0);
+			if (edits.first != edits.second) mark_dirty(edits.first, edits.second);
+			clear_container_edits(cached_contents_cntr, 0);
+			if (last_save_failed && last_save_failed->load()) mark_dirty(0U, to_end);
+			last_save_failed.reset();
+		}
+		std::size_t index_of(const_iterator pos) const noexcept {
+			return static_cast<std::size_t>(pos - cached_contents_cntr.cbegin());
+		}
 		/**
 		 * \brief Caches contents of files into the internal cached storage container.
-		 *
-		 * \param _max_line_length Approximate maximum line length of the file, used for performance improvements.
-		 */
-		void cache_contents(std::size_t _max_line_length) {
-			std::string line_str;
-			// reserve space for performance
-			line_str.reserve(_max_line_length);
-			while (std::getline(fs, line_str)) {
-				cached_contents_cntr.push_back(line_str);
+		 */
+		void cache_contents(std::size_t) {
+			std::string contents;
+			if (fs.seekg(0, std::ios::end)) {
+				const std::streamoff size = fs.tellg();
+				fs.seekg(0, std::ios::beg);
+				if (size > 0) {
+					contents.resize(static_cast<std::size_t>(size));
+					fs.read(&contents[0], static_cast<std::streamsize>(size));
+					// text-mode newline translation may yield fewer characters than the file size
+					contents.resize(static_cast<std::size_t>(fs.gcount()));
+				}
+			}
+			fs.clear();
+			load_contents(cached_contents_cntr, std::move(contents), 0);
+		}
+		// a container that indexes a whole text itself, e.g. crsc::line_piece_table, is preferred
+		template<class Cntr>
+		static auto load_contents(Cntr& cntr, std::string&& contents, int)
+			-> decltype(cntr.assign_contents(std::move(contents)), void()) {
+			cntr.assign_contents(std::move(contents));
+		}
+		template<class Cntr>
+		static void load_contents(Cntr& cntr, std::string&& contents, long) {
+			// split with the semantics of std::getline, a terminating newline does not begin a line
+			const char* p = contents.data();
+			const char* const last = p + contents.size();
+			while (p != last) {
+				const char* eol = std::find(p, last, '\n');
+				cntr.push_back(std::string(p, eol));
+				p = (eol == last) ? last : eol + 1;
+			}
+		}
+		/**
+		 * \brief Replaces the file `path` with the lines of `cntr`.
+		 */
+		static void save(const Container& cntr, const std::string& path) {
+			atomic_file_writer writer(path);
+			write_contents(cntr, writer.stream(), 0);
+			writer.commit();
+		}
+		template<class Cntr>
+		static auto write_contents(const Cntr& cntr, std::ostream& os, int) -> decltype(cntr.write_to(os), void()) {
+			cntr.write_to(os);
+		}
+		template<class Cntr>
+		static void write_contents(const Cntr& cntr, std::ostream& os, long) {
+			for (const auto& el : cntr) {
+				if (!os.write(el.data(), static_cast<std::streamsize>(el.size())).put('\n')) break;
 			}
 		}
 	};
+	template<class Container>
+	constexpr std::size_t file_loader<Container>::to_end;
+	/**
+	 * \brief A `file_loader` storing the file in one contiguous buffer with a copy-on-write overlay of
+	 *        edited lines, see `crsc::line_piece_table`.
+	 */
+	typedef file_loader<line_piece_table> compact_file_loader;
 }
 
 #endif // !FILE_LOADER_H
\ No newline at end of file
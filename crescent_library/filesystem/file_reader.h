@@ -1,5 +1,7 @@
 #ifndef FILE_MANIPULATOR_H
 #define FILE_MANIPULATOR_H
+#include "line_index.h"
+#include "mapped_file.h"
 #include <fstream>
 #include <ostream>
 #include <stdexcept>
@@ -14,6 +16,9 @@ namespace crsc {
 	 *	      quicker access for reading specified line numbers / blocks of lines as well as
 	 *		  manipulating specific lines in the file.
 	 *
+	 * For large files prefer `crsc::mapped_file_reader`, which indexes lines with a parallel SIMD scan of a
+	 * memory mapping and returns views into it rather than seeking and copying on each read.
+	 *
 	 * \author Samuel Rowlinson
 	 * \date June, 2016
 	 */
@@ -31,6 +36,31 @@ namespace crsc {
 		 */
 		explicit file_reader(const std::string& _filename, std::size_t _max_line_length = 256U) 
 			: fs(_filename), filename(_filename) { cache_file_streampos(_max_line_length); }
+		/**
+		 * \brief Initialises an instance of the `file_reader` class with specified `std::string` filename,
+		 *        obtaining the stream positions of each line beginning according to `mode`.
+		 *
+		 * With `line_index_mode::sidecar` the positions are reloaded from the sidecar index file of `_filename`
+		 * (see `crsc::load_line_index`), scanning only the bytes appended since it was saved (or the whole
+		 * file, with a parallel newline search, if there is no valid sidecar) and saving the result.
+		 *
+		 * \param _filename Name/directory of file.
+		 * \param mode Whether to reuse a persistent line index.
+		 * \param policy Execution policy with which to scan the file.
+		 * \throw Throws `std::system_error` if `mode == line_index_mode::sidecar` and the file cannot be mapped.
+		 */
+		file_reader(const std::string& _filename, line_index_mode mode, const execution::parallel_policy& policy = execution::par)
+			: fs(_filename), filename(_filename) {
+			if (mode == line_index_mode::rebuild) { cache_file_streampos(256U); return; }
+			const mapped_file file(_filename);
+			const std::vector<std::uint64_t> offsets = load_line_index(_filename, file, policy, mode);
+			line_streampos_vec.reserve(offsets.size());
+			for (std::uint64_t off : offsets)
+				line_streampos_vec.push_back(std::fstream::pos_type(static_cast<std::streamoff>(off)));
+			// cache_file_streampos records the failed tellg() at EOF in place of the end of an unterminated line
+			if (!file.empty() && offsets.back() == static_cast<std::uint64_t>(file.size()) + 1U)
+				line_streampos_vec.back() = std::fstream::pos_type(std::streamoff(-1));
+		}
 		/**
 	 	 * \brief Deleted copy constructor, copy constring is forbidden. No two `file_reader` instances
 		 *        may observe the same loaded file stream resource.
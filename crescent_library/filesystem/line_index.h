@@ -0,0 +1,335 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+#include "mapped_file.h"
+#include "threading_utilities.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <sys/stat.h>
+#if !defined(CRSC_DISABLE_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace crsc {
+	/**
+	 * \brief Determines how a file reader obtains its line index.
+	 */
+	enum class line_index_mode {
+		rebuild,	// scan the file on every open
+		sidecar		// reuse (and extend, for appended files) the index kept in `sidecar_path(filename)`
+	};
+	/**
+	 * \brief Returns the name of the line-index sidecar file of `filename`.
+	 */
+	inline std::string sidecar_path(const std::string& filename) { return filename + ".lidx"; }
+	/**
+	 * \brief Detail namespace for the line indexing kernels used by the file readers. Nothing in this
+	 *        namespace is part of the public API.
+	 *
+	 * SIMD code paths for the newline search are selected at compile-time from the instruction set macros
+	 * defined by the compiler (`__AVX2__`, SSE2 on x86-64); defining `CRSC_DISABLE_SIMD` before inclusion
+	 * forces the portable kernel, which searches with `std::memchr`.
+	 *
+	 * A line index is the sequence of the byte offsets of the start of each line followed by a sentinel, the
+	 * offset one past the terminating newline of the last line (`size + 1` if the last line is unterminated).
+	 */
+	namespace file_impl {
+		/**
+		 * \brief Number of bytes of file scanned per task of the parallel line indexing.
+		 */
+		constexpr std::size_t index_chunk_size = static_cast<std::size_t>(1U) << 24;
+		/**
+		 * \brief Appends `base + i + 1` to `out` for the position `i` of every `'\n'` in `[first, last)`, i.e.
+		 *        the offsets of the lines starting after each newline, using `std::memchr`.
+		 */
+		inline void scalar_find_newlines(const char* first, const char* last, std::uint64_t base,
+			std::vector<std::uint64_t>& out) {
+			for (const char* p = first; p < last;) {
+				const void* nl = std::memchr(p, '\n', static_cast<std::size_t>(last - p));
+				if (!nl) break;
+				p = static_cast<const char*>(nl) + 1;
+				out.push_back(base + static_cast<std::uint64_t>(p - first));
+			}
+		}
+#if !defined(CRSC_DISABLE_SIMD) && (defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+		inline unsigned count_trailing_zeros(std::uint32_t mask) noexcept {
+#if defined(_MSC_VER)
+			unsigned long idx;
+			_BitScanForward(&idx, mask);
+			return static_cast<unsigned>(idx);
+#else
+			return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+		}
+		/**
+		 * \brief Appends the offsets of the lines starting after each newline in `[first, last)` to `out`,
+		 *        with the semantics of `scalar_find_newlines`, comparing a vector of bytes at a time and
+		 *        extracting the matches from the comparison bitmask.
+		 */
+		inline void find_newlines(const char* first, const char* last, std::uint64_t base,
+			std::vector<std::uint64_t>& out) {
+			const std::size_t n = static_cast<std::size_t>(last - first);
+			std::size_t i = 0U;
+#if defined(__AVX2__)
+			const __m256i nl = _mm256_set1_epi8('\n');
+			for (; i + 32U <= n; i += 32U) {
+				const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+				std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, nl)));
+				for (; mask; mask &= mask - 1U)
+					out.push_back(base + i + count_trailing_zeros(mask) + 1U);
+			}
+#else
+			const __m128i nl = _mm_set1_epi8('\n');
+			for (; i + 16U <= n; i += 16U) {
+				const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+				std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, nl)));
+				for (; mask; mask &= mask - 1U)
+					out.push_back(base + i + count_trailing_zeros(mask) + 1U);
+			}
+#endif
+			scalar_find_newlines(first + i, last, base + i, out);
+		}
+#else
+		inline void find_newlines(const char* first, const char* last, std::uint64_t base,
+			std::vector<std::uint64_t>& out) {
+			scalar_find_newlines(first, last, base, out);
+		}
+#endif
+		/**
+		 * \brief Extends the line index `offsets` of the first `from` bytes of `data` to the index of all
+		 *        `size` bytes, scanning chunks of `index_chunk_size` bytes of `[from, size)` concurrently according
+		 *        to `policy`.
+		 */
+		inline void append_line_index(std::vector<std::uint64_t>& offsets, const char* data, std::size_t from,
+			std::size_t size, const execution::parallel_policy& policy) {
+			// an unterminated last line continues into the appended bytes, so drop its sentinel
+			if (offsets.size() > 1U && offsets.back() == static_cast<std::uint64_t>(from) + 1U) offsets.pop_back();
+			if (from >= size) {
+				if (size && data[size - 1U] != '\n') offsets.push_back(static_cast<std::uint64_t>(size) + 1U);
+				return;
+			}
+			const std::size_t nchunks = (size - from + index_chunk_size - 1U)/index_chunk_size;
+			std::vector<std::vector<std::uint64_t>> parts(nchunks);
+			parallel_for(policy, 0U, nchunks, 1U, [&](std::size_t chunk_first, std::size_t chunk_last) {
+				for (std::size_t c = chunk_first; c < chunk_last; ++c) {
+					const std::size_t first = from + c*index_chunk_size;
+					const std::size_t last = std::min(first + index_chunk_size, size);
+					find_newlines(data + first, data + last, first, parts[c]);
+				}
+			});
+			std::size_t total = offsets.size();
+			for (const auto& part : parts) total += part.size();
+			offsets.reserve(total + 1U);
+			for (auto& part : parts) {
+				offsets.insert(offsets.end(), part.begin(), part.end());
+				std::vector<std::uint64_t>().swap(part);
+			}
+			if (data[size - 1U] != '\n') offsets.push_back(static_cast<std::uint64_t>(size) + 1U);
+		}
+		/**
+		 * \brief Computes the line index of `[data, data + size)`, see `append_line_index`.
+		 */
+		inline std::vector<std::uint64_t> index_lines(const char* data, std::size_t size,
+			const execution::parallel_policy& policy) {
+			std::vector<std::uint64_t> offsets(1U, 0U);
+			append_line_index(offsets, data, 0U, size, policy);
+			return offsets;
+		}
+		// SIDECAR FORMAT: a header of little-endian 64-bit words (see `sidecar_header`) followed by the
+		// differences between consecutive offsets of the index, each as an unsigned LEB128 varint
+		inline const char* sidecar_magic() noexcept { return "CRSCLIX1"; }
+		constexpr std::size_t sidecar_magic_size = 8U;
+		constexpr std::size_t sidecar_sample = 4096U;	// bytes hashed at each end of the indexed file
+		/**
+		 * \struct sidecar_header
+		 *
+		 * \brief Identifies the version of the file from which a sidecar index was built.
+		 */
+		struct sidecar_header {
+			std::uint64_t size = 0U;	// size of the file indexed
+			std::int64_t mtime = 0;	// modification time of the file when indexed
+			std::uint64_t hash = 0U;	// `sample_hash` of the file indexed
+			std::uint64_t count = 0U;	// number of offsets in the index
+		};
+		constexpr std::size_t sidecar_header_size = sidecar_magic_size + 4U*sizeof(std::uint64_t);
+		/**
+		 * \brief Returns the modification time of the file `filename`, or `0` if it cannot be determined.
+		 */
+		inline std::int64_t modification_time(const std::string& filename) noexcept {
+#if defined(_WIN32)
+			struct _stat64 st;
+			return _stat64(filename.c_str(), &st) == 0 ? static_cast<std::int64_t>(st.st_mtime) : 0;
+#else
+			struct stat st;
+			return ::stat(filename.c_str(), &st) == 0 ? static_cast<std::int64_t>(st.st_mtime) : 0;
+#endif
+		}
+		/**
+		 * \brief Returns the FNV-1a hash of the size `size` and of the first and last `sidecar_sample` bytes of
+		 *        `[data, data + size)`, such that a file which has only been appended to since being indexed has
+		 *        the same hash over the old size.
+		 */
+		inline std::uint64_t sample_hash(const char* data, std::size_t size) noexcept {
+			std::uint64_t h = 0xCBF29CE484222325ULL;
+			auto mix = [&h](const char* first, const char* last) {
+				for (; first != last; ++first) h = (h ^ static_cast<unsigned char>(*first))*0x100000001B3ULL;
+			};
+			for (unsigned b = 0U; b < 8U; ++b) h = (h ^ ((static_cast<std::uint64_t>(size) >> (8U*b)) & 0xFFU))*0x100000001B3ULL;
+			const std::size_t head = std::min(size, sidecar_sample);
+			mix(data, data + head);
+			mix(data + std::max(head, size - std::min(size, sidecar_sample)), data + size);
+			return h;
+		}
+		inline void put_u64(std::string& out, std::uint64_t v) {
+			for (unsigned b = 0U; b < 8U; ++b) out.push_back(static_cast<char>((v >> (8U*b)) & 0xFFU));
+		}
+		inline std::uint64_t get_u64(const char* p) noexcept {
+			std::uint64_t v = 0U;
+			for (unsigned b = 0U; b < 8U; ++b) v |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[b])) << (8U*b);
+			return v;
+		}
+		/**
+		 * \brief Reads the sidecar index `path` into `header` and `offsets`.
+		 *
+		 * \return `true` if the sidecar exists and is well-formed, i.e. holds a strictly increasing index from `0`
+		 *         to the sentinel of a file of `header.size` bytes, `false` otherwise.
+		 */
+		inline bool read_sidecar(const std::string& path, sidecar_header& header, std::vector<std::uint64_t>& offsets) {
+			mapped_file buf;
+			try { buf.open(path); }
+			catch (const std::system_error&) { return false; }
+			if (buf.size() < sidecar_header_size || std::memcmp(buf.data(), sidecar_magic(), sidecar_magic_size)) return false;
+			const char* p = buf.data() + sidecar_magic_size;
+			header.size = get_u64(p);
+			header.mtime = static_cast<std::int64_t>(get_u64(p + 8U));
+			header.hash = get_u64(p + 16U);
+			header.count = get_u64(p + 24U);
+			// every offset takes at least one byte, which also bounds the reservation by the sidecar size
+			if (!header.count || header.count > buf.size() - sidecar_header_size) return false;
+			offsets.clear();
+			offsets.reserve(static_cast<std::size_t>(header.count));
+			const char* q = buf.data() + sidecar_header_size;
+			const char* const last = buf.data() + buf.size();
+			std::uint64_t off = 0U;
+			for (std::uint64_t i = 0U; i < header.count; ++i) {
+				std::uint64_t delta = 0U;
+				for (unsigned shift = 0U;; shift += 7U) {
+					if (q == last || shift > 63U) return false;
+					const unsigned char byte = static_cast<unsigned char>(*q++);
+					if (shift == 63U && (byte & 0x7EU)) return false;	// bits beyond 64
+					delta |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+					if (!(byte & 0x80U)) break;
+				}
+				// the index starts at 0 and strictly increases, without wrapping
+				if ((i == 0U) != (delta == 0U) || delta > std::numeric_limits<std::uint64_t>::max() - off) return false;
+				off += delta;
+				offsets.push_back(off);
+			}
+			// and ends with the sentinel of a terminated (or empty) or unterminated last line
+			return q == last && (off == header.size || (header.size && off - 1U == header.size));
+		}
+		/**
+		 * \brief Writes `offsets` and `header` to the sidecar index `path`, via a temporary file renamed over
+		 *        `path` such that readers never observe a partial sidecar.
+		 *
+		 * \return `true` if the sidecar was written, `false` otherwise.
+		 */
+		inline bool write_sidecar(const std::string& path, const sidecar_header& header, const std::vector<std::uint64_t>& offsets) {
+			std::string buf(sidecar_magic(), sidecar_magic_size);
+			buf.reserve(sidecar_header_size + offsets.size()*2U);
+			put_u64(buf, header.size);
+			put_u64(buf, static_cast<std::uint64_t>(header.mtime));
+			put_u64(buf, header.hash);
+			put_u64(buf, header.count);
+			std::uint64_t prev = 0U;
+			for (std::uint64_t off : offsets) {
+				std::uint64_t delta = off - prev;
+				prev = off;
+				for (; delta >= 0x80U; delta >>= 7) buf.push_back(static_cast<char>((delta & 0x7FU) | 0x80U));
+				buf.push_back(static_cast<char>(delta));
+			}
+			const std::string tmp = path + ".tmp";
+			{
+				std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+				if (!out.write(buf.data(), static_cast<std::streamsize>(buf.size())) || !out.flush()) {
+					out.close();
+					std::remove(tmp.c_str());
+					return false;
+				}
+			}
+#if defined(_WIN32)
+			std::remove(path.c_str());	// rename does not replace an existing file on Windows
+#endif
+			if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+				std::remove(tmp.c_str());
+				return false;
+			}
+			return true;
+		}
+	}
+	/**
+	 * \brief Returns the line index (see `crsc::file_impl`) of the mapped file `file` named `filename`.
+	 *
+	 * With `line_index_mode::sidecar` the index is read from `sidecar_path(filename)` if it was built for the
+	 * current version of the file. If the file has grown since and its size and sampled contents up to the old
+	 * size still match, the index is extended by scanning only the appended bytes. Otherwise the whole file is
+	 * rescanned. A new or extended index is written back to the sidecar. A sidecar that cannot be read is
+	 * rebuilt, and one that cannot be written (e.g. in a read-only directory) is skipped silently.
+	 *
+	 * Appends are detected from the size, the modification time and a hash of the first and last 4KB of the
+	 * old contents, so a rewrite that keeps all three unchanged goes undetected. Only use the sidecar mode
+	 * for files that are append-only or replaced as a whole.
+	 *
+	 * \param filename Name/directory of the file.
+	 * \param file Mapping of the file.
+	 * \param policy Execution policy with which to scan the file.
+	 * \param mode Whether to use the sidecar.
+	 * \return The line index of the file.
+	 */
+	inline std::vector<std::uint64_t> load_line_index(const std::string& filename, const mapped_file& file,
+		const execution::parallel_policy& policy, line_index_mode mode = line_index_mode::sidecar) {
+		if (mode == line_index_mode::rebuild) return file_impl::index_lines(file.data(), file.size(), policy);
+		const std::string path = sidecar_path(filename);
+		const std::int64_t mtime = file_impl::modification_time(filename);
+		file_impl::sidecar_header header;
+		std::vector<std::uint64_t> offsets;
+		if (file_impl::read_sidecar(path, header, offsets) && header.size <= file.size()
+			&& header.hash == file_impl::sample_hash(file.data(), static_cast<std::size_t>(header.size))) {
+			if (header.size == file.size() && header.mtime == mtime) return offsets;
+			// a file of unchanged size but a new modification time may have been rewritten in place
+			if (header.size < file.size()) {
+				file_impl::append_line_index(offsets, file.data(), static_cast<std::size_t>(header.size), file.size(), policy);
+				header.size = file.size();
+				header.mtime = mtime;
+				header.hash = file_impl::sample_hash(file.data(), file.size());
+				header.count = offsets.size();
+				file_impl::write_sidecar(path, header, offsets);
+				return offsets;
+			}
+		}
+		offsets = file_impl::index_lines(file.data(), file.size(), policy);
+		header.size = file.size();
+		header.mtime = mtime;
+		header.hash = file_impl::sample_hash(file.data(), file.size());
+		header.count = offsets.size();
+		file_impl::write_sidecar(path, header, offsets);
+		return offsets;
+	}
+}
+
+#endif // !LINE_INDEX_H
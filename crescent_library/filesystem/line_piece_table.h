@@ -0,0 +1,430 @@
+#ifndef LINE_PIECE_TABLE_H
+#define LINE_PIECE_TABLE_H
+#include "string_view.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace crsc {
+	/**
+	 * \class line_piece_table
+	 *
+	 * \brief Compact storage of the lines of a text, keeping the original text in one contiguous buffer
+	 *        indexed by a table of (offset, length) pieces, with edited and inserted lines held in a
+	 *        copy-on-write overlay. Intended as the `Container` of `crsc::file_loader` for large files.
+	 *
+	 * Each line costs a 16-byte piece rather than a separately allocated `std::string`, such that a loaded file
+	 * occupies little more than its own size in memory. Read-only access (`const` element access and
+	 * `const_iterator`) yields `crsc::string_view`s into the storage. Mutable access (non-`const` element
+	 * access and `iterator`) yields a `line_reference`, which reads the line in place as well and copies an
+	 * original line into the overlay, where it then stays, only when the line is written. Lines written
+	 * through references are recorded, see `edited_lines`. Inserting or erasing lines only moves pieces and
+	 * never copies line contents.
+	 *
+	 * `write_to` writes each run of unedited, consecutive lines with a single unformatted write.
+	 */
+	class line_piece_table {
+		struct piece {
+			std::size_t pos;	// offset in the original text, or index in the overlay if `len == in_overlay`
+			std::size_t len;
+		};
+		static constexpr std::size_t in_overlay = static_cast<std::size_t>(-1);
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef std::string value_type;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		class line_reference;
+		typedef line_reference reference;
+		typedef string_view const_reference;
+		class const_iterator;
+		/**
+		 * \class line_reference
+		 *
+		 * \brief Mutable reference to a line of a `line_piece_table`, reading the line in place and copying an
+		 *        original line into the overlay only when it is written.
+		 *
+		 * A reference stays valid until its line is erased. Writing through it records the line as edited.
+		 */
+		class line_reference {
+		public:
+			/**
+			 * \brief Returns a view of the line, valid until the line is written or erased.
+			 */
+			string_view view() const noexcept { return tbl->view(idx); }
+			operator string_view() const noexcept { return tbl->view(idx); }
+			std::string to_string() const { return view().to_string(); }
+			size_type size() const noexcept { return view().size(); }
+			bool empty() const noexcept { return view().empty(); }
+			/**
+			 * \brief Returns the line as a `std::string` to modify in place, copying an original line into the
+			 *        overlay. The reference stays valid until the line is erased.
+			 */
+			std::string& str() const { return tbl->materialise(idx); }
+			line_reference& operator=(const line_reference& other) { return *this = other.view(); }
+			line_reference& operator=(std::string&& str) {
+				tbl->replace(idx, std::move(str));
+				return *this;
+			}
+			line_reference& operator=(const std::string& str) { return *this = std::string(str); }
+			line_reference& operator=(string_view sv) { return *this = sv.to_string(); }
+			line_reference& operator=(const char* s) { return *this = string_view(s); }
+			line_reference& operator+=(string_view sv) {
+				str().append(sv.data(), sv.size());
+				return *this;
+			}
+			line_reference& operator+=(const char* s) { return *this += string_view(s); }
+			friend bool operator==(const line_reference& lhs, const line_reference& rhs) noexcept { return lhs.view() == rhs.view(); }
+			friend bool operator==(const line_reference& lhs, string_view rhs) noexcept { return lhs.view() == rhs; }
+			friend bool operator==(string_view lhs, const line_reference& rhs) noexcept { return lhs == rhs.view(); }
+			friend bool operator!=(const line_reference& lhs, const line_reference& rhs) noexcept { return !(lhs == rhs); }
+			friend bool operator!=(const line_reference& lhs, string_view rhs) noexcept { return !(lhs == rhs); }
+			friend bool operator!=(string_view lhs, const line_reference& rhs) noexcept { return !(lhs == rhs); }
+			friend std::ostream& operator<<(std::ostream& os, const line_reference& ref) { return os << ref.view(); }
+		private:
+			friend class line_piece_table;
+			line_piece_table* tbl;
+			std::size_t idx;
+			line_reference(line_piece_table* _tbl, std::size_t _idx) noexcept : tbl(_tbl), idx(_idx) {}
+		};
+		/**
+		 * \class iterator
+		 *
+		 * \brief Random access iterator yielding `line_reference`s to the lines.
+		 */
+		class iterator {
+			struct arrow_proxy {
+				mutable line_reference ref;
+				line_reference* operator->() const noexcept { return &ref; }
+			};
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef std::string value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef arrow_proxy pointer;
+			typedef line_reference reference;
+			iterator() noexcept : tbl(nullptr), idx(0U) {}
+			reference operator*() const noexcept { return line_reference(tbl, idx); }
+			pointer operator->() const noexcept { return arrow_proxy{ line_reference(tbl, idx) }; }
+			reference operator[](difference_type n) const noexcept { return line_reference(tbl, idx + n); }
+			iterator& operator++() noexcept { ++idx; return *this; }
+			iterator operator++(int) noexcept { iterator tmp = *this; ++idx; return tmp; }
+			iterator& operator--() noexcept { --idx; return *this; }
+			iterator operator--(int) noexcept { iterator tmp = *this; --idx; return tmp; }
+			iterator& operator+=(difference_type n) noexcept { idx += n; return *this; }
+			iterator& operator-=(difference_type n) noexcept { idx -= n; return *this; }
+			friend iterator operator+(iterator it, difference_type n) noexcept { return it += n; }
+			friend iterator operator+(difference_type n, iterator it) noexcept { return it += n; }
+			friend iterator operator-(iterator it, difference_type n) noexcept { return it -= n; }
+			friend difference_type operator-(const iterator& lhs, const iterator& rhs) noexcept {
+				return static_cast<difference_type>(lhs.idx) - static_cast<difference_type>(rhs.idx);
+			}
+			friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept { return lhs.idx == rhs.idx; }
+			friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept { return lhs.idx != rhs.idx; }
+			friend bool operator<(const iterator& lhs, const iterator& rhs) noexcept { return lhs.idx < rhs.idx; }
+			friend bool operator>(const iterator& lhs, const iterator& rhs) noexcept { return lhs.idx > rhs.idx; }
+			friend bool operator<=(const iterator& lhs, const iterator& rhs) noexcept { return lhs.idx <= rhs.idx; }
+			friend bool operator>=(const iterator& lhs, const iterator& rhs) noexcept { return lhs.idx >= rhs.idx; }
+		private:
+			friend class line_piece_table;
+			friend class const_iterator;
+			line_piece_table* tbl;
+			std::size_t idx;
+			iterator(line_piece_table* _tbl, std::size_t _idx) noexcept : tbl(_tbl), idx(_idx) {}
+		};
+		/**
+		 * \class const_iterator
+		 *
+		 * \brief Random access iterator yielding `crsc::string_view`s of the lines.
+		 */
+		class const_iterator {
+			struct arrow_proxy {
+				string_view sv;
+				const string_view* operator->() const noexcept { return &sv; }
+			};
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef string_view value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef arrow_proxy pointer;
+			typedef string_view reference;
+			const_iterator() noexcept : tbl(nullptr), idx(0U) {}
+			const_iterator(const iterator& it) noexcept : tbl(it.tbl), idx(it.idx) {}
+			reference operator*() const noexcept { return tbl->view(idx); }
+			pointer operator->() const noexcept { return arrow_proxy{ tbl->view(idx) }; }
+			reference operator[](difference_type n) const noexcept { return tbl->view(idx + n); }
+			const_iterator& operator++() noexcept { ++idx; return *this; }
+			const_iterator operator++(int) noexcept { const_iterator tmp = *this; ++idx; return tmp; }
+			const_iterator& operator--() noexcept { --idx; return *this; }
+			const_iterator operator--(int) noexcept { const_iterator tmp = *this; --idx; return tmp; }
+			const_iterator& operator+=(difference_type n) noexcept { idx += n; return *this; }
+			const_iterator& operator-=(difference_type n) noexcept { idx -= n; return *this; }
+			friend const_iterator operator+(const_iterator it, difference_type n) noexcept { return it += n; }
+			friend const_iterator operator+(difference_type n, const_iterator it) noexcept { return it += n; }
+			friend const_iterator operator-(const_iterator it, difference_type n) noexcept { return it -= n; }
+			friend difference_type operator-(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+				return static_cast<difference_type>(lhs.idx) - static_cast<difference_type>(rhs.idx);
+			}
+			friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.idx == rhs.idx; }
+			friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.idx != rhs.idx; }
+			friend bool operator<(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.idx < rhs.idx; }
+			friend bool operator>(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.idx > rhs.idx; }
+			friend bool operator<=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.idx <= rhs.idx; }
+			friend bool operator>=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.idx >= rhs.idx; }
+		private:
+			friend class line_piece_table;
+			const line_piece_table* tbl;
+			std::size_t idx;
+			const_iterator(const line_piece_table* _tbl, std::size_t _idx) noexcept : tbl(_tbl), idx(_idx) {}
+		};
+		typedef std::reverse_iterator<iterator> reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+		// CONSTRUCTION/ASSIGNMENT
+		/**
+		 * \brief Constructs an empty table.
+		 */
+		line_piece_table() = default;
+		/**
+		 * \brief Constructs the table of the lines of `contents`, see `assign_contents`.
+		 */
+		explicit line_piece_table(std::string contents) { assign_contents(std::move(contents)); }
+		/**
+		 * \brief Replaces the lines of the table with those of the text `contents`, taking ownership of it as
+		 *        the original text. Lines are delimited by `'\n'` (excluded from the lines) as with
+		 *        `std::getline`, such that a terminating newline does not begin a further, empty, line.
+		 *
+		 * \param contents Text to split into lines.
+		 * \complexity Linear in the size of `contents`.
+		 */
+		void assign_contents(std::string&& contents) {
+			clear();
+			text = std::move(contents);
+			const char* const first = text.data();
+			const char* const last = first + text.size();
+			for (const char* p = first; p != last;) {
+				const void* nl = std::memchr(p, '\n', static_cast<std::size_t>(last - p));
+				const char* eol = nl ? static_cast<const char*>(nl) : last;
+				pieces.push_back(piece{ static_cast<std::size_t>(p - first), static_cast<std::size_t>(eol - p) });
+				p = nl ? eol + 1 : last;
+			}
+		}
+		// CAPACITY
+		size_type size() const noexcept { return pieces.size(); }
+		bool empty() const noexcept { return pieces.empty(); }
+		/**
+		 * \brief Returns the number of lines held in the overlay, i.e. edited or inserted lines.
+		 */
+		size_type overlay_size() const noexcept { return overlay.size() - free_slots.size(); }
+		// ELEMENT ACCESS
+		const_reference operator[](size_type n) const noexcept { return view(n); }
+		reference operator[](size_type n) noexcept { return line_reference(this, n); }
+		const_reference front() const noexcept { return view(0U); }
+		reference front() noexcept { return line_reference(this, 0U); }
+		const_reference back() const noexcept { return view(pieces.size() - 1U); }
+		reference back() noexcept { return line_reference(this, pieces.size() - 1U); }
+		// EDIT TRACKING
+		/**
+		 * \brief Returns the range `[first, last)` of the lines written through a `line_reference` since
+		 *        construction, `assign_contents`, `clear` or `clear_edits`, extended over the lines whose
+		 *        positions have shifted since by insertion or erasure.
+		 *
+		 * \return Range of edited lines, empty if there are none.
+		 */
+		std::pair<size_type, size_type> edited_lines() const noexcept { return std::make_pair(edit_first, edit_last); }
+		/**
+		 * \brief Forgets the edited lines, e.g. once they are saved, see `edited_lines`.
+		 */
+		void clear_edits() noexcept { edit_first = edit_last = 0U; }
+		// ITERATORS
+		iterator begin() noexcept { return iterator(this, 0U); }
+		const_iterator begin() const noexcept { return const_iterator(this, 0U); }
+		const_iterator cbegin() const noexcept { return const_iterator(this, 0U); }
+		iterator end() noexcept { return iterator(this, pieces.size()); }
+		const_iterator end() const noexcept { return const_iterator(this, pieces.size()); }
+		const_iterator cend() const noexcept { return const_iterator(this, pieces.size()); }
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+		// MODIFIERS
+		/**
+		 * \brief Removes all lines, releasing the original text and the overlay.
+		 */
+		void clear() noexcept {
+			text.clear();
+			pieces.clear();
+			overlay.clear();
+			free_slots.clear();
+			clear_edits();
+		}
+		/**
+		 * \brief Erases the line at `pos`.
+		 *
+		 * \return Iterator following the erased line.
+		 * \complexity Linear in the number of lines after `pos`.
+		 */
+		iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+		/**
+		 * \brief Erases the lines `[first, last)`.
+		 *
+		 * \return Iterator following the last erased line.
+		 * \complexity Linear in the number of lines after `first`.
+		 */
+		iterator erase(const_iterator first, const_iterator last) {
+			free_slots.reserve(free_slots.size() + (last.idx - first.idx));	// such that release cannot throw
+			for (std::size_t i = first.idx; i < last.idx; ++i) release(pieces[i]);
+			pieces.erase(pieces.begin() + first.idx, pieces.begin() + last.idx);
+			shift_edits(first.idx);
+			return iterator(this, first.idx);
+		}
+		/**
+		 * \brief Inserts the line `str` before `pos`.
+		 *
+		 * \return Iterator to the inserted line.
+		 * \complexity Linear in the number of lines after `pos`.
+		 */
+		iterator insert(const_iterator pos, const std::string& str) { return insert(pos, std::string(str)); }
+		iterator insert(const_iterator pos, std::string&& str) {
+			const piece p{ acquire(std::move(str)), in_overlay };
+			try { pieces.insert(pieces.begin() + pos.idx, p); }
+			catch (...) { release(p); throw; }
+			shift_edits(pos.idx);
+			return iterator(this, pos.idx);
+		}
+		/**
+		 * \brief Inserts the lines `[first, last)`, each converted to `std::string`, before `pos`.
+		 *
+		 * \return Iterator to the first inserted line, or `pos` if `first == last`.
+		 * \complexity Linear in the number of lines inserted plus the number of lines after `pos`.
+		 */
+		template<class InputIt>
+		iterator insert(const_iterator pos, InputIt first, InputIt last) {
+			std::vector<piece> added;
+			try {
+				for (; first != last; ++first) added.push_back(piece{ acquire(std::string(*first)), in_overlay });
+				pieces.insert(pieces.begin() + pos.idx, added.begin(), added.end());
+			}
+			catch (...) {
+				for (const piece& p : added) release(p);
+				throw;
+			}
+			if (!added.empty()) shift_edits(pos.idx);
+			return iterator(this, pos.idx);
+		}
+		void push_back(const std::string& str) { insert(cend(), str); }
+		void push_back(std::string&& str) { insert(cend(), std::move(str)); }
+		void pop_back() { erase(cend() - 1); }
+		void swap(line_piece_table& other) noexcept {
+			text.swap(other.text);
+			pieces.swap(other.pieces);
+			overlay.swap(other.overlay);
+			free_slots.swap(other.free_slots);
+			std::swap(edit_first, other.edit_first);
+			std::swap(edit_last, other.edit_last);
+		}
+		// OUTPUT
+		/**
+		 * \brief Writes every line followed by `'\n'` to `os`, writing each run of unedited lines that are
+		 *        consecutive in the original text with a single `os.write`.
+		 *
+		 * \param os Output stream to write to.
+		 */
+		void write_to(std::ostream& os) const {
+			for (std::size_t i = 0U; i < pieces.size() && os;) {
+				if (pieces[i].len == in_overlay) {
+					const std::string& s = overlay[pieces[i].pos];
+					os.write(s.data(), static_cast<std::streamsize>(s.size())).put('\n');
+					++i;
+					continue;
+				}
+				std::size_t j = i + 1U;
+				while (j < pieces.size() && pieces[j].len != in_overlay
+					&& pieces[j].pos == pieces[j - 1U].pos + pieces[j - 1U].len + 1U) ++j;
+				const std::size_t first = pieces[i].pos, last = pieces[j - 1U].pos + pieces[j - 1U].len;
+				os.write(text.data() + first, static_cast<std::streamsize>(last - first)).put('\n');
+				i = j;
+			}
+		}
+	private:
+		std::string text;	// original text
+		std::vector<piece> pieces;	// one piece per line, in line order
+		std::deque<std::string> overlay;	// edited and inserted lines, a deque so references remain stable
+		std::vector<std::size_t> free_slots;	// overlay slots of erased lines, reused by later edits
+		std::size_t edit_first = 0U;	// range of lines written through references, see edited_lines
+		std::size_t edit_last = 0U;
+		string_view view(std::size_t n) const noexcept {
+			const piece& p = pieces[n];
+			if (p.len == in_overlay) return string_view(overlay[p.pos]);
+			return string_view(text.data() + p.pos, p.len);
+		}
+		/**
+		 * \brief Returns the overlay string of line `n` for writing, first copying the line into the overlay if
+		 *        it is an original line.
+		 */
+		std::string& materialise(std::size_t n) {
+			piece& p = pieces[n];
+			if (p.len != in_overlay) {
+				p.pos = acquire(std::string(text, p.pos, p.len));
+				p.len = in_overlay;
+			}
+			record_edit(n);
+			return overlay[p.pos];
+		}
+		/**
+		 * \brief Replaces line `n` with `str`, without copying an original line into the overlay first.
+		 */
+		void replace(std::size_t n, std::string&& str) {
+			piece& p = pieces[n];
+			if (p.len != in_overlay) {
+				p.pos = acquire(std::move(str));
+				p.len = in_overlay;
+			}
+			else overlay[p.pos] = std::move(str);
+			record_edit(n);
+		}
+		void record_edit(std::size_t n) noexcept {
+			if (edit_first == edit_last) {
+				edit_first = n;
+				edit_last = n + 1U;
+			}
+			else {
+				edit_first = std::min(edit_first, n);
+				edit_last = std::max(edit_last, n + 1U);
+			}
+		}
+		/**
+		 * \brief Extends the edited range over the lines from `pos` on, after an insertion or erasure at `pos`
+		 *        shifted them.
+		 */
+		void shift_edits(std::size_t pos) noexcept {
+			if (edit_first == edit_last || edit_last <= pos) return;
+			edit_first = std::min(edit_first, pos);
+			edit_last = std::max(pieces.size(), edit_first);
+		}
+		std::size_t acquire(std::string&& str) {
+			if (!free_slots.empty()) {
+				const std::size_t slot = free_slots.back();
+				overlay[slot] = std::move(str);
+				free_slots.pop_back();
+				return slot;
+			}
+			overlay.push_back(std::move(str));
+			return overlay.size() - 1U;
+		}
+		void release(const piece& p) {
+			if (p.len != in_overlay) return;
+			overlay[p.pos] = std::string();
+			free_slots.push_back(p.pos);
+		}
+	};
+}
+
+#endif // !LINE_PIECE_TABLE_H
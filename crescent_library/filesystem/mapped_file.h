@@ -0,0 +1,164 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace crsc {
+	/**
+	 * \class mapped_file
+	 *
+	 * \brief Read-only memory mapping of an entire file, owning the mapping for its lifetime.
+	 *
+	 * The contents are paged in by the operating system on first access rather than read up-front, such that
+	 * opening is constant time regardless of the file size and only the pages actually touched are read. Any
+	 * pointer into the mapping is invalidated when the `mapped_file` is destroyed, moved from or `close`d. An
+	 * empty file is represented by `data() == nullptr` and `size() == 0`.
+	 */
+	class mapped_file {
+	public:
+		enum class access_hint {
+			normal,		// default read-ahead
+			sequential,	// aggressive read-ahead, pages may be dropped soon after being read
+			random		// minimal read-ahead
+		};
+		// CONSTRUCTION/ASSIGNMENT
+		/**
+		 * \brief Constructs an instance mapping no file.
+		 */
+		mapped_file() noexcept = default;
+		/**
+		 * \brief Maps the file `_filename` for reading.
+		 *
+		 * \param _filename Name/directory of file.
+		 * \throw Throws `std::system_error` if the file cannot be opened or mapped.
+		 */
+		explicit mapped_file(const std::string& _filename) { open(_filename); }
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+		mapped_file(mapped_file&& _other) noexcept { swap(_other); }
+		mapped_file& operator=(mapped_file&& _other) noexcept {
+			if (this != &_other) {
+				close();
+				swap(_other);
+			}
+			return *this;
+		}
+		~mapped_file() { close(); }
+		/**
+		 * \brief Maps the file `_filename` for reading, unmapping any file currently mapped.
+		 *
+		 * \param _filename Name/directory of file.
+		 * \throw Throws `std::system_error` if the file cannot be opened or mapped.
+		 */
+		void open(const std::string& _filename) {
+			close();
+#if defined(_WIN32)
+			HANDLE file = ::CreateFileA(_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) throw_last_error("Unable to open file: " + _filename);
+			LARGE_INTEGER file_size;
+			if (!::GetFileSizeEx(file, &file_size)) {
+				const DWORD err = ::GetLastError();
+				::CloseHandle(file);
+				throw std::system_error(static_cast<int>(err), std::system_category(), "Unable to stat file: " + _filename);
+			}
+			if (file_size.QuadPart) {
+				HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				void* view = mapping ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+				const DWORD err = ::GetLastError();
+				if (mapping) ::CloseHandle(mapping);
+				::CloseHandle(file);
+				if (!view) throw std::system_error(static_cast<int>(err), std::system_category(), "Unable to map file: " + _filename);
+				ptr = static_cast<const char*>(view);
+				len = static_cast<std::size_t>(file_size.QuadPart);
+			}
+			else ::CloseHandle(file);
+#else
+			const int fd = ::open(_filename.c_str(), O_RDONLY);
+			if (fd < 0) throw std::system_error(errno, std::generic_category(), "Unable to open file: " + _filename);
+			struct stat st;
+			if (::fstat(fd, &st) != 0) {
+				const int err = errno;
+				::close(fd);
+				throw std::system_error(err, std::generic_category(), "Unable to stat file: " + _filename);
+			}
+			if (st.st_size > 0) {
+				void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				const int err = errno;
+				::close(fd);	// the mapping holds its own reference to the file
+				if (view == MAP_FAILED) throw std::system_error(err, std::generic_category(), "Unable to map file: " + _filename);
+				ptr = static_cast<const char*>(view);
+				len = static_cast<std::size_t>(st.st_size);
+			}
+			else ::close(fd);
+#endif
+		}
+		/**
+		 * \brief Unmaps the file, if any.
+		 */
+		void close() noexcept {
+			if (ptr) {
+#if defined(_WIN32)
+				::UnmapViewOfFile(ptr);
+#else
+				::munmap(const_cast<char*>(ptr), len);
+#endif
+			}
+			ptr = nullptr;
+			len = 0U;
+		}
+		/**
+		 * \brief Advises the operating system of the expected access pattern of the mapping. This is a no-op
+		 *        where the platform provides no such advice.
+		 */
+		void advise(access_hint hint) const noexcept {
+#if !defined(_WIN32)
+			if (!ptr) return;
+			const int advice = (hint == access_hint::sequential) ? MADV_SEQUENTIAL
+				: (hint == access_hint::random ? MADV_RANDOM : MADV_NORMAL);
+			::madvise(const_cast<char*>(ptr), len, advice);
+#else
+			(void)hint;
+#endif
+		}
+		// CONTENT ACCESS
+		const char* data() const noexcept { return ptr; }
+		const char* begin() const noexcept { return ptr; }
+		const char* end() const noexcept { return ptr + len; }
+		// CAPACITY
+		std::size_t size() const noexcept { return len; }
+		bool empty() const noexcept { return len == 0U; }
+		void swap(mapped_file& _other) noexcept {
+			std::swap(ptr, _other.ptr);
+			std::swap(len, _other.len);
+		}
+	private:
+		const char* ptr = nullptr;
+		std::size_t len = 0U;
+#if defined(_WIN32)
+		static void throw_last_error(const std::string& what) {
+			throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), what);
+		}
+#endif
+	};
+}
+
+#endif // !MAPPED_FILE_H
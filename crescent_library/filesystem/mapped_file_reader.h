@@ -0,0 +1,144 @@
+#ifndef MAPPED_FILE_READER_H
+#define MAPPED_FILE_READER_H
+#include "line_index.h"
+#include "mapped_file.h"
+#include "string_view.h"
+#include "threading_utilities.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace crsc {
+	/**
+	 * \class mapped_file_reader
+	 *
+	 * \brief A memory-mapped alternative to `crsc::file_reader` for large files, indexing the offset of every
+	 *        line during construction and returning lines as `crsc::string_view`s into the mapping.
+	 *
+	 * The line index is built by a SIMD newline search split across threads in chunks, and the reads neither
+	 * seek, copy nor allocate. Lines are delimited by `'\n'` only, such that (as with `std::getline`) a
+	 * trailing `'\r'` is part of the line; a final line without a terminating newline is still a line. Any view
+	 * returned is valid until the reader is destroyed or moved from.
+	 */
+	class mapped_file_reader {
+	public:
+		// CONSTRUCTION/ASSIGNMENT
+		/**
+		 * \brief Maps the file `_filename` and indexes the offsets of its lines.
+		 *
+		 * \param _filename Name/directory of file.
+		 * \param policy Execution policy with which to index the lines, defaults to all hardware threads.
+		 * \param mode Whether to reuse a persistent line index, see `crsc::load_line_index`.
+		 * \throw Throws `std::system_error` if the file cannot be opened or mapped.
+		 * \complexity Linear in the size of the file, divided across the threads of `policy`. With
+		 *             `line_index_mode::sidecar`, linear in the number of lines plus the size of any appended bytes.
+		 */
+		explicit mapped_file_reader(const std::string& _filename, const execution::parallel_policy& policy = execution::par,
+			line_index_mode mode = line_index_mode::rebuild)
+			: file(_filename), filename(_filename) {
+			file.advise(mapped_file::access_hint::sequential);
+			offsets = load_line_index(filename, file, policy, mode);
+			file.advise(mapped_file::access_hint::normal);
+		}
+		/**
+		 * \brief Maps the file `_filename` and obtains its line index according to `mode` using all hardware
+		 *        threads.
+		 */
+		mapped_file_reader(const std::string& _filename, line_index_mode mode)
+			: mapped_file_reader(_filename, execution::par, mode) {}
+		mapped_file_reader(const mapped_file_reader&) = delete;
+		mapped_file_reader& operator=(const mapped_file_reader&) = delete;
+		mapped_file_reader(mapped_file_reader&&) = default;
+		mapped_file_reader& operator=(mapped_file_reader&&) = default;
+		// CAPACITY
+		/**
+		 * \brief Returns the number of lines in the file.
+		 */
+		std::size_t lines() const noexcept { return offsets.empty() ? 0U : offsets.size() - 1U; }
+		/**
+		 * \brief Checks if the file is empty.
+		 */
+		bool empty() const noexcept { return offsets.size() <= 1U; }
+		/**
+		 * \brief Returns the size of the file in bytes.
+		 */
+		std::size_t size() const noexcept { return file.size(); }
+		// CONTENT ACCESS
+		/**
+		 * \brief Returns a view of a specified line of the file, excluding its terminating newline.
+		 *
+		 * \param n Line number to read.
+		 * \return `crsc::string_view` of the line.
+		 * \throw Throws `std::out_of_range` exception if `!(n < lines())`.
+		 * \complexity Constant.
+		 */
+		string_view read_line(std::size_t n) const {
+			if (n >= lines())
+				throw std::out_of_range("The file: " + filename + " does not have " + std::to_string(n + 1U) + " lines.");
+			return view(n, n + 1U);
+		}
+		/**
+		 * \brief Returns a view of the lines `[first, first + count)` of the file as one contiguous block,
+		 *        including the newlines between the lines but excluding the terminating newline of the last.
+		 *
+		 * \param first Number of first line of the block.
+		 * \param count Number of lines in the block.
+		 * \return `crsc::string_view` of the block, empty if `count == 0`.
+		 * \throw Throws `std::out_of_range` exception if `first + count > lines()`.
+		 * \complexity Constant.
+		 */
+		string_view read_block(std::size_t first, std::size_t count) const {
+			if (first > lines() || count > lines() - first)
+				throw std::out_of_range("The file: " + filename + " does not have " + std::to_string(first + count) + " lines.");
+			return count ? view(first, first + count) : string_view(file.data(), 0U);
+		}
+		/**
+		 * \brief Returns views of each of the lines `[first, first + count)` of the file.
+		 *
+		 * \throw Throws `std::out_of_range` exception if `first + count > lines()`.
+		 */
+		std::vector<string_view> read_lines(std::size_t first, std::size_t count) const {
+			if (first > lines() || count > lines() - first)
+				throw std::out_of_range("The file: " + filename + " does not have " + std::to_string(first + count) + " lines.");
+			std::vector<string_view> rtn;
+			rtn.reserve(count);
+			for (std::size_t n = first; n < first + count; ++n) rtn.push_back(view(n, n + 1U));
+			return rtn;
+		}
+		/**
+		 * \brief Returns a view of the first line of the file.
+		 *
+		 * \throw Throws `std::out_of_range` exception if the file is empty.
+		 */
+		string_view first_line() const { return read_line(0U); }
+		/**
+		 * \brief Returns a view of the last line of the file.
+		 *
+		 * \throw Throws `std::out_of_range` exception if the file is empty.
+		 */
+		string_view last_line() const { return read_line(lines() - 1U); }
+		/**
+		 * \brief Returns a view of the entire contents of the file.
+		 */
+		string_view contents() const noexcept { return string_view(file.data(), file.size()); }
+		/**
+		 * \brief Returns the byte offset of the start of each line, followed by the offset one past the
+		 *        terminating newline of the last line (`size() + 1` if it is unterminated).
+		 */
+		const std::vector<std::uint64_t>& line_offsets() const noexcept { return offsets; }
+	private:
+		mapped_file file;
+		std::vector<std::uint64_t> offsets;	// offset of the start of each line, plus the end sentinel
+		std::string filename;
+		/**
+		 * \brief Returns the view of lines `[first, last)` excluding the terminating newline of the last.
+		 */
+		string_view view(std::size_t first, std::size_t last) const noexcept {
+			return string_view(file.data() + offsets[first], static_cast<std::size_t>(offsets[last] - offsets[first] - 1U));
+		}
+	};
+}
+
+#endif // !MAPPED_FILE_READER_H
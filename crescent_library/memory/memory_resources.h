@@ -0,0 +1,415 @@
+#ifndef MEMORY_RESOURCES_H
+#define MEMORY_RESOURCES_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace crsc {
+	/**
+	 * \brief Allocation facilities for use with the allocator and container hooks of the crsc containers,
+	 *        modelled on the C++17 `<memory_resource>` library: polymorphic memory resources (including a
+	 *        monotonic arena) with an allocator adapter, and thread-local fixed-size block pools.
+	 */
+	namespace memory {
+		/**
+		 * \class memory_resource
+		 *
+		 * \brief Abstract interface to a source of untyped memory, see `std::pmr::memory_resource`.
+		 */
+		class memory_resource {
+		public:
+			virtual ~memory_resource() {}
+			/**
+			 * \brief Allocates at least `bytes` bytes aligned to `alignment` bytes.
+			 *
+			 * \throw Throws `std::bad_alloc` exception (or as otherwise specified by the resource) on failure.
+			 */
+			void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+				return do_allocate(bytes, alignment);
+			}
+			/**
+			 * \brief Deallocates `p`, which must have been returned by `allocate(bytes, alignment)` on a resource
+			 *        comparing equal to this one.
+			 */
+			void deallocate(void* p, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+				do_deallocate(p, bytes, alignment);
+			}
+			/**
+			 * \brief Checks whether memory allocated by this resource can be deallocated by `other` and vice versa.
+			 */
+			bool is_equal(const memory_resource& other) const noexcept { return do_is_equal(other); }
+		private:
+			virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+			virtual void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+			virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+		};
+		inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+			return &lhs == &rhs || lhs.is_equal(rhs);
+		}
+		inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+		namespace memory_impl {
+			class new_delete_resource_t : public memory_resource {
+				void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+					if (alignment <= alignof(std::max_align_t)) return ::operator new(bytes);
+					// over-allocate and store the original pointer immediately before the aligned block
+					const std::size_t extra = alignment + sizeof(void*);
+					if (bytes > std::numeric_limits<std::size_t>::max() - extra) throw std::bad_alloc();
+					void* raw = ::operator new(bytes + extra);
+					const std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(raw) + extra)
+						& ~static_cast<std::uintptr_t>(alignment - 1U);
+					reinterpret_cast<void**>(aligned)[-1] = raw;
+					return reinterpret_cast<void*>(aligned);
+				}
+				void do_deallocate(void* p, std::size_t, std::size_t alignment) override {
+					if (alignment <= alignof(std::max_align_t)) ::operator delete(p);
+					else ::operator delete(static_cast<void**>(p)[-1]);
+				}
+				bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+			};
+			constexpr std::size_t align_up(std::size_t n, std::size_t alignment) noexcept {
+				return (n + alignment - 1U)/alignment*alignment;
+			}
+			constexpr std::size_t max_of(std::size_t a, std::size_t b) noexcept { return (a < b) ? b : a; }
+		}
+		/**
+		 * \brief Returns a resource allocating through the global `operator new` and `operator delete`.
+		 */
+		inline memory_resource* new_delete_resource() noexcept {
+			static memory_impl::new_delete_resource_t res;
+			return &res;
+		}
+		namespace memory_impl {
+			inline std::atomic<memory_resource*>& default_resource_ptr() noexcept {
+				static std::atomic<memory_resource*> p(new_delete_resource());
+				return p;
+			}
+		}
+		/**
+		 * \brief Returns the resource used by default constructed `polymorphic_allocator`s, initially
+		 *        `new_delete_resource()`.
+		 */
+		inline memory_resource* get_default_resource() noexcept {
+			return memory_impl::default_resource_ptr().load(std::memory_order_acquire);
+		}
+		/**
+		 * \brief Sets the default resource to `r` (or `new_delete_resource()` if null), returning the previous one.
+		 */
+		inline memory_resource* set_default_resource(memory_resource* r) noexcept {
+			return memory_impl::default_resource_ptr().exchange(r ? r : new_delete_resource(), std::memory_order_acq_rel);
+		}
+		/**
+		 * \class monotonic_arena
+		 *
+		 * \brief A memory resource which serves allocations by bumping a pointer through chunks of memory
+		 *        obtained from an upstream resource, releasing all of its memory at once on `release()` or
+		 *        destruction. Deallocation of individual blocks is a no-op.
+		 *
+		 * Use an arena for groups of short-lived objects (e.g. all temporaries of one request) such that they
+		 * are freed together in time proportional to the number of chunks rather than the number of objects.
+		 * Chunk sizes grow geometrically from the initial size. Not thread-safe.
+		 */
+		class monotonic_arena : public memory_resource {
+		public:
+			/**
+			 * \brief Constructs an arena whose first chunk, allocated upon the first allocation, holds at least
+			 *        `initial_size` bytes.
+			 *
+			 * \param initial_size Size in bytes of the first chunk.
+			 * \param upstream Resource from which to obtain chunks.
+			 */
+			explicit monotonic_arena(std::size_t initial_size = 1024U, memory_resource* upstream = get_default_resource())
+				: upstream_res(upstream), next_chunk_size(std::max<std::size_t>(initial_size, 64U)) {}
+			/**
+			 * \brief Constructs an arena which serves allocations from `buffer` of `size` bytes until it is
+			 *        exhausted, only then obtaining chunks from `upstream`. `buffer` is not owned.
+			 */
+			monotonic_arena(void* buffer, std::size_t size, memory_resource* upstream = get_default_resource())
+				: upstream_res(upstream), initial_buf(static_cast<unsigned char*>(buffer)), initial_size(size),
+				current(initial_buf), remaining(size), next_chunk_size(std::max<std::size_t>(size, 64U)) {}
+			monotonic_arena(const monotonic_arena&) = delete;
+			monotonic_arena& operator=(const monotonic_arena&) = delete;
+			~monotonic_arena() { release(); }
+			/**
+			 * \brief Returns all chunks to the upstream resource, invalidating every allocation of the arena.
+			 *
+			 * \complexity Linear in the number of chunks.
+			 */
+			void release() noexcept {
+				while (chunks) {
+					chunk_header* prev = chunks->prev;
+					upstream_res->deallocate(chunks, chunks->size, alignof(chunk_header));
+					chunks = prev;
+				}
+				current = initial_buf;
+				remaining = initial_size;
+				allocated = 0U;
+			}
+			/**
+			 * \brief Returns the upstream resource of the arena.
+			 */
+			memory_resource* upstream_resource() const noexcept { return upstream_res; }
+			/**
+			 * \brief Returns the total number of bytes requested from the arena since construction or `release()`.
+			 */
+			std::size_t bytes_allocated() const noexcept { return allocated; }
+		private:
+			struct alignas(std::max_align_t) chunk_header {
+				chunk_header* prev;
+				std::size_t size;
+			};
+			memory_resource* upstream_res;
+			unsigned char* initial_buf = nullptr;
+			std::size_t initial_size = 0U;
+			unsigned char* current = nullptr;
+			std::size_t remaining = 0U;
+			std::size_t next_chunk_size;
+			std::size_t allocated = 0U;
+			chunk_header* chunks = nullptr;
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+				std::size_t pad = (alignment - reinterpret_cast<std::uintptr_t>(current) % alignment) % alignment;
+				if (!current || bytes > remaining || pad > remaining - bytes) {
+					// new chunk large enough for the request at any alignment
+					const std::size_t max_size = std::numeric_limits<std::size_t>::max();
+					if (bytes > max_size - sizeof(chunk_header) - alignment) throw std::bad_alloc();
+					const std::size_t needed = sizeof(chunk_header) + bytes + alignment;
+					std::size_t size = next_chunk_size;
+					while (size < needed) size = (size > max_size/2U) ? needed : size*2U;
+					chunk_header* c = static_cast<chunk_header*>(upstream_res->allocate(size, alignof(chunk_header)));
+					c->prev = chunks;
+					c->size = size;
+					chunks = c;
+					current = reinterpret_cast<unsigned char*>(c + 1);
+					remaining = size - sizeof(chunk_header);
+					next_chunk_size = (size > max_size/2U) ? size : size*2U;
+					pad = (alignment - reinterpret_cast<std::uintptr_t>(current) % alignment) % alignment;
+				}
+				void* p = current + pad;
+				current += pad + bytes;
+				remaining -= pad + bytes;
+				allocated += bytes;
+				return p;
+			}
+			void do_deallocate(void*, std::size_t, std::size_t) override {}
+			bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+		};
+		/**
+		 * \class polymorphic_allocator
+		 *
+		 * \brief An allocator satisfying the standard `Allocator` requirements which allocates through a
+		 *        `memory_resource`, see `std::pmr::polymorphic_allocator`. For example,
+		 *        `dynamic_matrix<double, polymorphic_allocator<double>> m(r, c, polymorphic_allocator<double>(&arena))`
+		 *        places the elements of `m` in `arena`.
+		 *
+		 * The resource is not propagated on container copy, move or swap, and copy constructed containers use
+		 * the default resource.
+		 *
+		 * \tparam Ty The type of the elements to allocate.
+		 */
+		template<typename Ty>
+		class polymorphic_allocator {
+		public:
+			typedef Ty value_type;
+			typedef std::size_t size_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef std::false_type propagate_on_container_copy_assignment;
+			typedef std::false_type propagate_on_container_move_assignment;
+			typedef std::false_type propagate_on_container_swap;
+			polymorphic_allocator() noexcept : res(get_default_resource()) {}
+			polymorphic_allocator(memory_resource* r) noexcept : res(r ? r : get_default_resource()) {}
+			template<typename Uty>
+			polymorphic_allocator(const polymorphic_allocator<Uty>& other) noexcept : res(other.resource()) {}
+			/**
+			 * \brief Allocates uninitialised storage for `n` objects of type `Ty` from the resource.
+			 *
+			 * \throw Throws `std::bad_alloc` exception if `n > max_size()` or as thrown by the resource.
+			 */
+			Ty* allocate(size_type n) {
+				if (n > max_size()) throw std::bad_alloc();
+				return static_cast<Ty*>(res->allocate(n*sizeof(Ty), alignof(Ty)));
+			}
+			void deallocate(Ty* p, size_type n) noexcept { res->deallocate(p, n*sizeof(Ty), alignof(Ty)); }
+			size_type max_size() const noexcept { return std::numeric_limits<size_type>::max()/sizeof(Ty); }
+			polymorphic_allocator select_on_container_copy_construction() const noexcept { return polymorphic_allocator(); }
+			memory_resource* resource() const noexcept { return res; }
+		private:
+			memory_resource* res;
+		};
+		template<typename Ty, typename Uty>
+		bool operator==(const polymorphic_allocator<Ty>& lhs, const polymorphic_allocator<Uty>& rhs) noexcept {
+			return *lhs.resource() == *rhs.resource();
+		}
+		template<typename Ty, typename Uty>
+		bool operator!=(const polymorphic_allocator<Ty>& lhs, const polymorphic_allocator<Uty>& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+		/**
+		 * \class fixed_pool
+		 *
+		 * \brief A pool of equal-size memory blocks carved from chunks of `BlocksPerChunk` blocks, with freed
+		 *        blocks kept on an intrusive free list such that allocation and deallocation are constant time
+		 *        and touch no shared state. Not thread-safe, see `thread_local_pool`.
+		 *
+		 * \tparam BlockSize Minimum size in bytes of each block.
+		 * \tparam Alignment Alignment in bytes of each block, at most `alignof(std::max_align_t)`.
+		 * \tparam BlocksPerChunk Number of blocks obtained from `operator new` at a time.
+		 */
+		template<std::size_t BlockSize,
+			std::size_t Alignment = alignof(std::max_align_t),
+			std::size_t BlocksPerChunk = 256U
+		> class fixed_pool {
+			static_assert(Alignment && !(Alignment & (Alignment - 1U)) && Alignment <= alignof(std::max_align_t),
+				"fixed_pool Alignment must be a power of two no greater than alignof(std::max_align_t).");
+		public:
+			/**
+			 * \brief Size in bytes of each block, at least `BlockSize` and large enough to hold a free list link.
+			 */
+			static constexpr std::size_t block_size = memory_impl::align_up(memory_impl::max_of(BlockSize, sizeof(void*)),
+				memory_impl::max_of(Alignment, alignof(void*)));
+			fixed_pool() noexcept = default;
+			fixed_pool(const fixed_pool&) = delete;
+			fixed_pool& operator=(const fixed_pool&) = delete;
+			fixed_pool(fixed_pool&& other) noexcept : free_list(other.free_list), chunks(other.chunks) {
+				other.free_list = nullptr; other.chunks = nullptr;
+			}
+			fixed_pool& operator=(fixed_pool&& other) noexcept {
+				std::swap(free_list, other.free_list);
+				std::swap(chunks, other.chunks);
+				return *this;
+			}
+			/**
+			 * \brief Returns all chunks to `operator delete`, invalidating every block of the pool.
+			 */
+			~fixed_pool() {
+				while (chunks) {
+					void* prev = *static_cast<void**>(chunks);
+					::operator delete(chunks);
+					chunks = prev;
+				}
+			}
+			/**
+			 * \brief Returns a block of `block_size` bytes.
+			 *
+			 * \throw Throws `std::bad_alloc` exception if a new chunk cannot be allocated.
+			 * \complexity Constant (amortised over chunk allocations).
+			 */
+			void* allocate() {
+				if (!free_list) refill();
+				void* p = free_list;
+				free_list = *static_cast<void**>(p);
+				return p;
+			}
+			/**
+			 * \brief Returns the block `p` to the pool. `p` must have been allocated by a pool of the same
+			 *        `block_size`, not necessarily this one, whose chunks are still alive.
+			 *
+			 * \complexity Constant.
+			 */
+			void deallocate(void* p) noexcept {
+				*static_cast<void**>(p) = free_list;
+				free_list = p;
+			}
+		private:
+			static constexpr std::size_t header_size = memory_impl::align_up(sizeof(void*), memory_impl::max_of(Alignment, alignof(void*)));
+			void* free_list = nullptr;
+			void* chunks = nullptr;	// each chunk starts with a link to the previous chunk
+			void refill() {
+				unsigned char* c = static_cast<unsigned char*>(::operator new(header_size + block_size*BlocksPerChunk));
+				*reinterpret_cast<void**>(c) = chunks;
+				chunks = c;
+				for (std::size_t i = BlocksPerChunk; i-- > 0U;) deallocate(c + header_size + i*block_size);
+			}
+		};
+		template<std::size_t B, std::size_t A, std::size_t N>
+		constexpr std::size_t fixed_pool<B, A, N>::block_size;
+		template<std::size_t B, std::size_t A, std::size_t N>
+		constexpr std::size_t fixed_pool<B, A, N>::header_size;
+		namespace memory_impl {
+			// pools of exited threads, adopted by new threads such that blocks still referenced elsewhere
+			// stay valid; intentionally never destroyed as blocks may outlive static destruction
+			template<class Pool>
+			struct pool_depot {
+				std::mutex mut;
+				std::vector<Pool> pools;
+				static pool_depot& instance() {
+					static pool_depot* d = new pool_depot();
+					return *d;
+				}
+			};
+			template<class Pool>
+			struct thread_pool_holder {
+				thread_pool_holder() {
+					pool_depot<Pool>& d = pool_depot<Pool>::instance();
+					std::lock_guard<std::mutex> lock(d.mut);
+					if (!d.pools.empty()) { pool = std::move(d.pools.back()); d.pools.pop_back(); }
+				}
+				~thread_pool_holder() {
+					pool_depot<Pool>& d = pool_depot<Pool>::instance();
+					std::lock_guard<std::mutex> lock(d.mut);
+					d.pools.push_back(std::move(pool));
+				}
+				Pool pool;
+			};
+		}
+		/**
+		 * \brief Returns the calling thread's instance of `fixed_pool<BlockSize, Alignment>`, through which
+		 *        threads allocate without contending on a global heap lock.
+		 *
+		 * Blocks may be deallocated on any thread, in which case they join that thread's pool. When a thread
+		 * exits its pool (including its free blocks) is handed on to the next thread to start using a pool of
+		 * the same block size, such that no memory is lost or invalidated.
+		 */
+		template<std::size_t BlockSize,
+			std::size_t Alignment = alignof(std::max_align_t)
+		> fixed_pool<BlockSize, Alignment>& thread_local_pool() {
+			thread_local memory_impl::thread_pool_holder<fixed_pool<BlockSize, Alignment>> holder;
+			return holder.pool;
+		}
+		/**
+		 * \class pool_allocator
+		 *
+		 * \brief A stateless allocator satisfying the standard `Allocator` requirements which serves
+		 *        single-object allocations from the calling thread's `thread_local_pool`, and arrays from
+		 *        `operator new`. Best suited to node-based containers (`std::list`, `std::map`, ...) whose
+		 *        allocations are all of one object.
+		 *
+		 * \tparam Ty The type of the elements to allocate.
+		 */
+		template<typename Ty>
+		class pool_allocator {
+			static constexpr std::size_t alignment = memory_impl::max_of(alignof(Ty), alignof(void*));
+			typedef fixed_pool<sizeof(Ty), alignment> pool_type;
+		public:
+			typedef Ty value_type;
+			typedef std::size_t size_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef std::true_type is_always_equal;
+			pool_allocator() noexcept = default;
+			template<typename Uty>
+			pool_allocator(const pool_allocator<Uty>&) noexcept {}
+			Ty* allocate(size_type n) {
+				if (n == 1U) return static_cast<Ty*>(thread_local_pool<sizeof(Ty), alignment>().allocate());
+				if (n > std::numeric_limits<size_type>::max()/sizeof(Ty)) throw std::bad_alloc();
+				return static_cast<Ty*>(::operator new(n*sizeof(Ty)));
+			}
+			void deallocate(Ty* p, size_type n) noexcept {
+				if (n == 1U) thread_local_pool<sizeof(Ty), alignment>().deallocate(p);
+				else ::operator delete(p);
+			}
+		};
+		template<typename Ty, typename Uty>
+		bool operator==(const pool_allocator<Ty>&, const pool_allocator<Uty>&) noexcept { return true; }
+		template<typename Ty, typename Uty>
+		bool operator!=(const pool_allocator<Ty>&, const pool_allocator<Uty>&) noexcept { return false; }
+	}
+}
+
+#endif // !MEMORY_RESOURCES_H
@@ -1,88 +1,677 @@
 #ifndef MARKOV_CHAIN_MONTE_CARLO_H
 #define MARKOV_CHAIN_MONTE_CARLO_H
+#include "posterior_sinks.h"
+#include "randomness.h"
+#include "threading_utilities.h"
 #include <array>
 #include <cmath>
-#include <functional>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <numeric>
 #include <random>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace crsc {
 	namespace mc {
+		/**
+		 * \class log_density_function
+		 *
+		 * \brief Wrapper marking a callable as returning the natural logarithm of the posterior pdf rather
+		 *        than the posterior pdf itself, create via `log_density`.
+		 */
+		template<class Function>
+		struct log_density_function {
+			Function fn;
+		};
+		/**
+		 * \brief Marks `f` as returning the log-posterior, such that the samplers never form the posterior pdf
+		 *        itself. Prefer this for posteriors built from many likelihood terms, whose product readily
+		 *        underflows to zero.
+		 *
+		 * \param f Callable returning the natural logarithm of the (unnormalised) posterior pdf, or
+		 *        `-std::numeric_limits<Ty>::infinity()` where the posterior is zero.
+		 * \return Wrapped callable to pass to any of the samplers in place of a posterior pdf.
+		 */
+		template<class Function>
+		log_density_function<std::decay_t<Function>> log_density(Function&& f) {
+			return log_density_function<std::decay_t<Function>>{ std::forward<Function>(f) };
+		}
+		/**
+		 * \struct mcmc_adaptation
+		 *
+		 * \brief Tuning parameters of the adaptive Metropolis sampler.
+		 */
+		struct mcmc_adaptation {
+			/**
+			 * \brief Acceptance rate towards which the proposal scale is driven during burn-in, `0.234` being
+			 *        optimal for random-walk proposals in many dimensions.
+			 */
+			double target_acceptance = 0.234;
+			/**
+			 * \brief Number of burn-in iterations between updates of the proposal covariance from the
+			 *        covariance of the states visited so far.
+			 */
+			std::size_t interval = 100U;
+			/**
+			 * \brief Fraction of the initial variance `jsigma[j]*jsigma[j]` added to each diagonal element
+			 *        of the estimated covariance, keeping the proposal non-degenerate.
+			 */
+			double regularisation = 1e-6;
+		};
+		/**
+		 * \brief Detail namespace for the Markov Chain Monte-Carlo samplers.
+		 */
+		namespace mcmc_impl {
+			/**
+			 * \brief Evaluates the log-posterior at `state` from a callable returning the posterior pdf.
+			 */
+			template<class Ty,
+				std::size_t Dims,
+				class InputIt,
+				class Function,
+				class... Args
+			> Ty log_posterior(Function& f, InputIt first, InputIt last, const std::array<Ty, Dims>& state, const Args&... f_args) {
+				return std::log(static_cast<Ty>(f(first, last, state, f_args...)));
+			}
+			/**
+			 * \brief Evaluates the log-posterior at `state` from a callable returning the log-posterior.
+			 */
+			template<class Ty,
+				std::size_t Dims,
+				class InputIt,
+				class Function,
+				class... Args
+			> Ty log_posterior(log_density_function<Function>& f, InputIt first, InputIt last, const std::array<Ty, Dims>& state,
+				const Args&... f_args) {
+				return static_cast<Ty>(f.fn(first, last, state, f_args...));
+			}
+			/**
+			 * \brief Determines whether `state` lies within the bounds of every prior of `prior`.
+			 */
+			template<class Ty,
+				std::size_t Dims
+			> bool within_prior(const std::array<Ty, Dims>& state, const std::array<std::pair<Ty, Ty>, Dims>& prior) noexcept {
+				for (std::size_t j = 0U; j < Dims; ++j) {
+					if (state[j] > prior[j].second || state[j] < prior[j].first) return false;
+				}
+				return true;
+			}
+			/**
+			 * \brief Overwrites the symmetric `Dims` x `Dims` row-major matrix `a` with its lower Cholesky
+			 *        factor, leaving `a` unchanged and returning `false` if `a` is not positive definite.
+			 */
+			template<class Ty,
+				std::size_t Dims
+			> bool cholesky_factorise(std::array<Ty, Dims*Dims>& a) {
+				std::array<Ty, Dims*Dims> l{};
+				for (std::size_t j = 0U; j < Dims; ++j) {
+					Ty diag = a[j*Dims + j];
+					for (std::size_t k = 0U; k < j; ++k) diag -= l[j*Dims + k]*l[j*Dims + k];
+					if (!(diag > Ty())) return false;
+					l[j*Dims + j] = std::sqrt(diag);
+					for (std::size_t i = j + 1U; i < Dims; ++i) {
+						Ty off = a[i*Dims + j];
+						for (std::size_t k = 0U; k < j; ++k) off -= l[i*Dims + k]*l[j*Dims + k];
+						l[i*Dims + j] = off/l[j*Dims + j];
+					}
+				}
+				a = l;
+				return true;
+			}
+			/**
+			 * \brief Runs a single Metropolis-Hastings chain with normal proposal densities using the engine
+			 *        `eng`, passing every `thin`-th state after the first `burn_in` iterations to `sink` until
+			 *        `samples` states have been retained.
+			 *
+			 * The log-posterior of the current state is cached, such that each iteration performs at most one
+			 * evaluation of `f` (none if the proposal falls outside the prior) and one normal draw per dimension.
+			 */
+			template<class Ty,
+				std::size_t Dims,
+				class InputIt,
+				class Generator,
+				class Sink,
+				class Function,
+				class... Args
+			> void metropolis_hastings_npd_chain(InputIt first, InputIt last,
+				const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+				const std::array<Ty, Dims>& jsigma, std::size_t samples, std::size_t burn_in, std::size_t thin,
+				Generator& mt_eng, Sink& sink, Function& f, const Args&... f_args) {
+				std::uniform_real_distribution<Ty> pdist(Ty(), static_cast<Ty>(1.0)); // generate probabilities
+				std::normal_distribution<Ty> jdist; // standard normal, scaled by jsigma for each variable
+				std::array<Ty, Dims> curr_state = init;
+				std::array<Ty, Dims> prop_state = init;
+				Ty lp_curr = log_posterior(f, first, last, curr_state, f_args...); // cached log-posterior of current state
+				Ty lp_prop = Ty(); // log-posterior for proposed state
+				bool skip = false; // skip to next loop iter flag
+				if (!thin) thin = 1U;
+				const std::size_t iterations = burn_in + samples*thin;
+				// monte-carlo loop
+				for (std::size_t i = 0U; i < iterations; ++i) {
+					skip = false; // reset skip status
+					for (std::size_t j = 0U; j < Dims; ++j) {
+						prop_state[j] = curr_state[j] + jsigma[j]*jdist(mt_eng); // translate proposed state
+						// check for proposed state falling outside any prior boundary
+						if (prop_state[j] > prior[j].second || prop_state[j] < prior[j].first) {
+							skip = true;
+							break;
+						}
+					}
+					if (!skip) {
+						// compute proposed log-posterior
+						lp_prop = log_posterior(f, first, last, prop_state, f_args...);
+						// metropolis-hasting algorithm criterion, log(p_prop/p_curr) >= log(u)
+						if (lp_prop >= lp_curr || lp_prop - lp_curr > std::log(pdist(mt_eng))) {
+							curr_state = prop_state;
+							lp_curr = lp_prop;
+						}
+					}
+					// retain current state once burnt-in, keeping every thin'th state
+					if (i >= burn_in && !((i - burn_in) % thin)) sink(curr_state);
+				}
+			}
+			/**
+			 * \brief Runs a single adaptive Metropolis chain, see `mcmc_adaptive_metropolis_npd_stream`.
+			 */
+			template<class Ty,
+				std::size_t Dims,
+				class InputIt,
+				class Generator,
+				class Sink,
+				class Function,
+				class... Args
+			> void adaptive_metropolis_npd_chain(InputIt first, InputIt last,
+				const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+				const std::array<Ty, Dims>& jsigma, std::size_t samples, std::size_t burn_in, std::size_t thin,
+				const mcmc_adaptation& adapt, Generator& mt_eng, Sink& sink, Function& f, const Args&... f_args) {
+				std::uniform_real_distribution<Ty> pdist(Ty(), static_cast<Ty>(1.0));
+				std::normal_distribution<Ty> jdist;
+				// lower cholesky factor of the proposal covariance, initially diag(jsigma^2)
+				std::array<Ty, Dims*Dims> chol{};
+				for (std::size_t j = 0U; j < Dims; ++j) chol[j*Dims + j] = jsigma[j];
+				running_covariance<Ty, Dims> moments; // covariance of burn-in states
+				const Ty cov_factor = static_cast<Ty>(2.38*2.38/Dims); // optimal random-walk scaling for normal targets
+				const Ty target = static_cast<Ty>(adapt.target_acceptance);
+				const std::size_t interval = adapt.interval ? adapt.interval : 1U;
+				Ty log_scale = Ty(); // robbins-monro adapted log of the proposal scale factor
+				std::array<Ty, Dims> curr_state = init;
+				std::array<Ty, Dims> prop_state;
+				std::array<Ty, Dims> z;
+				Ty lp_curr = log_posterior(f, first, last, curr_state, f_args...);
+				if (!thin) thin = 1U;
+				const std::size_t iterations = burn_in + samples*thin;
+				for (std::size_t i = 0U; i < iterations; ++i) {
+					const Ty scale = std::exp(log_scale);
+					for (std::size_t j = 0U; j < Dims; ++j) z[j] = jdist(mt_eng);
+					for (std::size_t j = 0U; j < Dims; ++j) {
+						Ty jump = Ty();
+						for (std::size_t k = 0U; k <= j; ++k) jump += chol[j*Dims + k]*z[k];
+						prop_state[j] = curr_state[j] + scale*jump;
+					}
+					Ty alpha = Ty(); // acceptance probability of the proposal
+					if (within_prior(prop_state, prior)) {
+						const Ty lp_prop = log_posterior(f, first, last, prop_state, f_args...);
+						alpha = (lp_prop >= lp_curr) ? static_cast<Ty>(1.0) : std::exp(lp_prop - lp_curr);
+						if (pdist(mt_eng) < alpha) {
+							curr_state = prop_state;
+							lp_curr = lp_prop;
+						}
+					}
+					if (i < burn_in) {
+						// drive the acceptance rate towards target and periodically re-estimate the covariance,
+						// adaptation stops after burn-in such that retained states follow a fixed proposal
+						log_scale += (alpha - target)/std::sqrt(static_cast<Ty>(i + 1U));
+						moments(curr_state);
+						if (!((i + 1U) % interval) && moments.count() > Dims) {
+							std::array<Ty, Dims*Dims> cov = moments.covariance();
+							for (auto& c : cov) c *= cov_factor;
+							for (std::size_t j = 0U; j < Dims; ++j)
+								cov[j*Dims + j] += static_cast<Ty>(adapt.regularisation)*jsigma[j]*jsigma[j];
+							if (cholesky_factorise<Ty, Dims>(cov)) chol = cov;
+						}
+					}
+					else if (!((i - burn_in) % thin)) sink(curr_state);
+				}
+			}
+			/**
+			 * \brief Runs a single batched-evaluation Metropolis-Hastings chain, see
+			 *        `mcmc_batched_metropolis_npd_stream`.
+			 */
+			template<class Ty,
+				std::size_t Dims,
+				class InputIt,
+				class Generator,
+				class Sink,
+				class Function,
+				class... Args
+			> void batched_metropolis_npd_chain(InputIt first, InputIt last,
+				const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+				const std::array<Ty, Dims>& jsigma, std::size_t samples, std::size_t burn_in, std::size_t thin,
+				std::size_t batch_size, Generator& mt_eng, Sink& sink, Function& f, const Args&... f_args) {
+				std::uniform_real_distribution<Ty> pdist(Ty(), static_cast<Ty>(1.0));
+				std::normal_distribution<Ty> jdist;
+				if (!batch_size) batch_size = 1U;
+				std::vector<std::array<Ty, Dims>> candidates(batch_size); // all candidates of a batch
+				std::vector<std::array<Ty, Dims>> evaluated(batch_size); // candidates within the prior
+				std::vector<std::size_t> slots(batch_size); // index into candidates of each evaluated state
+				std::vector<Ty> lp(batch_size); // log-posterior of each candidate
+				std::vector<Ty> lp_evaluated(batch_size);
+				std::vector<Ty> log_u(batch_size); // log of the uniform variate of each candidate
+				std::vector<char> feasible(batch_size); // whether each candidate lies within the prior
+				std::array<Ty, Dims> curr_state = init;
+				Ty lp_curr = Ty();
+				f(first, last, &curr_state, 1U, &lp_curr, f_args...);
+				if (!thin) thin = 1U;
+				const std::size_t iterations = burn_in + samples*thin;
+				std::size_t i = 0U;
+				while (i < iterations) {
+					// speculatively propose candidates assuming each of them is rejected, as then all of them
+					// are proposed from the current state
+					const std::size_t count = (iterations - i < batch_size) ? iterations - i : batch_size;
+					std::size_t n_eval = 0U;
+					for (std::size_t c = 0U; c < count; ++c) {
+						for (std::size_t j = 0U; j < Dims; ++j) candidates[c][j] = curr_state[j] + jsigma[j]*jdist(mt_eng);
+						log_u[c] = std::log(pdist(mt_eng));
+						feasible[c] = within_prior(candidates[c], prior);
+						if (feasible[c]) {
+							evaluated[n_eval] = candidates[c];
+							slots[n_eval++] = c;
+						}
+					}
+					if (n_eval) {
+						f(first, last, evaluated.data(), n_eval, lp_evaluated.data(), f_args...);
+						for (std::size_t e = 0U; e < n_eval; ++e) lp[slots[e]] = lp_evaluated[e];
+					}
+					// consume candidates up to and including the first accepted, the remainder were proposed
+					// from a stale state and are discarded
+					for (std::size_t c = 0U; c < count; ++c, ++i) {
+						const bool accept = feasible[c] && (lp[c] >= lp_curr || lp[c] - lp_curr > log_u[c]);
+						if (accept) {
+							curr_state = candidates[c];
+							lp_curr = lp[c];
+						}
+						if (i >= burn_in && !((i - burn_in) % thin)) sink(curr_state);
+						if (accept) { ++i; break; }
+					}
+				}
+			}
+		}
 		/**
 		 * \brief Performs a Markov Chain Monte-Carlo analysis in `Dims` dimensions on data in the
 		 *        range `[first, last)` using the Metropolis-Hastings algorithm to decide on jump
-		 *        sampling conditions. The proposal density used for the jump distributions is 
+		 *        sampling conditions. The proposal density used for the jump distributions is
          *        a normal distribution, hence the npd acronym.
 		 *
 		 * This function performs random sampling on some functional posterior form `f` using the
 		 * `std::mt19937` engine seeded with a `std::seed_seq` of 8 `std::random_device` instances.
+		 * The acceptance criterion is evaluated in log space and the log-posterior of the current state
+		 * is cached, so `f` is invoked once per iteration whose proposal lies within the prior.
 		 *
 		 * \tparam Ty Type of data stored in data range, must satisfy `std::is_floating_point<Ty>::value`.
 		 * \tparam Dims Number of dimensions.
 		 * \tparam InputIt `InputIterator` type.
-		 * \tparam Args Types of arguments to forward to function `f`.
+		 * \tparam Function Type of callable, invoked as `f(first, last, state, f_args...)`.
+		 * \tparam Args Types of arguments to pass to function `f`.
 		 * \param first Beginning of data range.
 		 * \param last End of data range.
 		 * \param init Initial values for each variable.
 		 * \param prior Priors on each variable, defining the bounds within which the posterior is non-zero.
 		 * \param jsigma Normal distribution standard deviation for the jumps on each variable.
 		 * \param samples Number of samples to perform.
-		 * \param f Functional form of posterior pdf.
-		 * \param f_args Optional arguments to forward to function `f`.
+		 * \param f Functional form of posterior pdf, or of the log-posterior if wrapped by `log_density`.
+		 * \param f_args Optional arguments to pass to function `f` on every evaluation.
 		 * \return A `std::vector` containing the `Dims` dimensional "posterior pdf" data.
 		 */
 		template<class Ty,
 			std::size_t Dims,
 			class InputIt,
+			class Function,
 			class... Args,
 			class = std::enable_if_t<std::is_floating_point<Ty>::value>
-		> std::vector<std::array<Ty, Dims>> mcmc_metropolis_hastings_npd(InputIt first, InputIt last, 
-			const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior, 
-			const std::array<Ty, Dims>& jsigma, std::size_t samples, 
-			std::function<Ty(InputIt, InputIt, const std::array<Ty, Dims>&, Args&&...)> f, Args&&... f_args) {
-			std::vector<std::array<Ty, Dims>> posterior; posterior.reserve(samples); // pre-allocate for speed
+		> std::vector<std::array<Ty, Dims>> mcmc_metropolis_hastings_npd(InputIt first, InputIt last,
+			const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+			const std::array<Ty, Dims>& jsigma, std::size_t samples, Function f, const Args&... f_args) {
 			std::random_device rd;
 			std::seed_seq seed{ rd(), rd(), rd(), rd(), rd(), rd(), rd(), rd() };
 			std::mt19937 mt_eng(seed); // mersenne-twister engine for prng
-			std::uniform_real_distribution<Ty> pdist(Ty(), static_cast<Ty>(1.0)); // generate probabilities
-			std::array<std::normal_distribution<Ty>, Dims> jdist_arr;
-			// jump distributions for each variable
-			for (std::size_t i = 0U; i < Dims; ++i) jdist_arr[i] = std::normal_distribution<Ty>(Ty(), jsigma[i]);
-			std::array<Ty, Dims> curr_state = init;
-			std::array<Ty, Dims> prop_state = init;
-			std::array<Ty, Dims> jump_arr;
-			Ty p_curr = Ty(); // posterior prob for current state
-			Ty p_prop = Ty(); // posterior prob for proposed state
-			Ty ratio = Ty();
-			bool skip = false; // skip to next loop iter flag
-			// monte-carlo loop
-			for (std::size_t i = 0U; i < samples; ++i) {
-				skip = false; // reset skip status
-				// compute current posterior
-				p_curr = f(first, last, curr_state, std::forward<Args>(f_args)...);
-				for (std::size_t j = 0U; j < Dims; ++j) {
-					jump_arr[j] = jdist_arr[j](mt_eng); // generate random jump
-					prop_state[j] = curr_state[j] + jdist_arr[j](mt_eng); // translate proposed state
-					// check for proposed state falling outside any prior boundary
-					if (prop_state[j] > prior[j].second || prop_state[j] < prior[j].first) {
-						p_prop = Ty();
-						skip = true;
-						break;
+			std::vector<std::array<Ty, Dims>> posterior; posterior.reserve(samples); // pre-allocate for speed
+			auto sink = make_output_sink(std::back_inserter(posterior));
+			mcmc_impl::metropolis_hastings_npd_chain(first, last, init, prior, jsigma, samples, 0U, 1U,
+				mt_eng, sink, f, f_args...);
+			return posterior;
+		}
+		/**
+		 * \struct mcmc_chain_config
+		 *
+		 * \brief Configuration of a multi-chain Markov Chain Monte-Carlo run.
+		 */
+		struct mcmc_chain_config {
+			/**
+			 * \brief Number of independent chains to run.
+			 */
+			std::size_t chains = 1U;
+			/**
+			 * \brief Number of states retained from each chain.
+			 */
+			std::size_t samples = 0U;
+			/**
+			 * \brief Number of initial iterations of each chain which are discarded.
+			 */
+			std::size_t burn_in = 0U;
+			/**
+			 * \brief Interval between retained states after burn-in, e.g. `10` keeps every 10th state.
+			 */
+			std::size_t thin = 1U;
+			/**
+			 * \brief Seed from which the random number stream of every chain is derived, a run with the
+			 *        same `seed` and `chains` reproduces the same samples regardless of the number of threads.
+			 */
+			std::uint64_t seed = 0U;
+		};
+		/**
+		 * \brief Returns the random number engine for chain `chain` of a run seeded with `seed`.
+		 *
+		 * Each chain is given stream `chain` of `seed` via `crsc::make_stream_engine`, i.e. a distinct,
+		 * reproducible stream that depends only on the pair `(seed, chain)`. With `crsc::philox4x32` or
+		 * `crsc::xoshiro256ss_engine` the streams are provably disjoint, otherwise the engine is seeded with a
+		 * `std::seed_seq` of the (split) run seed and chain index.
+		 *
+		 * \tparam Generator Engine type, must be seedable from a `std::seed_seq`.
+		 * \param seed Run seed.
+		 * \param chain Index of the chain.
+		 * \return Seeded engine for the chain.
+		 */
+		template<class Generator = std::mt19937_64>
+		Generator make_chain_engine(std::uint64_t seed, std::uint64_t chain) {
+			return make_stream_engine<Generator>(seed, chain);
+		}
+		namespace mcmc_impl {
+			/**
+			 * \brief Runs `config.chains` chains distributed over the threads of `policy`, where `chain(eng, c)`
+			 *        runs chain `c` drawing from the engine `eng`.
+			 */
+			template<class Generator,
+				class Chain
+			> void run_chains(const mcmc_chain_config& config, const execution::parallel_policy& policy, Chain&& chain) {
+				parallel_for(policy, 0U, config.chains, 1U, [&](std::size_t chain_first, std::size_t chain_last) {
+					for (std::size_t c = chain_first; c < chain_last; ++c) {
+						Generator eng = make_chain_engine<Generator>(config.seed, c);
+						chain(eng, c);
 					}
+				});
+			}
+			/**
+			 * \brief Collects the retained states of each chain of a streaming run into a `std::vector` per chain,
+			 *        where `stream(sinks)` performs the run streaming chain `c` to `sinks[c]`.
+			 */
+			template<class Ty,
+				std::size_t Dims,
+				class Stream
+			> std::vector<std::vector<std::array<Ty, Dims>>> collect_chains(const mcmc_chain_config& config, Stream&& stream) {
+				typedef std::vector<std::array<Ty, Dims>> chain_t;
+				std::vector<chain_t> chains(config.chains);
+				std::vector<output_iterator_sink<std::back_insert_iterator<chain_t>>> sinks;
+				sinks.reserve(config.chains);
+				for (auto& chain : chains) {
+					chain.reserve(config.samples);
+					sinks.push_back(make_output_sink(std::back_inserter(chain)));
 				}
-				if (skip) { posterior.push_back(curr_state); continue; } // if proposed fell outside prior, skip to next loop iter
-				// compute proposed posterior
-				else p_prop = f(first, last, prop_state, std::forward<Args>(f_args)...);
-				ratio = p_prop / p_curr;
-				// metropolis-hasting algorithm criterion
-				if (ratio >= static_cast<Ty>(1.0) || ratio > pdist(mt_eng)) curr_state = prop_state;
-				posterior.push_back(curr_state); // push current state to return vector
+				stream(sinks.begin());
+				return chains;
 			}
-			return posterior;
+		}
+		/**
+		 * \brief Runs `config.chains` independent Metropolis-Hastings chains with normal proposal densities
+		 *        (see `mcmc_metropolis_hastings_npd`) concurrently, passing the retained states of chain `c` to
+		 *        the posterior sink `sinks[c]` as they are produced rather than storing them.
+		 *
+		 * Each chain performs `config.burn_in + config.samples*config.thin` iterations from `init` and invokes
+		 * its sink as `sinks[c](state)` with each of its `config.samples` retained states, in order, such that a
+		 * run of any length needs only the memory of its sinks. A sink may be any callable, e.g. a
+		 * `running_covariance`, a `marginal_histogram_sink`, a `joint_histogram_sink` or an iterator
+		 * wrapped by `make_output_sink`; sinks of distinct chains are invoked concurrently but each sink only
+		 * from a single thread, so per-chain accumulators need no synchronisation and can be combined
+		 * afterwards with their `merge` member. For a single chain pass the address of the sink as `sinks`.
+		 * Chains are distributed over at most `policy.concurrency()` threads, each chain drawing from the engine
+		 * returned by `make_chain_engine<Generator>(config.seed, c)` for chain index `c`.
+		 *
+		 * \tparam Ty Type of data stored in data range, must satisfy `std::is_floating_point<Ty>::value`.
+		 * \tparam Dims Number of dimensions.
+		 * \tparam Generator Random number engine used by each chain.
+		 * \tparam SinkIt `RandomAccessIterator` type to the posterior sinks.
+		 * \param first Beginning of data range.
+		 * \param last End of data range.
+		 * \param init Initial values for each variable.
+		 * \param prior Priors on each variable, defining the bounds within which the posterior is non-zero.
+		 * \param jsigma Normal distribution standard deviation for the jumps on each variable.
+		 * \param config Number of chains, samples, burn-in, thinning interval and seed of the run.
+		 * \param policy Execution policy determining the number of threads used.
+		 * \param sinks Iterator to the first of `config.chains` posterior sinks.
+		 * \param f Functional form of posterior pdf, or of the log-posterior if wrapped by `log_density`. Invoked
+		 *        concurrently by different chains and therefore required to be safe to call from multiple threads.
+		 * \param f_args Optional arguments to pass to function `f`, shared by all chains.
+		 * \throw Rethrows the first exception thrown by `f` or a sink in any chain.
+		 */
+		template<class Ty,
+			std::size_t Dims,
+			class Generator = std::mt19937_64,
+			class InputIt,
+			class SinkIt,
+			class Function,
+			class... Args,
+			class = std::enable_if_t<std::is_floating_point<Ty>::value>
+		> void mcmc_metropolis_hastings_npd_stream(InputIt first, InputIt last,
+			const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+			const std::array<Ty, Dims>& jsigma, const mcmc_chain_config& config, const execution::parallel_policy& policy,
+			SinkIt sinks, Function f, const Args&... f_args) {
+			mcmc_impl::run_chains<Generator>(config, policy, [&](Generator& eng, std::size_t c) {
+				mcmc_impl::metropolis_hastings_npd_chain(first, last, init, prior, jsigma, config.samples,
+					config.burn_in, config.thin, eng, sinks[c], f, f_args...);
+			});
+		}
+		/**
+		 * \brief Runs `config.chains` independent Metropolis-Hastings chains with normal proposal densities
+		 *        (see `mcmc_metropolis_hastings_npd`) concurrently, returning the retained states of each chain.
+		 *
+		 * Equivalent to `mcmc_metropolis_hastings_npd_stream` with sinks appending to a `std::vector` per chain,
+		 * prefer the streaming form for long runs whose retained states need not all be kept in memory.
+		 *
+		 * \tparam Ty Type of data stored in data range, must satisfy `std::is_floating_point<Ty>::value`.
+		 * \tparam Dims Number of dimensions.
+		 * \tparam Generator Random number engine used by each chain.
+		 * \param first Beginning of data range.
+		 * \param last End of data range.
+		 * \param init Initial values for each variable.
+		 * \param prior Priors on each variable, defining the bounds within which the posterior is non-zero.
+		 * \param jsigma Normal distribution standard deviation for the jumps on each variable.
+		 * \param config Number of chains, samples, burn-in, thinning interval and seed of the run.
+		 * \param policy Execution policy determining the number of threads used.
+		 * \param f Functional form of posterior pdf, or of the log-posterior if wrapped by `log_density`. Invoked
+		 *        concurrently by different chains and therefore required to be safe to call from multiple threads.
+		 * \param f_args Optional arguments to pass to function `f`, shared by all chains.
+		 * \return A `std::vector` of the retained states of each chain, indexed by chain.
+		 * \throw Rethrows the first exception thrown by `f` in any chain.
+		 */
+		template<class Ty,
+			std::size_t Dims,
+			class Generator = std::mt19937_64,
+			class InputIt,
+			class Function,
+			class... Args,
+			class = std::enable_if_t<std::is_floating_point<Ty>::value>
+		> std::vector<std::vector<std::array<Ty, Dims>>> mcmc_metropolis_hastings_npd_chains(InputIt first, InputIt last,
+			const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+			const std::array<Ty, Dims>& jsigma, const mcmc_chain_config& config, const execution::parallel_policy& policy,
+			Function f, const Args&... f_args) {
+			return mcmc_impl::collect_chains<Ty, Dims>(config, [&](auto sinks) {
+				mcmc_metropolis_hastings_npd_stream<Ty, Dims, Generator>(first, last, init, prior, jsigma, config, policy,
+					sinks, f, f_args...);
+			});
+		}
+		/**
+		 * \brief Runs `config.chains` independent adaptive Metropolis chains concurrently, tuning the normal
+		 *        proposal of each chain during burn-in, and passes the retained states of chain `c` to the
+		 *        posterior sink `sinks[c]`.
+		 *
+		 * Each chain starts from the proposal `diag(jsigma^2)`. During the `config.burn_in` iterations the
+		 * proposal is scaled by a factor adapted (Robbins-Monro) to drive the acceptance rate towards
+		 * `adapt.target_acceptance`, and every `adapt.interval` iterations the proposal covariance is replaced
+		 * by `2.38^2/Dims` times the covariance of the states visited so far. Adaptation stops after burn-in,
+		 * hence the retained states are those of a Metropolis-Hastings chain with a fixed, tuned proposal; the
+		 * burn-in should therefore be long enough for the covariance estimate to settle. Prior bounds, seeding,
+		 * thinning and sinks behave as in `mcmc_metropolis_hastings_npd_stream`.
+		 *
+		 * \tparam Ty Type of data stored in data range, must satisfy `std::is_floating_point<Ty>::value`.
+		 * \tparam Dims Number of dimensions.
+		 * \tparam Generator Random number engine used by each chain.
+		 * \tparam SinkIt `RandomAccessIterator` type to the posterior sinks.
+		 * \param first Beginning of data range.
+		 * \param last End of data range.
+		 * \param init Initial values for each variable.
+		 * \param prior Priors on each variable, defining the bounds within which the posterior is non-zero.
+		 * \param jsigma Initial normal distribution standard deviation for the jumps on each variable.
+		 * \param config Number of chains, samples, burn-in, thinning interval and seed of the run.
+		 * \param adapt Target acceptance rate and covariance update interval of the adaptation.
+		 * \param policy Execution policy determining the number of threads used.
+		 * \param sinks Iterator to the first of `config.chains` posterior sinks.
+		 * \param f Functional form of posterior pdf, or of the log-posterior if wrapped by `log_density`, required
+		 *        to be safe to call from multiple threads.
+		 * \param f_args Optional arguments to pass to function `f`, shared by all chains.
+		 * \throw Rethrows the first exception thrown by `f` or a sink in any chain.
+		 */
+		template<class Ty,
+			std::size_t Dims,
+			class Generator = std::mt19937_64,
+			class InputIt,
+			class SinkIt,
+			class Function,
+			class... Args,
+			class = std::enable_if_t<std::is_floating_point<Ty>::value>
+		> void mcmc_adaptive_metropolis_npd_stream(InputIt first, InputIt last,
+			const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+			const std::array<Ty, Dims>& jsigma, const mcmc_chain_config& config, const mcmc_adaptation& adapt,
+			const execution::parallel_policy& policy, SinkIt sinks, Function f, const Args&... f_args) {
+			mcmc_impl::run_chains<Generator>(config, policy, [&](Generator& eng, std::size_t c) {
+				mcmc_impl::adaptive_metropolis_npd_chain(first, last, init, prior, jsigma, config.samples,
+					config.burn_in, config.thin, adapt, eng, sinks[c], f, f_args...);
+			});
+		}
+		/**
+		 * \brief Runs `config.chains` independent adaptive Metropolis chains concurrently, returning the
+		 *        retained states of each chain, see `mcmc_adaptive_metropolis_npd_stream`.
+		 *
+		 * \return A `std::vector` of the retained states of each chain, indexed by chain.
+		 * \throw Rethrows the first exception thrown by `f` in any chain.
+		 */
+		template<class Ty,
+			std::size_t Dims,
+			class Generator = std::mt19937_64,
+			class InputIt,
+			class Function,
+			class... Args,
+			class = std::enable_if_t<std::is_floating_point<Ty>::value>
+		> std::vector<std::vector<std::array<Ty, Dims>>> mcmc_adaptive_metropolis_npd_chains(InputIt first, InputIt last,
+			const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+			const std::array<Ty, Dims>& jsigma, const mcmc_chain_config& config, const mcmc_adaptation& adapt,
+			const execution::parallel_policy& policy, Function f, const Args&... f_args) {
+			return mcmc_impl::collect_chains<Ty, Dims>(config, [&](auto sinks) {
+				mcmc_adaptive_metropolis_npd_stream<Ty, Dims, Generator>(first, last, init, prior, jsigma, config, adapt,
+					policy, sinks, f, f_args...);
+			});
+		}
+		/**
+		 * \brief Runs `config.chains` independent Metropolis-Hastings chains with normal proposal densities
+		 *        concurrently, evaluating the log-posterior of up to `batch_size` candidates per callback, and
+		 *        passes the retained states of chain `c` to the posterior sink `sinks[c]`.
+		 *
+		 * Each chain speculatively proposes `batch_size` candidates from its current state, as a sequence of
+		 * rejections would, and passes those within the prior to a single invocation of
+		 * `f(first, last, states, count, log_posteriors, f_args...)`, which must write the log-posterior of
+		 * `states[i]` to `log_posteriors[i]` for each `i < count` and may vectorise or offload the evaluation.
+		 * Candidates are then consumed in order up to and including the first accepted one, with the remainder
+		 * discarded as they were proposed from a stale state. The retained states are hence distributed exactly
+		 * as those of `mcmc_metropolis_hastings_npd_stream`, at the cost of wasted evaluations after an
+		 * acceptance; a `batch_size` of around the reciprocal of the acceptance rate is a good choice. Note that
+		 * the initial log-posterior is obtained through a call with `count == 1`. Seeding, thinning and sinks
+		 * behave as in `mcmc_metropolis_hastings_npd_stream`.
+		 *
+		 * \tparam Ty Type of data stored in data range, must satisfy `std::is_floating_point<Ty>::value`.
+		 * \tparam Dims Number of dimensions.
+		 * \tparam Generator Random number engine used by each chain.
+		 * \tparam SinkIt `RandomAccessIterator` type to the posterior sinks.
+		 * \param first Beginning of data range.
+		 * \param last End of data range.
+		 * \param init Initial values for each variable.
+		 * \param prior Priors on each variable, defining the bounds within which the posterior is non-zero.
+		 * \param jsigma Normal distribution standard deviation for the jumps on each variable.
+		 * \param config Number of chains, samples, burn-in, thinning interval and seed of the run.
+		 * \param batch_size Maximum number of candidates evaluated per invocation of `f`.
+		 * \param policy Execution policy determining the number of threads used.
+		 * \param sinks Iterator to the first of `config.chains` posterior sinks.
+		 * \param f Batched functional form of the log-posterior, required to be safe to call from multiple threads.
+		 * \param f_args Optional arguments to pass to function `f`, shared by all chains.
+		 * \throw Rethrows the first exception thrown by `f` or a sink in any chain.
+		 */
+		template<class Ty,
+			std::size_t Dims,
+			class Generator = std::mt19937_64,
+			class InputIt,
+			class SinkIt,
+			class Function,
+			class... Args,
+			class = std::enable_if_t<std::is_floating_point<Ty>::value>
+		> void mcmc_batched_metropolis_npd_stream(InputIt first, InputIt last,
+			const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+			const std::array<Ty, Dims>& jsigma, const mcmc_chain_config& config, std::size_t batch_size,
+			const execution::parallel_policy& policy, SinkIt sinks, Function f, const Args&... f_args) {
+			mcmc_impl::run_chains<Generator>(config, policy, [&](Generator& eng, std::size_t c) {
+				mcmc_impl::batched_metropolis_npd_chain(first, last, init, prior, jsigma, config.samples,
+					config.burn_in, config.thin, batch_size, eng, sinks[c], f, f_args...);
+			});
+		}
+		/**
+		 * \brief Runs `config.chains` independent batched-evaluation Metropolis-Hastings chains concurrently,
+		 *        returning the retained states of each chain, see `mcmc_batched_metropolis_npd_stream`.
+		 *
+		 * \return A `std::vector` of the retained states of each chain, indexed by chain.
+		 * \throw Rethrows the first exception thrown by `f` in any chain.
+		 */
+		template<class Ty,
+			std::size_t Dims,
+			class Generator = std::mt19937_64,
+			class InputIt,
+			class Function,
+			class... Args,
+			class = std::enable_if_t<std::is_floating_point<Ty>::value>
+		> std::vector<std::vector<std::array<Ty, Dims>>> mcmc_batched_metropolis_npd_chains(InputIt first, InputIt last,
+			const std::array<Ty, Dims>& init, const std::array<std::pair<Ty, Ty>, Dims>& prior,
+			const std::array<Ty, Dims>& jsigma, const mcmc_chain_config& config, std::size_t batch_size,
+			const execution::parallel_policy& policy, Function f, const Args&... f_args) {
+			return mcmc_impl::collect_chains<Ty, Dims>(config, [&](auto sinks) {
+				mcmc_batched_metropolis_npd_stream<Ty, Dims, Generator>(first, last, init, prior, jsigma, config, batch_size,
+					policy, sinks, f, f_args...);
+			});
+		}
+		/**
+		 * \brief Concatenates the retained states of each chain returned by `mcmc_metropolis_hastings_npd_chains`
+		 *        into a single posterior sample, in order of chain index.
+		 *
+		 * \param chains Per-chain posterior samples.
+		 * \return A `std::vector` containing the states of all chains.
+		 * \complexity Linear in the total number of states.
+		 */
+		template<class Ty,
+			std::size_t Dims
+		> std::vector<std::array<Ty, Dims>> merge_chains(const std::vector<std::vector<std::array<Ty, Dims>>>& chains) {
+			std::size_t total = 0U;
+			for (const auto& chain : chains) total += chain.size();
+			std::vector<std::array<Ty, Dims>> merged; merged.reserve(total);
+			for (const auto& chain : chains) merged.insert(merged.end(), chain.begin(), chain.end());
+			return merged;
 		}
 	}
 }
 #endif // !MARKOV_CHAIN_MONTE_CARLO_H
-
@@ -0,0 +1,260 @@
+#ifndef POSTERIOR_SINKS_H
+#define POSTERIOR_SINKS_H
+#include "ranged_histogram.h"
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace crsc {
+	namespace mc {
+		/**
+		 * \class output_iterator_sink
+		 *
+		 * \brief Posterior sink writing each retained state through an `OutputIterator`, create via
+		 *        `make_output_sink`.
+		 *
+		 * \tparam OutputIt `OutputIterator` type.
+		 */
+		template<class OutputIt>
+		class output_iterator_sink {
+		public:
+			explicit output_iterator_sink(OutputIt _it) : it(_it) {}
+			/**
+			 * \brief Writes `state` to the iterator and advances it.
+			 */
+			template<class State>
+			void operator()(const State& state) { *it = state; ++it; }
+			/**
+			 * \brief Returns the iterator one past the last written state.
+			 */
+			OutputIt base() const { return it; }
+		private:
+			OutputIt it;
+		};
+		/**
+		 * \brief Creates a posterior sink writing retained states through `it`, e.g.
+		 *        `make_output_sink(std::back_inserter(vec))` or `make_output_sink(std::ostream_iterator<...>(os))`.
+		 */
+		template<class OutputIt>
+		output_iterator_sink<OutputIt> make_output_sink(OutputIt it) {
+			return output_iterator_sink<OutputIt>(it);
+		}
+		/**
+		 * \class running_covariance
+		 *
+		 * \brief Online accumulator of the mean and covariance of `Dims` dimensional states, updated in
+		 *        constant memory with Welford's algorithm. Usable directly as a posterior sink.
+		 *
+		 * \tparam Ty Floating point type of the state variables.
+		 * \tparam Dims Number of dimensions.
+		 */
+		template<class Ty,
+			std::size_t Dims
+		> class running_covariance {
+		public:
+			/**
+			 * \brief Accumulates the state `x`.
+			 *
+			 * \param x State to accumulate.
+			 * \complexity Quadratic in `Dims`.
+			 */
+			void operator()(const std::array<Ty, Dims>& x) noexcept {
+				++n;
+				std::array<Ty, Dims> delta;
+				for (std::size_t j = 0U; j < Dims; ++j) {
+					delta[j] = x[j] - mu[j];
+					mu[j] += delta[j]/static_cast<Ty>(n);
+				}
+				for (std::size_t i = 0U; i < Dims; ++i) {
+					for (std::size_t j = 0U; j < Dims; ++j) m2[i*Dims + j] += delta[i]*(x[j] - mu[j]);
+				}
+			}
+			/**
+			 * \brief Combines the states accumulated by `other` into this accumulator, e.g. to pool the
+			 *        accumulators of independent chains.
+			 *
+			 * \param other Accumulator to combine.
+			 * \complexity Quadratic in `Dims`.
+			 */
+			void merge(const running_covariance& other) noexcept {
+				if (!other.n) return;
+				const std::size_t total = n + other.n;
+				const Ty weight = static_cast<Ty>(n)*static_cast<Ty>(other.n)/static_cast<Ty>(total);
+				std::array<Ty, Dims> delta;
+				for (std::size_t j = 0U; j < Dims; ++j) delta[j] = other.mu[j] - mu[j];
+				for (std::size_t i = 0U; i < Dims; ++i) {
+					for (std::size_t j = 0U; j < Dims; ++j)
+						m2[i*Dims + j] += other.m2[i*Dims + j] + delta[i]*delta[j]*weight;
+				}
+				for (std::size_t j = 0U; j < Dims; ++j)
+					mu[j] += delta[j]*static_cast<Ty>(other.n)/static_cast<Ty>(total);
+				n = total;
+			}
+			/**
+			 * \brief Returns the number of accumulated states.
+			 */
+			std::size_t count() const noexcept { return n; }
+			/**
+			 * \brief Returns the mean of the accumulated states.
+			 */
+			const std::array<Ty, Dims>& mean() const noexcept { return mu; }
+			/**
+			 * \brief Returns the unbiased sample covariance of the accumulated states as a row-major
+			 *        `Dims` x `Dims` matrix, all zeros if fewer than two states have been accumulated.
+			 */
+			std::array<Ty, Dims*Dims> covariance() const noexcept {
+				std::array<Ty, Dims*Dims> cov{};
+				if (n < 2U) return cov;
+				for (std::size_t i = 0U; i < Dims*Dims; ++i) cov[i] = m2[i]/static_cast<Ty>(n - 1U);
+				return cov;
+			}
+			/**
+			 * \brief Discards all accumulated states.
+			 */
+			void clear() noexcept {
+				n = 0U; mu = std::array<Ty, Dims>{}; m2 = std::array<Ty, Dims*Dims>{};
+			}
+		private:
+			std::size_t n = 0U;
+			std::array<Ty, Dims> mu{};
+			std::array<Ty, Dims*Dims> m2{};
+		};
+		/**
+		 * \class marginal_histogram_sink
+		 *
+		 * \brief Posterior sink binning one variable of each retained state into the equal-width bins of a
+		 *        fixed range `hist::ranged_histogram`, such that the marginal posterior is obtained in
+		 *        constant memory.
+		 *
+		 * \tparam Ty Floating point type of the state variables.
+		 * \tparam Dims Number of dimensions.
+		 */
+		template<class Ty,
+			std::size_t Dims
+		> class marginal_histogram_sink {
+		public:
+			/**
+			 * \brief Constructs a sink binning variable `dim` into `nbins` bins over `[min, max]`, typically
+			 *        the prior bounds of the variable.
+			 *
+			 * \throw Throws `std::invalid_argument` exception if `dim >= Dims`, `nbins == 0` or `!(min < max)`.
+			 */
+			marginal_histogram_sink(std::size_t dim, Ty min, Ty max, std::size_t nbins)
+				: var(dim), hst(min, max, nbins) {
+				if (dim >= Dims) throw std::invalid_argument("invalid variable index for histogram sink.");
+			}
+			/**
+			 * \brief Bins variable `dim()` of `state`, counting it as outside if it lies beyond the range. A
+			 *        value equal to the upper bound of the range is counted in the last bin, as states on the
+			 *        prior bounds are within the prior.
+			 *
+			 * \complexity Constant.
+			 */
+			void operator()(const std::array<Ty, Dims>& state) noexcept {
+				const Ty v = state[var];
+				hst.add(v == hst.range_max() ? hst.bin(hst.bins() - 1U).first : v);
+			}
+			/**
+			 * \brief Adds the bin counts of `other`, which must bin the same variable over the same bins.
+			 *
+			 * \throw Throws `std::invalid_argument` exception if the binning of `other` differs.
+			 */
+			void merge(const marginal_histogram_sink& other) {
+				if (var != other.var) throw std::invalid_argument("histogram sinks must bin the same variable to merge.");
+				hst.merge(other.hst);
+			}
+			std::size_t dim() const noexcept { return var; }
+			std::size_t bins() const noexcept { return hst.bins(); }
+			Ty bin_width() const noexcept { return hst.bin_width(); }
+			/**
+			 * \brief Returns the frequencies of each bin, in order of increasing value.
+			 */
+			const std::vector<std::size_t>& frequencies() const noexcept { return hst.frequencies(); }
+			/**
+			 * \brief Returns the number of states whose variable fell outside the range.
+			 */
+			std::size_t outside() const noexcept { return hst.underflow() + hst.overflow(); }
+			/**
+			 * \brief Returns the underlying `hist::ranged_histogram`, in which states outside the range are
+			 *        split into its underflow and overflow counts.
+			 */
+			const hist::ranged_histogram<Ty>& histogram() const noexcept { return hst; }
+		private:
+			std::size_t var;
+			hist::ranged_histogram<Ty> hst;
+		};
+		/**
+		 * \class joint_histogram_sink
+		 *
+		 * \brief Posterior sink binning two variables of each retained state into the 2d grid of equal-width
+		 *        bins of a fixed range `hist::ranged_histogram_2d`, such that the joint marginal posterior is
+		 *        obtained in constant memory.
+		 *
+		 * \tparam Ty Floating point type of the state variables.
+		 * \tparam Dims Number of dimensions.
+		 */
+		template<class Ty,
+			std::size_t Dims
+		> class joint_histogram_sink {
+		public:
+			/**
+			 * \brief Constructs a sink binning variables `dim_x` and `dim_y` into `xbins` x `ybins` bins over
+			 *        `[min_x, max_x]` x `[min_y, max_y]`.
+			 *
+			 * \throw Throws `std::invalid_argument` exception if either variable index is out of range, either
+			 *        bin count is zero or either range is empty.
+			 */
+			joint_histogram_sink(std::size_t dim_x, Ty min_x, Ty max_x, std::size_t xbins,
+				std::size_t dim_y, Ty min_y, Ty max_y, std::size_t ybins)
+				: x_var(dim_x), y_var(dim_y), hst(min_x, max_x, xbins, min_y, max_y, ybins) {
+				if (dim_x >= Dims || dim_y >= Dims) throw std::invalid_argument("invalid variable index for histogram sink.");
+			}
+			/**
+			 * \brief Bins variables `x_dim()` and `y_dim()` of `state`, counting it as outside if either
+			 *        lies beyond its range. Values equal to the upper bound of a range are counted in the last
+			 *        bin along that axis, see `marginal_histogram_sink`.
+			 *
+			 * \complexity Constant.
+			 */
+			void operator()(const std::array<Ty, Dims>& state) noexcept {
+				const Ty vx = state[x_var];
+				const Ty vy = state[y_var];
+				hst.add(vx == hst.x_range_max() ? hst.xbin(hst.xbins() - 1U).first : vx,
+					vy == hst.y_range_max() ? hst.ybin(hst.ybins() - 1U).first : vy);
+			}
+			/**
+			 * \brief Adds the bin counts of `other`, which must bin the same variables over the same bins.
+			 *
+			 * \throw Throws `std::invalid_argument` exception if the binning of `other` differs.
+			 */
+			void merge(const joint_histogram_sink& other) {
+				if (x_var != other.x_var || y_var != other.y_var)
+					throw std::invalid_argument("histogram sinks must bin the same variables to merge.");
+				hst.merge(other.hst);
+			}
+			std::size_t x_dim() const noexcept { return x_var; }
+			std::size_t y_dim() const noexcept { return y_var; }
+			std::size_t xbins() const noexcept { return hst.xbins(); }
+			std::size_t ybins() const noexcept { return hst.ybins(); }
+			/**
+			 * \brief Returns the frequency of bin `(i, j)` for x bin `i` and y bin `j`.
+			 */
+			std::size_t frequency(std::size_t i, std::size_t j) const noexcept { return hst.frequency(i, j); }
+			/**
+			 * \brief Returns the number of states with either variable outside its range.
+			 */
+			std::size_t outside() const noexcept { return hst.outside(); }
+			/**
+			 * \brief Returns the underlying `hist::ranged_histogram_2d`.
+			 */
+			const hist::ranged_histogram_2d<Ty>& histogram() const noexcept { return hst; }
+		private:
+			std::size_t x_var;
+			std::size_t y_var;
+			hist::ranged_histogram_2d<Ty> hst;
+		};
+	}
+}
+
+#endif // !POSTERIOR_SINKS_H
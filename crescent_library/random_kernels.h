@@ -0,0 +1,295 @@
+#ifndef RANDOM_KERNELS_H
+#define RANDOM_KERNELS_H
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#if !defined(CRSC_DISABLE_SIMD)
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace crsc {
+	/**
+	 * \brief Detail namespace for the bulk sampling kernels used by the generators of `randomness.h`. Nothing
+	 *        in this namespace is part of the public API.
+	 *
+	 * Samples are produced in blocks: the engine first fills a buffer of raw bits, which the kernels then
+	 * transform into variates in tight loops that avoid the per-call overhead and branches of the `std::`
+	 * distributions.
+	 * SIMD code paths for the bits-to-uniform conversion are selected at compile-time from the instruction set
+	 * macros defined by the compiler (`__AVX512F__`, `__AVX2__`, `__ARM_NEON`); defining `CRSC_DISABLE_SIMD`
+	 * before inclusion forces the portable scalar kernels.
+	 */
+	namespace random_kernels_impl {
+		/**
+		 * \brief Number of variates generated per block, such that a block of bits and variates stays in L1.
+		 */
+		constexpr std::size_t block_size = 256U;
+		/**
+		 * \brief Number of random bits per call of the engine `Engine` if its range is exactly that of a
+		 *        32 or 64-bit unsigned integer, otherwise `0` (the bulk kernels are then not applicable).
+		 */
+		template<class Engine>
+		struct engine_bits {
+			typedef typename Engine::result_type result_type;
+			static constexpr std::uint64_t range = static_cast<std::uint64_t>(Engine::max() - Engine::min());
+			static constexpr unsigned value = (Engine::min() != 0U) ? 0U
+				: (range == std::numeric_limits<std::uint64_t>::max() ? 64U
+					: (range == std::numeric_limits<std::uint32_t>::max() ? 32U : 0U));
+		};
+		template<class Engine>
+		std::uint64_t next_u64(Engine& eng, std::integral_constant<unsigned, 64U>) {
+			return static_cast<std::uint64_t>(eng());
+		}
+		template<class Engine>
+		std::uint64_t next_u64(Engine& eng, std::integral_constant<unsigned, 32U>) {
+			const std::uint64_t lo = static_cast<std::uint32_t>(eng());
+			return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(eng())) << 32) | lo;
+		}
+		/**
+		 * \brief Fills `out[0, n)` with 64-bit words of random bits from `eng`.
+		 */
+		template<class Engine>
+		void fill_bits(Engine& eng, std::uint64_t* out, std::size_t n) {
+			typedef std::integral_constant<unsigned, engine_bits<Engine>::value> bits;
+			for (std::size_t i = 0U; i < n; ++i) out[i] = next_u64(eng, bits());
+		}
+		template<class Engine>
+		void fill_bits32(Engine& eng, std::uint32_t* out, std::size_t n, std::integral_constant<unsigned, 32U>) {
+			for (std::size_t i = 0U; i < n; ++i) out[i] = static_cast<std::uint32_t>(eng());
+		}
+		template<class Engine>
+		void fill_bits32(Engine& eng, std::uint32_t* out, std::size_t n, std::integral_constant<unsigned, 64U>) {
+			std::size_t i = 0U;
+			for (; i + 2U <= n; i += 2U) {
+				const std::uint64_t w = static_cast<std::uint64_t>(eng());
+				out[i] = static_cast<std::uint32_t>(w);
+				out[i + 1U] = static_cast<std::uint32_t>(w >> 32);
+			}
+			if (i < n) out[i] = static_cast<std::uint32_t>(static_cast<std::uint64_t>(eng()) >> 32);
+		}
+		/**
+		 * \brief Fills `out[0, n)` with 32-bit words of random bits from `eng`, two per call of a 64-bit engine.
+		 */
+		template<class Engine>
+		void fill_bits(Engine& eng, std::uint32_t* out, std::size_t n) {
+			fill_bits32(eng, out, n, std::integral_constant<unsigned, engine_bits<Engine>::value>());
+		}
+		/**
+		 * \brief Unsigned word type supplying the bits of one variate of type `FloatType`.
+		 */
+		template<class FloatType>
+		using bits_t = std::conditional_t<std::is_same<FloatType, float>::value, std::uint32_t, std::uint64_t>;
+		/**
+		 * \brief Converts the word of random bits `b` to a uniform variate on `[0, 1)` by placing its upper
+		 *        mantissa-width bits in the mantissa of a value in `[1, 2)` and subtracting one.
+		 */
+		inline double unit_from_bits(std::uint64_t b) noexcept {
+			b = (b >> 12) | 0x3FF0000000000000ULL;
+			double d;
+			std::memcpy(&d, &b, sizeof(d));
+			return d - 1.0;
+		}
+		inline float unit_from_bits(std::uint32_t b) noexcept {
+			b = (b >> 9) | 0x3F800000U;
+			float f;
+			std::memcpy(&f, &b, sizeof(f));
+			return f - 1.0f;
+		}
+		template<class FloatType>
+		void scalar_uniform(const bits_t<FloatType>* bits, std::size_t n, FloatType a, FloatType scale,
+			FloatType* out) noexcept {
+			for (std::size_t i = 0U; i < n; ++i)
+				out[i] = a + scale*static_cast<FloatType>(unit_from_bits(bits[i]));
+		}
+		/**
+		 * \struct uniform_kernel
+		 *
+		 * \brief Computes `out[i] = a + scale*u[i]` for the uniform variates `u[i]` on `[0, 1)` of the random
+		 *        words `bits[i]`, with the semantics of `unit_from_bits`. This is the portable version used for any
+		 *        floating point type without a vectorised specialisation.
+		 */
+		template<class FloatType, class = void>
+		struct uniform_kernel {
+			static void run(const bits_t<FloatType>* bits, std::size_t n, FloatType a, FloatType scale,
+				FloatType* out) noexcept {
+				scalar_uniform(bits, n, a, scale, out);
+			}
+		};
+#if !defined(CRSC_DISABLE_SIMD)
+#if defined(__AVX512F__)
+		template<>
+		struct uniform_kernel<double> {
+			static void run(const std::uint64_t* bits, std::size_t n, double a, double scale, double* out) noexcept {
+				const __m512i one_bits = _mm512_set1_epi64(0x3FF0000000000000LL);
+				const __m512d va = _mm512_set1_pd(a), vscale = _mm512_set1_pd(scale), vone = _mm512_set1_pd(1.0);
+				std::size_t i = 0U;
+				for (; i + 8U <= n; i += 8U) {
+					const __m512i b = _mm512_loadu_si512(reinterpret_cast<const void*>(bits + i));
+					const __m512d u = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(b, 12), one_bits)), vone);
+					_mm512_storeu_pd(out + i, _mm512_add_pd(va, _mm512_mul_pd(vscale, u)));
+				}
+				scalar_uniform(bits + i, n - i, a, scale, out + i);
+			}
+		};
+		template<>
+		struct uniform_kernel<float> {
+			static void run(const std::uint32_t* bits, std::size_t n, float a, float scale, float* out) noexcept {
+				const __m512i one_bits = _mm512_set1_epi32(0x3F800000);
+				const __m512 va = _mm512_set1_ps(a), vscale = _mm512_set1_ps(scale), vone = _mm512_set1_ps(1.0f);
+				std::size_t i = 0U;
+				for (; i + 16U <= n; i += 16U) {
+					const __m512i b = _mm512_loadu_si512(reinterpret_cast<const void*>(bits + i));
+					const __m512 u = _mm512_sub_ps(_mm512_castsi512_ps(_mm512_or_si512(_mm512_srli_epi32(b, 9), one_bits)), vone);
+					_mm512_storeu_ps(out + i, _mm512_add_ps(va, _mm512_mul_ps(vscale, u)));
+				}
+				scalar_uniform(bits + i, n - i, a, scale, out + i);
+			}
+		};
+#elif defined(__AVX2__)
+		template<>
+		struct uniform_kernel<double> {
+			static void run(const std::uint64_t* bits, std::size_t n, double a, double scale, double* out) noexcept {
+				const __m256i one_bits = _mm256_set1_epi64x(0x3FF0000000000000LL);
+				const __m256d va = _mm256_set1_pd(a), vscale = _mm256_set1_pd(scale), vone = _mm256_set1_pd(1.0);
+				std::size_t i = 0U;
+				for (; i + 4U <= n; i += 4U) {
+					const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i));
+					const __m256d u = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(b, 12), one_bits)), vone);
+					_mm256_storeu_pd(out + i, _mm256_add_pd(va, _mm256_mul_pd(vscale, u)));
+				}
+				scalar_uniform(bits + i, n - i, a, scale, out + i);
+			}
+		};
+		template<>
+		struct uniform_kernel<float> {
+			static void run(const std::uint32_t* bits, std::size_t n, float a, float scale, float* out) noexcept {
+				const __m256i one_bits = _mm256_set1_epi32(0x3F800000);
+				const __m256 va = _mm256_set1_ps(a), vscale = _mm256_set1_ps(scale), vone = _mm256_set1_ps(1.0f);
+				std::size_t i = 0U;
+				for (; i + 8U <= n; i += 8U) {
+					const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i));
+					const __m256 u = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(b, 9), one_bits)), vone);
+					_mm256_storeu_ps(out + i, _mm256_add_ps(va, _mm256_mul_ps(vscale, u)));
+				}
+				scalar_uniform(bits + i, n - i, a, scale, out + i);
+			}
+		};
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+		template<>
+		struct uniform_kernel<float> {
+			static void run(const std::uint32_t* bits, std::size_t n, float a, float scale, float* out) noexcept {
+				const uint32x4_t one_bits = vdupq_n_u32(0x3F800000U);
+				const float32x4_t va = vdupq_n_f32(a), vscale = vdupq_n_f32(scale), vone = vdupq_n_f32(1.0f);
+				std::size_t i = 0U;
+				for (; i + 4U <= n; i += 4U) {
+					const uint32x4_t b = vorrq_u32(vshrq_n_u32(vld1q_u32(bits + i), 9), one_bits);
+					const float32x4_t u = vsubq_f32(vreinterpretq_f32_u32(b), vone);
+					vst1q_f32(out + i, vaddq_f32(va, vmulq_f32(vscale, u)));
+				}
+				scalar_uniform(bits + i, n - i, a, scale, out + i);
+			}
+		};
+#if defined(__aarch64__)
+		template<>
+		struct uniform_kernel<double> {
+			static void run(const std::uint64_t* bits, std::size_t n, double a, double scale, double* out) noexcept {
+				const uint64x2_t one_bits = vdupq_n_u64(0x3FF0000000000000ULL);
+				const float64x2_t va = vdupq_n_f64(a), vscale = vdupq_n_f64(scale), vone = vdupq_n_f64(1.0);
+				std::size_t i = 0U;
+				for (; i + 2U <= n; i += 2U) {
+					const uint64x2_t b = vorrq_u64(vshrq_n_u64(vld1q_u64(bits + i), 12), one_bits);
+					const float64x2_t u = vsubq_f64(vreinterpretq_f64_u64(b), vone);
+					vst1q_f64(out + i, vaddq_f64(va, vmulq_f64(vscale, u)));
+				}
+				scalar_uniform(bits + i, n - i, a, scale, out + i);
+			}
+		};
+#endif
+#endif
+#endif // !CRSC_DISABLE_SIMD
+		/**
+		 * \struct ziggurat_normal
+		 *
+		 * \brief Standard normal sampling by the 128-layer ziggurat method of Marsaglia and Tsang (2000), in
+		 *        the form of Doornik (2005) which takes the layer and the abscissa from independent bits.
+		 *
+		 * Each variate costs one 64-bit word: the low 7 bits select a layer and the upper 52 an abscissa, which is
+		 * accepted by a single comparison for ~99% of words. Only rejected words, and the tail beyond the base
+		 * layer, draw further words from the engine.
+		 */
+		struct ziggurat_normal {
+			static constexpr std::size_t layers = 128U;
+			static constexpr double r = 3.442619855899;	// start of the tail
+			static constexpr double v = 9.91256303526217e-3;	// area of each layer
+			double x[layers + 1U];	// right edges of the layers
+			double ratio[layers];	// x[i + 1]/x[i], the fast acceptance bound of layer i
+			ziggurat_normal() noexcept {
+				double f = std::exp(-0.5*r*r);
+				x[0] = v/f;
+				x[1] = r;
+				x[layers] = 0.0;
+				for (std::size_t i = 2U; i < layers; ++i) {
+					x[i] = std::sqrt(-2.0*std::log(v/x[i - 1U] + f));
+					f = std::exp(-0.5*x[i]*x[i]);
+				}
+				for (std::size_t i = 0U; i < layers; ++i) ratio[i] = x[i + 1U]/x[i];
+			}
+			static const ziggurat_normal& tables() {
+				static const ziggurat_normal t;
+				return t;
+			}
+			/**
+			 * \brief Returns the standard normal variate of the word of random bits `b`, drawing any further
+			 *        words needed on rejection from `eng`.
+			 */
+			template<class Engine>
+			double operator()(std::uint64_t b, Engine& eng) const {
+				typedef std::integral_constant<unsigned, engine_bits<Engine>::value> bits;
+				for (;;) {
+					const std::size_t i = static_cast<std::size_t>(b & (layers - 1U));
+					const double u = 2.0*unit_from_bits(b) - 1.0;
+					if (std::fabs(u) < ratio[i]) return u*x[i];
+					if (i == 0U) return tail(u < 0.0, eng);
+					const double xu = u*x[i];
+					const double f0 = std::exp(-0.5*(x[i]*x[i] - xu*xu));
+					const double f1 = std::exp(-0.5*(x[i + 1U]*x[i + 1U] - xu*xu));
+					if (f1 + unit_from_bits(next_u64(eng, bits()))*(f0 - f1) < 1.0) return xu;
+					b = next_u64(eng, bits());
+				}
+			}
+		private:
+			template<class Engine>
+			static double tail(bool negative, Engine& eng) {
+				typedef std::integral_constant<unsigned, engine_bits<Engine>::value> bits;
+				double tx, ty;
+				do {
+					// 1 - u on (0, 1] keeps the logarithms finite
+					tx = std::log(1.0 - unit_from_bits(next_u64(eng, bits())))/r;
+					ty = std::log(1.0 - unit_from_bits(next_u64(eng, bits())));
+				} while (-2.0*ty < tx*tx);
+				return negative ? tx - r : r - tx;
+			}
+		};
+		/**
+		 * \brief Fills `out[0, n)` with normal variates of mean `mean` and standard deviation `stddev` from the
+		 *        words `bits[0, n)` by `ziggurat_normal`, drawing any further words needed from `eng`.
+		 */
+		template<class FloatType,
+			class Engine
+		> void ziggurat_fill(const std::uint64_t* bits, std::size_t n, FloatType mean, FloatType stddev, Engine& eng,
+			FloatType* out) {
+			const ziggurat_normal& zig = ziggurat_normal::tables();
+			for (std::size_t i = 0U; i < n; ++i)
+				out[i] = mean + stddev*static_cast<FloatType>(zig(bits[i], eng));
+		}
+	}
+}
+
+#endif // !RANDOM_KERNELS_H
@@ -1,7 +1,17 @@
 #include "algorithm_utilities.h"
+#include "random_kernels.h"
+#include <algorithm>
+#include <array>
 #include <complex>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <limits>
 #include <numeric>
+#include <ostream>
 #include <random>
+#include <type_traits>
+#include <vector>
 
 namespace crsc {
 #ifndef DISCRETE_TRIANGULAR_DISTRIBUTION_H
@@ -14,6 +24,10 @@ namespace crsc {
 	 *        its index in the series over the total series size in the case of an ascending triangle or 1 minus
 	 *        this quantity for a descending triangle.
 	 *
+	 * Values are sampled from a Walker alias table built on construction, i.e. each value costs one uniform
+	 * variate and at most one table lookup regardless of `n`, rather than the binary search of
+	 * `std::discrete_distribution`. The generation into a range, `generate`, samples in blocks.
+	 *
 	 * `crsc::discrete_triangular_distribution` satisfies all the requirements of `RandomNumberDistribution` (see
 	 * C++ Concepts).
 	 *
@@ -38,7 +52,8 @@ namespace crsc {
 			std::vector<IntType> weights(max);
 			if (ascending) std::iota(weights.begin(), weights.end(), 0);
 			else crsc::iota_opp(weights.begin(), weights.end(), max);
-			dd = std::discrete_distribution<IntType>(std::move(weights));
+			dd = std::discrete_distribution<IntType>(weights.begin(), weights.end());
+			build_alias_table();
 		}
 		/**
 		 * \brief Resets the internal state of the distribution object.
@@ -54,7 +69,10 @@ namespace crsc {
 		 * \param g An uniform random bit generator object.
 		 */
 		template<class Generator>
-		result_type operator()(Generator& g) { return dd(g); }
+		result_type operator()(Generator& g) {
+			return sample(canonical(g, std::integral_constant<bool, (random_kernels_impl::engine_bits<Generator>::value > 0U)>())
+				*static_cast<double>(alias_prob.size()));
+		}
 		/**
 		 * \brief Generates random numbers that are distributed according to the associated probability function. The
 		 *        entropy is acquired by calling `g.operator()`. Uses `params` as parameter set.
@@ -63,6 +81,21 @@ namespace crsc {
 		 */
 		template<class Generator>
 		result_type operator()(Generator& g, const param_type& params) { return dd(g, params); }
+		/**
+		 * \brief Fills the range `[first, last)` with random numbers distributed according to the associated
+		 *        probability function, converting blocks of engine output to table positions with the SIMD
+		 *        uniform kernels. Uses the associated parameter set.
+		 *
+		 * \param first Beginning of the range to fill.
+		 * \param last End of the range to fill.
+		 * \param g An uniform random bit generator object.
+		 * \complexity Linear in `std::distance(first, last)`.
+		 */
+		template<class ForwardIt,
+			class Generator
+		> void generate(ForwardIt first, ForwardIt last, Generator& g) {
+			generate(first, last, g, std::integral_constant<bool, (random_kernels_impl::engine_bits<Generator>::value > 0U)>());
+		}
 		// CHARACTERISTICS
 		/**
 		 * \brief Obtains a `std::vector<double>` containing the individual probabilities of each integer that is
@@ -79,7 +112,10 @@ namespace crsc {
 		 * \brief Sets the associated distribution parameter set.
 		 * \param params New contents of the associated parameter set.
 		 */
-		void param(const param_type& params) noexcept { dd.param(params); }
+		void param(const param_type& params) {
+			dd.param(params);
+			build_alias_table();
+		}
 		/**
 		 * \brief Returns the minimum value potentially generated by the distribution.
 		 * \return The minimum value potentially generated by the distribution.
@@ -92,10 +128,460 @@ namespace crsc {
 		result_type max() const noexcept { return dd.max(); }
 	private:
 		std::discrete_distribution<IntType> dd;
+		std::vector<double> alias_prob;	// probability of keeping each column rather than taking its alias
+		std::vector<IntType> alias;
+		/**
+		 * \brief Builds the alias table of the probabilities of `dd` with Vose's method.
+		 */
+		void build_alias_table() {
+			const std::vector<double> p = dd.probabilities();
+			const std::size_t n = p.size();
+			alias_prob.assign(n, 1.0);
+			alias.resize(n);
+			std::vector<double> scaled(n);
+			std::vector<std::size_t> small, large;
+			for (std::size_t i = 0U; i < n; ++i) {
+				scaled[i] = p[i]*static_cast<double>(n);
+				alias[i] = static_cast<IntType>(i);
+				(scaled[i] < 1.0 ? small : large).push_back(i);
+			}
+			while (!small.empty() && !large.empty()) {
+				const std::size_t lo = small.back(), hi = large.back();
+				small.pop_back();
+				alias_prob[lo] = scaled[lo];
+				alias[lo] = static_cast<IntType>(hi);
+				scaled[hi] -= 1.0 - scaled[lo];
+				if (scaled[hi] < 1.0) { large.pop_back(); small.push_back(hi); }
+			}
+			// columns left in either list are full up to rounding error
+		}
+		/**
+		 * \brief Returns the value of position `x` on `[0, n)` of the alias table.
+		 */
+		result_type sample(double x) const noexcept {
+			const std::size_t i = std::min(static_cast<std::size_t>(x), alias_prob.size() - 1U);
+			return (x - static_cast<double>(i) < alias_prob[i]) ? static_cast<IntType>(i) : alias[i];
+		}
+		template<class Generator>
+		static double canonical(Generator& g, std::true_type) {
+			typedef std::integral_constant<unsigned, random_kernels_impl::engine_bits<Generator>::value> bits;
+			return random_kernels_impl::unit_from_bits(random_kernels_impl::next_u64(g, bits()));
+		}
+		template<class Generator>
+		static double canonical(Generator& g, std::false_type) {
+			return std::generate_canonical<double, std::numeric_limits<double>::digits>(g);
+		}
+		template<class ForwardIt,
+			class Generator
+		> void generate(ForwardIt first, ForwardIt last, Generator& g, std::true_type) {
+			using namespace random_kernels_impl;
+			std::uint64_t bits[block_size];
+			double x[block_size];
+			const double n = static_cast<double>(alias_prob.size());
+			for (auto remaining = std::distance(first, last); remaining > 0;) {
+				const std::size_t m = std::min(static_cast<std::size_t>(remaining), block_size);
+				fill_bits(g, bits, m);
+				uniform_kernel<double>::run(bits, m, 0.0, n, x);
+				for (std::size_t i = 0U; i < m; ++i, ++first) *first = sample(x[i]);
+				remaining -= static_cast<decltype(remaining)>(m);
+			}
+		}
+		template<class ForwardIt,
+			class Generator
+		> void generate(ForwardIt first, ForwardIt last, Generator& g, std::false_type) {
+			for (; first != last; ++first) *first = operator()(g);
+		}
 	};
 #endif // !DISCRETE_TRIANGULAR_DISTRIBUTION_H
+#ifndef PARALLEL_RANDOM_ENGINES_H
+#define PARALLEL_RANDOM_ENGINES_H
+	namespace rng_impl {
+		// splitmix64 step, used to expand 64-bit seeds into engine state
+		inline std::uint64_t splitmix64(std::uint64_t& x) noexcept {
+			std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+		template<class SeedSeq>
+		std::uint64_t seed_from_seq(SeedSeq& q) {
+			std::array<std::uint32_t, 2> w;
+			q.generate(w.begin(), w.end());
+			return (static_cast<std::uint64_t>(w[1]) << 32) | w[0];
+		}
+		template<class SeedSeq, class Engine>
+		using enable_if_seed_seq = std::enable_if_t<!std::is_convertible<SeedSeq, std::uint64_t>::value
+			&& !std::is_same<std::decay_t<SeedSeq>, Engine>::value>;
+	}
+	/**
+	 * \class philox4x32_engine
+	 *
+	 * \brief Counter-based random number engine implementing the Philox4x32 generator of Salmon et al. (2011),
+	 *        producing 32-bit values by applying a keyed bijection of `Rounds` rounds to a 128-bit counter.
+	 *
+	 * The state is only the 64-bit key, the 128-bit counter and a buffer of one block of four outputs (32 bytes
+	 * in total), and any position of any stream is reachable in constant time: the upper 64 bits of the counter
+	 * select a stream (see `philox4x32_engine(seed, stream)`) and the lower 64 bits the block within the stream,
+	 * such that `discard` is constant time and streams of equal seed and distinct stream number are independent.
+	 *
+	 * `philox4x32_engine` satisfies the requirements of `RandomNumberEngine` (see C++ Concepts).
+	 *
+	 * \tparam Rounds Number of rounds of the bijection, the default of 10 passes BigCrush with a safety margin.
+	 */
+	template<std::size_t Rounds = 10U>
+	class philox4x32_engine {
+	public:
+		typedef std::uint32_t result_type;
+		static constexpr std::uint64_t default_seed = 20111115U;
+		// CONSTRUCTION/SEEDING
+		/**
+		 * \brief Constructs the engine at the start of stream `stream` of the key `seed`.
+		 *
+		 * \param seed Key of the engine.
+		 * \param stream Number of the stream, i.e. upper 64 bits of the counter.
+		 */
+		explicit philox4x32_engine(std::uint64_t seed = default_seed, std::uint64_t stream = 0U) { this->seed(seed, stream); }
+		template<class SeedSeq,
+			class = rng_impl::enable_if_seed_seq<SeedSeq, philox4x32_engine>
+		> explicit philox4x32_engine(SeedSeq& q) { seed(q); }
+		void seed(std::uint64_t seed = default_seed, std::uint64_t stream = 0U) noexcept {
+			key = { static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) };
+			ctr = { 0U, 0U, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32) };
+			idx = 4U;
+		}
+		template<class SeedSeq,
+			class = rng_impl::enable_if_seed_seq<SeedSeq, philox4x32_engine>
+		> void seed(SeedSeq& q) { seed(rng_impl::seed_from_seq(q)); }
+		// GENERATION
+		/**
+		 * \brief Returns the next value of the stream.
+		 *
+		 * \complexity Constant, one block evaluation per four values.
+		 */
+		result_type operator()() noexcept {
+			if (idx == 4U) { block = generate_block(ctr, key); increment(); idx = 0U; }
+			return block[idx++];
+		}
+		/**
+		 * \brief Advances the engine by `n` values.
+		 *
+		 * \complexity Constant.
+		 */
+		void discard(unsigned long long n) noexcept {
+			const unsigned long long buffered = 4U - idx;
+			if (n <= buffered) { idx += static_cast<unsigned>(n); return; }
+			n -= buffered;
+			// skip whole blocks by counter arithmetic, then refill for the remainder
+			std::uint64_t lo = (static_cast<std::uint64_t>(ctr[1]) << 32 | ctr[0]) + n/4U;
+			ctr[0] = static_cast<std::uint32_t>(lo); ctr[1] = static_cast<std::uint32_t>(lo >> 32);
+			idx = 4U;
+			if (n % 4U) { operator()(); idx = static_cast<unsigned>(n % 4U); }
+		}
+		/**
+		 * \brief Returns the four values of block `counter` under `key`, the stateless form of the engine.
+		 */
+		static std::array<std::uint32_t, 4> generate_block(std::array<std::uint32_t, 4> counter,
+			std::array<std::uint32_t, 2> key) noexcept {
+			for (std::size_t r = 0U; r < Rounds; ++r) {
+				const std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53U)*counter[0];
+				const std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57U)*counter[2];
+				counter = { static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<std::uint32_t>(p1),
+					static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<std::uint32_t>(p0) };
+				key[0] += 0x9E3779B9U;
+				key[1] += 0xBB67AE85U;
+			}
+			return counter;
+		}
+		static constexpr result_type min() noexcept { return 0U; }
+		static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+		friend bool operator==(const philox4x32_engine& lhs, const philox4x32_engine& rhs) noexcept {
+			return lhs.key == rhs.key && lhs.position() == rhs.position();
+		}
+		friend bool operator!=(const philox4x32_engine& lhs, const philox4x32_engine& rhs) noexcept { return !(lhs == rhs); }
+		template<class CharT, class Traits>
+		friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const philox4x32_engine& e) {
+			const auto p = e.position();
+			return os << e.key[0] << ' ' << e.key[1] << ' ' << p.first[0] << ' ' << p.first[1] << ' '
+				<< p.first[2] << ' ' << p.first[3] << ' ' << p.second;
+		}
+		template<class CharT, class Traits>
+		friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, philox4x32_engine& e) {
+			philox4x32_engine tmp;
+			unsigned offset = 0U;
+			is >> tmp.key[0] >> tmp.key[1] >> tmp.ctr[0] >> tmp.ctr[1] >> tmp.ctr[2] >> tmp.ctr[3] >> offset;
+			if (is) {
+				tmp.idx = 4U;
+				if (offset) { tmp(); tmp.idx = offset; }
+				e = tmp;
+			}
+			return is;
+		}
+	private:
+		std::array<std::uint32_t, 2> key;
+		std::array<std::uint32_t, 4> ctr;	// counter of the next block to generate
+		std::array<std::uint32_t, 4> block;	// buffered outputs of the previous block
+		unsigned idx;	// next buffered output, 4 if none remain
+		void increment() noexcept {
+			if (++ctr[0] == 0U) ++ctr[1];
+		}
+		// counter of the current block and offset within it, a canonical form of the position
+		std::pair<std::array<std::uint32_t, 4>, unsigned> position() const noexcept {
+			if (idx == 4U) return std::make_pair(ctr, 0U);
+			std::array<std::uint32_t, 4> c = ctr;
+			if (c[0]-- == 0U) --c[1];
+			return std::make_pair(c, idx);
+		}
+	};
+	template<std::size_t Rounds>
+	constexpr std::uint64_t philox4x32_engine<Rounds>::default_seed;
+	/**
+	 * \brief Philox4x32 with the recommended 10 rounds.
+	 */
+	typedef philox4x32_engine<10U> philox4x32;
+	/**
+	 * \class xoshiro256ss_engine
+	 *
+	 * \brief Random number engine implementing the xoshiro256** generator of Blackman and Vigna (2018), producing
+	 *        64-bit values from 32 bytes of state with a period of 2^256 - 1.
+	 *
+	 * `jump()` advances the engine by 2^128 values and `long_jump()` by 2^192, such that repeatedly jumping a
+	 * copy of one engine yields up to 2^64 (respectively 2^128) non-overlapping streams.
+	 *
+	 * `xoshiro256ss_engine` satisfies the requirements of `RandomNumberEngine` (see C++ Concepts).
+	 */
+	class xoshiro256ss_engine {
+	public:
+		typedef std::uint64_t result_type;
+		static constexpr std::uint64_t default_seed = 0x8C6A8D5B6B3F2A1DULL;
+		// CONSTRUCTION/SEEDING
+		/**
+		 * \brief Constructs the engine with its state expanded from `seed` by splitmix64.
+		 */
+		explicit xoshiro256ss_engine(std::uint64_t seed = default_seed) noexcept { this->seed(seed); }
+		template<class SeedSeq,
+			class = rng_impl::enable_if_seed_seq<SeedSeq, xoshiro256ss_engine>
+		> explicit xoshiro256ss_engine(SeedSeq& q) { seed(q); }
+		void seed(std::uint64_t seed = default_seed) noexcept {
+			for (auto& w : s) w = rng_impl::splitmix64(seed);
+		}
+		template<class SeedSeq,
+			class = rng_impl::enable_if_seed_seq<SeedSeq, xoshiro256ss_engine>
+		> void seed(SeedSeq& q) {
+			std::array<std::uint32_t, 8> w;
+			q.generate(w.begin(), w.end());
+			for (std::size_t i = 0U; i < 4U; ++i) s[i] = (static_cast<std::uint64_t>(w[2*i + 1]) << 32) | w[2*i];
+			if (!(s[0] | s[1] | s[2] | s[3])) seed();	// all-zero state is a fixed point
+		}
+		// GENERATION
+		result_type operator()() noexcept {
+			const std::uint64_t result = rotl(s[1]*5U, 7)*9U;
+			const std::uint64_t t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = rotl(s[3], 45);
+			return result;
+		}
+		void discard(unsigned long long n) noexcept { for (; n; --n) operator()(); }
+		/**
+		 * \brief Advances the engine by 2^128 values.
+		 *
+		 * \complexity Constant (256 engine steps).
+		 */
+		void jump() noexcept {
+			static const std::uint64_t poly[] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+			apply_jump(poly);
+		}
+		/**
+		 * \brief Advances the engine by 2^192 values.
+		 *
+		 * \complexity Constant (256 engine steps).
+		 */
+		void long_jump() noexcept {
+			static const std::uint64_t poly[] = { 0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL };
+			apply_jump(poly);
+		}
+		static constexpr result_type min() noexcept { return 0U; }
+		static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+		friend bool operator==(const xoshiro256ss_engine& lhs, const xoshiro256ss_engine& rhs) noexcept { return lhs.s == rhs.s; }
+		friend bool operator!=(const xoshiro256ss_engine& lhs, const xoshiro256ss_engine& rhs) noexcept { return !(lhs == rhs); }
+		template<class CharT, class Traits>
+		friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const xoshiro256ss_engine& e) {
+			return os << e.s[0] << ' ' << e.s[1] << ' ' << e.s[2] << ' ' << e.s[3];
+		}
+		template<class CharT, class Traits>
+		friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, xoshiro256ss_engine& e) {
+			std::array<std::uint64_t, 4> tmp;
+			if (is >> tmp[0] >> tmp[1] >> tmp[2] >> tmp[3]) e.s = tmp;
+			return is;
+		}
+	private:
+		std::array<std::uint64_t, 4> s;
+		static std::uint64_t rotl(std::uint64_t x, int k) noexcept { return (x << k) | (x >> (64 - k)); }
+		void apply_jump(const std::uint64_t (&poly)[4]) noexcept {
+			std::array<std::uint64_t, 4> t{};
+			for (std::uint64_t word : poly) {
+				for (int b = 0; b < 64; ++b) {
+					if (word & (static_cast<std::uint64_t>(1U) << b)) {
+						for (std::size_t i = 0U; i < 4U; ++i) t[i] ^= s[i];
+					}
+					operator()();
+				}
+			}
+			s = t;
+		}
+	};
+	/**
+	 * \brief Creates the engine of stream `stream` of the seed `seed`, such that engines of equal seed and
+	 *        distinct streams are independent and each is reproducible regardless of how many streams are
+	 *        created or in which order, e.g. one stream per thread or per Markov chain.
+	 *
+	 * - `philox4x32_engine` selects the stream by counter, in constant time.
+	 * - `xoshiro256ss_engine` seeds from `seed` and then `jump()`s `stream` times, i.e. streams are disjoint
+	 *   blocks of 2^128 values, in time linear in `stream`.
+	 * - Any other engine is constructed from a `std::seed_seq` of `seed` and `stream`.
+	 *
+	 * \tparam Engine Random number engine type.
+	 */
+	template<class Engine>
+	std::enable_if_t<!std::is_same<Engine, xoshiro256ss_engine>::value, Engine> make_stream_engine(std::uint64_t seed, std::uint64_t stream) {
+		std::seed_seq seq{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+			static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32), 0x6d636d63U };
+		return Engine(seq);
+	}
+	template<class Engine>
+	std::enable_if_t<std::is_same<Engine, xoshiro256ss_engine>::value, Engine> make_stream_engine(std::uint64_t seed, std::uint64_t stream) {
+		xoshiro256ss_engine eng(seed);
+		for (; stream; --stream) eng.jump();
+		return eng;
+	}
+	template<>
+	inline philox4x32 make_stream_engine<philox4x32>(std::uint64_t seed, std::uint64_t stream) {
+		return philox4x32(seed, stream);
+	}
+	/**
+	 * \class stream_factory
+	 *
+	 * \brief Hands out successive independent streams of one seed, see `make_stream_engine`. For
+	 *        `xoshiro256ss_engine` each stream after the first costs a single `jump()`.
+	 *
+	 * \tparam Engine Random number engine type.
+	 */
+	template<class Engine>
+	class stream_factory {
+	public:
+		explicit stream_factory(std::uint64_t _seed) : seed_(_seed) {}
+		/**
+		 * \brief Returns the engine of stream `stream`.
+		 */
+		Engine stream(std::uint64_t stream) const { return make_stream_engine<Engine>(seed_, stream); }
+		/**
+		 * \brief Returns the engine of the next stream, starting from stream `0`.
+		 */
+		Engine next() { return make_stream_engine<Engine>(seed_, next_stream++); }
+		std::uint64_t seed() const noexcept { return seed_; }
+	private:
+		std::uint64_t seed_;
+		std::uint64_t next_stream = 0U;
+	};
+	template<>
+	class stream_factory<xoshiro256ss_engine> {
+	public:
+		explicit stream_factory(std::uint64_t _seed) : seed_(_seed), eng(_seed) {}
+		xoshiro256ss_engine stream(std::uint64_t stream) const { return make_stream_engine<xoshiro256ss_engine>(seed_, stream); }
+		xoshiro256ss_engine next() noexcept {
+			xoshiro256ss_engine e = eng;
+			eng.jump();
+			return e;
+		}
+		std::uint64_t seed() const noexcept { return seed_; }
+	private:
+		std::uint64_t seed_;
+		xoshiro256ss_engine eng;
+	};
+#endif // !PARALLEL_RANDOM_ENGINES_H
 #ifndef RANDOM_NUMBER_GENERATOR_H
 #define RANDOM_NUMBER_GENERATOR_H
+	namespace rng_impl {
+		template<class Engine,
+			class FloatType
+		> using bulk_uniform_tag = std::integral_constant<bool, (random_kernels_impl::engine_bits<Engine>::value > 0U)
+			&& (std::is_same<FloatType, float>::value || std::is_same<FloatType, double>::value)>;
+		/**
+		 * \brief Fills `[first, last)` with variates of `dist` drawn one at a time, the fallback for any
+		 *        distribution or engine without a bulk kernel.
+		 */
+		template<class Engine,
+			class Distribution,
+			class ForwardIt
+		> void generate_bulk(Engine& eng, Distribution& dist, ForwardIt first, ForwardIt last) {
+			for (; first != last; ++first) *first = dist(eng);
+		}
+		template<class Engine,
+			class FloatType,
+			class ForwardIt
+		> void generate_uniform(Engine& eng, FloatType a, FloatType b, ForwardIt first, ForwardIt last, std::true_type) {
+			using namespace random_kernels_impl;
+			bits_t<FloatType> bits[block_size];
+			FloatType buf[block_size];
+			for (auto remaining = std::distance(first, last); remaining > 0;) {
+				const std::size_t m = std::min(static_cast<std::size_t>(remaining), block_size);
+				fill_bits(eng, bits, m);
+				uniform_kernel<FloatType>::run(bits, m, a, b - a, buf);
+				first = std::copy(buf, buf + m, first);
+				remaining -= static_cast<decltype(remaining)>(m);
+			}
+		}
+		template<class Engine,
+			class FloatType,
+			class ForwardIt
+		> void generate_uniform(Engine& eng, FloatType a, FloatType b, ForwardIt first, ForwardIt last, std::false_type) {
+			std::uniform_real_distribution<FloatType> dist(a, b);
+			generate_bulk(eng, dist, first, last);
+		}
+		template<class Engine,
+			class FloatType,
+			class ForwardIt
+		> void generate_bulk(Engine& eng, std::uniform_real_distribution<FloatType>& dist, ForwardIt first, ForwardIt last) {
+			generate_uniform(eng, dist.a(), dist.b(), first, last, bulk_uniform_tag<Engine, FloatType>());
+		}
+		template<class Engine,
+			class FloatType,
+			class ForwardIt
+		> void generate_normal(Engine& eng, FloatType mean, FloatType stddev, ForwardIt first, ForwardIt last, std::true_type) {
+			using namespace random_kernels_impl;
+			std::uint64_t bits[block_size];
+			FloatType buf[block_size];
+			for (auto remaining = std::distance(first, last); remaining > 0;) {
+				const std::size_t m = std::min(static_cast<std::size_t>(remaining), block_size);
+				fill_bits(eng, bits, m);
+				ziggurat_fill(bits, m, mean, stddev, eng, buf);
+				first = std::copy(buf, buf + m, first);
+				remaining -= static_cast<decltype(remaining)>(m);
+			}
+		}
+		template<class Engine,
+			class FloatType,
+			class ForwardIt
+		> void generate_normal(Engine& eng, FloatType mean, FloatType stddev, ForwardIt first, ForwardIt last, std::false_type) {
+			std::normal_distribution<FloatType> dist(mean, stddev);
+			generate_bulk(eng, dist, first, last);
+		}
+		template<class Engine,
+			class FloatType,
+			class ForwardIt
+		> void generate_bulk(Engine& eng, std::normal_distribution<FloatType>& dist, ForwardIt first, ForwardIt last) {
+			generate_normal(eng, dist.mean(), dist.stddev(), first, last, bulk_uniform_tag<Engine, FloatType>());
+		}
+		template<class Engine,
+			class IntType,
+			class ForwardIt
+		> void generate_bulk(Engine& eng, discrete_triangular_distribution<IntType>& dist, ForwardIt first, ForwardIt last) {
+			dist.generate(first, last, eng);
+		}
+	}
 	/**
 	 * \class random_number_generator
 	 *
@@ -209,6 +695,28 @@ namespace crsc {
 		 * \return The generated random number.
 		 */
 		result_type operator()() { return dist(eng); }
+		/**
+		 * \brief Fills the range `[first, last)` with random numbers of the distribution.
+		 *
+		 * For `std::uniform_real_distribution` and `std::normal_distribution` of `float` or `double`, and for
+		 * `crsc::discrete_triangular_distribution`, with an engine producing full 32 or 64-bit words, the values
+		 * are generated in blocks by the kernels of `random_kernels.h` (uniform variates with SIMD, normal variates
+		 * by the ziggurat method). The values then follow the same distribution as, but are not the same sequence
+		 * as, repeated calls to `operator()`. Any other distribution is sampled one value at a time.
+		 *
+		 * \param first Beginning of the range to fill.
+		 * \param last End of the range to fill.
+		 * \complexity Linear in `std::distance(first, last)`.
+		 */
+		template<class ForwardIt>
+		void generate(ForwardIt first, ForwardIt last) { rng_impl::generate_bulk(eng, dist, first, last); }
+		/**
+		 * \brief Fills the container (or array) `c` with random numbers of the distribution, see `generate`.
+		 *
+		 * \param c Container to fill.
+		 */
+		template<class Container>
+		void fill(Container& c) { generate(std::begin(c), std::end(c)); }
 		// GENERATOR AND DISTRIBUTION OBJECT ACCESS
 		/**
 		 * \brief Returns a copy of the underlying generator engine.
@@ -341,6 +849,22 @@ namespace crsc {
 		 * \return The generated random number.
 		 */
 		result_type operator()() { return generator(); }
+		/**
+		 * \brief Fills the range `[first, last)` with probabilities, in blocks, see
+		 *        `crsc::random_number_generator::generate`.
+		 *
+		 * \param first Beginning of the range to fill.
+		 * \param last End of the range to fill.
+		 */
+		template<class ForwardIt>
+		void generate(ForwardIt first, ForwardIt last) { generator.generate(first, last); }
+		/**
+		 * \brief Fills the container (or array) `c` with probabilities, see `generate`.
+		 *
+		 * \param c Container to fill.
+		 */
+		template<class Container>
+		void fill(Container& c) { generator.fill(c); }
 		// GENERATOR AND DISTRIBUTION OBJECT ACCESS
 		/**
 		 * \brief Returns a copy of the underlying distribution.
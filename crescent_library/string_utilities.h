@@ -1,13 +1,412 @@
 #ifndef STRING_UTILITIES_H
 #define STRING_UTILITIES_H
+#include "string_view.h"
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <clocale>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <set>
 #include <string>
 #include <sstream>
+#include <system_error>
+#include <type_traits>
 #include <vector>
+#if !defined(CRSC_DISABLE_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
 
 namespace crsc {
+	/**
+	 * \brief Detail namespace for the tokenizing and number parsing kernels. Nothing in this namespace is
+	 *        part of the public API.
+	 *
+	 * SIMD code paths for the delimiter search are selected at compile-time from the instruction set macros
+	 * defined by the compiler (`__AVX2__`, SSE2 on x86-64); defining `CRSC_DISABLE_SIMD` before inclusion
+	 * forces the portable kernel, which searches with `std::memchr`.
+	 */
+	namespace string_impl {
+		/**
+		 * \brief Invokes `f(token_first, token_last)` for each token of `[first, last)` delimited by `delim`
+		 *        until `f` returns `false`, with the semantics of repeated `std::getline(is, token, delim)`:
+		 *        empty tokens between delimiters are produced, but a trailing delimiter does not begin a
+		 *        further, empty, token.
+		 *
+		 * \return `false` if stopped by `f`, `true` otherwise.
+		 */
+		template<class F>
+		bool for_each_token(const char* first, const char* last, char delim, F&& f) {
+			if (first == last) return true;
+			const char* tok = first;
+			std::size_t i = 0U;
+#if !defined(CRSC_DISABLE_SIMD) && (defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+			const std::size_t n = static_cast<std::size_t>(last - first);
+#if defined(__AVX2__)
+			const __m256i d = _mm256_set1_epi8(delim);
+			for (; i + 32U <= n; i += 32U) {
+				const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+				std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, d)));
+#else
+			const __m128i d = _mm_set1_epi8(delim);
+			for (; i + 16U <= n; i += 16U) {
+				const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+				std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, d)));
+#endif
+				for (; mask; mask &= mask - 1U) {
+#if defined(_MSC_VER)
+					unsigned long bit;
+					_BitScanForward(&bit, mask);
+#else
+					const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+					const char* pos = first + i + bit;
+					if (!f(tok, pos)) return false;
+					tok = pos + 1;
+				}
+			}
+#endif
+			for (const char* p = first + i; p != last;) {
+				const void* pos = std::memchr(p, delim, static_cast<std::size_t>(last - p));
+				if (!pos) break;
+				if (!f(tok, static_cast<const char*>(pos))) return false;
+				tok = p = static_cast<const char*>(pos) + 1;
+			}
+			return tok == last || f(tok, last);
+		}
+		/**
+		 * \brief Returns the value of the digit `c` in bases of up to 36, or 36 if `c` is not a digit.
+		 */
+		inline int digit_value(char c) noexcept {
+			if (c >= '0' && c <= '9') return c - '0';
+			if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+			if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+			return 36;
+		}
+		inline bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+		/**
+		 * \brief Checks whether `[first, last)` starts with the lower case `word`, ignoring case.
+		 */
+		inline bool starts_with_nocase(const char* first, const char* last, const char* word) noexcept {
+			for (; *word; ++word, ++first) {
+				if (first == last || (*first | 0x20) != *word) return false;
+			}
+			return true;
+		}
+		/**
+		 * \brief The powers of ten which are exactly representable as `double`, `10^e` for `0 <= e <= 22`.
+		 */
+		inline double exact_pow10(int e) noexcept {
+			static const double table[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+			return table[e];
+		}
+		/**
+		 * \brief Limits within which a decimal `m * 10^e` is converted exactly, i.e. with a single correctly
+		 *        rounded operation, as both `m` and `10^|e|` are representable (Clinger's fast path), and the
+		 *        `std::strto*` function for all other values.
+		 */
+		template<class Float> struct float_parse_traits;
+		template<> struct float_parse_traits<float> {
+			static constexpr std::uint64_t max_mantissa = static_cast<std::uint64_t>(1U) << 24;
+			static constexpr int max_exp10 = 10;
+			static float strto(const char* s, char** end) { return std::strtof(s, end); }
+		};
+		template<> struct float_parse_traits<double> {
+			static constexpr std::uint64_t max_mantissa = static_cast<std::uint64_t>(1U) << 53;
+			static constexpr int max_exp10 = 22;
+			static double strto(const char* s, char** end) { return std::strtod(s, end); }
+		};
+		template<> struct float_parse_traits<long double> {
+			static constexpr std::uint64_t max_mantissa = 0U;	// precision varies by platform, always use strtold
+			static constexpr int max_exp10 = 0;
+			static long double strto(const char* s, char** end) { return std::strtold(s, end); }
+		};
+		/**
+		 * \brief Converts the validated decimal `[first, last)` with `std::strto*`, substituting the decimal
+		 *        point of the current C locale for `'.'` such that the result does not depend on the locale.
+		 */
+		template<class Float>
+		std::errc strto_fallback(const char* first, const char* last, Float& value) {
+			const std::size_t len = static_cast<std::size_t>(last - first);
+			char small[128];
+			std::string large;
+			char* buf = small;
+			if (len >= sizeof(small)) {
+				large.assign(len + 1U, '\0');
+				buf = &large[0];
+			}
+			std::memcpy(buf, first, len);
+			buf[len] = '\0';
+			const char point = *std::localeconv()->decimal_point;
+			if (point != '.') std::replace(buf, buf + len, '.', point);
+			const int saved_errno = errno;
+			errno = 0;
+			char* end = nullptr;
+			const Float v = float_parse_traits<Float>::strto(buf, &end);
+			const bool range_error = (errno == ERANGE);
+			errno = saved_errno;
+			if (end != buf + len) return std::errc::invalid_argument;
+			// subnormal results are accepted, only overflow and complete underflow are out of range
+			if (range_error && (v == Float(0) || v > std::numeric_limits<Float>::max() || v < std::numeric_limits<Float>::lowest()))
+				return std::errc::result_out_of_range;
+			value = v;
+			return std::errc();
+		}
+		/**
+		 * \brief Returns whether `c` is skipped around a field by `split_parse`.
+		 */
+		inline bool is_blank(char c) noexcept { return c == ' ' || c == '\t' || c == '\r'; }
+	}
+	/**
+	 * \brief Result of `crsc::from_chars`, as the C++17 `std::from_chars_result`.
+	 */
+	struct from_chars_result {
+		const char* ptr;	// first character not matching the pattern of a number
+		std::errc ec;		// `std::errc()` on success
+	};
+	/**
+	 * \brief Parses an integer from `[first, last)` without allocation, exceptions or locale dependence,
+	 *        as the C++17 `std::from_chars` for integers.
+	 *
+	 * The pattern is an optional `'-'` (for signed types only) followed by one or more digits of `base`.
+	 * Leading whitespace and `'+'` are not accepted.
+	 *
+	 * \param first Start of the characters to parse.
+	 * \param last End of the characters to parse.
+	 * \param value Parsed value, unmodified unless `ec` of the result is `std::errc()`.
+	 * \param base Base of the number, in `[2, 36]`.
+	 * \return `{ptr, std::errc()}` on success where `ptr` points past the number, `{first,
+	 *         std::errc::invalid_argument}` if no number matches, or `{ptr, std::errc::result_out_of_range}` if
+	 *         the number is not representable as `Integer`.
+	 */
+	template<class Integer,
+		class = std::enable_if_t<std::is_integral<Integer>::value && !std::is_same<Integer, bool>::value>
+	> from_chars_result from_chars(const char* first, const char* last, Integer& value, int base = 10) noexcept {
+		typedef std::make_unsigned_t<Integer> uint_type;
+		const char* p = first;
+		const bool neg = std::is_signed<Integer>::value && p != last && *p == '-';
+		if (neg) ++p;
+		const uint_type limit = neg ? static_cast<uint_type>(static_cast<uint_type>(std::numeric_limits<Integer>::max()) + 1U)
+			: static_cast<uint_type>(std::numeric_limits<Integer>::max());
+		const char* const digits = p;
+		uint_type acc = 0U;
+		bool overflow = false;
+		for (; p != last; ++p) {
+			const int d = string_impl::digit_value(*p);
+			if (d >= base) break;
+			if (overflow) continue;
+			if (acc > static_cast<uint_type>((limit - static_cast<uint_type>(d))/static_cast<uint_type>(base))) overflow = true;
+			else acc = static_cast<uint_type>(acc*static_cast<uint_type>(base) + static_cast<uint_type>(d));
+		}
+		if (p == digits) return from_chars_result{ first, std::errc::invalid_argument };
+		if (overflow) return from_chars_result{ p, std::errc::result_out_of_range };
+		value = neg ? static_cast<Integer>(static_cast<uint_type>(0U - acc)) : static_cast<Integer>(acc);
+		return from_chars_result{ p, std::errc() };
+	}
+	/**
+	 * \brief Parses a floating point number from `[first, last)` without exceptions or locale dependence, as
+	 *        the C++17 `std::from_chars` with `std::chars_format::general`.
+	 *
+	 * The pattern is an optional `'-'` followed by a decimal with an optional `'.'` and an optional exponent
+	 * `e` or `E` with optional sign, or by `inf`, `infinity`, `nan` or `nan(chars)` ignoring case. Leading
+	 * whitespace and `'+'` are not accepted. Decimals of up to 19 significant digits whose value and power of
+	 * ten are exactly representable (e.g. up to 15 digits and exponents of magnitude up to 22 for `double`)
+	 * are converted directly, and any others, as well as all `long double`s, through `std::strto*` on a stack
+	 * copy, allocating only for numbers longer than 127 characters. Both are correctly rounded.
+	 *
+	 * \param first Start of the characters to parse.
+	 * \param last End of the characters to parse.
+	 * \param value Parsed value, unmodified unless `ec` of the result is `std::errc()`.
+	 * \return `{ptr, std::errc()}` on success where `ptr` points past the number, `{first,
+	 *         std::errc::invalid_argument}` if no number matches, or `{ptr, std::errc::result_out_of_range}` if
+	 *         the number overflows or underflows to zero.
+	 */
+	template<class Float,
+		class = std::enable_if_t<std::is_floating_point<Float>::value>,
+		class = void
+	> from_chars_result from_chars(const char* first, const char* last, Float& value) {
+		typedef string_impl::float_parse_traits<Float> traits;
+		const char* p = first;
+		const bool neg = p != last && *p == '-';
+		if (neg) ++p;
+		if (p != last && ((*p | 0x20) == 'i' || (*p | 0x20) == 'n')) {
+			if (string_impl::starts_with_nocase(p, last, "inf")) {
+				p += 3;
+				if (string_impl::starts_with_nocase(p, last, "inity")) p += 5;
+				value = neg ? -std::numeric_limits<Float>::infinity() : std::numeric_limits<Float>::infinity();
+				return from_chars_result{ p, std::errc() };
+			}
+			if (string_impl::starts_with_nocase(p, last, "nan")) {
+				p += 3;
+				if (p != last && *p == '(') {
+					const char* q = p + 1;
+					while (q != last && (std::isalnum(static_cast<unsigned char>(*q)) || *q == '_')) ++q;
+					if (q != last && *q == ')') p = q + 1;
+				}
+				value = neg ? -std::numeric_limits<Float>::quiet_NaN() : std::numeric_limits<Float>::quiet_NaN();
+				return from_chars_result{ p, std::errc() };
+			}
+			return from_chars_result{ first, std::errc::invalid_argument };
+		}
+		std::uint64_t mantissa = 0U;
+		int sig_digits = 0;
+		int exp10 = 0;
+		bool truncated = false, any = false;
+		for (; p != last && string_impl::is_digit(*p); ++p) {
+			any = true;
+			const int d = *p - '0';
+			if (!mantissa && !d) continue;
+			if (sig_digits < 19) { mantissa = mantissa*10U + static_cast<unsigned>(d); ++sig_digits; }
+			else { ++exp10; truncated |= (d != 0); }
+		}
+		if (p != last && *p == '.') {
+			++p;
+			for (; p != last && string_impl::is_digit(*p); ++p) {
+				any = true;
+				const int d = *p - '0';
+				if (!mantissa && !d) { --exp10; continue; }
+				if (sig_digits < 19) { mantissa = mantissa*10U + static_cast<unsigned>(d); ++sig_digits; --exp10; }
+				else truncated |= (d != 0);
+			}
+		}
+		if (!any) return from_chars_result{ first, std::errc::invalid_argument };
+		if (p != last && (*p == 'e' || *p == 'E')) {
+			const char* q = p + 1;
+			const bool exp_neg = q != last && *q == '-';
+			if (q != last && (*q == '+' || *q == '-')) ++q;
+			if (q != last && string_impl::is_digit(*q)) {
+				int e = 0;
+				for (; q != last && string_impl::is_digit(*q); ++q) {
+					if (e < 100000) e = e*10 + (*q - '0');
+				}
+				exp10 += exp_neg ? -e : e;
+				p = q;
+			}
+		}
+		if (!mantissa) {
+			value = neg ? -Float(0) : Float(0);
+			return from_chars_result{ p, std::errc() };
+		}
+		if (!truncated && mantissa <= traits::max_mantissa && exp10 >= -traits::max_exp10 && exp10 <= traits::max_exp10) {
+			Float v = static_cast<Float>(mantissa);
+			const Float scale = static_cast<Float>(string_impl::exact_pow10(exp10 < 0 ? -exp10 : exp10));
+			v = (exp10 < 0) ? v/scale : v*scale;
+			value = neg ? -v : v;
+			return from_chars_result{ p, std::errc() };
+		}
+		const std::errc ec = string_impl::strto_fallback(first, p, value);
+		return from_chars_result{ ec == std::errc::invalid_argument ? first : p, ec };
+	}
+	/**
+	 * \brief Splits `s` around the delimiter `delim`, writing a `crsc::string_view` of each token to `out`
+	 *        without copying or allocating.
+	 *
+	 * Tokens are produced as by `crsc::split`, i.e. repeated `std::getline`: empty tokens between delimiters
+	 * are included but a trailing delimiter does not begin a further, empty, token. The views are valid as
+	 * long as the characters of `s` are.
+	 *
+	 * \param s Characters to split.
+	 * \param delim Delimiter around which to split `s`.
+	 * \param out Output iterator to which to write the `crsc::string_view`s.
+	 * \return Output iterator past the last view written.
+	 * \complexity Linear in the size of `s`, searching for delimiters a vector of characters at a time.
+	 */
+	template<class OutputIt>
+	OutputIt split_views(string_view s, char delim, OutputIt out) {
+		string_impl::for_each_token(s.data(), s.data() + s.size(), delim, [&out](const char* first, const char* last) {
+			*out = string_view(first, static_cast<std::size_t>(last - first));
+			++out;
+			return true;
+		});
+		return out;
+	}
+	/**
+	 * \brief Result of `crsc::split_parse`.
+	 */
+	template<class OutputIt>
+	struct split_parse_result {
+		OutputIt out;		// output iterator past the last value written
+		std::size_t count;	// number of values written
+		const char* ptr;	// start of the field which failed to parse, or the end of the input on success
+		std::errc ec;		// `std::errc()` on success
+	};
+	namespace string_impl {
+		/**
+		 * \brief Parses the field `[first, last)` in its entirety, ignoring blanks around it.
+		 */
+		template<class T>
+		std::errc parse_field(const char* first, const char* last, T& value) {
+			while (first != last && is_blank(*first)) ++first;
+			while (first != last && is_blank(*(last - 1))) --last;
+			if (first == last) return std::errc::invalid_argument;
+			const from_chars_result res = from_chars(first, last, value);
+			if (res.ec != std::errc()) return res.ec;
+			return (res.ptr == last) ? std::errc() : std::errc::invalid_argument;
+		}
+		template<class T, class OutputIt, class Full>
+		split_parse_result<OutputIt> split_parse(string_view s, char delim, OutputIt out, Full full) {
+			split_parse_result<OutputIt> r{ out, 0U, s.data() + s.size(), std::errc() };
+			for_each_token(s.data(), s.data() + s.size(), delim, [&r, &full](const char* first, const char* last) {
+				T value;
+				std::errc ec = parse_field(first, last, value);
+				if (ec == std::errc() && full(r.out)) ec = std::errc::value_too_large;
+				if (ec != std::errc()) {
+					r.ptr = first;
+					r.ec = ec;
+					return false;
+				}
+				*r.out = value;
+				++r.out;
+				++r.count;
+				return true;
+			});
+			return r;
+		}
+	}
+	/**
+	 * \brief Splits `s` around the delimiter `delim` and parses each field as a `T` with `crsc::from_chars`,
+	 *        writing the values to `out` without intermediate strings, allocation or exceptions, e.g.
+	 *        `split_parse<double>(line, ',', std::back_inserter(row))`.
+	 *
+	 * Fields are delimited as by `crsc::split_views`. Spaces, tabs and carriage returns around a field are
+	 * ignored, such that lines from files with CRLF line endings parse, but each field must otherwise consist
+	 * of exactly one number; unlike `std::stod` et al., trailing characters are an error.
+	 *
+	 * \tparam T Arithmetic type to parse, not deducible from `out`.
+	 * \param s Characters to split and parse.
+	 * \param delim Delimiter around which to split `s`.
+	 * \param out Output iterator to which to write the values.
+	 * \return `crsc::split_parse_result` of the parse, which stops at the first field that fails with
+	 *         `std::errc::invalid_argument` (empty or not a number) or `std::errc::result_out_of_range`.
+	 * \complexity Linear in the size of `s`.
+	 */
+	template<class T,
+		class OutputIt
+	> split_parse_result<OutputIt> split_parse(string_view s, char delim, OutputIt out) {
+		return string_impl::split_parse<T>(s, delim, out, [](const OutputIt&) { return false; });
+	}
+	/**
+	 * \brief Splits `s` around the delimiter `delim` and parses each field into the span `[first, last)`,
+	 *        see `split_parse(s, delim, out)`.
+	 *
+	 * \return `crsc::split_parse_result` of the parse, which additionally stops with
+	 *         `std::errc::value_too_large` at the first field for which the span has no room.
+	 */
+	template<class T>
+	split_parse_result<T*> split_parse(string_view s, char delim, T* first, T* last) {
+		return string_impl::split_parse<T>(s, delim, first, [last](T* const& out) { return out == last; });
+	}
 	/**
 	 * \brief Splits a `std::string` around a given delimiter into a `std::vector<std::string>`.
 	 *
@@ -15,12 +414,12 @@ namespace crsc {
 	 * \param delim `char` to split `s` around.
 	 * \return A `std::vector` of `std::string` instances containing each sub-string after splits.
 	 */
-	std::vector<std::string> split(const std::string& s, char delim) {
+	inline std::vector<std::string> split(const std::string& s, char delim) {
 		std::vector<std::string> elems;
-		std::stringstream ss(s);
-		std::string item;
-		while (std::getline(ss, item, delim))
-			elems.push_back(item);
+		string_impl::for_each_token(s.data(), s.data() + s.size(), delim, [&elems](const char* first, const char* last) {
+			elems.emplace_back(first, last);
+			return true;
+		});
 		return elems;
 	}
 	/**
@@ -29,7 +428,7 @@ namespace crsc {
 	 * \param delim delimiter around which to split `s`.
 	 * \return `std::vector<int>` of split and parsed values.
 	 */
-	std::vector<int> split_stoi(const std::string& s, char delim) {
+	inline std::vector<int> split_stoi(const std::string& s, char delim) {
 		std::vector<int> elems;
 		std::stringstream ss(s);
 		std::string item;
@@ -43,7 +442,7 @@ namespace crsc {
 	 * \param delim delimiter around which to split `s`.
 	 * \return `std::vector<long>` of split and parsed values.
 	 */
-	std::vector<long> split_stol(const std::string& s, char delim) {
+	inline std::vector<long> split_stol(const std::string& s, char delim) {
 		std::vector<long> elems;
 		std::stringstream ss(s);
 		std::string item;
@@ -57,7 +456,7 @@ namespace crsc {
 	 * \param delim delimiter around which to split `s`.
 	 * \return `std::vector<long long>` of split and parsed values.
 	 */
-	std::vector<long long> split_stoll(const std::string& s, char delim) {
+	inline std::vector<long long> split_stoll(const std::string& s, char delim) {
 		std::vector<long long> elems;
 		std::stringstream ss(s);
 		std::string item;
@@ -71,7 +470,7 @@ namespace crsc {
 	 * \param delim delimiter around which to split `s`.
 	 * \return `std::vector<unsigned long>` of split and parsed values.
 	 */
-	std::vector<unsigned long> split_stoul(const std::string& s, char delim) {
+	inline std::vector<unsigned long> split_stoul(const std::string& s, char delim) {
 		std::vector<unsigned long> elems;
 		std::stringstream ss(s);
 		std::string item;
@@ -85,7 +484,7 @@ namespace crsc {
 	 * \param delim delimiter around which to split `s`.
 	 * \return `std::vector<unsigned long long>` of split and parsed values.
 	 */
-	std::vector<unsigned long long> split_stoull(const std::string& s, char delim) {
+	inline std::vector<unsigned long long> split_stoull(const std::string& s, char delim) {
 		std::vector<unsigned long long> elems;
 		std::stringstream ss(s);
 		std::string item;
@@ -99,7 +498,7 @@ namespace crsc {
 	 * \param delim delimiter around which to split `s`.
 	 * \return `std::vector<float>` of split and parsed values.
 	 */
-	std::vector<float> split_stof(const std::string& s, char delim) {
+	inline std::vector<float> split_stof(const std::string& s, char delim) {
 		std::vector<float> elems;
 		std::stringstream ss(s);
 		std::string item;
@@ -113,7 +512,7 @@ namespace crsc {
 	 * \param delim delimiter around which to split `s`.
 	 * \return `std::vector<double>` of split and parsed values.
 	 */
-	std::vector<double> split_stod(const std::string& s, char delim) {
+	inline std::vector<double> split_stod(const std::string& s, char delim) {
 		std::vector<double> elems;
 		std::stringstream ss(s);
 		std::string item;
@@ -127,7 +526,7 @@ namespace crsc {
 	 * \param delim delimiter around which to split `s`.
 	 * \return `std::vector<long double>` of split and parsed values.
 	 */
-	std::vector<long double> split_stold(const std::string& s, char delim) {
+	inline std::vector<long double> split_stold(const std::string& s, char delim) {
 		std::vector<long double> elems;
 		std::stringstream ss(s);
 		std::string item;
@@ -142,7 +541,7 @@ namespace crsc {
 	 * \param pr `std::string` to prepend `s` with.
 	 * \return Reference to `s` with prepended string `pr`.
 	 */
-	std::string& prepend(std::string& s, const std::string& pr) {
+	inline std::string& prepend(std::string& s, const std::string& pr) {
 		return s.insert(0, pr);
 	}
 	/**
@@ -152,7 +551,7 @@ namespace crsc {
 	 * \param _c `char` to check against.
 	 * \return `true` if `_s` starts with `_c`, `false` otherwise.
 	 */
-	bool starts_with(const std::string& s, char c) {
+	inline bool starts_with(const std::string& s, char c) {
 		return *s.cbegin() == c;
 	}
 	/**
@@ -162,7 +561,7 @@ namespace crsc {
 	 * \param _c `char` to check against.
 	 * \return `true` if `_s` ends with `_c`, `false` otherwise.
  	 */
-	bool ends_with(const std::string& s, char c) {
+	inline bool ends_with(const std::string& s, char c) {
 		return *--(s.cend()) == c;
 	}
 	/**
@@ -171,7 +570,7 @@ namespace crsc {
 	 * \param _s Reference to `std::string` instance.
 	 * \return Reference to `_s` with all `char`s converted to upper case.
 	 */
-	std::string& to_upper(std::string& s) {
+	inline std::string& to_upper(std::string& s) {
 		for (auto& c : s)
 			c = static_cast<char>(std::toupper(c));
 		return s;
@@ -182,7 +581,7 @@ namespace crsc {
 	 * \param _s Reference to `std::string` instance.
 	 * \return Reference to `_s` with all `char`s converted to lower case.
 	 */
-	std::string& to_lower(std::string& s) {
+	inline std::string& to_lower(std::string& s) {
 		for (auto& c : s)
 			c = static_cast<char>(std::tolower(c));
 		return s;
@@ -193,7 +592,7 @@ namespace crsc {
 	 * \param _s Reference to `std::string` instance.
 	 * \return Reference to `_s` with all whitespace `char`s removed.
 	 */
-	std::string& remove_whitespace(std::string& s) {
+	inline std::string& remove_whitespace(std::string& s) {
 		// invoke erase-remove idiom and use std::isspace(char) to check for whitespaces.
 		s.erase(std::remove_if(s.begin(), s.end(), [](char x) { return std::isspace(x); }), s.end());
 		return s;
@@ -205,7 +604,7 @@ namespace crsc {
 	 * \param _char_set A `std::set` containing instances of `char` to remove from `_s`.
 	 * \return Reference to `_s` with all instances of any `char` within `_char_set` removed.
 	 */
-	std::string& trim(std::string& s, const std::set<char>& char_set) {
+	inline std::string& trim(std::string& s, const std::set<char>& char_set) {
 		// invoke erase-remove idiom and pass _char_set to lambda captue for checking if char's occur
 		s.erase(std::remove_if(s.begin(), s.end(), [&char_set](char x) {return char_set.find(x) != char_set.end(); }), s.end());
 		return s;
@@ -213,7 +612,7 @@ namespace crsc {
 	/**
 	 * \brief Removes all instances of any `char` in a given `std::string` from a `std::string`.
 	 */
-	std::string& trim(std::string& s, const std::string& str_source) {
+	inline std::string& trim(std::string& s, const std::string& str_source) {
 		s.erase(std::remove_if(s.begin(), s.end(), [&str_source](char x) {return str_source.find(x) != std::string::npos; }), s.end());
 		return s;
 	}
@@ -223,7 +622,7 @@ namespace crsc {
 	 * \param _s Reference to `std::string` instance.
 	 * \param Reference to `_s` with all vowels removed.
 	 */
-	std::string& remove_vowels(std::string& s) {
+	inline std::string& remove_vowels(std::string& s) {
 		std::set<char> vowel_set = { 'a', 'e', 'i', 'o', 'u', 'A', 'E', 'I', 'O', 'U' };
 		return trim(s, vowel_set);
 	}
@@ -233,7 +632,7 @@ namespace crsc {
 	 * \param _s Reference to `std::string` instance.
 	 * \return Reference to `_s` with all leading whitespaces removed.
 	 */
-	std::string& remove_leading_whitespaces(std::string& s) {
+	inline std::string& remove_leading_whitespaces(std::string& s) {
 		auto it = s.begin();
 		// loop until past-the-end iterator of _s
 		while (it != s.end()) {
@@ -254,7 +653,7 @@ namespace crsc {
 	 * \param _s Reference to `std::string` instance.
 	 * \return Reference to `_s` with all trailing whitespaces removed.
  	 */
-	std::string& remove_trailing_whitespaces(std::string& s) {
+	inline std::string& remove_trailing_whitespaces(std::string& s) {
 		auto it = s.rbegin();
 		// loop until rend iterator of _s
 		while (it != s.rend()) {
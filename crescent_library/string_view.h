@@ -0,0 +1,205 @@
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace crsc {
+	/**
+	 * \class basic_string_view
+	 *
+	 * \brief A non-owning, constant view of a contiguous sequence of characters, i.e. a pointer and a length,
+	 *        modelled on the C++17 `std::basic_string_view` for use from C++14.
+	 *
+	 * A view never allocates and is invalidated by whatever invalidates the referenced characters, e.g. the
+	 * destruction of the `std::basic_string` or the unmapping of the file it was created from. Conversion to
+	 * an owning `std::basic_string` is explicit, via `to_string()` or `static_cast`.
+	 *
+	 * \tparam CharT Character type.
+	 * \tparam Traits Character traits type, defaults to `std::char_traits<CharT>`.
+	 */
+	template<class CharT,
+		class Traits = std::char_traits<CharT>
+	> class basic_string_view {
+	public:
+		// PUBLIC API TYPE DEFINITIONS
+		typedef Traits traits_type;
+		typedef CharT value_type;
+		typedef const CharT* pointer;
+		typedef const CharT* const_pointer;
+		typedef const CharT& reference;
+		typedef const CharT& const_reference;
+		typedef const CharT* const_iterator;
+		typedef const_iterator iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+		typedef const_reverse_iterator reverse_iterator;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		static constexpr size_type npos = static_cast<size_type>(-1);
+		// CONSTRUCTION
+		/**
+		 * \brief Constructs an empty view.
+		 */
+		constexpr basic_string_view() noexcept : ptr(nullptr), len(0U) {}
+		/**
+		 * \brief Constructs a view of the `count` characters starting at `s`.
+		 */
+		constexpr basic_string_view(const CharT* s, size_type count) noexcept : ptr(s), len(count) {}
+		/**
+		 * \brief Constructs a view of the null-terminated character string `s`.
+		 */
+		basic_string_view(const CharT* s) : ptr(s), len(Traits::length(s)) {}
+		/**
+		 * \brief Constructs a view of the contents of `s`.
+		 */
+		template<class Allocator>
+		basic_string_view(const std::basic_string<CharT, Traits, Allocator>& s) noexcept : ptr(s.data()), len(s.size()) {}
+		// ITERATORS
+		constexpr const_iterator begin() const noexcept { return ptr; }
+		constexpr const_iterator cbegin() const noexcept { return ptr; }
+		constexpr const_iterator end() const noexcept { return ptr + len; }
+		constexpr const_iterator cend() const noexcept { return ptr + len; }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		// ELEMENT ACCESS
+		constexpr const_reference operator[](size_type pos) const noexcept { return ptr[pos]; }
+		/**
+		 * \brief Returns the character at position `pos`.
+		 *
+		 * \throw Throws `std::out_of_range` if `pos >= size()`.
+		 */
+		const_reference at(size_type pos) const {
+			if (pos >= len) throw std::out_of_range("basic_string_view::at: position out of range.");
+			return ptr[pos];
+		}
+		constexpr const_reference front() const noexcept { return ptr[0]; }
+		constexpr const_reference back() const noexcept { return ptr[len - 1U]; }
+		constexpr const_pointer data() const noexcept { return ptr; }
+		// CAPACITY
+		constexpr size_type size() const noexcept { return len; }
+		constexpr size_type length() const noexcept { return len; }
+		constexpr bool empty() const noexcept { return len == 0U; }
+		// MODIFIERS
+		/**
+		 * \brief Moves the start of the view forward by `n` characters.
+		 */
+		void remove_prefix(size_type n) noexcept { ptr += n; len -= n; }
+		/**
+		 * \brief Moves the end of the view back by `n` characters.
+		 */
+		void remove_suffix(size_type n) noexcept { len -= n; }
+		void swap(basic_string_view& other) noexcept {
+			std::swap(ptr, other.ptr);
+			std::swap(len, other.len);
+		}
+		// OPERATIONS
+		/**
+		 * \brief Returns an owning copy of the viewed characters.
+		 */
+		std::basic_string<CharT, Traits> to_string() const { return std::basic_string<CharT, Traits>(ptr, len); }
+		template<class Allocator>
+		explicit operator std::basic_string<CharT, Traits, Allocator>() const {
+			return std::basic_string<CharT, Traits, Allocator>(ptr, len);
+		}
+		/**
+		 * \brief Returns the view of the at most `count` characters starting at `pos`.
+		 *
+		 * \throw Throws `std::out_of_range` if `pos > size()`.
+		 */
+		basic_string_view substr(size_type pos = 0U, size_type count = npos) const {
+			if (pos > len) throw std::out_of_range("basic_string_view::substr: position out of range.");
+			return basic_string_view(ptr + pos, std::min(count, len - pos));
+		}
+		/**
+		 * \brief Lexicographically compares the view with `other`, returning a negative value, zero or a
+		 *        positive value if the view is less than, equal to or greater than `other`.
+		 */
+		int compare(basic_string_view other) const noexcept {
+			const int c = Traits::compare(ptr, other.ptr, std::min(len, other.len));
+			return c ? c : (len < other.len ? -1 : (len > other.len ? 1 : 0));
+		}
+		bool starts_with(basic_string_view prefix) const noexcept {
+			return len >= prefix.len && !Traits::compare(ptr, prefix.ptr, prefix.len);
+		}
+		bool ends_with(basic_string_view suffix) const noexcept {
+			return len >= suffix.len && !Traits::compare(ptr + len - suffix.len, suffix.ptr, suffix.len);
+		}
+		/**
+		 * \brief Returns the position of the first occurrence of `c` at or after `pos`, or `npos`.
+		 */
+		size_type find(CharT c, size_type pos = 0U) const noexcept {
+			if (pos >= len) return npos;
+			const CharT* p = Traits::find(ptr + pos, len - pos, c);
+			return p ? static_cast<size_type>(p - ptr) : npos;
+		}
+		/**
+		 * \brief Returns the position of the first occurrence of `s` at or after `pos`, or `npos`.
+		 */
+		size_type find(basic_string_view s, size_type pos = 0U) const noexcept {
+			if (pos > len || s.len > len - pos) return npos;
+			if (s.empty()) return pos;
+			for (; pos + s.len <= len; ++pos) {
+				const CharT* p = Traits::find(ptr + pos, len - s.len - pos + 1U, s.ptr[0]);
+				if (!p) return npos;
+				pos = static_cast<size_type>(p - ptr);
+				if (!Traits::compare(p, s.ptr, s.len)) return pos;
+			}
+			return npos;
+		}
+		/**
+		 * \brief Returns the position of the last occurrence of `c` at or before `pos`, or `npos`.
+		 */
+		size_type rfind(CharT c, size_type pos = npos) const noexcept {
+			if (!len) return npos;
+			for (size_type i = std::min(pos, len - 1U) + 1U; i-- > 0U;) {
+				if (Traits::eq(ptr[i], c)) return i;
+			}
+			return npos;
+		}
+	private:
+		const CharT* ptr;
+		size_type len;
+	};
+	template<class CharT, class Traits>
+	constexpr typename basic_string_view<CharT, Traits>::size_type basic_string_view<CharT, Traits>::npos;
+	typedef basic_string_view<char> string_view;
+	typedef basic_string_view<wchar_t> wstring_view;
+	// NON-MEMBER COMPARISON OPERATORS, the `type_identity`-style overloads of C++17 are provided for
+	// views compared with anything implicitly convertible to a view (strings and string literals)
+	template<class CharT, class Traits>
+	bool operator==(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept {
+		return lhs.size() == rhs.size() && !lhs.compare(rhs);
+	}
+	template<class CharT, class Traits>
+	bool operator==(basic_string_view<CharT, Traits> lhs, std::common_type_t<basic_string_view<CharT, Traits>> rhs) noexcept {
+		return lhs.size() == rhs.size() && !lhs.compare(rhs);
+	}
+	template<class CharT, class Traits>
+	bool operator==(std::common_type_t<basic_string_view<CharT, Traits>> lhs, basic_string_view<CharT, Traits> rhs) noexcept {
+		return lhs.size() == rhs.size() && !lhs.compare(rhs);
+	}
+	template<class CharT, class Traits>
+	bool operator!=(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept { return !(lhs == rhs); }
+	template<class CharT, class Traits>
+	bool operator!=(basic_string_view<CharT, Traits> lhs, std::common_type_t<basic_string_view<CharT, Traits>> rhs) noexcept { return !(lhs == rhs); }
+	template<class CharT, class Traits>
+	bool operator!=(std::common_type_t<basic_string_view<CharT, Traits>> lhs, basic_string_view<CharT, Traits> rhs) noexcept { return !(lhs == rhs); }
+	template<class CharT, class Traits>
+	bool operator<(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept { return lhs.compare(rhs) < 0; }
+	template<class CharT, class Traits>
+	bool operator>(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept { return lhs.compare(rhs) > 0; }
+	template<class CharT, class Traits>
+	bool operator<=(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept { return lhs.compare(rhs) <= 0; }
+	template<class CharT, class Traits>
+	bool operator>=(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept { return lhs.compare(rhs) >= 0; }
+	template<class CharT, class Traits>
+	std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, basic_string_view<CharT, Traits> sv) {
+		return os.write(sv.data(), static_cast<std::streamsize>(sv.size()));
+	}
+}
+
+#endif // !STRING_VIEW_H
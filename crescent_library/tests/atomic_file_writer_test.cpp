@@ -0,0 +1,90 @@
+// Tests of crsc::atomic_file_writer. Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Ifilesystem -pthread tests/atomic_file_writer_test.cpp
+#include "atomic_file_writer.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif
+
+namespace {
+	std::string read_file(const std::string& path) {
+		std::ifstream ifs(path, std::ios::binary);
+		std::ostringstream oss;
+		oss << ifs.rdbuf();
+		return oss.str();
+	}
+	void test_commit_and_discard() {
+		const std::string path = "atomic_file_writer_test.txt";
+		{
+			crsc::atomic_file_writer w(path);
+			w.write("abc", 3U);
+			w.stream() << "def";
+			w.commit();
+		}
+		assert(read_file(path) == "abcdef");
+		{
+			crsc::atomic_file_writer w(path);
+			w.write("xyz", 3U);
+		}
+		assert(read_file(path) == "abcdef");
+		std::remove(path.c_str());
+	}
+	// Concurrent writers of one file each get their own temporary file, so every commit installs the
+	// complete contents of one writer.
+	void test_concurrent_writers() {
+		const std::string path = "atomic_file_writer_test_concurrent.txt";
+		std::vector<std::future<void>> writers;
+		for (int t = 0; t < 8; ++t) {
+			writers.push_back(std::async(std::launch::async, [&path, t]() {
+				const std::string line(100000U, static_cast<char>('a' + t));
+				for (int i = 0; i < 10; ++i) {
+					crsc::atomic_file_writer w(path, 4096U);
+					w.write(line.data(), line.size());
+					w.commit();
+				}
+			}));
+		}
+		for (auto& w : writers) w.get();
+		const std::string data = read_file(path);
+		assert(data.size() == 100000U && data == std::string(data.size(), data[0]));
+		std::remove(path.c_str());
+	}
+#if !defined(_WIN32)
+	// A new file is created subject to the umask, a replaced one keeps its permissions.
+	void test_permissions() {
+		const std::string path = "atomic_file_writer_test_mode.txt";
+		std::remove(path.c_str());
+		const ::mode_t old_mask = ::umask(022);
+		{
+			crsc::atomic_file_writer w(path);
+			w.commit();
+		}
+		struct stat st;
+		assert(::stat(path.c_str(), &st) == 0 && (st.st_mode & 0777) == 0644);
+		assert(::chmod(path.c_str(), 0600) == 0);
+		{
+			crsc::atomic_file_writer w(path);
+			w.commit();
+		}
+		assert(::stat(path.c_str(), &st) == 0 && (st.st_mode & 0777) == 0600);
+		::umask(old_mask);
+		std::remove(path.c_str());
+	}
+#endif
+}
+
+int main() {
+	test_commit_and_discard();
+	test_concurrent_writers();
+#if !defined(_WIN32)
+	test_permissions();
+#endif
+	std::cout << "atomic_file_writer_test passed\n";
+}
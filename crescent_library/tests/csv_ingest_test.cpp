@@ -0,0 +1,44 @@
+// Tests of crsc::ingest_csv error reporting. Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Icontainer -Ifilesystem -pthread tests/csv_ingest_test.cpp
+#include "csv_ingest.h"
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+	// The rows preceding a parse error, including those in the same chunk, are appended before it is thrown.
+	void test_rows_before_error(const crsc::execution::parallel_policy& policy, std::size_t chunk_size) {
+		crsc::csv_ingest_options options;
+		options.chunk_size = chunk_size;
+		{
+			std::istringstream is("1,2\n3,x\n");
+			crsc::dynamic_matrix<int> m;
+			try {
+				crsc::load_csv(is, m, options, policy);
+				assert(false);
+			}
+			catch (const crsc::csv_parse_error& e) { assert(e.line() == 2U && e.field() == 2U); }
+			assert(m.rows() == 1U && m.columns() == 2U && m.at(0, 1) == 2);
+		}
+		{
+			std::istringstream is("1,2\n3,4\n5,6\n7\n");
+			crsc::dynamic_matrix<int> m;
+			try {
+				crsc::load_csv(is, m, options, policy);
+				assert(false);
+			}
+			catch (const crsc::csv_parse_error& e) { assert(e.line() == 4U); }
+			assert(m.rows() == 3U && m.at(2, 0) == 5);
+		}
+	}
+}
+
+int main() {
+	for (std::size_t threads : { 1U, 4U }) {
+		const crsc::execution::parallel_policy policy(threads);
+		test_rows_before_error(policy, crsc::csv_ingest_options().chunk_size);
+		test_rows_before_error(policy, 5U);
+	}
+	std::cout << "csv_ingest_test passed\n";
+}
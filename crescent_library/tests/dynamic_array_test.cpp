@@ -0,0 +1,92 @@
+// Tests of the exception safety of dynamic_array growth and insertion. Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -Icontainer tests/dynamic_array_test.cpp
+#include "dynamic_array.h"
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	int live = 0;	// number of live elements
+	int budget = 0;	// number of copies and throwing moves left before one throws
+	const int unlimited = 1 << 30;
+	void use_budget() {
+		if (--budget < 0) throw std::runtime_error("injected failure");
+	}
+	// element whose copy and move constructors may both throw
+	struct throwing_move {
+		std::string s;
+		explicit throwing_move(int v) : s(std::to_string(v)) { ++live; }
+		throwing_move(const throwing_move& o) : s(o.s) { use_budget(); ++live; }
+		throwing_move(throwing_move&& o) : s(std::move(o.s)) { use_budget(); ++live; }
+		throwing_move& operator=(const throwing_move&) = default;
+		throwing_move& operator=(throwing_move&&) = default;
+		~throwing_move() { --live; }
+	};
+	// element whose copy constructor may throw and whose move constructor is noexcept
+	struct nothrow_move {
+		std::string s;
+		explicit nothrow_move(int v) : s(std::to_string(v)) { ++live; }
+		nothrow_move(const nothrow_move& o) : s(o.s) { use_budget(); ++live; }
+		nothrow_move(nothrow_move&& o) noexcept : s(std::move(o.s)) { ++live; }
+		nothrow_move& operator=(const nothrow_move&) = default;
+		nothrow_move& operator=(nothrow_move&&) = default;
+		~nothrow_move() { --live; }
+	};
+	template<class Array>
+	void check_unchanged(const Array& a, int extra_live) {
+		assert(a.size() == 10U);
+		for (int i = 0; i < 10; ++i) assert(a[i].s == std::to_string(i));
+		assert(live == 10 + extra_live);
+	}
+	// Every growth and insertion either succeeds or, failing at any copy or move, leaves the array unchanged.
+	template<class E, std::size_t InlineCapacity>
+	void test_strong_guarantee() {
+		typedef dynamic_array<E, std::allocator<E>, InlineCapacity> array_type;
+		for (int fail = 0; fail < 40; ++fail) {
+			{
+				budget = unlimited;
+				array_type a;
+				for (int i = 0; i < 10; ++i) a.emplace_back(i);
+				a.shrink_to_fit();
+				const E v(5);
+				budget = fail;
+				try { a.emplace_back(10); a.pop_back(); }
+				catch (const std::runtime_error&) {}
+				budget = unlimited;
+				check_unchanged(a, 1);
+				budget = fail;
+				try { a.emplace(a.begin() + 3, 11); a.erase(a.begin() + 3); }
+				catch (const std::runtime_error&) {}
+				budget = unlimited;
+				check_unchanged(a, 1);
+				budget = fail;
+				try { a.insert(a.begin() + 2, 3U, v); a.erase(a.begin() + 2, a.begin() + 5); }
+				catch (const std::runtime_error&) {}
+				budget = unlimited;
+				check_unchanged(a, 1);
+				a.shrink_to_fit();
+				budget = fail;
+				try { a.insert(a.begin(), 1U, v); a.erase(a.begin()); }
+				catch (const std::runtime_error&) {}
+				budget = unlimited;
+				check_unchanged(a, 1);
+				budget = fail;
+				try { a.reserve(100U); }
+				catch (const std::runtime_error&) {}
+				budget = unlimited;
+				check_unchanged(a, 1);
+			}
+			assert(live == 0);
+		}
+	}
+}
+
+int main() {
+	test_strong_guarantee<throwing_move, 0U>();
+	test_strong_guarantee<throwing_move, 16U>();
+	test_strong_guarantee<nothrow_move, 0U>();
+	test_strong_guarantee<nothrow_move, 16U>();
+	std::cout << "dynamic_array_test passed\n";
+}
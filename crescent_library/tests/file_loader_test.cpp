@@ -0,0 +1,72 @@
+// Tests of crsc::file_loader asynchronous saves. Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Ifilesystem -pthread tests/file_loader_test.cpp
+#include "file_loader.h"
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	void write_file(const std::string& path, const std::string& data) {
+		std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+		ofs << data;
+	}
+	std::string read_file(const std::string& path) {
+		std::ifstream ifs(path, std::ios::binary);
+		std::ostringstream oss;
+		oss << ifs.rdbuf();
+		return oss.str();
+	}
+	// Back-to-back asynchronous saves followed by a synchronous one must complete in order without
+	// deadlocking, including when started from tasks of the pool which writes the saves.
+	void test_back_to_back_saves(const std::string& path, std::size_t rounds) {
+		write_file(path, "0\n");
+		crsc::file_loader<> fl(path);
+		for (std::size_t i = 1U; i <= rounds; ++i) {
+			fl[0] = std::to_string(i);
+			fl.write_changes_async();
+			fl.push_line_back("x");
+			fl.write_changes_async();
+			fl.pop_line_back();
+			fl.write_changes();
+			assert(read_file(path) == std::to_string(i) + "\n");
+		}
+		std::remove(path.c_str());
+	}
+	void test_saves_from_pool_tasks() {
+		crsc::thread_pool& pool = crsc::thread_pool::default_pool();
+		std::vector<std::future<void>> tasks;
+		for (std::size_t t = 0U; t < 2U * pool.size() + 1U; ++t)
+			tasks.push_back(pool.submit([t]() { test_back_to_back_saves("file_loader_test_" + std::to_string(t) + ".txt", 50U); }));
+		for (auto& task : tasks) {
+			pool.wait(task);
+			task.get();
+		}
+	}
+	void test_destructor_waits() {
+		const std::string path = "file_loader_test_dtor.txt";
+		write_file(path, "a\n");
+		std::atomic<int> completed(0);
+		{
+			crsc::file_loader<> fl(path);
+			for (int i = 0; i < 8; ++i) {
+				fl[0] = std::to_string(i);
+				fl.write_changes_async([&completed](std::exception_ptr e) { assert(!e); ++completed; });
+			}
+		}
+		assert(completed == 8);
+		assert(read_file(path) == "7\n");
+		std::remove(path.c_str());
+	}
+}
+
+int main() {
+	test_back_to_back_saves("file_loader_test.txt", 200U);
+	test_saves_from_pool_tasks();
+	test_destructor_waits();
+	std::cout << "file_loader_test passed\n";
+}
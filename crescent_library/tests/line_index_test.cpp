@@ -0,0 +1,46 @@
+// Tests of the validation of line index sidecars. Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Ifilesystem -pthread tests/line_index_test.cpp
+#include "line_index.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+	bool round_trips(std::uint64_t size, const std::vector<std::uint64_t>& offsets) {
+		const std::string path = "line_index_test.lidx";
+		crsc::file_impl::sidecar_header header;
+		header.size = size;
+		header.mtime = 1;
+		header.hash = 2U;
+		header.count = offsets.size();
+		assert(crsc::file_impl::write_sidecar(path, header, offsets));
+		crsc::file_impl::sidecar_header read_header;
+		std::vector<std::uint64_t> read_offsets;
+		const bool ok = crsc::file_impl::read_sidecar(path, read_header, read_offsets);
+		std::remove(path.c_str());
+		assert(!ok || read_offsets == offsets);
+		return ok;
+	}
+}
+
+int main() {
+	// well-formed indices of an empty, a terminated and an unterminated file
+	assert(round_trips(0U, { 0U }));
+	assert(round_trips(6U, { 0U, 2U, 6U }));
+	assert(round_trips(7U, { 0U, 2U, 6U, 8U }));
+	// not starting at 0 or not strictly increasing
+	assert(!round_trips(6U, { 1U, 2U, 6U }));
+	assert(!round_trips(6U, { 0U, 2U, 2U, 6U }));
+	// ending elsewhere than at the sentinel of the file size
+	assert(!round_trips(6U, { 0U, 2U, 5U }));
+	assert(!round_trips(6U, { 0U, 2U, 8U }));
+	assert(!round_trips(0U, { 0U, 1U }));
+	// offsets wrapping around 64 bits
+	const std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+	assert(!round_trips(6U, { 0U, max, 6U }));
+	std::cout << "line_index_test passed\n";
+}
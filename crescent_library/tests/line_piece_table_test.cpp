@@ -0,0 +1,72 @@
+// Tests of crsc::line_piece_table references and of compact_file_loader change tracking. Build from
+// crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Ifilesystem -pthread tests/line_piece_table_test.cpp
+#include "file_loader.h"
+#include "line_piece_table.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+	std::string read_file(const std::string& path) {
+		std::ifstream ifs(path, std::ios::binary);
+		std::ostringstream oss;
+		oss << ifs.rdbuf();
+		return oss.str();
+	}
+	// Mutable references read lines in place and copy them into the overlay only when written.
+	void test_references() {
+		crsc::line_piece_table t(std::string("alpha\nbeta\ngamma\ndelta\n"));
+		std::size_t total = 0U;
+		for (auto it = t.begin(); it != t.end(); ++it) total += it->size();
+		for (crsc::line_piece_table::reference line : t) total += crsc::string_view(line).size();
+		assert(total == 2U*19U && t[1] == "beta" && t.front() == t.begin()[0] && t.back() == "delta");
+		assert(t.overlay_size() == 0U && t.edited_lines().first == t.edited_lines().second);
+		t[2] = "GAMMA";
+		t.front() += "!";
+		assert(t.overlay_size() == 2U && t.edited_lines() == std::make_pair(std::size_t(0U), std::size_t(3U)));
+		assert(t[0] == "alpha!" && t[2] == "GAMMA" && t[3] == "delta");
+		*(t.begin() + 1) = t[3];
+		t.back().str().append("++");
+		assert(t[1] == "delta" && t[3] == "delta++");
+		t.clear_edits();
+		// an insertion shifts the edited lines following it
+		t[3] = "x";
+		t.insert(t.cbegin() + 1, std::string("new"));
+		assert(t.edited_lines() == std::make_pair(std::size_t(1U), std::size_t(5U)) && t[4] == "x");
+		std::ostringstream oss;
+		t.write_to(oss);
+		assert(oss.str() == "alpha!\nnew\ndelta\nGAMMA\nx\n");
+	}
+	// Iterating a compact_file_loader through mutable iterators does not mark its lines as changed.
+	void test_loader_change_tracking() {
+		const std::string path = "line_piece_table_test.txt";
+		{ std::ofstream ofs(path, std::ios::binary); ofs << "a\nb\nc\nd\n"; }
+		crsc::compact_file_loader fl(path);
+		std::size_t n = 0U;
+		for (auto it = fl.begin(); it != fl.end(); ++it) n += it->size();
+		assert(n == 4U && fl[2] == "c" && fl.line_at(3) == "d");
+		assert(!fl.has_unsaved_changes() && fl.file_contents().overlay_size() == 0U);
+		fl.line_at(2) = "C";
+		assert(fl.has_unsaved_changes() && fl.dirty_lines() == std::make_pair(std::size_t(2U), std::size_t(3U)));
+		fl.write_changes();
+		assert(!fl.has_unsaved_changes() && read_file(path) == "a\nb\nC\nd\n");
+		*std::find(fl.begin(), fl.end(), "b") = "B";
+		fl.erase_line(fl.cbegin());
+		assert(fl.dirty_lines() == std::make_pair(std::size_t(0U), std::size_t(3U)));
+		fl.write_changes_async().get();
+		assert(!fl.has_unsaved_changes() && read_file(path) == "B\nC\nd\n");
+		std::remove(path.c_str());
+	}
+}
+
+int main() {
+	test_references();
+	test_loader_change_tracking();
+	std::cout << "line_piece_table_test passed\n";
+}
@@ -0,0 +1,60 @@
+// Tests of assigning lazily evaluated matrix expressions to the matrix containers whose operands alias the destination.
+// Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Icontainer -Imemory -pthread tests/matrix_expression_test.cpp
+#include "aligned_matrix.h"
+#include "fixed_matrix.h"
+#include "mathematical_dynamic_matrix.h"
+#include "matrix_view.h"
+#include <cassert>
+#include <iostream>
+
+using namespace crsc;
+
+namespace {
+	template<class Matrix>
+	bool equals_2x2(const Matrix& m, int a, int b, int c, int d) {
+		return m.at(0U, 0U) == a && m.at(0U, 1U) == b && m.at(1U, 0U) == c && m.at(1U, 1U) == d;
+	}
+	void test_dynamic_aliasing() {
+		mathematical_dynamic_matrix<int> a = { { 1, 2 }, { 3, 4 } };
+		const mathematical_dynamic_matrix<int> z(2U, 2U, 0);
+		a = make_matrix_view(a).transpose() + z;
+		assert(equals_2x2(a, 1, 3, 2, 4));
+		a = a + a; // container operands are still evaluated in place
+		assert(equals_2x2(a, 2, 6, 4, 8));
+		a += make_matrix_view(a).transpose();
+		assert(equals_2x2(a, 4, 10, 10, 16));
+		a -= make_matrix_view(a).transpose()*2;
+		assert(equals_2x2(a, -4, -10, -10, -16));
+	}
+	void test_fixed_aliasing() {
+		fixed_matrix<int, 2, 2> a = { { 1, 2 }, { 3, 4 } };
+		const fixed_matrix<int, 2, 2> z(0);
+		a = make_matrix_view(a).transpose() + z;
+		assert(equals_2x2(a, 1, 3, 2, 4));
+		a = -make_matrix_view(a).transpose();
+		assert(equals_2x2(a, -1, -2, -3, -4));
+		a += make_matrix_view(a).transpose();
+		assert(equals_2x2(a, -2, -5, -5, -8));
+	}
+	template<class Layout>
+	void test_aligned_aliasing() {
+		aligned_matrix<int, Layout> b(2U, 2U);
+		b(0U, 0U) = 1; b(0U, 1U) = 2; b(1U, 0U) = 3; b(1U, 1U) = 4;
+		aligned_matrix<int, Layout> y(2U, 2U, 0);
+		b = b.view().transpose() + y.view();
+		assert(equals_2x2(b, 1, 3, 2, 4));
+		b += b.view().transpose();
+		assert(equals_2x2(b, 2, 5, 5, 8));
+		b = b*2;
+		assert(equals_2x2(b, 4, 10, 10, 16));
+	}
+}
+
+int main() {
+	test_dynamic_aliasing();
+	test_fixed_aliasing();
+	test_aligned_aliasing<row_major>();
+	test_aligned_aliasing<column_major>();
+	std::cout << "matrix_expression_test passed\n";
+}
@@ -0,0 +1,148 @@
+// Tests of crsc::memory resources and allocators, and of the library containers instantiated with them.
+// Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Icontainer -Ifilesystem -Imemory -pthread tests/memory_resources_test.cpp
+#include "memory_resources.h"
+#include "dynamic_array.h"
+#include "dynamic_matrix.h"
+#include "file_loader.h"
+#include "mathematical_dynamic_matrix.h"
+#include "priority_queue.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace crsc;
+using namespace crsc::memory;
+
+namespace {
+	// upstream resource refusing requests above a limit, such that oversized requests fail without being attempted
+	class limited_resource : public memory_resource {
+	public:
+		std::size_t requests = 0U;
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			++requests;
+			if (bytes > (static_cast<std::size_t>(1U) << 30)) throw std::bad_alloc();
+			return new_delete_resource()->allocate(bytes, alignment);
+		}
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+			new_delete_resource()->deallocate(p, bytes, alignment);
+		}
+		bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+	};
+	template<class Function>
+	bool throws_bad_alloc(Function f) {
+		try { f(); }
+		catch (const std::bad_alloc&) { return true; }
+		return false;
+	}
+	// Requests whose size computations would overflow throw std::bad_alloc instead of returning short blocks.
+	void test_arena_overflow() {
+		const std::size_t max_size = std::numeric_limits<std::size_t>::max();
+		limited_resource upstream;
+		monotonic_arena arena(1024U, &upstream);
+		for (std::size_t bytes : { max_size, max_size - 8U, max_size - 64U, max_size/2U, max_size/2U + 1U })
+			assert(throws_bad_alloc([&arena, bytes]() { arena.allocate(bytes, 64U); }));
+		assert(arena.bytes_allocated() == 0U);
+		// the arena remains usable after a failure
+		void* p = arena.allocate(100U, 64U);
+		assert(p && reinterpret_cast<std::uintptr_t>(p) % 64U == 0U && arena.bytes_allocated() == 100U);
+		alignas(64) unsigned char buf[512];
+		monotonic_arena buffered(buf, sizeof buf, &upstream);
+		buffered.allocate(16U);
+		assert(throws_bad_alloc([&buffered, max_size]() { buffered.allocate(max_size - 4U, 16U); }));
+		assert(throws_bad_alloc([max_size]() { new_delete_resource()->allocate(max_size - 8U, 256U); }));
+	}
+	void test_arena() {
+		alignas(64) unsigned char buf[512];
+		monotonic_arena small(buf, sizeof buf);
+		void* a = small.allocate(100U, 64U);
+		assert(reinterpret_cast<std::uintptr_t>(a) % 64U == 0U && a >= buf && a < buf + sizeof buf);
+		void* b = small.allocate(1000U, 128U);
+		assert(reinterpret_cast<std::uintptr_t>(b) % 128U == 0U);
+		small.release();
+		assert(small.bytes_allocated() == 0U);
+		void* big = new_delete_resource()->allocate(10U, 256U);
+		assert(reinterpret_cast<std::uintptr_t>(big) % 256U == 0U);
+		new_delete_resource()->deallocate(big, 10U, 256U);
+		monotonic_arena scoped;
+		set_default_resource(&scoped);
+		{ std::vector<int, polymorphic_allocator<int>> v(100U); }
+		assert(scoped.bytes_allocated() == 100U*sizeof(int));
+		set_default_resource(nullptr);
+		assert(get_default_resource() == new_delete_resource());
+	}
+	// The library containers work with both allocators.
+	void test_containers() {
+		monotonic_arena arena(256U);
+		{
+			dynamic_matrix<double, polymorphic_allocator<double>> m(50U, 40U, 1.5, polymorphic_allocator<double>(&arena));
+			assert(m.get_allocator().resource() == &arena && m[3][4] == 1.5);
+			const dynamic_matrix<double, polymorphic_allocator<double>> copy = m;
+			assert(copy.get_allocator().resource() == get_default_resource() && copy.at(49U, 39U) == 1.5);
+			mathematical_dynamic_matrix<double, polymorphic_allocator<double>> a(10U, 10U, polymorphic_allocator<double>(&arena));
+			mathematical_dynamic_matrix<double, pool_allocator<double>> b(10U, 10U);
+			assert(a.rows() == 10U && b.columns() == 10U);
+			std::vector<int, polymorphic_allocator<int>> storage{ polymorphic_allocator<int>(&arena) };
+			storage.push_back(3);
+			priority_queue<int, std::vector<int, polymorphic_allocator<int>>> pq(std::less<int>(), std::move(storage));
+			for (int i = 0; i < 1000; ++i) pq.enqueue(i);
+			assert(pq.top() == 999);
+			dynamic_array<std::string, polymorphic_allocator<std::string>, 2> da{ polymorphic_allocator<std::string>(&arena) };
+			for (int i = 0; i < 100; ++i) da.push_back(std::to_string(i));
+			assert(da[99] == "99");
+			const std::string path = "memory_resources_test.txt";
+			{ std::ofstream ofs(path); ofs << "a\nb\n"; }
+			{
+				file_loader<std::vector<std::string, polymorphic_allocator<std::string>>> fl(path);
+				assert(fl.lines() == 2U && fl[1] == "b");
+				fl.push_line_back("c");
+				fl.write_changes();
+			}
+			assert(file_loader<>(path).lines() == 3U);
+			std::remove(path.c_str());
+		}
+		assert(arena.bytes_allocated() > 0U);
+		arena.release();
+		assert(arena.bytes_allocated() == 0U);
+	}
+	void test_pool_allocator() {
+		std::list<int, pool_allocator<int>> shared;
+		std::vector<std::thread> threads;
+		std::mutex mut;
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([&shared, &mut, t]() {
+				std::map<int, int, std::less<int>, pool_allocator<std::pair<const int, int>>> m;
+				for (int i = 0; i < 10000; ++i) m[i] = i*t;
+				assert(m[77] == 77*t);
+				std::list<int, pool_allocator<int>> l;
+				for (int i = 0; i < 1000; ++i) l.push_back(i);
+				std::lock_guard<std::mutex> lock(mut);
+				shared.splice(shared.end(), l);
+			});
+		}
+		for (auto& t : threads) t.join();
+		assert(shared.size() == 4000U);
+		shared.clear();
+		static_assert(fixed_pool<1, 8>::block_size == sizeof(void*), "");
+		static_assert(fixed_pool<24, 8>::block_size == 24U, "");
+	}
+}
+
+int main() {
+	test_arena_overflow();
+	test_arena();
+	test_containers();
+	test_pool_allocator();
+	std::cout << "memory_resources_test passed\n";
+}
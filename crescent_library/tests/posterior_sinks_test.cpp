@@ -0,0 +1,79 @@
+// Tests of the crsc::mc posterior histogram sinks.
+// Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Ibinning -Imonte_carlo -pthread tests/posterior_sinks_test.cpp
+#include "posterior_sinks.h"
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+using namespace crsc;
+using namespace crsc::mc;
+
+namespace {
+	void test_marginal() {
+		marginal_histogram_sink<double, 2> sink(1U, 0.0, 10.0, 5U);
+		assert(sink.dim() == 1U && sink.bins() == 5U && sink.bin_width() == 2.0);
+		sink({ { -100.0, 0.0 } });
+		sink({ { -100.0, 3.0 } });
+		sink({ { -100.0, 10.0 } }); // upper prior bound lands in the last bin
+		sink({ { -100.0, -0.5 } });
+		sink({ { -100.0, 10.5 } });
+		sink({ { -100.0, std::numeric_limits<double>::quiet_NaN() } });
+		assert(sink.frequencies()[0] == 1U && sink.frequencies()[1] == 1U && sink.frequencies()[4] == 1U);
+		assert(sink.outside() == 3U);
+		const hist::ranged_histogram<double>& h = sink.histogram();
+		assert(h.underflow() == 2U && h.overflow() == 1U);
+		assert(h.range_min() == 0.0 && h.range_max() == 10.0);
+		marginal_histogram_sink<double, 2> other(1U, 0.0, 10.0, 5U);
+		other({ { 0.0, 9.0 } });
+		sink.merge(other);
+		assert(sink.frequencies()[4] == 2U && sink.outside() == 3U);
+		bool threw = false;
+		try { sink.merge(marginal_histogram_sink<double, 2>(0U, 0.0, 10.0, 5U)); }
+		catch (const std::invalid_argument&) { threw = true; }
+		assert(threw);
+		threw = false;
+		try { sink.merge(marginal_histogram_sink<double, 2>(1U, 0.0, 10.0, 4U)); }
+		catch (const std::invalid_argument&) { threw = true; }
+		assert(threw && sink.frequencies()[4] == 2U);
+	}
+	void test_marginal_invalid() {
+		int thrown = 0;
+		try { marginal_histogram_sink<double, 2>(2U, 0.0, 1.0, 1U); } catch (const std::invalid_argument&) { ++thrown; }
+		try { marginal_histogram_sink<double, 2>(0U, 0.0, 1.0, 0U); } catch (const std::invalid_argument&) { ++thrown; }
+		try { marginal_histogram_sink<double, 2>(0U, 1.0, 1.0, 1U); } catch (const std::invalid_argument&) { ++thrown; }
+		assert(thrown == 3);
+	}
+	void test_joint() {
+		joint_histogram_sink<double, 3> sink(0U, -5.0, 5.0, 4U, 2U, 0.0, 100.0, 5U);
+		assert(sink.x_dim() == 0U && sink.y_dim() == 2U && sink.xbins() == 4U && sink.ybins() == 5U);
+		sink({ { -5.0, 0.0, 0.0 } });
+		sink({ { 5.0, 0.0, 100.0 } }); // both upper bounds land in the last bins
+		sink({ { 0.0, 0.0, 50.0 } });
+		sink({ { 6.0, 0.0, 50.0 } });
+		sink({ { 0.0, 0.0, -1.0 } });
+		assert(sink.frequency(0U, 0U) == 1U && sink.frequency(3U, 4U) == 1U && sink.frequency(2U, 2U) == 1U);
+		assert(sink.outside() == 2U && sink.histogram().outside() == 2U);
+		joint_histogram_sink<double, 3> other(0U, -5.0, 5.0, 4U, 2U, 0.0, 100.0, 5U);
+		other({ { -4.0, 0.0, 1.0 } });
+		sink.merge(other);
+		assert(sink.frequency(0U, 0U) == 2U);
+		bool threw = false;
+		try { sink.merge(joint_histogram_sink<double, 3>(0U, -5.0, 5.0, 4U, 1U, 0.0, 100.0, 5U)); }
+		catch (const std::invalid_argument&) { threw = true; }
+		assert(threw);
+		threw = false;
+		try { joint_histogram_sink<double, 3>(0U, -5.0, 5.0, 4U, 3U, 0.0, 100.0, 5U); }
+		catch (const std::invalid_argument&) { threw = true; }
+		assert(threw);
+	}
+}
+
+int main() {
+	test_marginal();
+	test_marginal_invalid();
+	test_joint();
+	std::cout << "posterior_sinks_test passed\n";
+}
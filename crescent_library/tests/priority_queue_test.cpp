@@ -0,0 +1,66 @@
+// Tests of crsc::priority_queue range insertion.
+// Build from crescent_library/ with e.g.
+//   g++ -std=c++14 -I. -Icontainer tests/priority_queue_test.cpp
+#include "priority_queue.h"
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+using namespace crsc;
+
+namespace {
+	// element type without a default constructor
+	struct no_default {
+		explicit no_default(int _v) : v(_v) {}
+		bool operator<(const no_default& other) const noexcept { return v < other.v; }
+		int v;
+	};
+	// input iterator over [0, limit) which throws on dereferencing `fail_at`
+	class throwing_input_iterator {
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef no_default value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const no_default* pointer;
+		typedef no_default reference;
+		throwing_input_iterator(int _pos, int _fail_at) : pos(_pos), fail_at(_fail_at) {}
+		no_default operator*() const {
+			if (pos == fail_at) throw std::runtime_error("iterator failure");
+			return no_default(pos);
+		}
+		throwing_input_iterator& operator++() { ++pos; return *this; }
+		throwing_input_iterator operator++(int) { throwing_input_iterator tmp(*this); ++pos; return tmp; }
+		bool operator==(const throwing_input_iterator& other) const noexcept { return pos == other.pos; }
+		bool operator!=(const throwing_input_iterator& other) const noexcept { return pos != other.pos; }
+	private:
+		int pos;
+		int fail_at;
+	};
+	void test_enqueue_range() {
+		priority_queue<no_default> pq;
+		const std::vector<no_default> items = { no_default(3), no_default(7), no_default(1) };
+		pq.enqueue(items.begin(), items.end());
+		pq.enqueue(throwing_input_iterator(10, -1), throwing_input_iterator(12, -1));
+		assert(pq.size() == 5U && pq.top().v == 11);
+	}
+	void test_enqueue_range_rollback() {
+		priority_queue<no_default> pq;
+		pq.enqueue(no_default(5));
+		pq.enqueue(no_default(2));
+		bool threw = false;
+		try { pq.enqueue(throwing_input_iterator(0, 3), throwing_input_iterator(8, 3)); }
+		catch (const std::runtime_error&) { threw = true; }
+		assert(threw && pq.size() == 2U && pq.top().v == 5);
+		pq.dequeue();
+		assert(pq.top().v == 2);
+	}
+}
+
+int main() {
+	test_enqueue_range();
+	test_enqueue_range_rollback();
+	std::cout << "priority_queue_test passed\n";
+}
@@ -1,13 +1,41 @@
 #ifndef SEMAPHORE_H
 #define SEMAPHORE_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace crsc {
     /**
      * \class semaphore
      *
      * \brief A data type used for controlling access to a common resource in a concurrent system.
+     *
+     * The count is an atomic integer, so `notify` and `wait` complete with a single atomic operation while
+     * units of resource are available; only a `wait` finding the count exhausted (after spinning briefly)
+     * blocks on a condition variable, and only a `notify` releasing such a blocked thread takes the mutex.
      */
     class semaphore {
     public:
@@ -17,30 +45,460 @@ namespace crsc {
          * \param _count Units of resource (default set to `0`).
          */
         explicit semaphore(std::size_t _count = 0)
-            : count(_count) {}
+            : count(static_cast<std::ptrdiff_t>(_count)), wakeups(0U) {}
+        semaphore(const semaphore&) = delete;
+        semaphore& operator=(const semaphore&) = delete;
         /**
          * \brief Increments the value of the semaphore count by 1 unit and transfers
          *        blocked process from semaphore's waiting queue to the ready queue.
          */
         void notify() {
-            std::unique_lock<std::mutex> lock(mut);
-            ++count;
+            if (count.fetch_add(1, std::memory_order_acq_rel) >= 0) return;   // no thread is blocked
+            {
+                std::lock_guard<std::mutex> lock(mut);
+                ++wakeups;
+            }
             cv.notify_one();
         }
         /**
-         * \brief Process executing wait is blocked until semaphore count value is 
+         * \brief Process executing wait is blocked until semaphore count value is
          *        greater than 0 and count is decremented.
          */
         void wait() {
+            for (int i = 0; i < spin_count; ++i) {
+                if (try_wait()) return;
+            }
+            if (count.fetch_sub(1, std::memory_order_acq_rel) > 0) return;
+            // the count is now negative by the number of blocked threads, each released by one notify
             std::unique_lock<std::mutex> lock(mut);
-            cv.wait(lock, [this]() {return count > 0; });
-            --count;
+            cv.wait(lock, [this]() { return wakeups > 0U; });
+            --wakeups;
+        }
+        /**
+         * \brief Decrements the semaphore count by 1 unit if it is greater than 0, without blocking.
+         *
+         * \return `true` if a unit of resource was acquired, `false` otherwise.
+         */
+        bool try_wait() noexcept {
+            std::ptrdiff_t c = count.load(std::memory_order_relaxed);
+            while (c > 0) {
+                if (count.compare_exchange_weak(c, c - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) return true;
+            }
+            return false;
         }
     private:
+        static constexpr int spin_count = 64;
+        std::atomic<std::ptrdiff_t> count;  // units available, or minus the number of blocked threads
+        std::size_t wakeups;                // notifications not yet consumed by blocked threads
         std::mutex mut;
         std::condition_variable cv;
-        std::size_t count;
     };
+    /**
+     * \class thread_pool
+     *
+     * \brief A fixed set of worker threads executing submitted tasks, balanced by work stealing.
+     *
+     * Each worker owns a deque of tasks: tasks submitted from a worker are pushed onto its own deque, which it
+     * pops from the back (most recent first, for locality), while tasks submitted from other threads are dealt
+     * round-robin over the deques. A worker whose deque is empty steals from the front of the others, and
+     * sleeps only when every deque is empty.
+     *
+     * Threads waiting for tasks through `wait` execute queued tasks in the meantime, so tasks may submit and
+     * wait for further tasks (e.g. nested `parallel_for` calls) without exhausting the workers. The tasks run
+     * while waiting may be unrelated to the one waited for, so a task should only wait for the tasks it submits
+     * itself, and those must not wait for tasks other than their own in turn: a task run on top of a waiting
+     * one which blocks on anything that waiting task holds up never completes. Tasks still queued when the
+     * pool is destroyed are run before the workers are joined.
+     */
+    class thread_pool {
+    public:
+        // CONSTRUCTION
+        /**
+         * \brief Starts the worker threads of the pool.
+         *
+         * \param threads Number of worker threads, `0` selects `std::thread::hardware_concurrency()`.
+         * \param pin_to_cores Whether worker `i` is bound to logical processor `i % hardware_concurrency()`;
+         *        best effort, ignored on platforms without thread affinity support.
+         * \throw Throws `std::system_error` if a thread cannot be started.
+         */
+        explicit thread_pool(std::size_t threads = 0U, bool pin_to_cores = false)
+            : next_queue(0U), pending(0U), stop(false) {
+            const std::size_t n = threads ? threads : std::max(1U, std::thread::hardware_concurrency());
+            queues.reserve(n);
+            for (std::size_t i = 0U; i < n; ++i) queues.emplace_back(new worker_queue());
+            workers.reserve(n);
+            try {
+                for (std::size_t i = 0U; i < n; ++i) {
+                    workers.emplace_back([this, i]() { run_worker(i); });
+                    if (pin_to_cores) pin(workers.back(), i);
+                }
+            }
+            catch (...) {
+                shutdown();
+                throw;
+            }
+        }
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        /**
+         * \brief Runs the tasks still queued and joins the worker threads.
+         */
+        ~thread_pool() { shutdown(); }
+        /**
+         * \brief Returns the pool shared by the parallel operations of the library, with a worker per hardware
+         *        thread, started on first use.
+         */
+        static thread_pool& default_pool() {
+            static thread_pool pool;
+            return pool;
+        }
+        // CAPACITY
+        /**
+         * \brief Returns the number of worker threads.
+         */
+        std::size_t size() const noexcept { return workers.size(); }
+        // OPERATIONS
+        /**
+         * \brief Queues `f` for execution on the pool.
+         *
+         * \param f Callable with signature `R()`.
+         * \return `std::future<R>` receiving the result of `f`, or the exception it threw.
+         * \throw Throws `std::bad_alloc` if the task cannot be allocated.
+         */
+        template<class Function>
+        auto submit(Function&& f) -> std::future<std::result_of_t<std::decay_t<Function>()>> {
+            typedef std::result_of_t<std::decay_t<Function>()> result_type;
+            std::packaged_task<result_type()> pt(std::forward<Function>(f));
+            std::future<result_type> fut = pt.get_future();
+            push(task(new task_impl<std::packaged_task<result_type()>>(std::move(pt))));
+            return fut;
+        }
+        /**
+         * \brief Blocks until the future `fut` is ready, executing queued tasks of the pool on the calling
+         *        thread in the meantime. Does not retrieve the result, such that `fut.get()` completes without
+         *        blocking afterwards.
+         *
+         * Any queued task may be executed by this call, including ones submitted after `fut`'s task; called
+         * from a task, `fut` should therefore belong to a task submitted by the caller (see class remarks).
+         *
+         * \param fut `std::future` or `std::shared_future` made ready by a task of this pool.
+         */
+        template<class Future>
+        void wait(const Future& fut) {
+            while (fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                if (run_pending_task()) continue;
+                // nothing is queued, so the task of fut is running and will complete without this thread
+                if (!pending.load()) {
+                    fut.wait();
+                    return;
+                }
+            }
+        }
+        /**
+         * \brief Executes one queued task on the calling thread, if any.
+         *
+         * \return `true` if a task was executed, `false` if none was queued.
+         */
+        bool run_pending_task() {
+            task t;
+            const std::size_t self = (current().pool == this) ? current().index : 0U;
+            if (!pop(self, t)) return false;
+            t->run();
+            return true;
+        }
+    private:
+        struct task_base {
+            virtual ~task_base() = default;
+            virtual void run() = 0;
+        };
+        template<class Function>
+        struct task_impl : task_base {
+            explicit task_impl(Function&& _f) : f(std::move(_f)) {}
+            void run() override { f(); }
+            Function f;
+        };
+        typedef std::unique_ptr<task_base> task;
+        struct worker_queue {
+            std::mutex mut;
+            std::deque<task> tasks;
+        };
+        struct worker_context {
+            const thread_pool* pool = nullptr;
+            std::size_t index = 0U;
+        };
+        std::vector<std::unique_ptr<worker_queue>> queues;
+        std::vector<std::thread> workers;
+        std::atomic<std::size_t> next_queue;
+        std::atomic<std::size_t> pending;   // number of queued tasks, over all deques
+        std::mutex sleep_mut;
+        std::condition_variable sleep_cv;
+        bool stop;
+        /**
+         * \brief Returns the pool and index of the worker running on the calling thread, if any.
+         */
+        static worker_context& current() noexcept {
+            static thread_local worker_context ctx;
+            return ctx;
+        }
+        void push(task t) {
+            const std::size_t idx = (current().pool == this) ? current().index : next_queue.fetch_add(1U) % queues.size();
+            {
+                std::lock_guard<std::mutex> lock(queues[idx]->mut);
+                queues[idx]->tasks.push_back(std::move(t));
+                pending.fetch_add(1U);
+            }
+            { std::lock_guard<std::mutex> lock(sleep_mut); }   // orders the push before any sleeping worker's check
+            sleep_cv.notify_one();
+        }
+        /**
+         * \brief Takes the most recent task of deque `self`, otherwise steals the oldest task of another deque.
+         */
+        bool pop(std::size_t self, task& out) {
+            if (!pending.load()) return false;
+            for (std::size_t k = 0U; k < queues.size(); ++k) {
+                worker_queue& q = *queues[(self + k) % queues.size()];
+                std::lock_guard<std::mutex> lock(q.mut);
+                if (q.tasks.empty()) continue;
+                if (k == 0U) {
+                    out = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                }
+                else {
+                    out = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                }
+                pending.fetch_sub(1U);
+                return true;
+            }
+            return false;
+        }
+        void run_worker(std::size_t index) {
+            current().pool = this;
+            current().index = index;
+            for (;;) {
+                task t;
+                if (pop(index, t)) {
+                    t->run();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleep_mut);
+                if (stop && !pending.load()) return;
+                sleep_cv.wait(lock, [this]() { return stop || pending.load(); });
+            }
+        }
+        void shutdown() noexcept {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mut);
+                stop = true;
+            }
+            sleep_cv.notify_all();
+            for (auto& w : workers) w.join();
+        }
+        static void pin(std::thread& th, std::size_t index) noexcept {
+            const std::size_t cpu = index % std::max(1U, std::thread::hardware_concurrency());
+#if defined(_WIN32)
+            if (cpu < sizeof(DWORD_PTR)*8U) ::SetThreadAffinityMask(th.native_handle(), static_cast<DWORD_PTR>(1U) << cpu);
+#elif defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            ::pthread_setaffinity_np(th.native_handle(), sizeof(set), &set);
+#else
+            (void)th; (void)cpu;
+#endif
+        }
+    };
+    /**
+     * \brief Execution policies used to select between the serial and multithreaded overloads of
+     *        container operations, modelled on the C++17 `<execution>` policies.
+     */
+    namespace execution {
+        /**
+         * \class sequenced_policy
+         *
+         * \brief Execution policy requesting that an operation runs entirely on the calling thread.
+         */
+        class sequenced_policy {};
+        /**
+         * \class parallel_policy
+         *
+         * \brief Execution policy requesting that an operation splits its work across multiple threads.
+         *
+         * The work is only split when each thread would receive at least `grain_size()` units of work (elements
+         * for element-wise operations), such that small operations keep running serially on the calling thread
+         * rather than paying the cost of scheduling tasks. A `parallel_policy` with a `concurrency()` of `1`
+         * always executes serially; `sequenced_policy` converts implicitly to such a policy. The work is run on
+         * `executor()`, `thread_pool::default_pool()` unless the policy was constructed with a pool.
+         */
+        class parallel_policy {
+        public:
+            /**
+             * \brief Constructs the policy with `_threads` threads and a minimum of `_grain` units of work
+             *        per thread.
+             *
+             * \param _threads Maximum number of threads to use, `0` selects `std::thread::hardware_concurrency()`.
+             * \param _grain Minimum number of units of work assigned to each thread.
+             */
+            explicit parallel_policy(std::size_t _threads = 0U, std::size_t _grain = default_grain)
+                : threads(_threads ? _threads : std::max(1U, std::thread::hardware_concurrency())),
+                grain(std::max<std::size_t>(_grain, 1U)), pool(nullptr) {}
+            /**
+             * \brief Constructs the policy running on the pool `_pool`, with a thread per worker plus the
+             *        calling thread and a minimum of `_grain` units of work per thread.
+             *
+             * \param _pool Pool executing the work, which must outlive the operations using the policy.
+             * \param _grain Minimum number of units of work assigned to each thread.
+             */
+            explicit parallel_policy(thread_pool& _pool, std::size_t _grain = default_grain)
+                : threads(_pool.size() + 1U), grain(std::max<std::size_t>(_grain, 1U)), pool(&_pool) {}
+            /**
+             * \brief Converting constructor, a sequenced policy is a parallel policy of a single thread.
+             */
+            parallel_policy(const sequenced_policy&)
+                : threads(1U), grain(default_grain), pool(nullptr) {}
+            /**
+             * \brief Returns the maximum number of threads an operation may use.
+             */
+            std::size_t concurrency() const noexcept { return threads; }
+            /**
+             * \brief Returns the minimum number of units of work assigned to each thread.
+             */
+            std::size_t grain_size() const noexcept { return grain; }
+            /**
+             * \brief Returns the pool on which operations using this policy run.
+             */
+            thread_pool& executor() const { return pool ? *pool : thread_pool::default_pool(); }
+            /**
+             * \brief Default minimum number of elements per thread for element-wise operations.
+             */
+            static constexpr std::size_t default_grain = 1U << 15;
+        private:
+            std::size_t threads;
+            std::size_t grain;
+            thread_pool* pool;
+        };
+        /**
+         * \brief Instance of `sequenced_policy` to pass to policy overloads.
+         */
+        const sequenced_policy seq{};
+        /**
+         * \brief Instance of `parallel_policy` using all hardware threads and the default grain size.
+         */
+        const parallel_policy par{};
+    }
+    namespace threading_impl {
+        /**
+         * \brief Returns the number of chunks into which `parallel_for` splits `n` indices.
+         */
+        inline std::size_t chunk_count(const execution::parallel_policy& policy, std::size_t n, std::size_t grain) noexcept {
+            return std::min(policy.concurrency(), std::max<std::size_t>(n / std::max<std::size_t>(grain, 1U), 1U));
+        }
+        /**
+         * \brief Splits the `n` indices from `first` into `chunks` contiguous chunks, running `run(c, b, e)` for
+         *        each chunk `c = [b, e)`; chunk `0` runs on the calling thread, the others as tasks of
+         *        `policy.executor()`. The first exception thrown by `run` is rethrown once all chunks completed.
+         */
+        template<class Run>
+        void run_chunks(const execution::parallel_policy& policy, std::size_t first, std::size_t n, std::size_t chunks, Run& run) {
+            auto chunk_begin = [first, n, chunks](std::size_t c) { return first + (n / chunks)*c + std::min(c, n % chunks); };
+            thread_pool& pool = policy.executor();
+            std::vector<std::future<void>> tasks;
+            tasks.reserve(chunks - 1U);
+            std::exception_ptr error;
+            try {
+                for (std::size_t c = 1U; c < chunks; ++c)
+                    tasks.push_back(pool.submit([&run, &chunk_begin, c]() { run(c, chunk_begin(c), chunk_begin(c + 1U)); }));
+                run(0U, chunk_begin(0U), chunk_begin(1U));
+            }
+            catch (...) { error = std::current_exception(); }
+            // every task refers to the frame of this call, so all must finish before any exception escapes
+            for (auto& t : tasks) pool.wait(t);
+            for (auto& t : tasks) {
+                try { t.get(); }
+                catch (...) { if (!error) error = std::current_exception(); }
+            }
+            if (error) std::rethrow_exception(error);
+        }
+    }
+    /**
+     * \brief Applies `f` to sub-ranges partitioning the index range `[first, last)`, with the sub-ranges
+     *        processed concurrently according to `policy`.
+     *
+     * The range is split into at most `policy.concurrency()` contiguous chunks of at least `grain` indices
+     * each; the first chunk runs on the calling thread and the others as tasks of `policy.executor()`, with the
+     * calling thread executing queued tasks while it waits for them. If only one chunk results, `f(first, last)`
+     * is invoked directly. The first exception thrown by any invocation of `f` is rethrown once all chunks have
+     * completed.
+     *
+     * \param policy Execution policy to use.
+     * \param first Beginning of index range.
+     * \param last End of index range.
+     * \param grain Minimum number of indices in each chunk.
+     * \param f Callable with signature `void(std::size_t, std::size_t)` processing a half-open sub-range.
+     */
+    template<class Function>
+    void parallel_for(const execution::parallel_policy& policy, std::size_t first, std::size_t last,
+        std::size_t grain, Function f) {
+        if (last <= first) return;
+        const std::size_t n = last - first;
+        const std::size_t chunks = threading_impl::chunk_count(policy, n, grain);
+        if (chunks == 1U) { f(first, last); return; }
+        auto run = [&f](std::size_t, std::size_t b, std::size_t e) { f(b, e); };
+        threading_impl::run_chunks(policy, first, n, chunks, run);
+    }
+    /**
+     * \brief Applies `f` to sub-ranges partitioning the index range `[first, last)` using the grain size
+     *        of `policy`.
+     *
+     * \see parallel_for(const execution::parallel_policy&, std::size_t, std::size_t, std::size_t, Function)
+     */
+    template<class Function>
+    void parallel_for(const execution::parallel_policy& policy, std::size_t first, std::size_t last, Function f) {
+        parallel_for(policy, first, last, policy.grain_size(), f);
+    }
+    /**
+     * \brief Reduces the index range `[first, last)` by mapping sub-ranges partitioning it to partial results
+     *        concurrently according to `policy`, as `parallel_for`, and combining the partial results in order.
+     *
+     * The result is `combine(...combine(combine(identity, map(b0, e0)), map(b1, e1))..., map(bk, ek))` for the
+     * chunks `[b0, e0), ..., [bk, ek)` in increasing order, so `combine` need only be associative.
+     *
+     * \param policy Execution policy to use.
+     * \param first Beginning of index range.
+     * \param last End of index range.
+     * \param grain Minimum number of indices in each chunk.
+     * \param identity Initial value of the reduction, returned for an empty range.
+     * \param map Callable with signature `Ty(std::size_t, std::size_t)` reducing a half-open sub-range.
+     * \param combine Callable with signature `Ty(Ty, Ty)` combining two partial results.
+     * \return The reduction of the range.
+     */
+    template<class Ty,
+        class Map,
+        class Combine
+    > Ty parallel_reduce(const execution::parallel_policy& policy, std::size_t first, std::size_t last,
+        std::size_t grain, Ty identity, Map map, Combine combine) {
+        if (last <= first) return identity;
+        const std::size_t n = last - first;
+        const std::size_t chunks = threading_impl::chunk_count(policy, n, grain);
+        if (chunks == 1U) return combine(std::move(identity), map(first, last));
+        std::vector<Ty> partials(chunks, identity);
+        auto run = [&map, &partials](std::size_t c, std::size_t b, std::size_t e) { partials[c] = map(b, e); };
+        threading_impl::run_chunks(policy, first, n, chunks, run);
+        for (auto& p : partials) identity = combine(std::move(identity), std::move(p));
+        return identity;
+    }
+    /**
+     * \brief Reduces the index range `[first, last)` using the grain size of `policy`.
+     *
+     * \see parallel_reduce(const execution::parallel_policy&, std::size_t, std::size_t, std::size_t, Ty, Map, Combine)
+     */
+    template<class Ty,
+        class Map,
+        class Combine
+    > Ty parallel_reduce(const execution::parallel_policy& policy, std::size_t first, std::size_t last,
+        Ty identity, Map map, Combine combine) {
+        return parallel_reduce(policy, first, last, policy.grain_size(), std::move(identity), map, combine);
+    }
 }
 
-#endif // !SEMAPHORE_H
\ No newline at end of file
+#endif // !SEMAPHORE_H